@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Benchmark regression check (sim_bench JSON vs. a stored baseline)
+Usage:
+  python3 bench_compare.py <baseline_json> <current_json> [--tolerance 0.10]
+Exits 1 when a case is slower, allocates more or uses more memory than the
+baseline by more than the tolerance. Record a baseline with `make bench_baseline`.
+"""
+
+import argparse
+import json
+import sys
+
+# metric -> True when higher is better
+METRICS = [
+    ("transactions_per_sec", True),
+    ("ns_per_hop", False),
+    ("allocations_per_transaction", False),
+    ("peak_rss_kb", False),
+]
+
+# Absolute slack so near-zero metrics (0.00 allocations) do not flag noise
+ABSOLUTE_SLACK = {
+    "allocations_per_transaction": 0.05,
+    "peak_rss_kb": 1024,
+}
+
+
+def load_cases(path):
+    with open(path) as f:
+        return json.load(f).get("cases", {})
+
+
+def regressed(metric, higher_is_better, baseline, current, tolerance):
+    slack = ABSOLUTE_SLACK.get(metric, 0.0)
+    if higher_is_better:
+        return current < baseline * (1.0 - tolerance) - slack
+    return current > baseline * (1.0 + tolerance) + slack
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare sim_bench results against a baseline")
+    parser.add_argument("baseline", help="Baseline JSON written by sim_bench")
+    parser.add_argument("current", help="Current JSON written by sim_bench")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="Relative change tolerated before a regression is reported (default 0.10)")
+    args = parser.parse_args()
+
+    baseline_cases = load_cases(args.baseline)
+    current_cases = load_cases(args.current)
+
+    regressions = []
+    print("%-22s %-28s %14s %14s %8s" % ("case", "metric", "baseline", "current", "change"))
+    for name, baseline in baseline_cases.items():
+        current = current_cases.get(name)
+        if current is None:
+            print("%-22s (not in current run)" % name)
+            continue
+        if not current.get("ok", False):
+            regressions.append("%s: failed (%s)" % (name, current.get("note", "")))
+            continue
+        for metric, higher_is_better in METRICS:
+            base_value = baseline.get(metric)
+            value = current.get(metric)
+            if base_value is None or value is None:
+                continue
+            change = (value - base_value) / base_value * 100.0 if base_value else 0.0
+            flag = ""
+            if regressed(metric, higher_is_better, base_value, value, args.tolerance):
+                flag = "  REGRESSION"
+                regressions.append("%s: %s %g -> %g" % (name, metric, base_value, value))
+            print("%-22s %-28s %14.2f %14.2f %+7.1f%%%s" % (name, metric, base_value, value, change, flag))
+
+    if regressions:
+        print("\n%d regression(s) beyond %.0f%%:" % (len(regressions), args.tolerance * 100.0))
+        for regression in regressions:
+            print("  " + regression)
+        return 1
+    print("\nNo regressions beyond %.0f%%" % (args.tolerance * 100.0))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
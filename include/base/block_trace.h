@@ -0,0 +1,353 @@
+#ifndef BLOCK_TRACE_H
+#define BLOCK_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Captured block I/O traces for TrafficPattern::TRACE_REPLAY.
+//
+// Text traces are converted once into a compact binary file (<trace>.mbt, rebuilt when
+// older than the source) with a single streaming pass, then the binary file is mapped
+// read-only and walked sequentially. Nothing is loaded up front: pages are faulted in
+// on demand and released behind the cursor, so a multi-GB trace costs neither startup
+// time (after the first conversion) nor resident memory.
+//
+// Supported inputs (BlockTraceFormat):
+//   BINARY   : already converted .mbt file
+//   SNIA_CSV : Timestamp,Hostname,DiskNumber,Type,Offset,Size[,ResponseTime]
+//              (MSR Cambridge style; timestamp in 100 ns ticks, Type Read/Write)
+//   FIO_IOLOG: fio iolog v2/v3 ("[timestamp_ms] file read|write offset length")
+//   BLKPARSE : default blkparse text output, queue (Q) events only
+//
+// .mbt layout: "MOONBLK1" | u32 version (1) | u32 record size | u64 record count |
+//              BlockTraceRecord[count]  (timestamps relative to the first record)
+
+enum class BlockTraceFormat {
+    AUTO,
+    BINARY,
+    SNIA_CSV,
+    FIO_IOLOG,
+    BLKPARSE
+};
+
+inline BlockTraceFormat parse_block_trace_format(const std::string& format_str) {
+    if (format_str == "BINARY" || format_str == "MBT") return BlockTraceFormat::BINARY;
+    if (format_str == "SNIA_CSV" || format_str == "CSV") return BlockTraceFormat::SNIA_CSV;
+    if (format_str == "FIO_IOLOG" || format_str == "FIO") return BlockTraceFormat::FIO_IOLOG;
+    if (format_str == "BLKPARSE" || format_str == "BLKTRACE") return BlockTraceFormat::BLKPARSE;
+    return BlockTraceFormat::AUTO;
+}
+
+inline const char* block_trace_format_name(BlockTraceFormat format) {
+    switch (format) {
+        case BlockTraceFormat::BINARY: return "BINARY";
+        case BlockTraceFormat::SNIA_CSV: return "SNIA_CSV";
+        case BlockTraceFormat::FIO_IOLOG: return "FIO_IOLOG";
+        case BlockTraceFormat::BLKPARSE: return "BLKPARSE";
+        default: return "AUTO";
+    }
+}
+
+struct BlockTraceRecord {
+    uint64_t timestamp_ns;   // Relative to the first record
+    uint64_t offset;         // Bytes
+    uint32_t size;           // Bytes
+    uint8_t is_write;
+    uint8_t reserved[3];
+};
+static_assert(sizeof(BlockTraceRecord) == 24, "BlockTraceRecord is the on-disk .mbt record");
+
+class BlockTraceReader {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    static const size_t HEADER_SIZE = 24;
+
+    BlockTraceReader()
+        : m_base(nullptr), m_mapped_size(0), m_records(nullptr), m_count(0),
+          m_position(0), m_released(0) {}
+    ~BlockTraceReader() { close(); }
+
+    // Opens (converting first if needed) a trace; returns false with get_error() set
+    bool open(const std::string& path, BlockTraceFormat format = BlockTraceFormat::AUTO) {
+        close();
+        if (format == BlockTraceFormat::AUTO) {
+            format = detect_format(path);
+        }
+        std::string binary_path = path;
+        if (format != BlockTraceFormat::BINARY) {
+            binary_path = path + ".mbt";
+            if (!is_up_to_date(binary_path, path) && !convert(path, format, binary_path, &m_error)) {
+                return false;
+            }
+        }
+        return map(binary_path);
+    }
+
+    void close() {
+        if (m_base) {
+            munmap(m_base, m_mapped_size);
+        }
+        m_base = nullptr;
+        m_records = nullptr;
+        m_mapped_size = 0;
+        m_count = 0;
+        m_position = 0;
+        m_released = 0;
+    }
+
+    bool is_open() const { return m_base != nullptr; }
+    uint64_t size() const { return m_count; }
+    uint64_t position() const { return m_position; }
+    bool at_end() const { return m_position >= m_count; }
+    const std::string& get_error() const { return m_error; }
+
+    // Next record in trace order (nullptr at end). The pointer stays valid until the
+    // reader has advanced RELEASE_WINDOW bytes past it.
+    const BlockTraceRecord* next() {
+        if (m_position >= m_count) return nullptr;
+        const BlockTraceRecord* record = &m_records[m_position++];
+        release_consumed();
+        return record;
+    }
+    
+    // Next record without consuming it (nullptr at end)
+    const BlockTraceRecord* peek() const {
+        return (m_position < m_count) ? &m_records[m_position] : nullptr;
+    }
+
+    // One streaming pass from a text trace into .mbt; memory use is independent of size
+    static bool convert(const std::string& source, BlockTraceFormat format,
+                        const std::string& destination, std::string* error = nullptr) {
+        std::ifstream in(source);
+        if (!in.is_open()) {
+            if (error) *error = "cannot open trace " + source;
+            return false;
+        }
+        std::string temporary = destination + ".tmp";
+        std::FILE* out = std::fopen(temporary.c_str(), "wb");
+        if (!out) {
+            if (error) *error = "cannot create " + temporary;
+            return false;
+        }
+        uint64_t count = 0;
+        write_header(out, count);
+
+        std::string line;
+        bool have_base = false;
+        uint64_t base_ns = 0;
+        uint64_t line_number = 0;   // fio iolog v2 has no timestamps: line order at 1 us
+        while (std::getline(in, line)) {
+            BlockTraceRecord record;
+            uint64_t absolute_ns = 0;
+            if (!parse_line(line, format, line_number, record, absolute_ns)) {
+                continue;
+            }
+            line_number++;
+            if (!have_base) {
+                base_ns = absolute_ns;
+                have_base = true;
+            }
+            record.timestamp_ns = (absolute_ns >= base_ns) ? absolute_ns - base_ns : 0;
+            std::fwrite(&record, sizeof(record), 1, out);
+            count++;
+        }
+        // Patch the record count now that it is known
+        std::fseek(out, 16, SEEK_SET);
+        std::fwrite(&count, sizeof(count), 1, out);
+        std::fclose(out);
+        if (std::rename(temporary.c_str(), destination.c_str()) != 0) {
+            if (error) *error = "cannot rename " + temporary;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // Already-consumed pages are dropped from the mapping in windows of this size
+    static const size_t RELEASE_WINDOW = 64 * 1024 * 1024;
+
+    void* m_base;
+    size_t m_mapped_size;
+    const BlockTraceRecord* m_records;
+    uint64_t m_count;
+    uint64_t m_position;
+    size_t m_released;      // Bytes from m_base already released
+    std::string m_error;
+
+    bool map(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            m_error = "cannot open " + path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HEADER_SIZE) {
+            ::close(fd);
+            m_error = path + " is not a block trace";
+            return false;
+        }
+        m_mapped_size = static_cast<size_t>(info.st_size);
+        m_base = mmap(nullptr, m_mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m_base == MAP_FAILED) {
+            m_base = nullptr;
+            m_error = "cannot map " + path;
+            return false;
+        }
+        const char* bytes = static_cast<const char*>(m_base);
+        uint32_t version = 0;
+        uint32_t record_size = 0;
+        std::memcpy(&version, bytes + 8, sizeof(version));
+        std::memcpy(&record_size, bytes + 12, sizeof(record_size));
+        std::memcpy(&m_count, bytes + 16, sizeof(m_count));
+        if (std::memcmp(bytes, "MOONBLK1", 8) != 0 || version != FORMAT_VERSION ||
+            record_size != sizeof(BlockTraceRecord) ||
+            HEADER_SIZE + m_count * sizeof(BlockTraceRecord) > m_mapped_size) {
+            close();
+            m_error = path + " is not a valid .mbt trace";
+            return false;
+        }
+        m_records = reinterpret_cast<const BlockTraceRecord*>(bytes + HEADER_SIZE);
+        madvise(m_base, m_mapped_size, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    void release_consumed() {
+        size_t consumed = HEADER_SIZE + static_cast<size_t>(m_position) * sizeof(BlockTraceRecord);
+        if (consumed - m_released < 2 * RELEASE_WINDOW) return;
+        // Keep one window behind the cursor for records still referenced
+        size_t release_end = consumed - RELEASE_WINDOW;
+        release_end -= release_end % static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (release_end > m_released) {
+            madvise(static_cast<char*>(m_base) + m_released, release_end - m_released, MADV_DONTNEED);
+            m_released = release_end;
+        }
+    }
+
+    static void write_header(std::FILE* out, uint64_t count) {
+        uint32_t version = FORMAT_VERSION;
+        uint32_t record_size = sizeof(BlockTraceRecord);
+        std::fwrite("MOONBLK1", 1, 8, out);
+        std::fwrite(&version, sizeof(version), 1, out);
+        std::fwrite(&record_size, sizeof(record_size), 1, out);
+        std::fwrite(&count, sizeof(count), 1, out);
+    }
+
+    static bool is_up_to_date(const std::string& binary_path, const std::string& source_path) {
+        struct stat binary_info, source_info;
+        if (stat(binary_path.c_str(), &binary_info) != 0) return false;
+        if (stat(source_path.c_str(), &source_info) != 0) return true;   // Source gone: use cache
+        return binary_info.st_mtime >= source_info.st_mtime;
+    }
+
+    static BlockTraceFormat detect_format(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        char magic[8] = {0};
+        in.read(magic, sizeof(magic));
+        if (in.gcount() == 8 && std::memcmp(magic, "MOONBLK1", 8) == 0) {
+            return BlockTraceFormat::BINARY;
+        }
+        in.clear();
+        in.seekg(0);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (line.compare(0, 11, "fio version") == 0 || line.find(" add") != std::string::npos ||
+                line.find(" open") != std::string::npos) {
+                return BlockTraceFormat::FIO_IOLOG;
+            }
+            if (line.find(" + ") != std::string::npos) {
+                return BlockTraceFormat::BLKPARSE;   // "8,0 ... sector + count"
+            }
+            return (line.find(',') != std::string::npos) ? BlockTraceFormat::SNIA_CSV
+                                                         : BlockTraceFormat::FIO_IOLOG;
+        }
+        return BlockTraceFormat::SNIA_CSV;
+    }
+
+    static bool parse_line(const std::string& line, BlockTraceFormat format, uint64_t line_number,
+                           BlockTraceRecord& record, uint64_t& absolute_ns) {
+        std::memset(&record, 0, sizeof(record));
+        if (line.empty() || line[0] == '#') return false;
+        switch (format) {
+            case BlockTraceFormat::SNIA_CSV: return parse_snia_csv(line, record, absolute_ns);
+            case BlockTraceFormat::FIO_IOLOG: return parse_fio_iolog(line, line_number, record, absolute_ns);
+            case BlockTraceFormat::BLKPARSE: return parse_blkparse(line, record, absolute_ns);
+            default: return false;
+        }
+    }
+
+    static bool parse_snia_csv(const std::string& line, BlockTraceRecord& record, uint64_t& absolute_ns) {
+        std::string fields[7];
+        size_t field_count = 0;
+        std::stringstream stream(line);
+        while (field_count < 7 && std::getline(stream, fields[field_count], ',')) {
+            field_count++;
+        }
+        if (field_count < 6) return false;
+        char* end = nullptr;
+        uint64_t ticks = std::strtoull(fields[0].c_str(), &end, 10);
+        if (end == fields[0].c_str()) return false;   // Header line
+        const std::string& type = fields[3];
+        if (type.empty()) return false;
+        absolute_ns = ticks * 100;
+        record.is_write = (type[0] == 'W' || type[0] == 'w') ? 1 : 0;
+        record.offset = std::strtoull(fields[4].c_str(), nullptr, 10);
+        record.size = static_cast<uint32_t>(std::strtoul(fields[5].c_str(), nullptr, 10));
+        return true;
+    }
+
+    static bool parse_fio_iolog(const std::string& line, uint64_t line_number,
+                                BlockTraceRecord& record, uint64_t& absolute_ns) {
+        std::istringstream stream(line);
+        std::string first, file, action;
+        if (!(stream >> first)) return false;
+        // v3 lines start with a millisecond timestamp, v2 lines with the file name
+        char* end = nullptr;
+        uint64_t timestamp_ms = std::strtoull(first.c_str(), &end, 10);
+        bool has_timestamp = (end != first.c_str() && *end == '\0');
+        if (has_timestamp) {
+            if (!(stream >> file)) return false;
+        } else {
+            file = first;
+        }
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        if (!(stream >> action >> offset >> length)) return false;   // add/open/close lines
+        if (action != "read" && action != "write") return false;
+        absolute_ns = has_timestamp ? timestamp_ms * 1000000ULL : line_number * 1000ULL;
+        record.is_write = (action == "write") ? 1 : 0;
+        record.offset = offset;
+        record.size = static_cast<uint32_t>(length);
+        return true;
+    }
+
+    static bool parse_blkparse(const std::string& line, BlockTraceRecord& record, uint64_t& absolute_ns) {
+        // 8,0  3  1  0.000000000  697  Q  WS  223490 + 8 [kjournald]
+        std::istringstream stream(line);
+        std::string device, cpu, sequence, time_str, pid, action, rwbs, plus;
+        uint64_t sector = 0;
+        uint64_t sectors = 0;
+        if (!(stream >> device >> cpu >> sequence >> time_str >> pid >> action >> rwbs)) return false;
+        if (action != "Q") return false;
+        if (!(stream >> sector >> plus >> sectors) || plus != "+") return false;
+        bool is_write = rwbs.find('W') != std::string::npos;
+        if (!is_write && rwbs.find('R') == std::string::npos) return false;   // Discards, flushes
+        absolute_ns = static_cast<uint64_t>(std::strtod(time_str.c_str(), nullptr) * 1e9 + 0.5);
+        record.is_write = is_write ? 1 : 0;
+        record.offset = sector * 512;
+        record.size = static_cast<uint32_t>(sectors * 512);
+        return true;
+    }
+};
+
+#endif // BLOCK_TRACE_H
@@ -7,10 +7,19 @@
 #include <random>
 #include <algorithm>
 #include <iomanip>
+#include <deque>
 #include "packet/base_packet.h"
 #include "packet/generic_packet.h"
+#include "packet/packet_pool.h"
 #include "cache_line.h"
+#include "cache_tag_store.h"
+#include "cache_mshr.h"
 #include "common/json_config.h"
+#include "common/tlm_support.h"
+#include "common/stats_registry.h"
+#include "common/random.h"
+#include "common/self_profiler.h"
+#include <cstring>
 
 // L1 Cache statistics
 struct CacheStats {
@@ -20,7 +29,16 @@ struct CacheStats {
     uint64_t evictions;
     uint64_t writebacks;
     
-    CacheStats() : total_accesses(0), hits(0), misses(0), evictions(0), writebacks(0) {}
+    // Non-blocking operation (MSHRs)
+    uint64_t hits_under_miss;       // Hits served while at least one fill was outstanding
+    uint64_t secondary_misses;      // Misses merged into an outstanding MSHR
+    uint64_t mshr_stalls;           // Misses that waited for a free MSHR / target slot
+    uint32_t mshr_peak_occupancy;
+    std::vector<uint64_t> mshr_allocations;   // Per MSHR
+    std::vector<double> mshr_busy_ns;         // Per MSHR, accumulated fill time
+    
+    CacheStats() : total_accesses(0), hits(0), misses(0), evictions(0), writebacks(0),
+                   hits_under_miss(0), secondary_misses(0), mshr_stalls(0), mshr_peak_occupancy(0) {}
     
     double get_hit_rate() const {
         return total_accesses > 0 ? (double)hits / total_accesses : 0.0;
@@ -29,6 +47,18 @@ struct CacheStats {
     double get_miss_rate() const {
         return total_accesses > 0 ? (double)misses / total_accesses : 0.0;
     }
+    
+    // Fraction of elapsed_ns an MSHR held an outstanding fill
+    double get_mshr_occupancy(size_t mshr, double elapsed_ns) const {
+        return (mshr < mshr_busy_ns.size() && elapsed_ns > 0.0) ? mshr_busy_ns[mshr] / elapsed_ns : 0.0;
+    }
+    
+    // Average number of outstanding fills over elapsed_ns
+    double get_avg_mshr_occupancy(double elapsed_ns) const {
+        double busy = 0.0;
+        for (size_t i = 0; i < mshr_busy_ns.size(); ++i) busy += mshr_busy_ns[i];
+        return elapsed_ns > 0.0 ? busy / elapsed_ns : 0.0;
+    }
 };
 
 // L1 Cache template class
@@ -54,6 +84,10 @@ SC_MODULE(CacheL1) {
     sc_fifo_out<std::shared_ptr<BasePacket>> mem_out;   // To L2/Memory
     sc_fifo_in<std::shared_ptr<BasePacket>> mem_in;     // From L2/Memory
     
+    // TLM-2.0 front-end (alternative to the fifo ports)
+    TlmTargetSocket<CacheL1> tlm_socket;                // From a TLM initiator
+    TlmInitiatorSocket<CacheL1> tlm_mem_socket;         // To the next level (optional)
+    
     // Configuration
     const ReplacementPolicy m_replacement_policy;
     const WritePolicy m_write_policy;
@@ -69,7 +103,10 @@ SC_MODULE(CacheL1) {
             AllocationPolicy allocation_policy = AllocationPolicy::WRITE_ALLOCATE,
             sc_time hit_latency = sc_time(1, SC_NS),
             sc_time miss_latency = sc_time(10, SC_NS),
-            bool debug_enable = false)
+            bool debug_enable = false,
+            bool functional_data = false,
+            int num_mshrs = 4,
+            int mshr_max_targets = 4)
         : sc_module(name),
           m_replacement_policy(replacement_policy),
           m_write_policy(write_policy),
@@ -77,14 +114,10 @@ SC_MODULE(CacheL1) {
           m_hit_latency(hit_latency),
           m_miss_latency(miss_latency),
           m_debug_enable(debug_enable),
-          m_random_generator(std::random_device{}())
+          m_tag_store(functional_data),
+          m_mshrs(num_mshrs, mshr_max_targets),
+          m_random_generator(RandomService::stream(this->name()))
     {
-        // Initialize cache sets
-        m_cache_sets.resize(NUM_SETS);
-        for (int i = 0; i < NUM_SETS; ++i) {
-            m_cache_sets[i].resize(WAYS);
-        }
-        
         // Initialize statistics
         m_stats = CacheStats();
         
@@ -92,9 +125,18 @@ SC_MODULE(CacheL1) {
             std::cout << "CacheL1: Initialized " << CACHE_SIZE_KB << "KB L1 cache" << std::endl;
             std::cout << "  Sets: " << NUM_SETS << ", Ways: " << WAYS << ", Line Size: " << LINE_SIZE << std::endl;
             std::cout << "  Index bits: " << INDEX_BITS << ", Offset bits: " << OFFSET_BITS << std::endl;
+            std::cout << "  Functional data: " << (m_tag_store.has_data() ? "enabled" : "disabled")
+                      << ", tag store footprint: " << m_tag_store.footprint_bytes() << " bytes" << std::endl;
+            std::cout << "  MSHRs: " << m_mshrs.size() << " x " << m_mshrs.get_max_targets() << " targets" << std::endl;
         }
         
+        tlm_socket.register_b_transport(this, &CacheL1::b_transport);
+        tlm_socket.register_transport_dbg(this, &CacheL1::transport_dbg);
+        register_stats();
+        
         SC_THREAD(cache_process);
+        SC_THREAD(fill_process);
+        SC_THREAD(response_process);
     }
     
     // JSON-based constructor
@@ -105,12 +147,114 @@ SC_MODULE(CacheL1) {
                   parse_allocation_policy(config.get_string("allocation_policy", "WRITE_ALLOCATE")),
                   sc_time(config.get_int("hit_latency_ns", 1), SC_NS),
                   sc_time(config.get_int("miss_latency_ns", 10), SC_NS),
-                  config.get_bool("debug_enable", false))
+                  config.get_bool("debug_enable", false),
+                  config.get_bool("functional_data", false),
+                  config.get_int("num_mshrs", 4),
+                  config.get_int("mshr_max_targets", 4))
     {
     }
     
     // Get cache statistics
-    CacheStats get_stats() const { return m_stats; }
+    CacheStats get_stats() const {
+        CacheStats stats = m_stats;
+        stats.mshr_peak_occupancy = static_cast<uint32_t>(m_mshrs.get_peak_occupied());
+        stats.mshr_allocations.resize(m_mshrs.size());
+        stats.mshr_busy_ns.resize(m_mshrs.size());
+        for (int i = 0; i < m_mshrs.size(); ++i) {
+            stats.mshr_allocations[i] = m_mshrs.get_allocations(i);
+            stats.mshr_busy_ns[i] = m_mshrs.get_busy_time(i).to_seconds() * 1e9;
+        }
+        return stats;
+    }
+    
+    // Statistics restart from zero; tags and line states are kept (end of a fast-forward warm-up)
+    void reset_stats() {
+        m_stats = CacheStats();
+    }
+    
+    // Functional tag lookup with annotated hit/miss latency.
+    // Tags only (default): data comes from the next level, untimed (transport_dbg) on a hit,
+    // timed on a miss. With functional_data the line payload is held here: hits are served
+    // locally, misses fetch the whole line and dirty victims are written back.
+    // Without a bound next level, reads of unfilled data return zeros.
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        if (trans.get_command() == tlm::TLM_IGNORE_COMMAND) {
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            return;
+        }
+        if (!tlm_check_payload(trans)) {
+            return;
+        }
+        
+        uint32_t address = static_cast<uint32_t>(trans.get_address());
+        Command command = tlm_command_to_packet(trans);
+        if (m_tag_store.has_data() &&
+            get_offset(address) + trans.get_data_length() > static_cast<unsigned int>(LINE_SIZE)) {
+            trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);  // Must stay within one line
+            return;
+        }
+        
+        int set_index = get_set_index(address);
+        int way = find_way(address, set_index);
+        
+        m_stats.total_accesses++;
+        
+        if (way != -1) {
+            m_stats.hits++;
+            m_tag_store.touch(set_index, way);
+            delay += m_hit_latency;
+            
+            if (command == Command::WRITE && m_write_policy == WritePolicy::WRITE_BACK) {
+                m_tag_store.set_dirty(set_index, way, true);
+                m_tag_store.set_state(set_index, way, CacheLineState::MODIFIED);
+            }
+            
+            if (m_tag_store.has_data()) {
+                copy_line_data(trans, set_index, way);
+                if (command == Command::WRITE && m_write_policy == WritePolicy::WRITE_THROUGH) {
+                    next_level_transport(trans, delay);
+                }
+            } else if (command == Command::WRITE && m_write_policy == WritePolicy::WRITE_THROUGH) {
+                next_level_transport(trans, delay);
+            } else {
+                next_level_debug(trans);
+            }
+        } else {
+            m_stats.misses++;
+            delay += m_miss_latency;
+            
+            if (m_tag_store.has_data()) {
+                way = fill_line(address, command, &delay);
+                copy_line_data(trans, set_index, way);
+                if (command == Command::WRITE && m_write_policy != WritePolicy::WRITE_BACK) {
+                    next_level_transport(trans, delay);
+                }
+            } else {
+                next_level_transport(trans, delay);
+                fill_line(address, command);
+            }
+        }
+        
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+    
+    // Debug access goes straight to the next level without touching tags or statistics
+    unsigned int transport_dbg(tlm::tlm_generic_payload& trans) {
+        if (!tlm_check_payload(trans)) {
+            return 0;
+        }
+        uint32_t address = static_cast<uint32_t>(trans.get_address());
+        int set_index = get_set_index(address);
+        int way = find_way(address, set_index);
+        if (m_tag_store.has_data() && way != -1 &&
+            get_offset(address) + trans.get_data_length() <= static_cast<unsigned int>(LINE_SIZE)) {
+            copy_line_data(trans, set_index, way);  // Resident line holds the newest data
+        } else {
+            next_level_debug(trans);
+        }
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+        return trans.get_data_length();
+    }
     
     // Print cache statistics
     void print_stats() const {
@@ -120,17 +264,67 @@ SC_MODULE(CacheL1) {
         std::cout << "Misses: " << m_stats.misses << " (" << (m_stats.get_miss_rate() * 100) << "%)" << std::endl;
         std::cout << "Evictions: " << m_stats.evictions << std::endl;
         std::cout << "Writebacks: " << m_stats.writebacks << std::endl;
+        
+        CacheStats stats = get_stats();
+        double elapsed_ns = sc_time_stamp().to_seconds() * 1e9;
+        std::cout << "Hits under miss: " << stats.hits_under_miss << std::endl;
+        std::cout << "Secondary misses (merged): " << stats.secondary_misses << std::endl;
+        std::cout << "MSHR stalls: " << stats.mshr_stalls << std::endl;
+        std::cout << "MSHR peak occupancy: " << stats.mshr_peak_occupancy << "/" << m_mshrs.size()
+                  << ", average: " << stats.get_avg_mshr_occupancy(elapsed_ns) << std::endl;
+        for (size_t i = 0; i < stats.mshr_busy_ns.size(); ++i) {
+            std::cout << "  MSHR[" << i << "]: " << stats.mshr_allocations[i] << " fills, "
+                      << (stats.get_mshr_occupancy(i, elapsed_ns) * 100) << "% busy" << std::endl;
+        }
+    }
+    
+    // Tag store access (read-only) for inspection/debug
+    const CacheTagStore<NUM_SETS, WAYS, LINE_SIZE_BYTES>& get_tag_store() const { return m_tag_store; }
+    
+    // Checkpoint: cache contents (warm cache after restore), statistics start from zero
+    void save_checkpoint(CheckpointWriter& writer) const {
+        writer.begin_section(name());
+        m_tag_store.save(writer);
+        writer.end_section();
+    }
+    
+    bool restore_checkpoint(CheckpointReader& reader) {
+        return reader.begin_section(name()) && m_tag_store.restore(reader);
     }
 
 private:
-    // Cache storage: sets x ways
-    std::vector<std::vector<CacheLine<LINE_SIZE_BYTES>>> m_cache_sets;
+    // Cache storage: flat structure-of-arrays tag store (+ optional line data)
+    CacheTagStore<NUM_SETS, WAYS, LINE_SIZE_BYTES> m_tag_store;
+    
+    // Outstanding line fills (non-blocking fifo path)
+    CacheMshrFile m_mshrs;
+    sc_event m_mshr_released;
+    
+    // cpu_out has a single writer: hits and completed fills queue here
+    std::deque<std::shared_ptr<BasePacket>> m_response_queue;
+    sc_event m_response_ready;
     
     // Statistics
     CacheStats m_stats;
+    StatsGroup m_stats_group;
+    
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("accesses", &m_stats.total_accesses);
+        m_stats_group.counter("hits", &m_stats.hits);
+        m_stats_group.counter("misses", &m_stats.misses);
+        m_stats_group.counter("evictions", &m_stats.evictions);
+        m_stats_group.counter("writebacks", &m_stats.writebacks);
+        m_stats_group.counter("hits_under_miss", &m_stats.hits_under_miss);
+        m_stats_group.counter("secondary_misses", &m_stats.secondary_misses);
+        m_stats_group.counter("mshr_stalls", &m_stats.mshr_stalls);
+        m_stats_group.gauge("hit_rate", [this]() { return m_stats.get_hit_rate(); }, "ratio");
+        m_stats_group.gauge("mshr_peak_occupancy",
+                            [this]() { return static_cast<double>(m_mshrs.get_peak_occupied()); }, "entries");
+    }
     
     // Random number generator for random replacement
-    std::mt19937 m_random_generator;
+    RandomStream m_random_generator;
     
     // Helper functions for policy parsing
     ReplacementPolicy parse_replacement_policy(const std::string& policy) {
@@ -151,11 +345,12 @@ private:
         return AllocationPolicy::WRITE_ALLOCATE; // Default
     }
     
-    // Main cache process
+    // Main cache process: tag lookup per request. Hits are answered while misses
+    // are outstanding; misses allocate an MSHR or merge into the one for their line.
     void cache_process() {
         while (true) {
             // Wait for incoming CPU request
-            auto packet = cpu_in.read();
+            auto packet = SelfProfiler::read(cpu_in);
             
             if (m_debug_enable) {
                 std::cout << sc_time_stamp() << " | CacheL1: Processing " 
@@ -170,34 +365,101 @@ private:
             
             if (hit) {
                 m_stats.hits++;
-                wait(m_hit_latency);
+                if (m_mshrs.any_outstanding()) {
+                    m_stats.hits_under_miss++;
+                }
+                SelfProfiler::wait(m_hit_latency);
                 
                 if (m_debug_enable) {
                     std::cout << sc_time_stamp() << " | CacheL1: HIT - returning to CPU" << std::endl;
                 }
                 
                 // Send response back to CPU
-                cpu_out.write(packet);
+                queue_response(packet);
             } else {
                 m_stats.misses++;
-                wait(m_miss_latency);
-                
+                SelfProfiler::wait(m_miss_latency);
+                handle_miss(packet);
+            }
+        }
+    }
+    
+    void handle_miss(const std::shared_ptr<BasePacket>& packet) {
+        uint32_t line_address = static_cast<uint32_t>(packet->get_address()) & ~static_cast<uint32_t>(LINE_SIZE - 1);
+        bool stalled = false;
+        
+        while (true) {
+            int mshr = m_mshrs.find(line_address);
+            if (mshr != -1 && m_mshrs.add_target(mshr, packet)) {
+                m_stats.secondary_misses++;
+                if (m_debug_enable) {
+                    std::cout << sc_time_stamp() << " | CacheL1: MISS - merged into MSHR " << mshr << std::endl;
+                }
+                return;
+            }
+            if (mshr == -1 && m_mshrs.allocate(line_address, packet) != -1) {
                 if (m_debug_enable) {
                     std::cout << sc_time_stamp() << " | CacheL1: MISS - forwarding to memory" << std::endl;
                 }
-                
                 // Forward to next level (L2/Memory)
-                mem_out.write(packet);
-                
-                // Wait for response from memory
-                auto response = mem_in.read();
-                
-                // Handle cache line fill
-                handle_cache_fill(response);
-                
-                // Send response back to CPU
-                cpu_out.write(response);
+                SelfProfiler::write(mem_out, packet);
+                return;
+            }
+            
+            // No free MSHR, or the line's target list is full
+            if (!stalled) {
+                m_stats.mshr_stalls++;
+                stalled = true;
+            }
+            SelfProfiler::wait(m_mshr_released);
+        }
+    }
+    
+    // Next-level responses: fill the line and complete every target of its MSHR
+    void fill_process() {
+        while (true) {
+            auto response = SelfProfiler::read(mem_in);
+            uint32_t line_address = static_cast<uint32_t>(response->get_address()) & ~static_cast<uint32_t>(LINE_SIZE - 1);
+            int mshr = m_mshrs.match_response(response);
+            if (mshr == -1) {
+                continue;  // Write-through acknowledgement, no fill pending
             }
+            
+            // Handle cache line fill
+            handle_cache_fill(response);
+            queue_response(response);
+            
+            int set_index = get_set_index(line_address);
+            int way = find_way(line_address, set_index);
+            for (const auto& target : m_mshrs.get_secondaries(mshr)) {
+                if (way != -1) {
+                    m_tag_store.touch(set_index, way);
+                    if (target->get_command() == Command::WRITE && m_write_policy == WritePolicy::WRITE_BACK) {
+                        m_tag_store.set_dirty(set_index, way, true);
+                        m_tag_store.set_state(set_index, way, CacheLineState::MODIFIED);
+                    }
+                }
+                queue_response(target);
+            }
+            
+            m_mshrs.release(mshr);
+            m_mshr_released.notify();
+        }
+    }
+    
+    void queue_response(const std::shared_ptr<BasePacket>& packet) {
+        m_response_queue.push_back(packet);
+        m_response_ready.notify();
+    }
+    
+    void response_process() {
+        while (true) {
+            while (m_response_queue.empty()) {
+                SelfProfiler::wait(m_response_ready);
+            }
+            auto packet = m_response_queue.front();
+            m_response_queue.pop_front();
+            SelfProfiler::write(cpu_out, packet);
         }
     }
     
@@ -209,19 +471,18 @@ private:
         
         if (way != -1) {
             // Cache hit
-            auto& line = m_cache_sets[set_index][way];
-            line.update_access_time();
+            m_tag_store.touch(set_index, way);
             
             if (packet->get_command() == Command::WRITE) {
                 // Handle write hit
                 if (m_write_policy == WritePolicy::WRITE_BACK) {
-                    line.dirty = true;
-                    line.state = CacheLineState::MODIFIED;
+                    m_tag_store.set_dirty(set_index, way, true);
+                    m_tag_store.set_state(set_index, way, CacheLineState::MODIFIED);
                 } else if (m_write_policy == WritePolicy::WRITE_THROUGH) {
                     // Write through to next level
                     auto generic_packet = std::static_pointer_cast<GenericPacket>(packet);
-                    auto write_packet = std::make_shared<GenericPacket>(*generic_packet);
-                    mem_out.write(write_packet);
+                    auto write_packet = PacketPool<GenericPacket>::acquire(*generic_packet);
+                    SelfProfiler::write(mem_out, write_packet);
                 }
             }
             
@@ -232,16 +493,40 @@ private:
         }
     }
     
+    // TLM helpers for the optional next level
+    bool has_next_level() const { return tlm_mem_socket.size() > 0; }
+    
+    void next_level_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        if (has_next_level()) {
+            tlm_mem_socket->b_transport(trans, delay);
+        } else if (trans.is_read() && trans.get_data_ptr()) {
+            std::memset(trans.get_data_ptr(), 0, trans.get_data_length());
+        }
+    }
+    
+    void next_level_debug(tlm::tlm_generic_payload& trans) {
+        if (has_next_level()) {
+            tlm_mem_socket->transport_dbg(trans);
+        } else if (trans.is_read() && trans.get_data_ptr()) {
+            std::memset(trans.get_data_ptr(), 0, trans.get_data_length());
+        }
+    }
+    
     // Handle cache line fill on miss
     void handle_cache_fill(std::shared_ptr<BasePacket> packet) {
-        uint32_t address = packet->get_address();
+        fill_line(packet->get_address(), packet->get_command());
+    }
+    
+    // Install the line for address and return its way. With functional data and a
+    // delay to annotate (TLM path), the dirty victim is written back and the line is
+    // fetched from the next level.
+    int fill_line(uint32_t address, Command command, sc_time* delay = nullptr) {
         int set_index = get_set_index(address);
         int victim_way = select_victim_way(set_index);
-        
-        auto& victim_line = m_cache_sets[set_index][victim_way];
+        bool victim_valid = m_tag_store.is_valid(set_index, victim_way);
         
         // Handle eviction if line is dirty
-        if (victim_line.valid && victim_line.dirty && 
+        if (victim_valid && m_tag_store.is_dirty(set_index, victim_way) &&
             m_write_policy == WritePolicy::WRITE_BACK) {
             m_stats.writebacks++;
             
@@ -249,27 +534,56 @@ private:
                 std::cout << sc_time_stamp() << " | CacheL1: Writing back dirty line" << std::endl;
             }
             
-            // Create writeback packet (in real implementation)
-            // For now, just count the writeback
+            if (m_tag_store.has_data() && delay) {
+                uint32_t victim_address = line_address(m_tag_store.get_tag(set_index, victim_way), set_index);
+                line_transport(tlm::TLM_WRITE_COMMAND, victim_address,
+                               m_tag_store.data(set_index, victim_way), *delay);
+            }
         }
         
-        if (victim_line.valid) {
+        if (victim_valid) {
             m_stats.evictions++;
         }
         
         // Fill cache line
-        victim_line.tag = get_tag(address);
-        victim_line.valid = true;
-        victim_line.dirty = (packet->get_command() == Command::WRITE && 
-                           m_write_policy == WritePolicy::WRITE_BACK);
-        victim_line.state = (packet->get_command() == Command::WRITE) ? 
-                           CacheLineState::MODIFIED : CacheLineState::EXCLUSIVE;
-        victim_line.update_access_time();
+        m_tag_store.fill(set_index, victim_way, get_tag(address),
+                         command == Command::WRITE && m_write_policy == WritePolicy::WRITE_BACK,
+                         (command == Command::WRITE) ? CacheLineState::MODIFIED : CacheLineState::EXCLUSIVE);
+        
+        if (m_tag_store.has_data() && delay) {
+            line_transport(tlm::TLM_READ_COMMAND, address & ~static_cast<uint32_t>(LINE_SIZE_BYTES - 1),
+                           m_tag_store.data(set_index, victim_way), *delay);
+        }
         
         if (m_debug_enable) {
             std::cout << sc_time_stamp() << " | CacheL1: Filled cache line in set " 
                       << set_index << ", way " << victim_way << std::endl;
         }
+        return victim_way;
+    }
+    
+    // Whole-line transfer to/from the next level (functional data only)
+    void line_transport(tlm::tlm_command command, uint32_t address, uint8_t* line_data, sc_time& delay) {
+        tlm::tlm_generic_payload line_trans;
+        line_trans.set_command(command);
+        line_trans.set_address(address);
+        line_trans.set_data_ptr(line_data);
+        line_trans.set_data_length(LINE_SIZE_BYTES);
+        line_trans.set_streaming_width(LINE_SIZE_BYTES);
+        line_trans.set_byte_enable_ptr(nullptr);
+        line_trans.set_dmi_allowed(false);
+        line_trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+        next_level_transport(line_trans, delay);
+    }
+    
+    // Serve a (single-line) transaction from the resident line payload
+    void copy_line_data(tlm::tlm_generic_payload& trans, int set_index, int way) {
+        uint8_t* line_data = m_tag_store.data(set_index, way) + get_offset(static_cast<uint32_t>(trans.get_address()));
+        if (trans.is_read()) {
+            std::memcpy(trans.get_data_ptr(), line_data, trans.get_data_length());
+        } else {
+            std::memcpy(line_data, trans.get_data_ptr(), trans.get_data_length());
+        }
     }
     
     // Address parsing functions
@@ -285,54 +599,30 @@ private:
         return address & ((1 << OFFSET_BITS) - 1);
     }
     
+    uint32_t line_address(uint32_t tag, int set_index) const {
+        return (tag << (OFFSET_BITS + INDEX_BITS)) | (static_cast<uint32_t>(set_index) << OFFSET_BITS);
+    }
+    
     // Find way in set that matches address
     int find_way(uint32_t address, int set_index) const {
-        uint32_t tag = get_tag(address);
-        for (int way = 0; way < WAYS; ++way) {
-            const auto& line = m_cache_sets[set_index][way];
-            if (line.valid && line.tag == tag) {
-                return way;
-            }
-        }
-        return -1; // Not found
+        return m_tag_store.find_way(set_index, get_tag(address));
     }
     
     // Select victim way for eviction
     int select_victim_way(int set_index) {
-        auto& set = m_cache_sets[set_index];
-        
         // First, try to find an invalid line
-        for (int way = 0; way < WAYS; ++way) {
-            if (!set[way].valid) {
-                return way;
-            }
+        int invalid_way = m_tag_store.find_invalid_way(set_index);
+        if (invalid_way != -1) {
+            return invalid_way;
         }
         
         // All lines valid, apply replacement policy
         switch (m_replacement_policy) {
-            case ReplacementPolicy::LRU: {
-                int lru_way = 0;
-                sc_time oldest_time = set[0].last_access_time;
-                for (int way = 1; way < WAYS; ++way) {
-                    if (set[way].last_access_time < oldest_time) {
-                        oldest_time = set[way].last_access_time;
-                        lru_way = way;
-                    }
-                }
-                return lru_way;
-            }
+            case ReplacementPolicy::LRU:
+                return m_tag_store.plru_victim(set_index);  // Tree-PLRU approximation
             
-            case ReplacementPolicy::LFU: {
-                int lfu_way = 0;
-                uint32_t min_count = set[0].access_count;
-                for (int way = 1; way < WAYS; ++way) {
-                    if (set[way].access_count < min_count) {
-                        min_count = set[way].access_count;
-                        lfu_way = way;
-                    }
-                }
-                return lfu_way;
-            }
+            case ReplacementPolicy::LFU:
+                return m_tag_store.lfu_victim(set_index);
             
             case ReplacementPolicy::RANDOM: {
                 std::uniform_int_distribution<int> dist(0, WAYS - 1);
@@ -340,18 +630,8 @@ private:
             }
             
             case ReplacementPolicy::FIFO:
-            default: {
-                // Simple FIFO approximation using access time
-                int fifo_way = 0;
-                sc_time oldest_time = set[0].last_access_time;
-                for (int way = 1; way < WAYS; ++way) {
-                    if (set[way].last_access_time < oldest_time) {
-                        oldest_time = set[way].last_access_time;
-                        fifo_way = way;
-                    }
-                }
-                return fifo_way;
-            }
+            default:
+                return m_tag_store.fifo_victim(set_index);
         }
     }
 };
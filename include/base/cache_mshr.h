@@ -0,0 +1,116 @@
+#ifndef CACHE_MSHR_H
+#define CACHE_MSHR_H
+
+#include <systemc.h>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "packet/base_packet.h"
+
+// Miss Status Holding Registers for a non-blocking cache.
+// Each entry tracks one outstanding line fill: the primary miss that went to the
+// next level plus the secondary misses to the same line merged into it.
+// Occupancy (allocations, busy time) is accumulated per entry for CacheStats.
+class CacheMshrFile {
+public:
+    CacheMshrFile(int num_entries, int max_targets)
+        : m_entries(num_entries > 0 ? num_entries : 1),
+          m_max_targets(max_targets > 0 ? max_targets : 1),
+          m_occupied(0),
+          m_peak_occupied(0) {}
+
+    int size() const { return static_cast<int>(m_entries.size()); }
+    int get_max_targets() const { return m_max_targets; }
+    int get_occupied() const { return m_occupied; }
+    int get_peak_occupied() const { return m_peak_occupied; }
+    bool is_full() const { return m_occupied == size(); }
+    bool any_outstanding() const { return m_occupied > 0; }
+
+    // Entry index tracking line_address, or -1
+    int find(uint32_t line_address) const {
+        for (int i = 0; i < size(); ++i) {
+            if (m_entries[i].valid && m_entries[i].line_address == line_address) return i;
+        }
+        return -1;
+    }
+
+    // Allocate an entry for a primary miss; -1 when every MSHR is busy
+    int allocate(uint32_t line_address, const std::shared_ptr<BasePacket>& primary) {
+        for (int i = 0; i < size(); ++i) {
+            Entry& entry = m_entries[i];
+            if (!entry.valid) {
+                entry.valid = true;
+                entry.line_address = line_address;
+                entry.primary = primary;
+                entry.secondaries.clear();
+                entry.alloc_time = sc_time_stamp();
+                entry.allocations++;
+                m_occupied++;
+                if (m_occupied > m_peak_occupied) m_peak_occupied = m_occupied;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Merge a secondary miss; false when the entry's target list is full
+    bool add_target(int index, const std::shared_ptr<BasePacket>& packet) {
+        if (!can_merge(index)) return false;
+        m_entries[index].secondaries.push_back(packet);
+        return true;
+    }
+
+    bool can_merge(int index) const {
+        return 1 + static_cast<int>(m_entries[index].secondaries.size()) < m_max_targets;
+    }
+
+    // Entry a next-level response completes: only the primary packet itself. A
+    // write-through copy to a line with a fill outstanding must not release it.
+    int match_response(const std::shared_ptr<BasePacket>& response) const {
+        for (int i = 0; i < size(); ++i) {
+            if (m_entries[i].valid && m_entries[i].primary == response) return i;
+        }
+        return -1;
+    }
+
+    const std::vector<std::shared_ptr<BasePacket>>& get_secondaries(int index) const {
+        return m_entries[index].secondaries;
+    }
+
+    void release(int index) {
+        Entry& entry = m_entries[index];
+        entry.busy_time += sc_time_stamp() - entry.alloc_time;
+        entry.valid = false;
+        entry.primary.reset();
+        entry.secondaries.clear();
+        m_occupied--;
+    }
+
+    uint64_t get_allocations(int index) const { return m_entries[index].allocations; }
+
+    // Accumulated busy time of one entry, including a fill still in flight
+    sc_time get_busy_time(int index) const {
+        const Entry& entry = m_entries[index];
+        return entry.valid ? entry.busy_time + (sc_time_stamp() - entry.alloc_time) : entry.busy_time;
+    }
+
+private:
+    struct Entry {
+        bool valid;
+        uint32_t line_address;
+        std::shared_ptr<BasePacket> primary;
+        std::vector<std::shared_ptr<BasePacket>> secondaries;
+        sc_time alloc_time;
+        sc_time busy_time;
+        uint64_t allocations;
+
+        Entry() : valid(false), line_address(0), allocations(0) {}
+    };
+
+    std::vector<Entry> m_entries;
+    const int m_max_targets;   // Primary + merged secondaries per entry
+    int m_occupied;
+    int m_peak_occupied;
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef CACHE_TAG_STORE_H
+#define CACHE_TAG_STORE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "cache_line.h"
+#include "common/checkpoint.h"
+
+// Structure-of-arrays tag store for set-associative caches.
+// set * WAYS + way indexes every per-line array, so one set's tags/valid bits are
+// contiguous and find_way() is a fixed-trip, branch-free loop the compiler can vectorize.
+// Replacement state is bit-packed: tree-PLRU (WAYS - 1 bits per set) for LRU and a
+// round-robin fill pointer for FIFO; LFU keeps a per-line access counter.
+// Line data is only allocated when functional data is enabled.
+template<int NUM_SETS, int WAYS, int LINE_SIZE>
+class CacheTagStore {
+    static_assert(WAYS > 0 && WAYS <= 64 && (WAYS & (WAYS - 1)) == 0,
+                  "CacheTagStore: WAYS must be a power of two <= 64 (tree-PLRU)");
+    static const int PLRU_LEVELS = __builtin_ctz(WAYS);
+
+public:
+    explicit CacheTagStore(bool functional_data = false)
+        : m_tags(NUM_SETS * WAYS, 0),
+          m_valid(NUM_SETS * WAYS, 0),
+          m_dirty(NUM_SETS * WAYS, 0),
+          m_state(NUM_SETS * WAYS, static_cast<uint8_t>(CacheLineState::INVALID)),
+          m_access_count(NUM_SETS * WAYS, 0),
+          m_plru(NUM_SETS, 0),
+          m_fifo_next(NUM_SETS, 0) {
+        if (functional_data) {
+            m_data.assign(static_cast<size_t>(NUM_SETS) * WAYS * LINE_SIZE, 0);
+        }
+    }
+
+    bool has_data() const { return !m_data.empty(); }
+
+    // Returns the matching way or -1
+    int find_way(int set, uint32_t tag) const {
+        const uint32_t* tags = &m_tags[line(set, 0)];
+        const uint8_t* valid = &m_valid[line(set, 0)];
+        int hit = -1;
+        for (int way = 0; way < WAYS; ++way) {
+            hit = (valid[way] && tags[way] == tag) ? way : hit;
+        }
+        return hit;
+    }
+
+    int find_invalid_way(int set) const {
+        const uint8_t* valid = &m_valid[line(set, 0)];
+        for (int way = 0; way < WAYS; ++way) {
+            if (!valid[way]) return way;
+        }
+        return -1;
+    }
+
+    // Record an access for replacement (hit or fill)
+    void touch(int set, int way) {
+        m_access_count[line(set, way)]++;
+        uint64_t bits = m_plru[set];
+        unsigned int node = 1;
+        for (int level = PLRU_LEVELS - 1; level >= 0; --level) {
+            unsigned int dir = (way >> level) & 1;
+            // Point the node away from the accessed half
+            if (dir) bits &= ~(uint64_t(1) << node);
+            else     bits |= (uint64_t(1) << node);
+            node = node * 2 + dir;
+        }
+        m_plru[set] = bits;
+    }
+
+    // Tree-PLRU victim: follow the node bits from the root
+    int plru_victim(int set) const {
+        uint64_t bits = m_plru[set];
+        unsigned int node = 1;
+        for (int level = 0; level < PLRU_LEVELS; ++level) {
+            node = node * 2 + ((bits >> node) & 1);
+        }
+        return static_cast<int>(node - WAYS);
+    }
+
+    // FIFO victim: ways are replaced in fill order
+    int fifo_victim(int set) {
+        int way = m_fifo_next[set];
+        m_fifo_next[set] = static_cast<uint8_t>((way + 1) % WAYS);
+        return way;
+    }
+
+    int lfu_victim(int set) const {
+        const uint32_t* counts = &m_access_count[line(set, 0)];
+        int victim = 0;
+        for (int way = 1; way < WAYS; ++way) {
+            if (counts[way] < counts[victim]) victim = way;
+        }
+        return victim;
+    }
+
+    // Install a new line (access count restarts)
+    void fill(int set, int way, uint32_t tag, bool dirty, CacheLineState state) {
+        size_t i = line(set, way);
+        m_tags[i] = tag;
+        m_valid[i] = 1;
+        m_dirty[i] = dirty ? 1 : 0;
+        m_state[i] = static_cast<uint8_t>(state);
+        m_access_count[i] = 0;
+        touch(set, way);
+    }
+
+    void invalidate(int set, int way) {
+        size_t i = line(set, way);
+        m_valid[i] = 0;
+        m_dirty[i] = 0;
+        m_state[i] = static_cast<uint8_t>(CacheLineState::INVALID);
+    }
+
+    bool is_valid(int set, int way) const { return m_valid[line(set, way)] != 0; }
+    bool is_dirty(int set, int way) const { return m_dirty[line(set, way)] != 0; }
+    uint32_t get_tag(int set, int way) const { return m_tags[line(set, way)]; }
+    CacheLineState get_state(int set, int way) const {
+        return static_cast<CacheLineState>(m_state[line(set, way)]);
+    }
+
+    void set_dirty(int set, int way, bool dirty) { m_dirty[line(set, way)] = dirty ? 1 : 0; }
+    void set_state(int set, int way, CacheLineState state) {
+        m_state[line(set, way)] = static_cast<uint8_t>(state);
+    }
+
+    // Line payload (functional data only)
+    uint8_t* data(int set, int way) { return &m_data[line(set, way) * LINE_SIZE]; }
+    const uint8_t* data(int set, int way) const { return &m_data[line(set, way) * LINE_SIZE]; }
+
+    // Checkpoint: every line with its replacement state (and data when functional)
+    void save(CheckpointWriter& writer) const {
+        writer.write_vector(m_tags);
+        writer.write_vector(m_valid);
+        writer.write_vector(m_dirty);
+        writer.write_vector(m_state);
+        writer.write_vector(m_access_count);
+        writer.write_vector(m_plru);
+        writer.write_vector(m_fifo_next);
+        writer.write_vector(m_data);
+    }
+    
+    bool restore(CheckpointReader& reader) {
+        const uint64_t lines = static_cast<uint64_t>(NUM_SETS) * WAYS;
+        return reader.read_vector(m_tags, lines) && reader.read_vector(m_valid, lines) &&
+               reader.read_vector(m_dirty, lines) && reader.read_vector(m_state, lines) &&
+               reader.read_vector(m_access_count, lines) && reader.read_vector(m_plru, NUM_SETS) &&
+               reader.read_vector(m_fifo_next, NUM_SETS) && reader.read_vector(m_data, m_data.size());
+    }
+    
+    // Approximate host memory footprint
+    size_t footprint_bytes() const {
+        return m_tags.size() * sizeof(uint32_t) + m_valid.size() + m_dirty.size() + m_state.size() +
+               m_access_count.size() * sizeof(uint32_t) + m_plru.size() * sizeof(uint64_t) +
+               m_fifo_next.size() + m_data.size();
+    }
+
+private:
+    static size_t line(int set, int way) { return static_cast<size_t>(set) * WAYS + way; }
+
+    std::vector<uint32_t> m_tags;
+    std::vector<uint8_t> m_valid;
+    std::vector<uint8_t> m_dirty;
+    std::vector<uint8_t> m_state;
+    std::vector<uint32_t> m_access_count;
+    std::vector<uint64_t> m_plru;       // Tree-PLRU node bits (bit n = node n, root = 1)
+    std::vector<uint8_t> m_fifo_next;   // Next fill way per set
+    std::vector<uint8_t> m_data;        // NUM_SETS * WAYS * LINE_SIZE, empty unless functional
+};
+
+#endif
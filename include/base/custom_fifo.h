@@ -7,6 +7,8 @@
 #include "packet/base_packet.h"
 #include "common/json_config.h"
 #include "common/vcd_helper.h"
+#include "common/transaction_trace.h"
+#include "common/self_profiler.h"
 
 // CustomFifo template class with sc_fifo interface compatibility
 template<typename T>
@@ -23,19 +25,37 @@ private:
     std::unique_ptr<PacketTraceSignals> in_trace_signals;
     std::unique_ptr<PacketTraceSignals> out_trace_signals;
     
-    void trace_packet_if_enabled(const T& packet, const std::string& operation) {
+    // Binary transaction trace (TransactionTrace), -1 when this FIFO is not traced.
+    // Sampling counts each direction separately: the FIFO keeps order, so the n-th write
+    // and the n-th read are the same packet and every sampled IN has its OUT.
+    int trace_id;
+    unsigned int trace_countdown[2];    // Indexed by TraceDirection
+    
+    void trace_packet_if_enabled(const T& packet, TraceDirection direction) {
         // Update pre-registered signals instead of creating new traces
-        if (operation == "write" || operation == "nb_write") {
+        if (direction == TraceDirection::IN) {
             if (dump_in) {
                 update_packet_signals(packet, true);  // true = input signals
             }
-        } else if (operation == "read" || operation == "nb_read") {
-            if (dump_out) {
-                update_packet_signals(packet, false); // false = output signals
+        } else if (dump_out) {
+            update_packet_signals(packet, false); // false = output signals
+        }
+        
+        if (trace_id >= 0) {
+            unsigned int& countdown = trace_countdown[static_cast<int>(direction)];
+            if (--countdown == 0) {
+                countdown = TransactionTrace::instance().get_sample_ratio();
+                TransactionTrace::instance().record(trace_id, direction, packet);
             }
         }
     }
     
+    void init_transaction_trace() {
+        trace_id = TransactionTrace::instance().register_fifo(fifo_name);
+        trace_countdown[static_cast<int>(TraceDirection::IN)] = 1;
+        trace_countdown[static_cast<int>(TraceDirection::OUT)] = 1;
+    }
+    
     // Helper function to update packet field signals using VCD helper functions
     void update_packet_signals(const T& packet, bool is_input) {
         if (is_input && in_trace_signals) {
@@ -50,6 +70,7 @@ public:
     // Constructor with JSON config
     CustomFifo(sc_module_name name, int size, const JsonConfig& config) 
         : sc_module(name), internal_fifo("internal_fifo", size), fifo_name(std::string(name)) {
+        init_transaction_trace();
         
         // Get dump configuration (use direct keys due to JsonConfig limitations)
         bool dump_interface = config.get_bool("dump.interface", false);
@@ -78,6 +99,7 @@ public:
     CustomFifo(sc_module_name name, int size, bool dump_in_packets = false, bool dump_out_packets = false)
         : sc_module(name), internal_fifo("internal_fifo", size), fifo_name(std::string(name)),
           dump_in(dump_in_packets), dump_out(dump_out_packets) {
+        init_transaction_trace();
         
         // Initialize signal containers if tracing is enabled, then register traces with unified hierarchy
         if (dump_in || dump_out) {
@@ -95,15 +117,16 @@ public:
     
     // sc_fifo_out_if implementation (writing interface)
     void write(const T& data) override {
-        internal_fifo.write(data);
-        trace_packet_if_enabled(data, "write");
+        SelfProfiler::write(internal_fifo, data);
+        trace_packet_if_enabled(data, TraceDirection::IN);
     }
     
     bool nb_write(const T& data) override {
+        SelfProfiler::nb_access(true);
         bool success = internal_fifo.nb_write(data);
         
         if (success) {
-            trace_packet_if_enabled(data, "nb_write");
+            trace_packet_if_enabled(data, TraceDirection::IN);
         }
         
         return success;
@@ -115,8 +138,8 @@ public:
     
     // sc_fifo_in_if implementation (reading interface)  
     T read() override {
-        T data = internal_fifo.read();
-        trace_packet_if_enabled(data, "read");
+        T data = SelfProfiler::read(internal_fifo);
+        trace_packet_if_enabled(data, TraceDirection::OUT);
         return data;
     }
     
@@ -125,10 +148,11 @@ public:
     }
     
     bool nb_read(T& data) override {
+        SelfProfiler::nb_access(false);
         bool success = internal_fifo.nb_read(data);
         
         if (success) {
-            trace_packet_if_enabled(data, "nb_read");
+            trace_packet_if_enabled(data, TraceDirection::OUT);
         }
         
         return success;
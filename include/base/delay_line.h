@@ -5,6 +5,8 @@
 #include <memory>
 #include <type_traits>
 #include "common/error_handling.h"
+#include "base/delay_pipeline.h"
+#include "common/process_style.h"
 
 // Template-based DelayLine that works with any packet type
 template<typename PacketType>
@@ -18,6 +20,8 @@ SC_MODULE(DelayLine) {
     // Configuration
     const sc_time m_delay;
     const bool m_debug_enable;
+    const DelayLineMode m_mode;
+    const ProcessStyle m_process_style;
 
     // Process method
     void process_packets() {
@@ -43,13 +47,106 @@ SC_MODULE(DelayLine) {
         }
     }
 
+    // SC_METHOD version of process_packets (same read -> delay -> write timing)
+    // Event-triggered: nb_read/nb_write are only attempted when the fifo signalled a change
+    void process_packets_method() {
+        while (true) {
+            switch (m_method_state) {
+                case MethodStageState::READ:
+                    if (!in.nb_read(m_method_packet)) {
+                        next_trigger(in.data_written_event());
+                        return;
+                    }
+                    if (!m_method_packet) {
+                        SOC_SIM_ERROR("DelayLine", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                                     "Received null packet");
+                        continue;
+                    }
+                    // Apply delay
+                    m_method_state = MethodStageState::DELAY;
+                    next_trigger(m_delay);
+                    return;
+                    
+                case MethodStageState::DELAY:
+                    // Log packet processing if debug enabled
+                    if (m_debug_enable) {
+                        log_packet_processing(*m_method_packet);
+                    }
+                    m_method_state = MethodStageState::WRITE;
+                    // fall through
+                    
+                case MethodStageState::WRITE:
+                    // Forward packet
+                    if (!out.nb_write(m_method_packet)) {
+                        next_trigger(out.data_read_event());
+                        return;
+                    }
+                    m_method_packet.reset();
+                    m_method_state = MethodStageState::READ;
+                    break;
+            }
+        }
+    }
+
+    // Pipelined mode: ingress timestamps packets, egress releases them when due
+    void pipeline_ingress() {
+        while (true) {
+            auto packet = in.read();
+            
+            if (!packet) {
+                SOC_SIM_ERROR("DelayLine", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                             "Received null packet");
+                continue;
+            }
+            
+            m_pipeline.push(packet, m_delay);
+        }
+    }
+    
+    void pipeline_egress() {
+        while (true) {
+            auto packet = m_pipeline.pop();
+            
+            // Log packet processing if debug enabled
+            if (m_debug_enable) {
+                log_packet_processing(*packet);
+            }
+            
+            // Forward packet
+            out.write(packet);
+        }
+    }
+
     // Constructor
-    DelayLine(sc_module_name name, sc_time delay, bool debug_enable = false) 
-        : sc_module(name), m_delay(delay), m_debug_enable(debug_enable) {
-        SC_THREAD(process_packets);
+    // max_in_flight only applies to PIPELINED mode (0 = unlimited)
+    // process_style only applies to BLOCKING mode (the pipelined mode always uses threads)
+    DelayLine(sc_module_name name, sc_time delay, bool debug_enable = false,
+              DelayLineMode mode = DelayLineMode::BLOCKING, unsigned int max_in_flight = 0,
+              ProcessStyle process_style = ProcessStyle::THREAD) 
+        : sc_module(name), m_delay(delay), m_debug_enable(debug_enable), m_mode(mode),
+          m_process_style(process_style),
+          m_pipeline(max_in_flight),
+          m_method_state(MethodStageState::READ) {
+        if (m_mode == DelayLineMode::PIPELINED) {
+            SC_THREAD(pipeline_ingress);
+            SC_THREAD(pipeline_egress);
+        } else if (m_process_style == ProcessStyle::METHOD) {
+            SC_METHOD(process_packets_method);
+        } else {
+            SC_THREAD(process_packets);
+        }
     }
+    
+    size_t get_peak_in_flight() const { return m_pipeline.peak_in_flight(); }
 
 private:
+    DelayPipeline<PacketType> m_pipeline;
+    
+    // SC_METHOD state
+    MethodStageState m_method_state;
+    std::shared_ptr<PacketType> m_method_packet;
+    
+
     // Simple logging that works with any packet type
     void log_packet_processing(const PacketType& packet) {
         std::cout << sc_time_stamp() << " | DelayLine: Packet processed after " 
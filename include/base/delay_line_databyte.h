@@ -6,6 +6,8 @@
 #include <string>
 #include <functional>
 #include "common/error_handling.h"
+#include "base/delay_pipeline.h"
+#include "common/process_style.h"
 
 // Template-based DelayLineDatabyte that works with any packet type
 template<typename PacketType>
@@ -21,6 +23,9 @@ SC_MODULE(DelayLineDatabyte) {
     const sc_time m_clk_period;
     const std::string m_attribute_name;
     
+    const DelayLineMode m_mode;
+    const ProcessStyle m_process_style;
+    
     // Attribute accessor function
     std::function<double(const PacketType&)> m_attribute_accessor;
 
@@ -35,11 +40,7 @@ SC_MODULE(DelayLineDatabyte) {
                 continue;
             }
             
-            // Get attribute value using the accessor function
-            double attribute_value = m_attribute_accessor(*packet);
-            
-            // Calculate delay based on attribute, width, and clock period
-            sc_time calculated_delay = sc_time((attribute_value / m_width_byte) * m_clk_period.to_double(), SC_SEC);
+            sc_time calculated_delay = calculate_delay(*packet);
             
             // Apply calculated delay
             wait(calculated_delay);
@@ -53,35 +54,143 @@ SC_MODULE(DelayLineDatabyte) {
         }
     }
 
+    // SC_METHOD version of process_packets (same read -> delay -> write timing)
+    void process_packets_method() {
+        while (true) {
+            switch (m_method_state) {
+                case MethodStageState::READ: {
+                    if (!in.nb_read(m_method_packet)) {
+                        next_trigger(in.data_written_event());
+                        return;
+                    }
+                    if (!m_method_packet) {
+                        SOC_SIM_ERROR("DelayLineDatabyte", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                                     "Received null packet");
+                        continue;
+                    }
+                    m_method_delay = calculate_delay(*m_method_packet);
+                    m_method_state = MethodStageState::DELAY;
+                    next_trigger(m_method_delay);
+                    return;
+                }
+                    
+                case MethodStageState::DELAY:
+                    // Log packet processing
+                    std::cout << sc_time_stamp() << " | DelayLineDatabyte: Packet processed after " 
+                              << m_method_delay.to_string() << ", " << *m_method_packet << std::endl;
+                    m_method_state = MethodStageState::WRITE;
+                    // fall through
+                    
+                case MethodStageState::WRITE:
+                    // Forward packet
+                    if (!out.nb_write(m_method_packet)) {
+                        next_trigger(out.data_read_event());
+                        return;
+                    }
+                    m_method_packet.reset();
+                    m_method_state = MethodStageState::READ;
+                    break;
+            }
+        }
+    }
+
+    // Pipelined mode: ingress timestamps packets, egress releases them when due
+    void pipeline_ingress() {
+        while (true) {
+            auto packet = in.read();
+            
+            if (!packet) {
+                SOC_SIM_ERROR("DelayLineDatabyte", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                             "Received null packet");
+                continue;
+            }
+            
+            m_pipeline.push(packet, calculate_delay(*packet));
+        }
+    }
+    
+    void pipeline_egress() {
+        while (true) {
+            auto packet = m_pipeline.pop();
+            
+            // Log packet processing
+            std::cout << sc_time_stamp() << " | DelayLineDatabyte: Packet released, " 
+                      << *packet << std::endl;
+            
+            // Forward packet
+            out.write(packet);
+        }
+    }
+
     // Constructor with attribute accessor function
+    // max_in_flight only applies to PIPELINED mode (0 = unlimited)
     DelayLineDatabyte(sc_module_name name, 
                      unsigned int width_byte,
                      sc_time clk_period,
-                     std::function<double(const PacketType&)> attribute_accessor)
+                     std::function<double(const PacketType&)> attribute_accessor,
+                     DelayLineMode mode = DelayLineMode::BLOCKING,
+                     unsigned int max_in_flight = 0,
+                     ProcessStyle process_style = ProcessStyle::THREAD)
         : sc_module(name), 
           m_width_byte(width_byte), 
           m_clk_period(clk_period),
           m_attribute_name("custom"),
-          m_attribute_accessor(attribute_accessor) {
-        SC_THREAD(process_packets);
+          m_mode(mode),
+          m_process_style(process_style),
+          m_attribute_accessor(attribute_accessor),
+          m_pipeline(max_in_flight),
+          m_method_state(MethodStageState::READ) {
+        start_processes();
     }
     
     // Constructor with attribute name (requires PacketType to have get_attribute method)
     DelayLineDatabyte(sc_module_name name,
                      unsigned int width_byte,
                      sc_time clk_period,
-                     const std::string& attribute_name)
+                     const std::string& attribute_name,
+                     DelayLineMode mode = DelayLineMode::BLOCKING,
+                     unsigned int max_in_flight = 0,
+                     ProcessStyle process_style = ProcessStyle::THREAD)
         : sc_module(name),
           m_width_byte(width_byte),
           m_clk_period(clk_period),
-          m_attribute_name(attribute_name) {
+          m_attribute_name(attribute_name),
+          m_mode(mode),
+          m_process_style(process_style),
+          m_pipeline(max_in_flight),
+          m_method_state(MethodStageState::READ) {
         
         // Set up attribute accessor for types with get_attribute method
         m_attribute_accessor = [attribute_name](const PacketType& packet) -> double {
             return packet.get_attribute(attribute_name);
         };
         
-        SC_THREAD(process_packets);
+        start_processes();
+    }
+
+private:
+    DelayPipeline<PacketType> m_pipeline;
+    
+    // SC_METHOD state
+    MethodStageState m_method_state;
+    std::shared_ptr<PacketType> m_method_packet;
+    sc_time m_method_delay;
+    
+    // Calculate delay based on attribute, width, and clock period
+    sc_time calculate_delay(const PacketType& packet) const {
+        double attribute_value = m_attribute_accessor(packet);
+        return sc_time((attribute_value / m_width_byte) * m_clk_period.to_double(), SC_SEC);
+    }
+    
+    void start_processes() {
+        if (m_mode == DelayLineMode::PIPELINED) {
+            SC_THREAD(pipeline_ingress);
+            SC_THREAD(pipeline_egress);
+        } else if (m_process_style == ProcessStyle::METHOD) {
+            SC_METHOD(process_packets_method);
+        } else {
+            SC_THREAD(process_packets);
+        }
     }
 };
 
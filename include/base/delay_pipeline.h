@@ -0,0 +1,122 @@
+#ifndef DELAY_PIPELINE_H
+#define DELAY_PIPELINE_H
+
+#include <systemc.h>
+#include <memory>
+#include <deque>
+#include <map>
+#include <utility>
+#include "common/self_profiler.h"
+
+// Delay line operating mode
+enum class DelayLineMode {
+    BLOCKING,   // read -> wait(delay) -> write, one packet in flight (original behaviour)
+    PIPELINED   // each packet released at entry_time + delay, many packets in flight
+};
+
+// Timed packet queue for latency-only (wire-like) delay modelling.
+// Not a module: push() and pop() are called from the owning module's SC_THREADs.
+// Packets leave in arrival order, each no earlier than its entry time plus delay,
+// so a stage with delay D passes back-to-back traffic at full rate with latency D.
+template<typename PacketType>
+class DelayPipeline {
+public:
+    // max_in_flight = 0 means unlimited
+    explicit DelayPipeline(unsigned int max_in_flight = 0)
+        : m_max_in_flight(max_in_flight), m_peak_in_flight(0) {}
+
+    // Ingress side: timestamp the packet; blocks while the pipeline is full
+    void push(const std::shared_ptr<PacketType>& packet, const sc_time& delay) {
+        while (m_max_in_flight > 0 && m_entries.size() >= m_max_in_flight) {
+            SelfProfiler::wait(m_slot_freed);
+        }
+
+        sc_time release_time = sc_time_stamp() + delay;
+        // Keep arrival order: a packet never overtakes the one ahead of it
+        if (!m_entries.empty() && release_time < m_entries.back().first) {
+            release_time = m_entries.back().first;
+        }
+        m_entries.push_back(std::make_pair(release_time, packet));
+        if (m_entries.size() > m_peak_in_flight) {
+            m_peak_in_flight = m_entries.size();
+        }
+        m_packet_queued.notify(SC_ZERO_TIME);
+    }
+
+    // Egress side: blocks until the oldest packet is due, then removes it
+    std::shared_ptr<PacketType> pop() {
+        while (m_entries.empty()) {
+            SelfProfiler::wait(m_packet_queued);
+        }
+
+        sc_time now = sc_time_stamp();
+        if (m_entries.front().first > now) {
+            SelfProfiler::wait(m_entries.front().first - now);
+        }
+
+        std::shared_ptr<PacketType> packet = m_entries.front().second;
+        m_entries.pop_front();
+        m_slot_freed.notify(SC_ZERO_TIME);
+        return packet;
+    }
+
+    size_t in_flight() const { return m_entries.size(); }
+    size_t peak_in_flight() const { return m_peak_in_flight; }
+    unsigned int max_in_flight() const { return m_max_in_flight; }
+
+private:
+    const unsigned int m_max_in_flight;
+    size_t m_peak_in_flight;
+    std::deque<std::pair<sc_time, std::shared_ptr<PacketType>>> m_entries;
+    sc_event m_packet_queued;
+    sc_event m_slot_freed;
+};
+
+// Timed packet queue released in due-time order rather than arrival order.
+// For stages whose resources finish independently (flash dies, planes): the caller
+// computes each packet's absolute release time, and a later packet may leave first.
+// Packets due at the same time leave in push order.
+template<typename PacketType>
+class TimedReleaseQueue {
+public:
+    TimedReleaseQueue() : m_next_sequence(0), m_peak_in_flight(0) {}
+    
+    void push(const std::shared_ptr<PacketType>& packet, const sc_time& release_time) {
+        m_entries.insert(std::make_pair(std::make_pair(release_time, m_next_sequence++), packet));
+        if (m_entries.size() > m_peak_in_flight) {
+            m_peak_in_flight = m_entries.size();
+        }
+        m_packet_queued.notify(SC_ZERO_TIME);
+    }
+    
+    // Blocks until the earliest packet is due; a packet pushed meanwhile with an
+    // earlier release time is picked up without waiting for the previous head
+    std::shared_ptr<PacketType> pop() {
+        while (true) {
+            while (m_entries.empty()) {
+                SelfProfiler::wait(m_packet_queued);
+            }
+            sc_time now = sc_time_stamp();
+            sc_time due = m_entries.begin()->first.first;
+            if (due <= now) {
+                break;
+            }
+            SelfProfiler::wait(due - now, m_packet_queued);
+        }
+        
+        std::shared_ptr<PacketType> packet = m_entries.begin()->second;
+        m_entries.erase(m_entries.begin());
+        return packet;
+    }
+    
+    size_t in_flight() const { return m_entries.size(); }
+    size_t peak_in_flight() const { return m_peak_in_flight; }
+
+private:
+    uint64_t m_next_sequence;
+    size_t m_peak_in_flight;
+    std::map<std::pair<sc_time, uint64_t>, std::shared_ptr<PacketType>> m_entries;
+    sc_event m_packet_queued;
+};
+
+#endif
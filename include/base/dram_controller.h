@@ -4,10 +4,18 @@
 #include <systemc.h>
 #include <memory>
 #include <queue>
+#include <deque>
 #include <vector>
+#include <algorithm>
 #include <random>
 #include "packet/base_packet.h"
 #include "common/json_config.h"
+#include "common/tlm_support.h"
+#include "common/stats_registry.h"
+#include "common/random.h"
+#include "common/self_profiler.h"
+#include "delay_pipeline.h"
+#include <cstring>
 
 /*
  * MOON-SIM: Modular Object-Oriented Network Simulator
@@ -68,6 +76,12 @@ struct DramTiming {
     sc_time tRRDL;      // Row to Row Delay (Long) - different bank group
     sc_time tRRDS;      // Row to Row Delay (Short) - same bank group
     
+    // Scheduler constraints (FR-FCFS command scheduling)
+    sc_time tFAW;       // Four Activate Window
+    sc_time tRTP;       // Read to Precharge
+    sc_time tWTR;       // Write to Read turnaround (end of write burst to read CAS)
+    sc_time tRTW;       // Read to Write turnaround (read CAS to write CAS)
+
     // Refresh scheme specific timings
     RefreshScheme refresh_scheme;   // Refresh strategy
     sc_time tRFCab;     // All Bank Refresh Cycle time
@@ -91,6 +105,10 @@ struct DramTiming {
           tCCDS(sc_time(4, SC_NS)),     // Same as tBurst for DDR4
           tRRDL(sc_time(6, SC_NS)),     // Row-to-row delay
           tRRDS(sc_time(4, SC_NS)),     // Row-to-row delay (same bank)
+          tFAW(sc_time(21, SC_NS)),     // 1KB page
+          tRTP(sc_time(7.5, SC_NS)),
+          tWTR(sc_time(7.5, SC_NS)),
+          tRTW(sc_time(6, SC_NS)),
           // DDR4 uses traditional all-bank refresh
           refresh_scheme(RefreshScheme::ALL_BANK_REFRESH),
           tRFCab(sc_time(350, SC_NS)),  // All bank refresh cycle
@@ -143,6 +161,80 @@ enum class DramCommand {
     NOP            // No operation
 };
 
+// Request scheduling on the fifo path
+enum class DramSchedulerPolicy {
+    FCFS,       // One request at a time, commands waited inline (original behaviour)
+    FR_FCFS     // Transaction queue + per-bank queues, row hits first, banks overlap
+};
+
+inline DramSchedulerPolicy parse_dram_scheduler_policy(const std::string& policy_str) {
+    if (policy_str == "FCFS") return DramSchedulerPolicy::FCFS;
+    return DramSchedulerPolicy::FR_FCFS;
+}
+
+// Physical address -> (bank, row, column) layout, 64B line granularity
+enum class DramAddressMapping {
+    ROW_BANK_COL,           // A whole page per bank: streaming stays in one open row
+    BANK_INTERLEAVED,       // Consecutive lines rotate over banks (original layout)
+    XOR_BANK,               // ROW_BANK_COL with bank ^= low row bits (conflict hashing)
+    BANK_GROUP_INTERLEAVED  // Consecutive lines rotate over bank groups, pages stay per bank
+};
+
+inline DramAddressMapping parse_dram_address_mapping(const std::string& mapping_str) {
+    if (mapping_str == "ROW_BANK_COL") return DramAddressMapping::ROW_BANK_COL;
+    if (mapping_str == "XOR_BANK") return DramAddressMapping::XOR_BANK;
+    if (mapping_str == "BANK_GROUP_INTERLEAVED") return DramAddressMapping::BANK_GROUP_INTERLEAVED;
+    return DramAddressMapping::BANK_INTERLEAVED;
+}
+
+inline const char* dram_address_mapping_name(DramAddressMapping mapping) {
+    switch (mapping) {
+        case DramAddressMapping::ROW_BANK_COL: return "ROW_BANK_COL";
+        case DramAddressMapping::XOR_BANK: return "XOR_BANK";
+        case DramAddressMapping::BANK_GROUP_INTERLEAVED: return "BANK_GROUP_INTERLEAVED";
+        default: return "BANK_INTERLEAVED";
+    }
+}
+
+// Row buffer management after a column access
+enum class DramPagePolicy {
+    FROM_AUTO_PRECHARGE,    // CLOSED when auto_precharge is set, OPEN otherwise
+    OPEN,                   // Leave the row open
+    CLOSED,                 // Precharge after the access
+    ADAPTIVE                // Per-bank row-hit history decides
+};
+
+inline DramPagePolicy parse_dram_page_policy(const std::string& policy_str) {
+    if (policy_str == "OPEN") return DramPagePolicy::OPEN;
+    if (policy_str == "CLOSED") return DramPagePolicy::CLOSED;
+    if (policy_str == "ADAPTIVE") return DramPagePolicy::ADAPTIVE;
+    return DramPagePolicy::FROM_AUTO_PRECHARGE;
+}
+
+inline const char* dram_page_policy_name(DramPagePolicy policy) {
+    switch (policy) {
+        case DramPagePolicy::OPEN: return "OPEN";
+        case DramPagePolicy::CLOSED: return "CLOSED";
+        case DramPagePolicy::ADAPTIVE: return "ADAPTIVE";
+        default: return "FROM_AUTO_PRECHARGE";
+    }
+}
+
+struct DramSchedulerConfig {
+    DramSchedulerPolicy policy;
+    int queue_depth;            // Transaction queue entries (reads + writes)
+    int write_high_watermark;   // Queued writes that start a write drain
+    int write_low_watermark;    // Queued writes that end it (reads pending)
+    DramAddressMapping address_mapping;
+    DramPagePolicy page_policy;
+    
+    DramSchedulerConfig()
+        : policy(DramSchedulerPolicy::FR_FCFS), queue_depth(32),
+          write_high_watermark(16), write_low_watermark(8),
+          address_mapping(DramAddressMapping::BANK_INTERLEAVED),
+          page_policy(DramPagePolicy::FROM_AUTO_PRECHARGE) {}
+};
+
 // DRAM bank state
 enum class BankState {
     IDLE,          // Bank is idle (precharged)
@@ -198,17 +290,39 @@ struct DramStats {
     sc_time total_refresh_latency;
     uint64_t refresh_conflicts;     // Commands delayed due to refresh
     
+    // FR-FCFS scheduler statistics
+    uint64_t reordered_requests;        // Served ahead of an older queued request
+    uint64_t read_write_turnarounds;    // Switches between read and write drain
+    uint32_t max_queue_occupancy;
+    
+    // Address mapping / page policy effect
+    uint64_t policy_precharges;         // Rows closed by the page policy after an access
+    uint64_t closed_row_reopens;        // Page-empty accesses to the row the policy just closed
+    std::vector<uint64_t> bank_accesses;
+    
     DramStats() : total_requests(0), read_requests(0), write_requests(0),
-                  row_hits(0), row_misses(0), page_empty_hits(0), 
+                  row_hits(0), row_misses(0), page_empty_hits(0),
                   refresh_cycles(0), bank_conflicts(0),
                   total_read_latency(SC_ZERO_TIME), total_write_latency(SC_ZERO_TIME),
                   all_bank_refreshes(0), same_bank_refreshes(0), per_bank_refreshes(0),
-                  distributed_refreshes(0), total_refresh_latency(SC_ZERO_TIME), refresh_conflicts(0) {}
+                  distributed_refreshes(0), total_refresh_latency(SC_ZERO_TIME), refresh_conflicts(0),
+                  reordered_requests(0), read_write_turnarounds(0), max_queue_occupancy(0),
+                  policy_precharges(0), closed_row_reopens(0) {}
     
     double get_row_hit_rate() const {
         return total_requests > 0 ? (double)row_hits / total_requests : 0.0;
     }
     
+    // Busiest bank relative to the mean (1.0 = perfectly balanced mapping)
+    double get_bank_imbalance() const {
+        uint64_t total = 0, busiest = 0;
+        for (size_t i = 0; i < bank_accesses.size(); ++i) {
+            total += bank_accesses[i];
+            busiest = std::max(busiest, bank_accesses[i]);
+        }
+        return total > 0 ? (double)busiest * bank_accesses.size() / total : 0.0;
+    }
+    
     sc_time get_avg_read_latency() const {
         return read_requests > 0 ? sc_time(total_read_latency.to_seconds() / read_requests, SC_SEC) : SC_ZERO_TIME;
     }
@@ -227,6 +341,9 @@ SC_MODULE(DramController) {
     sc_fifo_in<std::shared_ptr<BasePacket>> mem_in;    // From cache/CPU
     sc_fifo_out<std::shared_ptr<BasePacket>> mem_out;  // To cache/CPU
     
+    // TLM-2.0 target (alternative to the fifo ports)
+    TlmTargetSocket<DramController> tlm_socket;
+    
     // Configuration
     const DramTiming m_timing;
     const MemoryType m_memory_type;  // Memory type for bank group logic
@@ -235,6 +352,8 @@ SC_MODULE(DramController) {
     const bool m_auto_precharge;    // Auto precharge after read/write
     const bool m_refresh_enable;    // Enable periodic refresh
     const bool m_debug_enable;
+    const DramSchedulerConfig m_scheduler_config;
+    const DramPagePolicy m_page_policy;
     
     // Constructor
     DramController(sc_module_name name,
@@ -244,7 +363,8 @@ SC_MODULE(DramController) {
                    int burst_length = 8,
                    bool auto_precharge = true,
                    bool refresh_enable = true,
-                   bool debug_enable = false)
+                   bool debug_enable = false,
+                   DramSchedulerConfig scheduler_config = DramSchedulerConfig())
         : sc_module(name),
           m_timing(timing),
           m_memory_type(memory_type),
@@ -253,13 +373,22 @@ SC_MODULE(DramController) {
           m_auto_precharge(auto_precharge),
           m_refresh_enable(refresh_enable),
           m_debug_enable(debug_enable),
-          m_random_generator(std::random_device{}())
+          m_scheduler_config(scheduler_config),
+          m_page_policy(scheduler_config.page_policy != DramPagePolicy::FROM_AUTO_PRECHARGE ?
+                        scheduler_config.page_policy :
+                        (auto_precharge ? DramPagePolicy::CLOSED : DramPagePolicy::OPEN)),
+          m_random_generator(RandomService::stream(this->name())),
+          m_queued_requests(0), m_queued_writes(0), m_write_drain(false), m_next_sequence(0),
+          m_last_cas_time(SC_ZERO_TIME), m_last_cas_bank(-1),
+          m_last_activate_time(SC_ZERO_TIME), m_last_activate_bank(-1),
+          m_next_read_cas(SC_ZERO_TIME), m_next_write_cas(SC_ZERO_TIME)
     {
         // Initialize banks with Bank Group support
         init_banks_with_groups();
+        m_bank_queues.resize(m_banks.size());
+        m_page_history.resize(m_banks.size());
+        m_stats.bank_accesses.assign(m_banks.size(), 0);
         
-        // Initialize statistics
-        m_stats = DramStats();
         
         if (m_debug_enable) {
             std::cout << "MOON-SIM DramController: Initialized " << DramTimingFactory::memoryTypeToString(m_memory_type) << std::endl;
@@ -269,9 +398,28 @@ SC_MODULE(DramController) {
             if (has_bank_groups()) {
                 std::cout << "  Bank Group timings - tCCDL: " << m_timing.tCCDL << ", tCCDS: " << m_timing.tCCDS << std::endl;
             }
+            std::cout << "  Address mapping: " << dram_address_mapping_name(get_address_mapping())
+                      << ", page policy: " << dram_page_policy_name(m_page_policy) << std::endl;
+            std::cout << "  Scheduler: " << (is_fr_fcfs() ? "FR_FCFS" : "FCFS");
+            if (is_fr_fcfs()) {
+                std::cout << " (queue depth " << m_scheduler_config.queue_depth
+                          << ", write drain " << m_scheduler_config.write_high_watermark
+                          << "/" << m_scheduler_config.write_low_watermark << ")";
+            }
+            std::cout << std::endl;
         }
         
-        SC_THREAD(memory_controller_process);
+        tlm_socket.register_b_transport(this, &DramController::b_transport);
+        tlm_socket.register_transport_dbg(this, &DramController::transport_dbg);
+        register_stats();
+        
+        if (is_fr_fcfs()) {
+            SC_THREAD(request_queue_process);
+            SC_THREAD(scheduler_process);
+            SC_THREAD(response_process);
+        } else {
+            SC_THREAD(memory_controller_process);
+        }
         if (m_refresh_enable) {
             SC_THREAD(refresh_process);
         }
@@ -286,7 +434,8 @@ SC_MODULE(DramController) {
                         config.get_int("dram.burst_length", 8),
                         config.get_bool("dram.auto_precharge", true),
                         config.get_bool("dram.refresh_enable", true),
-                        config.get_bool("dram.debug_enable", false))
+                        config.get_bool("dram.debug_enable", false),
+                        create_scheduler_config_from_config(config))
     {
         // Print memory configuration info
         if (config.get_bool("dram.debug_enable", false)) {
@@ -308,14 +457,17 @@ SC_MODULE(DramController) {
                    int burst_length = 8,
                    bool auto_precharge = true,
                    bool refresh_enable = true,
-                   bool debug_enable = false)
+                   bool debug_enable = false,
+                   DramSchedulerConfig scheduler_config = DramSchedulerConfig())
         : DramController(name,
                         DramTimingFactory::create(memory_type, speed_grade),
+                        memory_type,
                         page_size,
                         burst_length,
                         auto_precharge,
                         refresh_enable,
-                        debug_enable)
+                        debug_enable,
+                        scheduler_config)
     {
         if (debug_enable) {
             std::cout << "MOON-SIM DRAM Controller initialized:" << std::endl;
@@ -328,6 +480,63 @@ SC_MODULE(DramController) {
     // Get DRAM statistics
     DramStats get_stats() const { return m_stats; }
     
+    // End of a fast-forward warm-up: b_transport calls ran on a virtual clock, so their
+    // bank timestamps are dropped (open rows and the page policy history are kept) and
+    // the statistics restart for the timed phase
+    void end_fast_forward() {
+        for (auto& bank : m_banks) {
+            bank.last_activate_time = SC_ZERO_TIME;
+            bank.last_precharge_time = SC_ZERO_TIME;
+            bank.last_read_time = SC_ZERO_TIME;
+            bank.last_write_time = SC_ZERO_TIME;
+        }
+        m_stats = DramStats();
+        m_stats.bank_accesses.assign(m_banks.size(), 0);
+    }
+    
+    // Functional access: bank/row state and statistics are updated as the fifo path would,
+    // and the resulting latency is annotated. The controller stores no data, so reads return zeros.
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        if (trans.get_command() == tlm::TLM_IGNORE_COMMAND) {
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            return;
+        }
+        if (!tlm_check_payload(trans)) {
+            return;
+        }
+        
+        Command command = tlm_command_to_packet(trans);
+        sc_time latency = functional_access(static_cast<uint32_t>(trans.get_address()), command,
+                                            sc_time_stamp() + delay);
+        
+        m_stats.total_requests++;
+        if (command == Command::READ) {
+            m_stats.read_requests++;
+            m_stats.total_read_latency += latency;
+        } else {
+            m_stats.write_requests++;
+            m_stats.total_write_latency += latency;
+        }
+        
+        if (command == Command::READ && trans.get_data_ptr()) {
+            std::memset(trans.get_data_ptr(), 0, trans.get_data_length());
+        }
+        
+        delay += latency;
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+    
+    unsigned int transport_dbg(tlm::tlm_generic_payload& trans) {
+        if (!tlm_check_payload(trans)) {
+            return 0;
+        }
+        if (trans.is_read() && trans.get_data_ptr()) {
+            std::memset(trans.get_data_ptr(), 0, trans.get_data_length());
+        }
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+        return trans.get_data_length();
+    }
+    
     // Print DRAM statistics
     void print_stats() const {
         std::cout << "=== DRAM Controller Statistics ===" << std::endl;
@@ -339,10 +548,25 @@ SC_MODULE(DramController) {
         std::cout << "Row misses: " << m_stats.row_misses << std::endl;
         std::cout << "Page empty hits: " << m_stats.page_empty_hits << std::endl;
         std::cout << "Bank conflicts: " << m_stats.bank_conflicts << std::endl;
+        std::cout << "Address mapping: " << dram_address_mapping_name(get_address_mapping())
+                  << ", page policy: " << dram_page_policy_name(m_page_policy) << std::endl;
+        std::cout << "Policy precharges: " << m_stats.policy_precharges
+                  << ", closed-row reopens: " << m_stats.closed_row_reopens << std::endl;
+        std::cout << "Bank imbalance (max/mean): " << m_stats.get_bank_imbalance() << std::endl;
         std::cout << "Refresh cycles: " << m_stats.refresh_cycles << std::endl;
         std::cout << "Avg read latency: " << m_stats.get_avg_read_latency() << std::endl;
         std::cout << "Avg write latency: " << m_stats.get_avg_write_latency() << std::endl;
+        if (is_fr_fcfs()) {
+            std::cout << "Reordered requests: " << m_stats.reordered_requests << std::endl;
+            std::cout << "Read/write turnarounds: " << m_stats.read_write_turnarounds << std::endl;
+            std::cout << "Max queue occupancy: " << m_stats.max_queue_occupancy
+                      << "/" << m_scheduler_config.queue_depth << std::endl;
+        }
     }
+    
+    bool is_fr_fcfs() const { return m_scheduler_config.policy == DramSchedulerPolicy::FR_FCFS; }
+    DramAddressMapping get_address_mapping() const { return m_scheduler_config.address_mapping; }
+    DramPagePolicy get_page_policy() const { return m_page_policy; }
 
 private:
     // DRAM banks storage
@@ -350,9 +574,77 @@ private:
     
     // Statistics
     DramStats m_stats;
+    StatsGroup m_stats_group;
+    
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("requests", &m_stats.total_requests);
+        m_stats_group.counter("read_requests", &m_stats.read_requests);
+        m_stats_group.counter("write_requests", &m_stats.write_requests);
+        m_stats_group.counter("row_hits", &m_stats.row_hits);
+        m_stats_group.counter("row_misses", &m_stats.row_misses);
+        m_stats_group.counter("page_empty_hits", &m_stats.page_empty_hits);
+        m_stats_group.counter("bank_conflicts", &m_stats.bank_conflicts);
+        m_stats_group.counter("refresh_cycles", &m_stats.refresh_cycles);
+        m_stats_group.counter("refresh_conflicts", &m_stats.refresh_conflicts);
+        m_stats_group.counter("reordered_requests", &m_stats.reordered_requests);
+        m_stats_group.counter("read_write_turnarounds", &m_stats.read_write_turnarounds);
+        m_stats_group.counter("policy_precharges", &m_stats.policy_precharges);
+        m_stats_group.gauge("max_queue_occupancy", &m_stats.max_queue_occupancy, "requests");
+        m_stats_group.gauge("total_read_latency", &m_stats.total_read_latency, "ns");
+        m_stats_group.gauge("total_write_latency", &m_stats.total_write_latency, "ns");
+        m_stats_group.gauge("row_hit_rate", [this]() { return m_stats.get_row_hit_rate(); }, "ratio");
+    }
     
     // Random number generator
-    std::mt19937 m_random_generator;
+    RandomStream m_random_generator;
+    
+    // FR-FCFS scheduler state
+    struct DramRequest {
+        std::shared_ptr<BasePacket> packet;
+        uint32_t row;
+        bool is_write;
+        bool classified;        // Row hit/miss/empty already counted
+        sc_time arrival_time;
+        uint64_t sequence;      // Arrival order
+    };
+    
+    // Per-bank command queue and earliest issue time of each command type
+    struct DramBankQueue {
+        std::deque<DramRequest> requests;
+        sc_time next_activate;  // tRP after precharge, tRFC after refresh
+        sc_time next_precharge; // tRAS after activate, tRTP/tWR after CAS
+        sc_time next_cas;       // tRCD after activate
+        
+        DramBankQueue() : next_activate(SC_ZERO_TIME), next_precharge(SC_ZERO_TIME), next_cas(SC_ZERO_TIME) {}
+    };
+    
+    std::vector<DramBankQueue> m_bank_queues;
+    int m_queued_requests;
+    int m_queued_writes;
+    bool m_write_drain;             // Serving writes (batched) instead of reads
+    uint64_t m_next_sequence;
+    sc_event m_scheduler_wakeup;    // New request or refresh changed bank timing
+    sc_event m_queue_space;
+    DelayPipeline<BasePacket> m_completions;
+    
+    // Adaptive page policy: 2-bit saturating counter per bank, >= 2 keeps the row open
+    struct DramPageHistory {
+        uint8_t keep_open;
+        uint32_t last_closed_row;   // Row the policy closed last (0xFFFFFFFF = none)
+        
+        DramPageHistory() : keep_open(2), last_closed_row(0xFFFFFFFF) {}
+    };
+    std::vector<DramPageHistory> m_page_history;
+    
+    // Rank-level command timing
+    sc_time m_last_cas_time;
+    int m_last_cas_bank;
+    sc_time m_last_activate_time;
+    int m_last_activate_bank;
+    std::deque<sc_time> m_activate_window;  // Last four activates (tFAW)
+    sc_time m_next_read_cas;                // Data bus turnaround (tWTR)
+    sc_time m_next_write_cas;               // Data bus turnaround (tRTW)
     
     // Bank Group helper functions
     void init_banks_with_groups() {
@@ -394,6 +686,17 @@ private:
         return same_bank_group(bank1, bank2) ? m_timing.tRRDS : m_timing.tRRDL;
     }
     
+    static DramSchedulerConfig create_scheduler_config_from_config(const JsonConfig& config) {
+        DramSchedulerConfig scheduler_config;
+        scheduler_config.policy = parse_dram_scheduler_policy(config.get_string("dram.scheduler.policy", "FR_FCFS"));
+        scheduler_config.queue_depth = std::max(1, config.get_int("dram.scheduler.queue_depth", 32));
+        scheduler_config.write_high_watermark = config.get_int("dram.scheduler.write_high_watermark", 16);
+        scheduler_config.write_low_watermark = config.get_int("dram.scheduler.write_low_watermark", 8);
+        scheduler_config.address_mapping = parse_dram_address_mapping(config.get_string("dram.address_mapping", "BANK_INTERLEAVED"));
+        scheduler_config.page_policy = parse_dram_page_policy(config.get_string("dram.page_policy", "FROM_AUTO_PRECHARGE"));
+        return scheduler_config;
+    }
+    
     // Helper function to create timing from config
     static DramTiming create_timing_from_config(const JsonConfig& config) {
         // Check if custom timings are enabled
@@ -428,6 +731,10 @@ private:
         timing.tCCDS = sc_time(config.get_double("dram.custom_timings.tCCDS_ns", 4), SC_NS);
         timing.tRRDL = sc_time(config.get_double("dram.custom_timings.tRRDL_ns", 6), SC_NS);
         timing.tRRDS = sc_time(config.get_double("dram.custom_timings.tRRDS_ns", 4), SC_NS);
+        timing.tFAW = sc_time(config.get_double("dram.custom_timings.tFAW_ns", 21), SC_NS);
+        timing.tRTP = sc_time(config.get_double("dram.custom_timings.tRTP_ns", 7.5), SC_NS);
+        timing.tWTR = sc_time(config.get_double("dram.custom_timings.tWTR_ns", 7.5), SC_NS);
+        timing.tRTW = sc_time(config.get_double("dram.custom_timings.tRTW_ns", 6), SC_NS);
         return timing;
     }
     
@@ -447,6 +754,10 @@ private:
         timing.tCCDS = sc_time(config.get_double(prefix + "tCCDS_ns", 4), SC_NS);
         timing.tRRDL = sc_time(config.get_double(prefix + "tRRDL_ns", 6), SC_NS);
         timing.tRRDS = sc_time(config.get_double(prefix + "tRRDS_ns", 4), SC_NS);
+        timing.tFAW = sc_time(config.get_double(prefix + "tFAW_ns", 21), SC_NS);
+        timing.tRTP = sc_time(config.get_double(prefix + "tRTP_ns", 7.5), SC_NS);
+        timing.tWTR = sc_time(config.get_double(prefix + "tWTR_ns", 7.5), SC_NS);
+        timing.tRTW = sc_time(config.get_double(prefix + "tRTW_ns", 6), SC_NS);
         return timing;
     }
     
@@ -518,12 +829,368 @@ private:
         }
     }
     
+    // FR-FCFS intake: admit requests into the per-bank queues while the transaction queue has room
+    void request_queue_process() {
+        while (true) {
+            while (m_queued_requests >= m_scheduler_config.queue_depth) {
+                SelfProfiler::wait(m_queue_space);
+            }
+            auto packet = SelfProfiler::read(mem_in);
+            DramAddress decoded = decode_address(packet->get_address());
+            
+            DramRequest request;
+            request.packet = packet;
+            request.row = decoded.row;
+            request.is_write = (packet->get_command() == Command::WRITE);
+            request.classified = false;
+            request.arrival_time = sc_time_stamp();
+            request.sequence = m_next_sequence++;
+            auto& bank_requests = m_bank_queues[decoded.bank].requests;
+            for (const auto& queued : bank_requests) {
+                if (queued.row != request.row) {
+                    m_stats.bank_conflicts++;  // Same bank, different row already waiting
+                    break;
+                }
+            }
+            bank_requests.push_back(request);
+            
+            m_queued_requests++;
+            if (request.is_write) {
+                m_queued_writes++;
+            }
+            if (static_cast<uint32_t>(m_queued_requests) > m_stats.max_queue_occupancy) {
+                m_stats.max_queue_occupancy = m_queued_requests;
+            }
+            m_scheduler_wakeup.notify();
+        }
+    }
+    
+    // FR-FCFS command scheduler: every bank offers the next command of its best request
+    // (row hit first, then oldest, in the current read/write direction). Among the commands
+    // whose timing constraints are met now, a row hit wins, then the oldest request.
+    // Otherwise the scheduler sleeps until the earliest constraint expires or a request arrives.
+    void scheduler_process() {
+        while (true) {
+            while (m_queued_requests == 0) {
+                SelfProfiler::wait(m_scheduler_wakeup);
+            }
+            update_write_drain();
+            
+            sc_time now = sc_time_stamp();
+            int best_bank = -1;
+            size_t best_index = 0;
+            bool best_hit = false;
+            uint64_t best_sequence = 0;
+            bool have_earliest = false;
+            sc_time earliest = SC_ZERO_TIME;
+            
+            for (size_t bank_id = 0; bank_id < m_bank_queues.size(); ++bank_id) {
+                size_t index;
+                if (!select_bank_request(bank_id, index)) {
+                    continue;
+                }
+                const DramRequest& request = m_bank_queues[bank_id].requests[index];
+                bool hit = is_row_hit(bank_id, request.row);
+                sc_time ready = command_ready_time(bank_id, request);
+                
+                if (ready <= now) {
+                    if (best_bank == -1 || (hit && !best_hit) ||
+                        (hit == best_hit && request.sequence < best_sequence)) {
+                        best_bank = static_cast<int>(bank_id);
+                        best_index = index;
+                        best_hit = hit;
+                        best_sequence = request.sequence;
+                    }
+                } else if (!have_earliest || ready < earliest) {
+                    earliest = ready;
+                    have_earliest = true;
+                }
+            }
+            
+            if (best_bank != -1) {
+                issue_command(best_bank, best_index);
+                SelfProfiler::wait(SC_ZERO_TIME);  // One command per delta cycle
+            } else if (have_earliest) {
+                SelfProfiler::wait(earliest - now, m_scheduler_wakeup);
+            } else {
+                SelfProfiler::wait(m_scheduler_wakeup);
+            }
+        }
+    }
+    
+    void response_process() {
+        while (true) {
+            SelfProfiler::write(mem_out, m_completions.pop());
+        }
+    }
+    
+    // Reads are served first; writes are buffered and drained in batches
+    void update_write_drain() {
+        int queued_reads = m_queued_requests - m_queued_writes;
+        if (!m_write_drain) {
+            if (m_queued_writes > 0 &&
+                (m_queued_writes >= m_scheduler_config.write_high_watermark || queued_reads == 0)) {
+                m_write_drain = true;
+                m_stats.read_write_turnarounds++;
+            }
+        } else if (m_queued_writes == 0 ||
+                   (queued_reads > 0 && m_queued_writes <= m_scheduler_config.write_low_watermark)) {
+            m_write_drain = false;
+            m_stats.read_write_turnarounds++;
+        }
+    }
+    
+    bool is_row_hit(size_t bank_id, uint32_t row) const {
+        return m_banks[bank_id].state == BankState::ACTIVE && m_banks[bank_id].active_row == row;
+    }
+    
+    // Best request of one bank in the current direction: first row hit, else oldest
+    bool select_bank_request(size_t bank_id, size_t& index) const {
+        const auto& requests = m_bank_queues[bank_id].requests;
+        bool found = false;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (requests[i].is_write != m_write_drain) {
+                continue;
+            }
+            if (is_row_hit(bank_id, requests[i].row)) {
+                index = i;
+                return true;
+            }
+            if (!found) {
+                index = i;
+                found = true;
+            }
+        }
+        return found;
+    }
+    
+    // Earliest time the next command for request may issue (CAS, PRECHARGE or ACTIVATE)
+    sc_time command_ready_time(size_t bank_id, const DramRequest& request) const {
+        const DramBank& bank = m_banks[bank_id];
+        const DramBankQueue& queue = m_bank_queues[bank_id];
+        sc_time ready;
+        
+        if (is_row_hit(bank_id, request.row)) {
+            ready = std::max(queue.next_cas, request.is_write ? m_next_write_cas : m_next_read_cas);
+            if (m_last_cas_bank >= 0) {
+                ready = std::max(ready, m_last_cas_time + get_cas_to_cas_delay(m_banks[m_last_cas_bank], bank));
+            }
+        } else if (bank.state == BankState::ACTIVE) {
+            ready = queue.next_precharge;
+        } else {
+            ready = queue.next_activate;
+            if (m_last_activate_bank >= 0) {
+                ready = std::max(ready, m_last_activate_time +
+                                        get_row_to_row_delay(m_banks[m_last_activate_bank], bank));
+            }
+            if (m_activate_window.size() == 4) {
+                ready = std::max(ready, m_activate_window.front() + m_timing.tFAW);
+            }
+        }
+        return ready;
+    }
+    
+    void issue_command(size_t bank_id, size_t index) {
+        DramBank& bank = m_banks[bank_id];
+        DramBankQueue& queue = m_bank_queues[bank_id];
+        DramRequest& request = queue.requests[index];
+        sc_time now = sc_time_stamp();
+        
+        if (!request.classified) {
+            if (is_row_hit(bank_id, request.row)) {
+                m_stats.row_hits++;
+            } else if (bank.state == BankState::ACTIVE) {
+                m_stats.row_misses++;
+            } else {
+                m_stats.page_empty_hits++;
+            }
+            record_page_outcome(bank_id, request.row);
+            m_stats.bank_accesses[bank_id]++;
+            request.classified = true;
+        }
+        
+        if (!is_row_hit(bank_id, request.row)) {
+            if (bank.state == BankState::ACTIVE) {
+                close_bank(bank_id, now);
+            } else {
+                // ACTIVATE
+                bank.state = BankState::ACTIVE;
+                bank.active_row = request.row;
+                bank.last_activate_time = now;
+                queue.next_cas = now + m_timing.tRCD;
+                queue.next_precharge = std::max(queue.next_precharge, now + m_timing.tRAS);
+                m_last_activate_time = now;
+                m_last_activate_bank = static_cast<int>(bank_id);
+                m_activate_window.push_back(now);
+                if (m_activate_window.size() > 4) {
+                    m_activate_window.pop_front();
+                }
+                if (m_debug_enable) {
+                    std::cout << now << " | DramController: ACT bank " << bank_id << " row " << request.row << std::endl;
+                }
+            }
+            return;
+        }
+        
+        // CAS (READ/WRITE)
+        sc_time done;
+        if (request.is_write) {
+            bank.last_write_time = now;
+            done = now + m_timing.tBurst;
+            queue.next_precharge = std::max(queue.next_precharge, done + m_timing.tWR);
+            m_next_read_cas = std::max(m_next_read_cas, done + m_timing.tWTR);
+            m_stats.write_requests++;
+            m_stats.total_write_latency += done - request.arrival_time;
+        } else {
+            bank.last_read_time = now;
+            done = now + m_timing.tCL + m_timing.tBurst;
+            queue.next_precharge = std::max(queue.next_precharge, now + m_timing.tRTP);
+            m_next_write_cas = std::max(m_next_write_cas, now + m_timing.tRTW);
+            m_stats.read_requests++;
+            m_stats.total_read_latency += done - request.arrival_time;
+        }
+        m_stats.total_requests++;
+        m_last_cas_time = now;
+        m_last_cas_bank = static_cast<int>(bank_id);
+        
+        if (has_older_request(request.sequence)) {
+            m_stats.reordered_requests++;
+        }
+        if (m_debug_enable) {
+            std::cout << now << " | DramController: " << (request.is_write ? "WR" : "RD")
+                      << " bank " << bank_id << " row " << request.row
+                      << ", latency " << (done - request.arrival_time) << std::endl;
+        }
+        
+        m_completions.push(request.packet, done - now);
+        uint32_t open_row = bank.active_row;
+        if (request.is_write) {
+            m_queued_writes--;
+        }
+        queue.requests.erase(queue.requests.begin() + index);
+        m_queued_requests--;
+        m_queue_space.notify();
+        
+        // The page policy closes the row once no queued request still hits it
+        if (!keep_row_open(bank_id) && !has_queued_row_hit(bank_id, open_row)) {
+            policy_close(bank_id, open_row);
+            close_bank(bank_id, queue.next_precharge);
+        }
+    }
+    
+    // PRECHARGE issued at time t (timestamp only)
+    void close_bank(size_t bank_id, const sc_time& t) {
+        DramBank& bank = m_banks[bank_id];
+        DramBankQueue& queue = m_bank_queues[bank_id];
+        bank.state = BankState::IDLE;
+        bank.active_row = 0xFFFFFFFF;
+        bank.last_precharge_time = t;
+        queue.next_activate = std::max(queue.next_activate, t + m_timing.tRP);
+    }
+    
+    // Page policy bookkeeping, called once per access before its row is opened:
+    // a row hit or a reopen of the row just closed votes for open, a conflict votes for close
+    void record_page_outcome(size_t bank_id, uint32_t row) {
+        DramPageHistory& history = m_page_history[bank_id];
+        const DramBank& bank = m_banks[bank_id];
+        if (bank.state == BankState::ACTIVE) {
+            if (bank.active_row == row) {
+                if (history.keep_open < 3) history.keep_open++;
+            } else if (history.keep_open > 0) {
+                history.keep_open--;
+            }
+        } else if (row == history.last_closed_row) {
+            m_stats.closed_row_reopens++;
+            if (history.keep_open < 3) history.keep_open++;
+        }
+    }
+    
+    bool keep_row_open(size_t bank_id) const {
+        switch (m_page_policy) {
+            case DramPagePolicy::OPEN: return true;
+            case DramPagePolicy::ADAPTIVE: return m_page_history[bank_id].keep_open >= 2;
+            default: return false;
+        }
+    }
+    
+    void policy_close(size_t bank_id, uint32_t row) {
+        m_page_history[bank_id].last_closed_row = row;
+        m_stats.policy_precharges++;
+    }
+    
+    bool has_queued_row_hit(size_t bank_id, uint32_t row) const {
+        for (const auto& request : m_bank_queues[bank_id].requests) {
+            if (request.row == row) return true;
+        }
+        return false;
+    }
+    
+    // Per-bank queues are in arrival order, so only the fronts need checking
+    bool has_older_request(uint64_t sequence) const {
+        for (const auto& queue : m_bank_queues) {
+            if (!queue.requests.empty() && queue.requests.front().sequence < sequence) return true;
+        }
+        return false;
+    }
+    
+    // Scheduler-mode refresh: close the banks, then block their activates for tRFC.
+    // Requests keep queueing and the other banks keep serving.
+    void scheduled_refresh(size_t first_bank, size_t num_banks, const sc_time& refresh_cycle) {
+        sc_time now = sc_time_stamp();
+        sc_time start = now;
+        size_t last_bank = std::min(first_bank + num_banks, m_banks.size());
+        for (size_t bank_id = first_bank; bank_id < last_bank; ++bank_id) {
+            if (m_banks[bank_id].state == BankState::ACTIVE) {
+                close_bank(bank_id, std::max(now, m_bank_queues[bank_id].next_precharge));
+            }
+            start = std::max(start, m_bank_queues[bank_id].next_activate);
+        }
+        for (size_t bank_id = first_bank; bank_id < last_bank; ++bank_id) {
+            m_bank_queues[bank_id].next_activate = start + refresh_cycle;
+        }
+        m_stats.total_refresh_latency += (start + refresh_cycle) - now;
+        m_scheduler_wakeup.notify();
+    }
+    
+    void perform_scheduled_refresh(uint32_t refresh_counter, uint32_t& distributed_bank_index) {
+        switch (m_timing.refresh_scheme) {
+            case RefreshScheme::SAME_BANK_REFRESH:
+                if (has_bank_groups()) {
+                    scheduled_refresh((refresh_counter % NUM_BANK_GROUPS) * NUM_BANKS, NUM_BANKS, m_timing.tRFCsb);
+                    m_stats.same_bank_refreshes++;
+                    return;
+                }
+                break;
+            case RefreshScheme::PER_BANK_REFRESH:
+                scheduled_refresh(refresh_counter % get_total_banks(), 1, m_timing.tRFCpb);
+                m_stats.per_bank_refreshes++;
+                return;
+            case RefreshScheme::DISTRIBUTED_REFRESH:
+                scheduled_refresh(distributed_bank_index, 1, m_timing.tRFCpb);
+                distributed_bank_index = (distributed_bank_index + 1) % get_total_banks();
+                m_stats.per_bank_refreshes++;
+                m_stats.distributed_refreshes++;
+                return;
+            case RefreshScheme::REFRESH_MANAGEMENT_UNIT:
+                if (refresh_counter % 4 != 0) {
+                    scheduled_refresh(refresh_counter % get_total_banks(), 1, m_timing.tRFCpb);
+                    m_stats.per_bank_refreshes++;
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+        scheduled_refresh(0, m_banks.size(), m_timing.tRFCab);
+        m_stats.all_bank_refreshes++;
+    }
+    
     // Process DRAM request
     void process_dram_request(std::shared_ptr<BasePacket> packet) {
-        uint32_t address = packet->get_address();
-        int bank_id = get_bank_id(address);
-        uint32_t row = get_row(address);
-        uint32_t col = get_column(address);
+        DramAddress decoded = decode_address(packet->get_address());
+        size_t bank_id = decoded.bank;
+        uint32_t row = decoded.row;
+        uint32_t col = decoded.column;
         
         auto& bank = m_banks[bank_id];
         
@@ -536,6 +1203,9 @@ private:
             }
         }
         
+        record_page_outcome(bank_id, row);
+        m_stats.bank_accesses[bank_id]++;
+        
         // Handle different scenarios
         if (bank.state == BankState::IDLE) {
             // Bank is idle, need to activate row
@@ -560,12 +1230,70 @@ private:
             perform_write(bank, col);
         }
         
-        // Auto precharge if enabled
-        if (m_auto_precharge) {
+        // Close the row if the page policy says so
+        if (!keep_row_open(bank_id)) {
+            policy_close(bank_id, row);
             precharge_bank(bank);
         }
     }
     
+    // Timestamp-only version of process_dram_request for b_transport: same
+    // activate/precharge/CAS sequence, computed from start_time instead of waited
+    sc_time functional_access(uint32_t address, Command command, const sc_time& start_time) {
+        DramAddress decoded = decode_address(address);
+        auto& bank = m_banks[decoded.bank];
+        uint32_t row = decoded.row;
+        sc_time t = start_time;
+        
+        record_page_outcome(decoded.bank, row);
+        m_stats.bank_accesses[decoded.bank]++;
+        
+        if (bank.state == BankState::ACTIVE && bank.active_row == row) {
+            m_stats.row_hits++;
+        } else {
+            if (bank.state == BankState::ACTIVE) {
+                // Row miss - precharge the open row first
+                m_stats.row_misses++;
+                t = functional_precharge(bank, t);
+            } else {
+                m_stats.page_empty_hits++;
+            }
+            if (t < bank.last_precharge_time + m_timing.tRP) {
+                t = bank.last_precharge_time + m_timing.tRP;
+            }
+            bank.last_activate_time = t;
+            bank.active_row = row;
+            bank.state = BankState::ACTIVE;
+            t += m_timing.tRCD;
+        }
+        
+        if (command == Command::READ) {
+            bank.last_read_time = t;
+            t += m_timing.tCL + m_timing.tBurst;
+        } else {
+            bank.last_write_time = t;
+            t += m_timing.tBurst;
+        }
+        
+        if (!keep_row_open(decoded.bank)) {
+            policy_close(decoded.bank, row);
+            t = functional_precharge(bank, t);
+        }
+        
+        return t - start_time;
+    }
+    
+    sc_time functional_precharge(DramBank& bank, sc_time t) {
+        if (t < bank.last_activate_time + m_timing.tRAS) {
+            t = bank.last_activate_time + m_timing.tRAS;
+        }
+        t += m_timing.tRP;
+        bank.state = BankState::IDLE;
+        bank.last_precharge_time = t;
+        bank.active_row = 0xFFFFFFFF;
+        return t;
+    }
+    
     // Activate row in bank
     void activate_row(DramBank& bank, uint32_t row) {
         // Wait for tRP if needed
@@ -651,9 +1379,11 @@ private:
         
         while (true) {
             sc_time refresh_interval = get_refresh_interval();
-            wait(refresh_interval);
+            SelfProfiler::wait(refresh_interval);
             
-            switch (m_timing.refresh_scheme) {
+            if (is_fr_fcfs()) {
+                perform_scheduled_refresh(refresh_counter, distributed_bank_index);
+            } else switch (m_timing.refresh_scheme) {
                 case RefreshScheme::ALL_BANK_REFRESH:
                     perform_all_bank_refresh();
                     break;
@@ -857,22 +1587,56 @@ private:
         }
     }
     
-    // Address mapping functions
-    int get_bank_id(uint32_t address) const {
-        // Simple bank interleaving: use middle bits
-        return (address >> 6) & (NUM_BANKS - 1);  // Assumes NUM_BANKS is power of 2
-    }
-    
-    uint32_t get_row(uint32_t address) const {
-        // Row address from upper bits
-        return address >> (6 + __builtin_ctz(NUM_BANKS) + __builtin_ctz(m_page_size/64));
-    }
-    
-    uint32_t get_column(uint32_t address) const {
-        // Column address from lower bits (excluding offset)
-        int bank_bits = __builtin_ctz(NUM_BANKS);
-        int offset_bits = 6; // 64-byte cache line
-        return (address >> offset_bits) & ((m_page_size/64) - 1);
+    // Address mapping functions (bank counts and page size are powers of two)
+    struct DramAddress {
+        size_t bank;        // Index into m_banks: rank, bank group, bank
+        uint32_t row;
+        uint32_t column;    // 64B line within the page
+    };
+    
+    DramAddress decode_address(uint32_t address) const {
+        static const int LINE_BITS = 6;  // 64-byte cache line
+        static const int BANK_BITS = __builtin_ctz(NUM_BANKS);
+        static const int GROUP_BITS = __builtin_ctz(NUM_BANK_GROUPS);
+        static const int ALL_BANK_BITS = __builtin_ctz(NUM_BANKS * NUM_BANK_GROUPS * NUM_RANKS);
+        const int column_bits = __builtin_ctz(m_page_size / 64);
+        const uint32_t column_mask = (1u << column_bits) - 1;
+        const uint32_t all_bank_mask = (1u << ALL_BANK_BITS) - 1;
+        uint32_t line = address >> LINE_BITS;
+        DramAddress decoded;
+        
+        switch (m_scheduler_config.address_mapping) {
+            case DramAddressMapping::ROW_BANK_COL:
+            case DramAddressMapping::XOR_BANK:
+                decoded.column = line & column_mask;
+                decoded.bank = (line >> column_bits) & all_bank_mask;
+                decoded.row = line >> (column_bits + ALL_BANK_BITS);
+                if (m_scheduler_config.address_mapping == DramAddressMapping::XOR_BANK) {
+                    decoded.bank ^= decoded.row & all_bank_mask;
+                }
+                break;
+            
+            case DramAddressMapping::BANK_GROUP_INTERLEAVED: {
+                // line = row | rank+bank | column | bank group
+                uint32_t group = line & (NUM_BANK_GROUPS - 1);
+                line >>= GROUP_BITS;
+                decoded.column = line & column_mask;
+                line >>= column_bits;
+                uint32_t bank = line & (NUM_BANKS - 1);
+                uint32_t rank = (line >> BANK_BITS) & (NUM_RANKS - 1);
+                decoded.bank = (rank * NUM_BANK_GROUPS + group) * NUM_BANKS + bank;
+                decoded.row = line >> (ALL_BANK_BITS - GROUP_BITS);
+                break;
+            }
+            
+            case DramAddressMapping::BANK_INTERLEAVED:
+            default:
+                decoded.bank = line & all_bank_mask;
+                decoded.column = (line >> ALL_BANK_BITS) & column_mask;
+                decoded.row = line >> (ALL_BANK_BITS + column_bits);
+                break;
+        }
+        return decoded;
     }
 };
 
@@ -1206,6 +1970,10 @@ inline DramTiming create_timing_from_config(const JsonConfig& config) {
             timing.tCCDS = sc_time(config.get_double(config_prefix + "tCCDS_ns", 4.0), SC_NS);
             timing.tRRDL = sc_time(config.get_double(config_prefix + "tRRDL_ns", 6.0), SC_NS);
             timing.tRRDS = sc_time(config.get_double(config_prefix + "tRRDS_ns", 4.0), SC_NS);
+            timing.tFAW = sc_time(config.get_double(config_prefix + "tFAW_ns", 21.0), SC_NS);
+            timing.tRTP = sc_time(config.get_double(config_prefix + "tRTP_ns", 7.5), SC_NS);
+            timing.tWTR = sc_time(config.get_double(config_prefix + "tWTR_ns", 7.5), SC_NS);
+            timing.tRTW = sc_time(config.get_double(config_prefix + "tRTW_ns", 6.0), SC_NS);
             
             // Load refresh parameters if available
             timing.tRFCab = sc_time(config.get_double(config_prefix + "tRFCab_ns", 350.0), SC_NS);
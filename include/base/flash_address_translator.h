@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include "packet/base_packet.h"
 #include "packet/flash_packet.h"
+#include "packet/packet_pool.h"
 #include "common/error_handling.h"
 
 // Address translation policies
@@ -68,7 +69,7 @@ SC_MODULE(FlashAddressTranslator) {
             }
             
             // Create FlashPacket from BasePacket
-            auto flash_packet = std::make_shared<FlashPacket>(packet);
+            auto flash_packet = PacketPool<FlashPacket>::acquire(packet);
             
             // Get system address from original packet
             int system_address = m_get_address(*packet);
@@ -84,12 +85,12 @@ SC_MODULE(FlashAddressTranslator) {
             flash_packet->set_flash_address(flash_addr);
             
             // Set data size based on original packet
-            uint32_t data_size = static_cast<uint32_t>(packet->get_databyte());
+            uint32_t data_size = packet->get_transfer_length();
             if (data_size == 0) data_size = m_geometry.page_size_bytes; // Default page size
             flash_packet->set_data_size(data_size);
             
             // Copy index for tracking
-            flash_packet->set_attribute("index", packet->get_attribute("index"));
+            set_field<PacketField::INDEX>(*flash_packet, get_field<PacketField::INDEX>(*packet));
             
             if (m_debug_enable) {
                 std::cout << sc_time_stamp() << " | FlashAddressTranslator: "
@@ -4,12 +4,60 @@
 #include <systemc.h>
 #include <memory>
 #include <set>
+#include <vector>
+#include <string>
 #include <functional>
+#include <algorithm>
+#include "packet/base_packet.h"
 #include "common/error_handling.h"
+#include "common/self_profiler.h"
+#include "base/index_bitmap.h"
+
+// Index bookkeeping strategy
+enum class IndexAllocatorMode {
+    SET_SCAN,   // std::set + linear scan (original implementation)
+    BITMAP      // Hierarchical bitmap, O(1) lowest-free lookup
+};
+
+inline IndexAllocatorMode parse_index_allocator_mode(const std::string& mode_str) {
+    if (mode_str == "BITMAP") return IndexAllocatorMode::BITMAP;
+    return IndexAllocatorMode::SET_SCAN;
+}
+
+// Index setter policies. FieldIndexSetter (default) writes the typed INDEX field
+// directly; FunctionIndexSetter wraps a runtime setter for custom packet types.
+struct FieldIndexSetter {
+    template<typename PacketType>
+    void operator()(PacketType& packet, unsigned int index) const {
+        set_field<PacketField::INDEX>(packet, static_cast<int>(index));
+    }
+};
+
+// QueueIndexSetter gives each NVMe queue its own tag range: local index i is written as
+// base + i. The release path must hand the allocator the local index again.
+struct QueueIndexSetter {
+    unsigned int m_base;
+    
+    QueueIndexSetter(unsigned int base = 0) : m_base(base) {}
+    
+    template<typename PacketType>
+    void operator()(PacketType& packet, unsigned int index) const {
+        set_field<PacketField::INDEX>(packet, static_cast<int>(m_base + index));
+    }
+};
+
+template<typename PacketType>
+struct FunctionIndexSetter {
+    std::function<void(PacketType&, unsigned int)> m_setter;
+    
+    FunctionIndexSetter(std::function<void(PacketType&, unsigned int)> setter) : m_setter(setter) {}
+    
+    void operator()(PacketType& packet, unsigned int index) const { m_setter(packet, index); }
+};
 
 // Template-based IndexAllocator that works with any packet type
 // Always allocates from minimum available index, handles out-of-order releases
-template<typename PacketType>
+template<typename PacketType, typename IndexSetter = FieldIndexSetter>
 SC_MODULE(IndexAllocator) {
     SC_HAS_PROCESS(IndexAllocator);
     
@@ -21,13 +69,15 @@ SC_MODULE(IndexAllocator) {
     // Configuration parameters
     const unsigned int m_max_index;
     
-    // Index setter function - allows flexible index assignment
-    std::function<void(PacketType&, unsigned int)> m_index_setter;
+    // Index setter policy - allows flexible index assignment
+    IndexSetter m_index_setter;
     
     // Process methods
     void allocate_indices() {
+        std::vector<unsigned int> reserved;
+        
         while (true) {
-            auto packet = in.read();
+            auto packet = SelfProfiler::read(in);
             
             if (!packet) {
                 SOC_SIM_ERROR("IndexAllocator", soc_sim::error::codes::INVALID_PACKET_TYPE, 
@@ -35,25 +85,24 @@ SC_MODULE(IndexAllocator) {
                 continue;
             }
             
-            // Wait for available index if pool is exhausted
-            unsigned int allocated_index = allocate_index_blocking();
-            
-            // Set index using the setter function
-            m_index_setter(*packet, allocated_index);
-            
-            // Update statistics
-            m_total_allocated++;
+            // Packets already queued behind this one (e.g. a TrafficGenerator burst)
+            // share one reservation, so the burst costs one wakeup instead of one each
+            unsigned int wanted = std::min<unsigned int>(m_max_batch, 1 + in.num_available());
+            allocate_batch_blocking(wanted, reserved);
             
-            // Log allocation
-            if (m_debug_enable) {
-                std::cout << sc_time_stamp() << " | IndexAllocator: Allocated index=" 
-                          << allocated_index << ", in_use=" << m_allocated_indices.size() 
-                          << ", " << *packet << std::endl;
+            for (size_t i = 0; i < reserved.size(); ++i) {
+                if (i > 0) {
+                    packet = SelfProfiler::read(in);  // Already available - does not block
+                    if (!packet) {
+                        SOC_SIM_ERROR("IndexAllocator", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                                     "Received null packet");
+                        release_index(reserved[i]);
+                        continue;
+                    }
+                }
+                assign_and_forward(packet, reserved[i]);
             }
             
-            // Forward packet
-            out.write(packet);
-            
             // Print statistics periodically (disabled for cleaner output)
             // if (m_total_allocated % 1000 == 0) {
             //     print_statistics();
@@ -63,69 +112,97 @@ SC_MODULE(IndexAllocator) {
     
     void release_indices() {
         while (true) {
-            auto packet = release_in.read();
-            
-            if (!packet) {
-                SOC_SIM_ERROR("IndexAllocator", soc_sim::error::codes::INVALID_PACKET_TYPE, 
-                             "Received null packet in release path");
-                continue;
-            }
-            
-            // Get index from packet
-            unsigned int released_index = static_cast<unsigned int>(packet->get_attribute("index"));
-            
-            // Release the index (remove from allocated set)
-            m_allocated_indices.erase(released_index);
+            auto packet = SelfProfiler::read(release_in);
             
-            // Update statistics
-            m_total_deallocated++;
-            
-            // Log release
-            if (m_debug_enable) {
-                std::cout << sc_time_stamp() << " | IndexAllocator: Released index=" 
-                          << released_index << ", in_use=" << m_allocated_indices.size() 
-                          << ", " << *packet << std::endl;
+            // Drain every completion already queued and notify the allocator once
+            unsigned int batch = 1 + std::min<unsigned int>(m_max_batch - 1, release_in.num_available());
+            for (unsigned int i = 0; i < batch; ++i) {
+                if (i > 0) {
+                    packet = SelfProfiler::read(release_in);  // Already available - does not block
+                }
+                release_packet(packet);
+                
+                // Drop the last host-side reference; pooled packets return to their PacketPool here
+                packet.reset();
             }
             
             // Signal that an index is now available
             m_index_available.notify();
         }
     }
+    
+    // Batch entry points - reserve/return several indices with a single bookkeeping pass.
+    // Reserves up to `count` lowest free indices (at least one, waiting if the pool is exhausted).
+    void allocate_batch_blocking(unsigned int count, std::vector<unsigned int>& indices) {
+        indices.clear();
+        while (in_use_count() >= m_max_index) {
+            SelfProfiler::wait(m_index_available);
+        }
+        while (indices.size() < count && in_use_count() < m_max_index) {
+            indices.push_back(allocate_minimum_index());
+        }
+    }
+    
+    void release_batch(const std::vector<unsigned int>& indices) {
+        for (unsigned int index : indices) {
+            release_index(index);
+        }
+        m_index_available.notify();
+    }
+    
+    unsigned int in_use_count() const {
+        return (m_mode == IndexAllocatorMode::BITMAP) ? m_bitmap.used_count()
+                                                      : static_cast<unsigned int>(m_allocated_indices.size());
+    }
+    
+    IndexAllocatorMode get_mode() const { return m_mode; }
 
-    // Constructor with custom index setter
-    IndexAllocator(sc_module_name name, 
+    // Constructor with custom index setter (a FunctionIndexSetter std::function, or a setter policy object)
+    IndexAllocator(sc_module_name name,
                   unsigned int max_index,
-                  std::function<void(PacketType&, unsigned int)> index_setter,
-                  bool debug_enable = false)
+                  IndexSetter index_setter,
+                  bool debug_enable = false,
+                  IndexAllocatorMode mode = IndexAllocatorMode::SET_SCAN,
+                  unsigned int max_batch = 1)
         : sc_module(name), 
           m_max_index(max_index),
           m_index_setter(index_setter),
           m_debug_enable(debug_enable),
+          m_mode(mode),
+          m_max_batch(std::max(1u, max_batch)),
           m_total_allocated(0),
           m_total_deallocated(0) {
         
+        if (m_mode == IndexAllocatorMode::BITMAP) {
+            m_bitmap.reset(m_max_index);
+        }
+        
         SC_THREAD(allocate_indices);
         SC_THREAD(release_indices);
         
         SOC_SIM_INFO("IndexAllocator", "INIT", 
-                     "Initialized simple index allocator with max_index=" + std::to_string(max_index));
+                     "Initialized " + std::string(m_mode == IndexAllocatorMode::BITMAP ? "bitmap" : "simple") +
+                     " index allocator with max_index=" + std::to_string(max_index) +
+                     ", max_batch=" + std::to_string(m_max_batch));
     }
     
-    // Constructor for types with set_attribute method
+    // Constructor for types with the typed index accessor
     IndexAllocator(sc_module_name name, 
                   unsigned int max_index = 1024,
-                  bool debug_enable = false)
-        : IndexAllocator(name, max_index,
-                        [](PacketType& packet, unsigned int index) {
-                            packet.set_attribute("index", static_cast<double>(index));
-                        }, debug_enable) {}
+                  bool debug_enable = false,
+                  IndexAllocatorMode mode = IndexAllocatorMode::SET_SCAN,
+                  unsigned int max_batch = 1)
+        : IndexAllocator(name, max_index, IndexSetter(), debug_enable, mode, max_batch) {}
 
 private:
     // Configuration
     const bool m_debug_enable;
+    const IndexAllocatorMode m_mode;
+    const unsigned int m_max_batch;
     
     // Internal state - tracks allocated indices for minimum allocation
-    std::set<unsigned int> m_allocated_indices;
+    std::set<unsigned int> m_allocated_indices;  // SET_SCAN mode
+    IndexBitmap m_bitmap;                        // BITMAP mode
     
     // Statistics
     unsigned int m_total_allocated;
@@ -134,19 +211,65 @@ private:
     // Synchronization for blocking allocation
     sc_event m_index_available;
     
-    // Blocking allocation - waits if no indices available
-    unsigned int allocate_index_blocking() {
-        while (true) {
-            if (m_allocated_indices.size() < m_max_index) {
-                return allocate_minimum_index();
+    void assign_and_forward(const std::shared_ptr<PacketType>& packet, unsigned int allocated_index) {
+        // Set index using the setter policy
+        m_index_setter(*packet, allocated_index);
+        
+        // Update statistics
+        m_total_allocated++;
+        
+        // Log allocation
+        if (m_debug_enable) {
+            std::cout << sc_time_stamp() << " | IndexAllocator: Allocated index=" 
+                      << allocated_index << ", in_use=" << in_use_count() 
+                      << ", " << *packet << std::endl;
+        }
+        
+        // Forward packet
+        SelfProfiler::write(out, packet);
+    }
+    
+    void release_packet(const std::shared_ptr<PacketType>& packet) {
+        if (!packet) {
+            SOC_SIM_ERROR("IndexAllocator", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                         "Received null packet in release path");
+            return;
+        }
+        
+        // Get index from packet
+        unsigned int released_index = static_cast<unsigned int>(get_field<PacketField::INDEX>(*packet));
+        release_index(released_index);
+        
+        // Log release
+        if (m_debug_enable) {
+            std::cout << sc_time_stamp() << " | IndexAllocator: Released index=" 
+                      << released_index << ", in_use=" << in_use_count() 
+                      << ", " << *packet << std::endl;
+        }
+    }
+    
+    void release_index(unsigned int released_index) {
+        if (m_mode == IndexAllocatorMode::BITMAP) {
+            if (!m_bitmap.release(released_index)) {
+                SOC_SIM_WARNING("IndexAllocator", soc_sim::error::codes::INVALID_ATTRIBUTE,
+                               "Release of index not in use: " + std::to_string(released_index));
+                return;
             }
-            // Wait for an index to become available
-            wait(m_index_available);
+        } else {
+            // Release the index (remove from allocated set)
+            m_allocated_indices.erase(released_index);
         }
+        
+        // Update statistics
+        m_total_deallocated++;
     }
     
     // Find and allocate the minimum available index
     unsigned int allocate_minimum_index() {
+        if (m_mode == IndexAllocatorMode::BITMAP) {
+            return m_bitmap.take_lowest();
+        }
+        
         // Find the smallest index not in the allocated set
         for (unsigned int i = 0; i < m_max_index; ++i) {
             if (m_allocated_indices.find(i) == m_allocated_indices.end()) {
@@ -164,8 +287,8 @@ private:
         std::cout << sc_time_stamp() << " | IndexAllocator Statistics:" << std::endl;
         std::cout << "  Total allocated: " << m_total_allocated << std::endl;
         std::cout << "  Total deallocated: " << m_total_deallocated << std::endl;
-        std::cout << "  Current in use: " << m_allocated_indices.size() << std::endl;
-        std::cout << "  Available slots: " << (m_max_index - m_allocated_indices.size()) << std::endl;
+        std::cout << "  Current in use: " << in_use_count() << std::endl;
+        std::cout << "  Available slots: " << (m_max_index - in_use_count()) << std::endl;
     }
     
     void handle_allocation_error(const std::string& reason) {
@@ -177,14 +300,18 @@ private:
 // Type alias for backward compatibility
 using BasePacketIndexAllocator = IndexAllocator<BasePacket>;
 
+// IndexAllocator driven by a runtime index setter (custom packet types)
+template<typename PacketType>
+using FunctionIndexAllocator = IndexAllocator<PacketType, FunctionIndexSetter<PacketType>>;
+
 // Helper function to create IndexAllocator with custom index setter
 template<typename PacketType>
-IndexAllocator<PacketType>* create_index_allocator(
+FunctionIndexAllocator<PacketType>* create_index_allocator(
     sc_module_name name,
     unsigned int max_index,
     std::function<void(PacketType&, unsigned int)> index_setter) {
     
-    return new IndexAllocator<PacketType>(name, max_index, index_setter);
+    return new FunctionIndexAllocator<PacketType>(name, max_index, index_setter);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef INDEX_BITMAP_H
+#define INDEX_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical free-index bitmap with O(levels) lowest-free lookup.
+// Level 0 holds one bit per index (1 = free); each higher level holds one bit
+// per lower-level word (1 = that word still has a free index). With 64-bit words
+// a 64K pool needs three levels, so a lookup is three count-trailing-zeros steps.
+class IndexBitmap {
+public:
+    explicit IndexBitmap(unsigned int size = 0) {
+        reset(size);
+    }
+
+    void reset(unsigned int size) {
+        m_size = size;
+        m_free_count = size;
+        m_levels.clear();
+
+        // Level 0: one bit per index
+        unsigned int bits = size;
+        do {
+            unsigned int words = (bits + 63) / 64;
+            m_levels.push_back(std::vector<uint64_t>(words, 0));
+            for (unsigned int i = 0; i < bits; ++i) {
+                m_levels.back()[i / 64] |= (uint64_t(1) << (i % 64));
+            }
+            bits = words;
+        } while (bits > 1);
+    }
+
+    unsigned int size() const { return m_size; }
+    unsigned int free_count() const { return m_free_count; }
+    unsigned int used_count() const { return m_size - m_free_count; }
+    bool empty() const { return m_free_count == 0; }
+
+    bool is_free(unsigned int index) const {
+        return index < m_size && (m_levels[0][index / 64] >> (index % 64)) & 1;
+    }
+
+    // Take the lowest free index; caller must check empty() first
+    unsigned int take_lowest() {
+        unsigned int word = 0;
+        for (std::size_t level = m_levels.size(); level-- > 0;) {
+            word = word * 64 + count_trailing_zeros(m_levels[level][word]);
+        }
+        clear_bit(word);
+        return word;
+    }
+
+    // Return an index to the pool; returns false if it was not allocated
+    bool release(unsigned int index) {
+        if (index >= m_size || is_free(index)) {
+            return false;
+        }
+        unsigned int position = index;
+        for (std::size_t level = 0; level < m_levels.size(); ++level) {
+            uint64_t& w = m_levels[level][position / 64];
+            bool was_empty = (w == 0);
+            w |= uint64_t(1) << (position % 64);
+            if (!was_empty) break;
+            position /= 64;
+        }
+        m_free_count++;
+        return true;
+    }
+
+private:
+    unsigned int m_size;
+    unsigned int m_free_count;
+    std::vector<std::vector<uint64_t>> m_levels;
+
+    static unsigned int count_trailing_zeros(uint64_t value) {
+        return static_cast<unsigned int>(__builtin_ctzll(value));
+    }
+
+    void clear_bit(unsigned int index) {
+        unsigned int position = index;
+        for (std::size_t level = 0; level < m_levels.size(); ++level) {
+            uint64_t& w = m_levels[level][position / 64];
+            w &= ~(uint64_t(1) << (position % 64));
+            if (w != 0) break;
+            position /= 64;
+        }
+        m_free_count--;
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// Fixed-memory log-linear (HDR-style) latency histogram over integer nanoseconds.
+// Values below 2^SUB_BUCKET_BITS get one bucket each; above that every power-of-two
+// range is split into 2^(SUB_BUCKET_BITS-1) equal sub-buckets, so a bucket's width is
+// below 1/128 of its value. Values up to 2^MAX_VALUE_BITS ns (~18 minutes) are resolved;
+// larger ones land in the last bucket (max() stays exact).
+// Histograms of the same layout merge by adding counts, and percentile queries are a
+// single pass over the buckets.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 8;
+    static const int MAX_VALUE_BITS = 40;
+    static const uint64_t LINEAR_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static const uint64_t HALF_BUCKETS = LINEAR_BUCKETS / 2;
+    static const size_t NUM_BUCKETS = LINEAR_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * HALF_BUCKETS;
+
+    LatencyHistogram() : m_counts(NUM_BUCKETS, 0) {
+        reset();
+    }
+
+    void reset() {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_count = 0;
+        m_sum_ns = 0.0;
+        m_sum_sq_ns = 0.0;
+        m_min_ns = UINT64_MAX;
+        m_max_ns = 0;
+    }
+
+    void record(uint64_t value_ns, uint64_t occurrences = 1) {
+        m_counts[bucket_index(value_ns)] += occurrences;
+        m_count += occurrences;
+        double value = static_cast<double>(value_ns);
+        m_sum_ns += value * occurrences;
+        m_sum_sq_ns += value * value * occurrences;
+        m_min_ns = std::min(m_min_ns, value_ns);
+        m_max_ns = std::max(m_max_ns, value_ns);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_sum_ns += other.m_sum_ns;
+        m_sum_sq_ns += other.m_sum_sq_ns;
+        m_min_ns = std::min(m_min_ns, other.m_min_ns);
+        m_max_ns = std::max(m_max_ns, other.m_max_ns);
+    }
+
+    uint64_t count() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    uint64_t min() const { return m_count > 0 ? m_min_ns : 0; }
+    uint64_t max() const { return m_max_ns; }
+    double mean() const { return m_count > 0 ? m_sum_ns / m_count : 0.0; }
+
+    // Sample standard deviation (exact: kept from running sums, not from buckets)
+    double stddev() const {
+        if (m_count <= 1) return 0.0;
+        double mean_ns = mean();
+        double variance = (m_sum_sq_ns - m_count * mean_ns * mean_ns) / (m_count - 1);
+        return (variance > 0.0) ? std::sqrt(variance) : 0.0;
+    }
+
+    // Value at percentile (0-100): midpoint of the bucket holding the rank, clamped to [min, max]
+    double value_at_percentile(double percentile) const {
+        if (m_count == 0) return 0.0;
+        double clamped = std::min(std::max(percentile, 0.0), 100.0);
+        uint64_t rank = static_cast<uint64_t>(std::ceil(clamped / 100.0 * m_count));
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                double value = bucket_lower(i) + (bucket_width(i) - 1) / 2.0;
+                return std::min(std::max(value, static_cast<double>(m_min_ns)), static_cast<double>(m_max_ns));
+            }
+        }
+        return static_cast<double>(m_max_ns);
+    }
+
+    size_t memory_bytes() const { return sizeof(*this) + m_counts.size() * sizeof(uint64_t); }
+
+    static size_t bucket_index(uint64_t value_ns) {
+        if (value_ns < LINEAR_BUCKETS) {
+            return static_cast<size_t>(value_ns);
+        }
+        int msb = 63 - __builtin_clzll(value_ns);
+        if (msb >= MAX_VALUE_BITS) {
+            return NUM_BUCKETS - 1;
+        }
+        int shift = msb - SUB_BUCKET_BITS + 1;
+        uint64_t mantissa = (value_ns >> shift) - HALF_BUCKETS;
+        return static_cast<size_t>(LINEAR_BUCKETS + (shift - 1) * HALF_BUCKETS + mantissa);
+    }
+
+    static uint64_t bucket_lower(size_t index) {
+        if (index < LINEAR_BUCKETS) {
+            return index;
+        }
+        uint64_t shift = (index - LINEAR_BUCKETS) / HALF_BUCKETS + 1;
+        uint64_t mantissa = (index - LINEAR_BUCKETS) % HALF_BUCKETS;
+        return (HALF_BUCKETS + mantissa) << shift;
+    }
+
+    static uint64_t bucket_width(size_t index) {
+        if (index < LINEAR_BUCKETS) {
+            return 1;
+        }
+        return uint64_t(1) << ((index - LINEAR_BUCKETS) / HALF_BUCKETS + 1);
+    }
+
+private:
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count;
+    double m_sum_ns;
+    double m_sum_sq_ns;
+    uint64_t m_min_ns;
+    uint64_t m_max_ns;
+};
+
+#endif
@@ -3,12 +3,17 @@
 
 #include <systemc.h>
 #include <memory>
-#include <array>
 #include <functional>
+#include <type_traits>
 #include <random>
 #include <algorithm>
 #include <iomanip>
+#include <cstring>
 #include "common/error_handling.h"
+#include "common/process_style.h"
+#include "common/tlm_support.h"
+#include "common/random.h"
+#include "base/memory_store.h"
 
 // Memory entry structure - can be customized per use case
 template<typename DataType>
@@ -20,17 +25,74 @@ struct MemoryEntry {
     MemoryEntry() : data{}, databyte(0), valid(false) {}
 };
 
-// Template-based Memory that works with any packet type
-template<typename PacketType, typename DataType = int, size_t MemorySize = 256>
+// Packet access policies for Memory. The policy is a member of the module, so the
+// per-packet command/address/data accesses are plain inline calls on the policy.
+//
+// DirectMemoryAccess (default): calls the packet's own accessor methods, which is every
+// BasePacket-derived type. Costs no std::function dispatch per access.
+template<typename PacketType, typename DataType>
+struct DirectMemoryAccess {
+    int get_command(const PacketType& p) const { return static_cast<int>(p.get_command()); }
+    // Packet addresses are signed 32-bit: a negative one sign-extends past every MemorySize
+    // and is rejected by check_address, so packets reach entries 0 to 2^31-1 (TLM: 64-bit)
+    uint64_t get_address(const PacketType& p) const { return static_cast<uint64_t>(static_cast<int64_t>(p.get_address())); }
+    DataType get_data(const PacketType& p) const { return static_cast<DataType>(p.get_data()); }
+    unsigned char get_databyte(const PacketType& p) const { return p.get_databyte(); }
+    void set_data(PacketType& p, DataType data) const { p.set_data(static_cast<int>(data)); }
+    void set_databyte(PacketType& p, unsigned char databyte) const { p.set_databyte(databyte); }
+};
+
+// FunctionMemoryAccess: runtime accessor functions, for packet types without the
+// standard methods (see the accessor-function constructor and create_memory)
+template<typename PacketType, typename DataType>
+struct FunctionMemoryAccess {
+    std::function<int(const PacketType&)> m_get_command;
+    std::function<uint64_t(const PacketType&)> m_get_address;
+    std::function<DataType(const PacketType&)> m_get_data;
+    std::function<unsigned char(const PacketType&)> m_get_databyte;
+    std::function<void(PacketType&, DataType)> m_set_data;
+    std::function<void(PacketType&, unsigned char)> m_set_databyte;
+    
+    FunctionMemoryAccess(std::function<int(const PacketType&)> get_command,
+                         std::function<uint64_t(const PacketType&)> get_address,
+                         std::function<DataType(const PacketType&)> get_data,
+                         std::function<unsigned char(const PacketType&)> get_databyte,
+                         std::function<void(PacketType&, DataType)> set_data,
+                         std::function<void(PacketType&, unsigned char)> set_databyte)
+        : m_get_command(get_command), m_get_address(get_address), m_get_data(get_data),
+          m_get_databyte(get_databyte), m_set_data(set_data), m_set_databyte(set_databyte) {}
+    
+    int get_command(const PacketType& p) const { return m_get_command(p); }
+    uint64_t get_address(const PacketType& p) const { return m_get_address(p); }
+    DataType get_data(const PacketType& p) const { return m_get_data(p); }
+    unsigned char get_databyte(const PacketType& p) const { return m_get_databyte(p); }
+    void set_data(PacketType& p, DataType data) const { m_set_data(p, data); }
+    void set_databyte(PacketType& p, unsigned char databyte) const { m_set_databyte(p, databyte); }
+};
+
+// Template-based Memory that works with any packet type.
+// MemorySize is the number of DataType entries; addresses are 64-bit entry indices.
+// FIXED_ARRAY backing holds all entries in arrays; PAGED backing maps 4K-entry pages on
+// first write, so MemorySize can describe a multi-GB space of which only the working set costs memory.
+// Access selects how packet fields are read and written (DirectMemoryAccess / FunctionMemoryAccess).
+template<typename PacketType, typename DataType = int, size_t MemorySize = 256,
+         MemoryBacking Backing = MemoryBacking::FIXED_ARRAY,
+         typename Access = DirectMemoryAccess<PacketType, DataType>>
 SC_MODULE(Memory) {
     SC_HAS_PROCESS(Memory);
     
     // Template-based SystemC ports
     sc_fifo_in<std::shared_ptr<PacketType>> in;
     sc_fifo_out<std::shared_ptr<PacketType>> release_out; // For sending processed packets back to IndexAllocator
+    
+    // TLM-2.0 target (alternative to the fifo path). Byte-addressed view of the data array:
+    // entry i occupies bytes [i * sizeof(DataType), (i + 1) * sizeof(DataType)).
+    // DMI covers the whole array (FIXED_ARRAY) or the page holding the address (PAGED).
+    TlmTargetSocket<Memory> tlm_socket;
 
     // Memory configuration
     static constexpr size_t MEMORY_SIZE = MemorySize;
+    static constexpr MemoryBacking BACKING = Backing;
     const bool m_debug_enable;
     
     // Delay parameters
@@ -39,16 +101,11 @@ SC_MODULE(Memory) {
     const double m_mean_delay_ns;
     const double m_stddev_delay_ns;
     
-    // Accessor functions for packet attributes
-    std::function<int(const PacketType&)> m_get_command;
-    std::function<int(const PacketType&)> m_get_address;
-    std::function<DataType(const PacketType&)> m_get_data;
-    std::function<unsigned char(const PacketType&)> m_get_databyte;
-    std::function<void(PacketType&, DataType)> m_set_data;
-    std::function<void(PacketType&, unsigned char)> m_set_databyte;
+    // Packet field access policy
+    Access m_access;
     
     // Random number generation for normal distribution
-    mutable std::mt19937 m_rng;
+    mutable RandomStream m_rng;
     mutable std::normal_distribution<double> m_normal_dist;
     
     // Memory operation types (customizable)
@@ -68,15 +125,12 @@ SC_MODULE(Memory) {
                 continue;
             }
             
-            // Get packet attributes using accessor functions
-            int command = m_get_command(*packet);
-            int address = m_get_address(*packet);
+            // Get packet attributes through the access policy
+            int command = m_access.get_command(*packet);
+            uint64_t address = m_access.get_address(*packet);
             
             // Bounds checking
-            if (address < 0 || static_cast<size_t>(address) >= MEMORY_SIZE) {
-                SOC_SIM_ERROR("Memory", soc_sim::error::codes::ADDRESS_OUT_OF_BOUNDS,
-                             "Address out of bounds: " + std::to_string(address) + 
-                             " (valid range: 0-" + std::to_string(MEMORY_SIZE-1) + ")");
+            if (!check_address(address)) {
                 continue;
             }
             
@@ -87,121 +141,138 @@ SC_MODULE(Memory) {
             }
             
             // Process memory operation
-            if (command == static_cast<int>(MemoryCommand::WRITE)) {
-                DataType data = m_get_data(*packet);
-                unsigned char databyte = m_get_databyte(*packet);
-                
-                mem[address].data = data;
-                mem[address].databyte = databyte;
-                mem[address].valid = true;
-                
-                if (m_debug_enable) {
-                    std::cout << sc_time_stamp() << " | Memory: Received WRITE, " 
-                              << *packet << " (delay=" << std::fixed << std::setprecision(1) << delay_ns << "ns)" << std::endl;
-                }
-                          
-            } else if (command == static_cast<int>(MemoryCommand::READ)) {
-                if (mem[address].valid) {
-                    m_set_data(*packet, mem[address].data);
-                    m_set_databyte(*packet, mem[address].databyte);
-                } else {
-                    // Return default values for uninitialized memory
-                    m_set_data(*packet, DataType{});
-                    m_set_databyte(*packet, 0);
-                }
-                
-                if (m_debug_enable) {
-                    std::cout << sc_time_stamp() << " | Memory: Received READ, " 
-                              << *packet << " (delay=" << std::fixed << std::setprecision(1) << delay_ns << "ns)" << std::endl;
-                }
-            } else {
-                SOC_SIM_ERROR("Memory", soc_sim::error::codes::INVALID_PACKET_TYPE,
-                             "Unknown command: " + std::to_string(command));
-            }
+            perform_operation(*packet, command, address, delay_ns);
             
             // Send processed packet to release path for index deallocation
             release_out.write(packet);
         }
     }
+    
+    // SC_METHOD version of run (same read -> delay -> access -> release timing)
+    // Event-triggered: nb_read/nb_write are only attempted when the fifo signalled a change
+    void run_method() {
+        while (true) {
+            switch (m_method_state) {
+                case MethodStageState::READ: {
+                    if (!in.nb_read(m_method_packet)) {
+                        next_trigger(in.data_written_event());
+                        return;
+                    }
+                    if (!m_method_packet) {
+                        SOC_SIM_ERROR("Memory", soc_sim::error::codes::INVALID_PACKET_TYPE, 
+                                     "Received null packet");
+                        continue;
+                    }
+                    if (!check_address(m_access.get_address(*m_method_packet))) {
+                        m_method_packet.reset();
+                        continue;
+                    }
+                    m_method_state = MethodStageState::DELAY;
+                    m_method_delay_ns = generate_delay();
+                    if (m_method_delay_ns > 0.0) {
+                        next_trigger(m_method_delay_ns, SC_NS);
+                        return;
+                    }
+                    // No delay - access immediately
+                    continue;
+                }
+                    
+                case MethodStageState::DELAY:
+                    perform_operation(*m_method_packet, m_access.get_command(*m_method_packet),
+                                      m_access.get_address(*m_method_packet), m_method_delay_ns);
+                    m_method_state = MethodStageState::WRITE;
+                    // fall through
+                    
+                case MethodStageState::WRITE:
+                    // Send processed packet to release path for index deallocation
+                    if (!release_out.nb_write(m_method_packet)) {
+                        next_trigger(release_out.data_read_event());
+                        return;
+                    }
+                    m_method_packet.reset();
+                    m_method_state = MethodStageState::READ;
+                    break;
+            }
+        }
+    }
 
-    // Constructor with custom accessor functions
+    // Constructor with custom accessor functions (Access = FunctionMemoryAccess)
     Memory(sc_module_name name,
            std::function<int(const PacketType&)> get_command,
-           std::function<int(const PacketType&)> get_address,
+           std::function<uint64_t(const PacketType&)> get_address,
            std::function<DataType(const PacketType&)> get_data,
            std::function<unsigned char(const PacketType&)> get_databyte,
            std::function<void(PacketType&, DataType)> set_data,
            std::function<void(PacketType&, unsigned char)> set_databyte,
            bool debug_enable = false,
            double min_delay_ns = 0.0,
-           double max_delay_ns = 0.0)
+           double max_delay_ns = 0.0,
+           ProcessStyle process_style = ProcessStyle::THREAD)
         : sc_module(name),
           m_debug_enable(debug_enable),
           m_min_delay_ns(min_delay_ns),
           m_max_delay_ns(max_delay_ns),
           m_mean_delay_ns((min_delay_ns + max_delay_ns) / 2.0),
           m_stddev_delay_ns((max_delay_ns > min_delay_ns) ? (max_delay_ns - min_delay_ns) / 6.0 : 0.0),
-          m_get_command(get_command),
-          m_get_address(get_address),
-          m_get_data(get_data),
-          m_get_databyte(get_databyte),
-          m_set_data(set_data),
-          m_set_databyte(set_databyte),
-          m_rng(std::random_device{}()),
-          m_normal_dist(0.0, 1.0) {
+          m_access(get_command, get_address, get_data, get_databyte, set_data, set_databyte),
+          m_rng(RandomService::stream(this->name())),
+          m_normal_dist(0.0, 1.0),
+          m_process_style(process_style),
+          m_method_state(MethodStageState::READ),
+          m_method_delay_ns(0.0) {
         
         // Initialize memory
-        for (size_t i = 0; i < MEMORY_SIZE; ++i) {
-            mem[i] = MemoryEntry<DataType>();
-        }
+        clear_memory();
         
         if (m_debug_enable && m_max_delay_ns > 0.0) {
             std::cout << "0 s | " << basename() << ": Memory delay range: " 
                       << m_min_delay_ns << " - " << m_max_delay_ns << " ns (normal distribution)" << std::endl;
         }
         
-        SC_THREAD(run);
+        start_process();
+        register_tlm_socket();
     }
     
     // Constructor for types with standard accessor methods
-    Memory(sc_module_name name, bool debug_enable = false, double min_delay_ns = 0.0, double max_delay_ns = 0.0) 
+    Memory(sc_module_name name, bool debug_enable = false, double min_delay_ns = 0.0, double max_delay_ns = 0.0,
+           ProcessStyle process_style = ProcessStyle::THREAD) 
         : sc_module(name), 
           m_debug_enable(debug_enable),
           m_min_delay_ns(min_delay_ns),
           m_max_delay_ns(max_delay_ns),
           m_mean_delay_ns((min_delay_ns + max_delay_ns) / 2.0),
           m_stddev_delay_ns((max_delay_ns > min_delay_ns) ? (max_delay_ns - min_delay_ns) / 6.0 : 0.0),
-          m_rng(std::random_device{}()),
-          m_normal_dist(0.0, 1.0) {
-        // Set up default accessors for types with standard methods
-        m_get_command = [](const PacketType& p) { return static_cast<int>(p.get_command()); };
-        m_get_address = [](const PacketType& p) { return p.get_address(); };
-        m_get_data = [](const PacketType& p) { return static_cast<DataType>(p.get_data()); };
-        m_get_databyte = [](const PacketType& p) { return p.get_databyte(); };
-        m_set_data = [](PacketType& p, DataType data) { p.set_data(static_cast<int>(data)); };
-        m_set_databyte = [](PacketType& p, unsigned char databyte) { p.set_databyte(databyte); };
-        
+          m_rng(RandomService::stream(this->name())),
+          m_normal_dist(0.0, 1.0),
+          m_process_style(process_style),
+          m_method_state(MethodStageState::READ),
+          m_method_delay_ns(0.0) {
         // Initialize memory
-        for (size_t i = 0; i < MEMORY_SIZE; ++i) {
-            mem[i] = MemoryEntry<DataType>();
-        }
+        clear_memory();
         
         if (m_debug_enable && m_max_delay_ns > 0.0) {
             std::cout << "0 s | " << basename() << ": Memory delay range: " 
                       << m_min_delay_ns << " - " << m_max_delay_ns << " ns (normal distribution)" << std::endl;
         }
         
-        SC_THREAD(run);
+        start_process();
+        register_tlm_socket();
     }
 
     // Memory access methods for testing/debugging
-    const MemoryEntry<DataType>& get_memory_entry(size_t address) const {
-        return mem[address];
+    MemoryEntry<DataType> get_memory_entry(uint64_t address) const {
+        MemoryEntry<DataType> entry;
+        if (address < MEMORY_SIZE) {
+            entry.data = m_store.get_data(address);
+            entry.databyte = m_store.get_databyte(address);
+            entry.valid = m_store.is_valid(address);
+        }
+        return entry;
     }
     
-    void set_memory_entry(size_t address, const MemoryEntry<DataType>& entry) {
+    void set_memory_entry(uint64_t address, const MemoryEntry<DataType>& entry) {
         if (address < MEMORY_SIZE) {
-            mem[address] = entry;
+            m_store.write(address, entry.data, entry.databyte, entry.valid);
         }
     }
     
@@ -209,15 +280,141 @@ SC_MODULE(Memory) {
     size_t get_memory_size() const { return MEMORY_SIZE; }
     
     size_t count_valid_entries() const {
-        size_t count = 0;
-        for (const auto& entry : mem) {
-            if (entry.valid) count++;
+        return m_store.count_valid();
+    }
+    
+    // Backing store usage (PAGED: pages mapped so far)
+    size_t get_mapped_pages() const { return m_store.mapped_pages(); }
+    size_t get_store_footprint_bytes() const { return m_store.footprint_bytes(); }
+    
+    // ---- TLM-2.0 target interface ----
+    static constexpr uint64_t TLM_SIZE_BYTES = static_cast<uint64_t>(MEMORY_SIZE) * sizeof(DataType);
+    
+    // Functional access; the mean access delay is annotated instead of waited
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        if (!tlm_access(trans)) {
+            return;
         }
-        return count;
+        delay += sc_time(m_mean_delay_ns, SC_NS);
+        trans.set_dmi_allowed(true);
+    }
+    
+    // Direct pointer to the data array, read-only: a DMI write would bypass the per-entry
+    // valid/databyte bookkeeping the FIFO READ path relies on, so writes go through b_transport
+    bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi_data) {
+        if (trans.get_address() >= TLM_SIZE_BYTES) {
+            return false;
+        }
+        uint64_t start = 0;
+        uint64_t end = 0;
+        dmi_data.set_dmi_ptr(m_store.dmi_region(trans.get_address(), start, end));
+        dmi_data.set_start_address(start);
+        dmi_data.set_end_address(std::min(end, TLM_SIZE_BYTES - 1));
+        dmi_data.set_read_latency(sc_time(m_mean_delay_ns, SC_NS));
+        dmi_data.allow_read();
+        return true;
+    }
+    
+    unsigned int transport_dbg(tlm::tlm_generic_payload& trans) {
+        return tlm_access(trans) ? trans.get_data_length() : 0;
     }
 
 private:
-    std::array<MemoryEntry<DataType>, MEMORY_SIZE> mem;
+    typedef typename std::conditional<Backing == MemoryBacking::PAGED,
+                                      PagedMemoryStore<DataType>,
+                                      FixedMemoryStore<DataType, MemorySize>>::type Store;
+    Store m_store;
+    
+    // Process style and SC_METHOD state
+    const ProcessStyle m_process_style;
+    MethodStageState m_method_state;
+    std::shared_ptr<PacketType> m_method_packet;
+    double m_method_delay_ns;
+    
+    void clear_memory() {
+        m_store.clear();
+    }
+    
+    void register_tlm_socket() {
+        tlm_socket.register_b_transport(this, &Memory::b_transport);
+        tlm_socket.register_get_direct_mem_ptr(this, &Memory::get_direct_mem_ptr);
+        tlm_socket.register_transport_dbg(this, &Memory::transport_dbg);
+    }
+    
+    // Shared by b_transport and transport_dbg: bounds check and copy
+    bool tlm_access(tlm::tlm_generic_payload& trans) {
+        if (trans.get_command() == tlm::TLM_IGNORE_COMMAND) {
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            return true;
+        }
+        if (!tlm_check_payload(trans, TLM_SIZE_BYTES)) {
+            return false;
+        }
+        
+        uint64_t offset = trans.get_address();
+        unsigned int length = trans.get_data_length();
+        
+        if (trans.get_command() == tlm::TLM_WRITE_COMMAND) {
+            m_store.write_bytes(offset, trans.get_data_ptr(), length);
+        } else {
+            m_store.read_bytes(offset, trans.get_data_ptr(), length);
+        }
+        
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+        return true;
+    }
+    
+    void start_process() {
+        if (m_process_style == ProcessStyle::METHOD) {
+            SC_METHOD(run_method);
+        } else {
+            SC_THREAD(run);
+        }
+    }
+    
+    bool check_address(uint64_t address) const {
+        if (static_cast<int64_t>(address) < 0) {
+            SOC_SIM_ERROR("Memory", soc_sim::error::codes::ADDRESS_OUT_OF_BOUNDS,
+                         "Negative packet address: " + std::to_string(static_cast<int64_t>(address)));
+            return false;
+        }
+        if (address >= MEMORY_SIZE) {
+            SOC_SIM_ERROR("Memory", soc_sim::error::codes::ADDRESS_OUT_OF_BOUNDS,
+                         "Address out of bounds: " + std::to_string(address) + 
+                         " (valid range: 0-" + std::to_string(MEMORY_SIZE-1) + ")");
+            return false;
+        }
+        return true;
+    }
+    
+    void perform_operation(PacketType& packet, int command, uint64_t address, double delay_ns) {
+        if (command == static_cast<int>(MemoryCommand::WRITE)) {
+            m_store.write(address, m_access.get_data(packet), m_access.get_databyte(packet));
+            
+            if (m_debug_enable) {
+                std::cout << sc_time_stamp() << " | Memory: Received WRITE, " 
+                          << packet << " (delay=" << std::fixed << std::setprecision(1) << delay_ns << "ns)" << std::endl;
+            }
+                      
+        } else if (command == static_cast<int>(MemoryCommand::READ)) {
+            if (m_store.is_valid(address)) {
+                m_access.set_data(packet, m_store.get_data(address));
+                m_access.set_databyte(packet, m_store.get_databyte(address));
+            } else {
+                // Return default values for uninitialized memory
+                m_access.set_data(packet, DataType{});
+                m_access.set_databyte(packet, 0);
+            }
+            
+            if (m_debug_enable) {
+                std::cout << sc_time_stamp() << " | Memory: Received READ, " 
+                          << packet << " (delay=" << std::fixed << std::setprecision(1) << delay_ns << "ns)" << std::endl;
+            }
+        } else {
+            SOC_SIM_ERROR("Memory", soc_sim::error::codes::INVALID_PACKET_TYPE,
+                         "Unknown command: " + std::to_string(command));
+        }
+    }
     
     // Generate delay using normal distribution
     double generate_delay() const {
@@ -235,19 +432,26 @@ private:
 using BasePacketMemory = Memory<BasePacket, int, 256>;
 using IntMemory256 = Memory<BasePacket, int, 256>;
 using FloatMemory1K = Memory<BasePacket, float, 1024>;
+using SparseIntMemory16G = Memory<BasePacket, int, (size_t(1) << 32), MemoryBacking::PAGED>;  // 4G entries, 16 GB (packets: lower 2G)
+
+// Memory driven by runtime accessor functions (custom packet types)
+template<typename PacketType, typename DataType = int, size_t MemorySize = 256,
+         MemoryBacking Backing = MemoryBacking::FIXED_ARRAY>
+using FunctionAccessMemory = Memory<PacketType, DataType, MemorySize, Backing,
+                                    FunctionMemoryAccess<PacketType, DataType>>;
 
 // Helper function to create Memory with custom accessors
 template<typename PacketType, typename DataType = int, size_t MemorySize = 256>
-Memory<PacketType, DataType, MemorySize>* create_memory(
+FunctionAccessMemory<PacketType, DataType, MemorySize>* create_memory(
     sc_module_name name,
     std::function<int(const PacketType&)> get_command,
-    std::function<int(const PacketType&)> get_address,
+    std::function<uint64_t(const PacketType&)> get_address,
     std::function<DataType(const PacketType&)> get_data,
     std::function<unsigned char(const PacketType&)> get_databyte,
     std::function<void(PacketType&, DataType)> set_data,
     std::function<void(PacketType&, unsigned char)> set_databyte) {
     
-    return new Memory<PacketType, DataType, MemorySize>(
+    return new FunctionAccessMemory<PacketType, DataType, MemorySize>(
         name, get_command, get_address, get_data, get_databyte, set_data, set_databyte);
 }
 
@@ -0,0 +1,208 @@
+#ifndef MEMORY_STORE_H
+#define MEMORY_STORE_H
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+
+// Backing store selection for the Memory template
+enum class MemoryBacking {
+    FIXED_ARRAY,   // Whole address space in fixed arrays (fast path for small memories)
+    PAGED          // Fixed-size pages mapped on first write (sparse, multi-GB address spaces)
+};
+
+// Fixed backing store: one array per field, so the data array is one contiguous DMI region.
+// Entries are addressed with 64-bit indices; callers bounds-check against Entries.
+template<typename DataType, size_t Entries>
+class FixedMemoryStore {
+public:
+    void clear() {
+        m_data.fill(DataType{});
+        m_databyte.fill(0);
+        m_valid.fill(false);
+    }
+
+    bool is_valid(uint64_t index) const { return m_valid[index]; }
+    DataType get_data(uint64_t index) const { return m_data[index]; }
+    unsigned char get_databyte(uint64_t index) const { return m_databyte[index]; }
+
+    void write(uint64_t index, DataType data, unsigned char databyte, bool valid = true) {
+        m_data[index] = data;
+        m_databyte[index] = databyte;
+        m_valid[index] = valid;
+    }
+
+    size_t count_valid() const {
+        size_t count = 0;
+        for (bool valid : m_valid) {
+            if (valid) count++;
+        }
+        return count;
+    }
+
+    // Byte view of the data array (offset in bytes); writes mark the touched entries valid
+    void read_bytes(uint64_t offset, unsigned char* dst, size_t length) const {
+        std::memcpy(dst, reinterpret_cast<const unsigned char*>(m_data.data()) + offset, length);
+    }
+
+    void write_bytes(uint64_t offset, const unsigned char* src, size_t length) {
+        std::memcpy(reinterpret_cast<unsigned char*>(m_data.data()) + offset, src, length);
+        if (length > 0) {
+            for (uint64_t i = offset / sizeof(DataType); i <= (offset + length - 1) / sizeof(DataType); ++i) {
+                m_valid[i] = true;
+            }
+        }
+    }
+
+    // Read-only DMI region holding byte offset: the whole data array
+    unsigned char* dmi_region(uint64_t offset, uint64_t& start, uint64_t& end) {
+        (void)offset;
+        start = 0;
+        end = static_cast<uint64_t>(Entries) * sizeof(DataType) - 1;
+        return reinterpret_cast<unsigned char*>(m_data.data());
+    }
+
+    size_t mapped_pages() const { return 1; }
+    size_t footprint_bytes() const { return sizeof(*this); }
+
+private:
+    std::array<DataType, Entries> m_data;
+    std::array<unsigned char, Entries> m_databyte;
+    std::array<bool, Entries> m_valid;
+};
+
+// Sparse backing store: the address space is split into pages of PageEntries entries,
+// allocated on first write and found through a hash-map page table (with a one-entry
+// cache for the last page touched). Unmapped pages read as DataType{} / invalid.
+// DMI is granted per page, mapping it on demand.
+template<typename DataType, size_t PageEntries = 4096>
+class PagedMemoryStore {
+    static_assert((PageEntries & (PageEntries - 1)) == 0, "PagedMemoryStore: PageEntries must be a power of two");
+
+public:
+    static const uint64_t PAGE_BYTES = static_cast<uint64_t>(PageEntries) * sizeof(DataType);
+
+    PagedMemoryStore() : m_last_page_number(~0ULL), m_last_page(nullptr) {}
+
+    void clear() {
+        m_pages.clear();
+        m_last_page_number = ~0ULL;
+        m_last_page = nullptr;
+    }
+
+    bool is_valid(uint64_t index) const {
+        const Page* page = find_page(index / PageEntries);
+        return page && page->valid[index % PageEntries];
+    }
+
+    DataType get_data(uint64_t index) const {
+        const Page* page = find_page(index / PageEntries);
+        return page ? page->data[index % PageEntries] : DataType{};
+    }
+
+    unsigned char get_databyte(uint64_t index) const {
+        const Page* page = find_page(index / PageEntries);
+        return page ? page->databyte[index % PageEntries] : 0;
+    }
+
+    void write(uint64_t index, DataType data, unsigned char databyte, bool valid = true) {
+        Page& page = map_page(index / PageEntries);
+        size_t slot = index % PageEntries;
+        page.valid_count += static_cast<size_t>(valid) - static_cast<size_t>(page.valid[slot]);
+        page.data[slot] = data;
+        page.databyte[slot] = databyte;
+        page.valid[slot] = valid;
+    }
+
+    size_t count_valid() const {
+        size_t count = 0;
+        for (const auto& entry : m_pages) {
+            count += entry.second->valid_count;
+        }
+        return count;
+    }
+
+    void read_bytes(uint64_t offset, unsigned char* dst, size_t length) const {
+        while (length > 0) {
+            uint64_t in_page = offset % PAGE_BYTES;
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(length, PAGE_BYTES - in_page));
+            const Page* page = find_page(offset / PAGE_BYTES);
+            if (page) {
+                std::memcpy(dst, reinterpret_cast<const unsigned char*>(page->data) + in_page, chunk);
+            } else {
+                std::memset(dst, 0, chunk);
+            }
+            offset += chunk;
+            dst += chunk;
+            length -= chunk;
+        }
+    }
+
+    void write_bytes(uint64_t offset, const unsigned char* src, size_t length) {
+        while (length > 0) {
+            uint64_t in_page = offset % PAGE_BYTES;
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(length, PAGE_BYTES - in_page));
+            Page& page = map_page(offset / PAGE_BYTES);
+            std::memcpy(reinterpret_cast<unsigned char*>(page.data) + in_page, src, chunk);
+            for (uint64_t slot = in_page / sizeof(DataType); slot <= (in_page + chunk - 1) / sizeof(DataType); ++slot) {
+                page.valid_count += !page.valid[slot];
+                page.valid[slot] = true;
+            }
+            offset += chunk;
+            src += chunk;
+            length -= chunk;
+        }
+    }
+
+    // Read-only DMI region holding byte offset: its page, mapped if needed (an unmapped
+    // page reads as zeros, as through read_bytes)
+    unsigned char* dmi_region(uint64_t offset, uint64_t& start, uint64_t& end) {
+        uint64_t page_number = offset / PAGE_BYTES;
+        start = page_number * PAGE_BYTES;
+        end = start + PAGE_BYTES - 1;
+        return reinterpret_cast<unsigned char*>(map_page(page_number).data);
+    }
+
+    size_t mapped_pages() const { return m_pages.size(); }
+    size_t footprint_bytes() const { return sizeof(*this) + m_pages.size() * (sizeof(Page) + 2 * sizeof(void*)); }
+
+private:
+    struct Page {
+        DataType data[PageEntries];
+        unsigned char databyte[PageEntries];
+        bool valid[PageEntries];
+        size_t valid_count;
+
+        Page() : data(), databyte(), valid(), valid_count(0) {}
+    };
+
+    const Page* find_page(uint64_t page_number) const {
+        if (page_number == m_last_page_number) return m_last_page;
+        auto it = m_pages.find(page_number);
+        if (it == m_pages.end()) return nullptr;
+        m_last_page_number = page_number;
+        m_last_page = it->second.get();
+        return m_last_page;
+    }
+
+    Page& map_page(uint64_t page_number) {
+        if (page_number != m_last_page_number || !m_last_page) {
+            std::unique_ptr<Page>& slot = m_pages[page_number];
+            if (!slot) {
+                slot.reset(new Page());
+            }
+            m_last_page_number = page_number;
+            m_last_page = slot.get();
+        }
+        return *m_last_page;
+    }
+
+    std::unordered_map<uint64_t, std::unique_ptr<Page>> m_pages;
+    mutable uint64_t m_last_page_number;
+    mutable Page* m_last_page;
+};
+
+#endif
@@ -3,13 +3,19 @@
 
 #include <systemc.h>
 #include <memory>
-#include <array>
 #include <vector>
 #include <random>
 #include <algorithm>
 #include <iomanip>
+#include <deque>
 #include "packet/flash_packet.h"
 #include "common/error_handling.h"
+#include "base/delay_pipeline.h"
+#include "common/stats_registry.h"
+#include "common/partition_executor.h"
+#include "common/checkpoint.h"
+#include "common/random.h"
+#include "common/self_profiler.h"
 
 // NAND Flash timing parameters (in nanoseconds)
 struct FlashTimingParams {
@@ -37,31 +43,176 @@ struct FlashTimingParams {
     }
 };
 
-// Page state enumeration
+// Page state enumeration (2-bit encoded in NandBlockStore; CLEAN must stay 0)
 enum class PageState {
-    CLEAN,      // Erased, ready for program
+    CLEAN = 0,  // Erased, ready for program
     PROGRAMMED, // Contains valid data
     INVALID     // Contains invalid/old data
 };
 
-// Block state structure
-struct FlashBlock {
-    std::vector<PageState> pages;
-    uint32_t erase_count;
-    bool is_bad_block;
+// Compact NAND state store: 2 bits of PageState per page, allocated per block on its
+// first program (an unallocated block reads as all CLEAN and costs one pointer).
+// Erase counts and bad-block flags are dense per-block arrays, so a TB-scale geometry
+// only pays for the blocks it has actually written.
+class NandBlockStore {
+public:
+    NandBlockStore(size_t num_blocks, size_t pages_per_block)
+        : m_pages_per_block(pages_per_block),
+          m_words_per_block((pages_per_block + PAGES_PER_WORD - 1) / PAGES_PER_WORD),
+          m_pages(num_blocks),
+          m_erase_counts(num_blocks, 0),
+          m_bad_blocks(num_blocks, 0),
+          m_allocated_blocks(0) {}
     
-    // Default constructor for array initialization
-    FlashBlock() : pages(128, PageState::CLEAN), erase_count(0), is_bad_block(false) {}
+    size_t num_blocks() const { return m_erase_counts.size(); }
+    size_t pages_per_block() const { return m_pages_per_block; }
     
-    FlashBlock(size_t pages_per_block) 
-        : pages(pages_per_block, PageState::CLEAN), erase_count(0), is_bad_block(false) {}
+    PageState get_page(size_t block, size_t page) const {
+        const uint64_t* words = m_pages[block].get();
+        if (!words || page >= m_pages_per_block) return PageState::CLEAN;
+        return static_cast<PageState>((words[page / PAGES_PER_WORD] >> shift(page)) & 0x3);
+    }
+    
+    void set_page(size_t block, size_t page, PageState state) {
+        if (page >= m_pages_per_block) return;
+        if (!m_pages[block]) {
+            if (state == PageState::CLEAN) return;
+            m_pages[block].reset(new uint64_t[m_words_per_block]());  // Zero = all CLEAN
+            m_allocated_blocks++;
+        }
+        uint64_t& word = m_pages[block][page / PAGES_PER_WORD];
+        word = (word & ~(0x3ULL << shift(page))) | (static_cast<uint64_t>(state) << shift(page));
+    }
+    
+    // Every page becomes CLEAN again; the block's page storage is released
+    void erase(size_t block) {
+        if (m_pages[block]) {
+            m_pages[block].reset();
+            m_allocated_blocks--;
+        }
+        m_erase_counts[block]++;
+    }
+    
+    uint32_t get_erase_count(size_t block) const { return m_erase_counts[block]; }
+    bool is_bad(size_t block) const { return m_bad_blocks[block] != 0; }
+    void mark_bad(size_t block) { m_bad_blocks[block] = 1; }
+    
+    size_t allocated_blocks() const { return m_allocated_blocks; }
+    
+    // Checkpoint: geometry, then (block, page words) for written blocks only
+    void save(CheckpointWriter& writer) const {
+        writer.write(static_cast<uint64_t>(num_blocks()));
+        writer.write(static_cast<uint64_t>(m_pages_per_block));
+        writer.write(static_cast<uint64_t>(m_allocated_blocks));
+        for (size_t block = 0; block < m_pages.size(); block++) {
+            if (m_pages[block]) {
+                writer.write(static_cast<uint64_t>(block));
+                writer.write_bytes(m_pages[block].get(), m_words_per_block * sizeof(uint64_t));
+            }
+        }
+        writer.write_vector(m_erase_counts);
+        writer.write_vector(m_bad_blocks);
+    }
+    
+    bool restore(CheckpointReader& reader) {
+        uint64_t blocks = 0, pages_per_block = 0, allocated = 0;
+        if (!reader.read(blocks) || !reader.read(pages_per_block) || !reader.read(allocated)) return false;
+        if (blocks != num_blocks() || pages_per_block != m_pages_per_block || allocated > blocks) {
+            return reader.fail("NAND block store geometry differs from the checkpoint");
+        }
+        for (auto& pages : m_pages) {
+            pages.reset();
+        }
+        m_allocated_blocks = 0;
+        for (uint64_t i = 0; i < allocated; i++) {
+            uint64_t block = 0;
+            if (!reader.read(block)) return false;
+            if (block >= blocks || m_pages[block]) {
+                return reader.fail("NAND block store: bad block index " + std::to_string(block));
+            }
+            m_pages[block].reset(new uint64_t[m_words_per_block]);
+            m_allocated_blocks++;
+            if (!reader.read_bytes(m_pages[block].get(), m_words_per_block * sizeof(uint64_t))) return false;
+        }
+        return reader.read_vector(m_erase_counts, blocks) && reader.read_vector(m_bad_blocks, blocks);
+    }
+    
+    size_t footprint_bytes() const {
+        return m_pages.size() * sizeof(m_pages[0]) +
+               m_allocated_blocks * m_words_per_block * sizeof(uint64_t) +
+               m_erase_counts.size() * sizeof(uint32_t) + m_bad_blocks.size();
+    }
+    
+private:
+    static const size_t PAGES_PER_WORD = 32;  // 2 bits per page
+    
+    static unsigned int shift(size_t page) { return static_cast<unsigned int>((page % PAGES_PER_WORD) * 2); }
+    
+    const size_t m_pages_per_block;
+    const size_t m_words_per_block;
+    std::vector<std::unique_ptr<uint64_t[]>> m_pages;
+    std::vector<uint32_t> m_erase_counts;
+    std::vector<uint8_t> m_bad_blocks;
+    size_t m_allocated_blocks;
+};
+
+// Operation counters of one NAND device
+struct FlashDeviceCounters {
+    uint64_t reads;
+    uint64_t programs;
+    uint64_t erases;
+    uint64_t bad_blocks;
+    uint64_t multi_plane_operations;
+    
+    FlashDeviceCounters() : reads(0), programs(0), erases(0), bad_blocks(0), multi_plane_operations(0) {}
 };
 
-// Template-based NAND Flash controller
+// One flash operation: execute_operation() fills in the release times, errors and a
+// snapshot of the counters; apply_operation() hands them to the SystemC side.
+// The model side works in plain ns and never touches a packet the host can see:
+// sc_time construction and host packet writes happen in apply_operation().
+struct FlashOperationJob {
+    std::vector<std::shared_ptr<FlashPacket>> planes;
+    sc_time start;
+    double start_ns;
+    std::vector<std::pair<std::shared_ptr<FlashPacket>, double>> releases;   // Release time (ns)
+    std::vector<std::shared_ptr<FlashPacket>> clean_reads;                  // Reads of erased pages
+    std::vector<std::pair<const char*, std::string>> errors;
+    FlashDeviceCounters counters;
+    size_t allocated_blocks;
+    size_t footprint_bytes;
+    
+    // Debug report (formatted on the SystemC side)
+    double array_ns;
+    double done_ns;
+    bool success;
+    
+    // Partitioned execution
+    PartitionWorker::Ticket ticket;
+    sc_time join_time;
+    
+    FlashOperationJob() : start_ns(0.0), allocated_blocks(0), footprint_bytes(0), array_ns(0.0), done_ns(0.0), success(false), ticket(0) {}
+};
+
+// Template-based NAND Flash device for one channel.
+// The channel's dies share its I/O bus but run array operations (tR/tProg/tErase)
+// concurrently; a multi-plane operation costs one array time for all its planes.
+// Completion times are computed on arrival, and packets are released as they finish.
+//
+// Partitioned execution: with a PartitionWorker attached, the device model (page
+// states, die/bus timing, RNG) runs on the worker thread and the SystemC side joins
+// each operation channel_latency after its arrival. No release can be due earlier
+// than that, so the join is conservative and the schedule is the serial one. The
+// worker runs ahead across that window: operations are handed over in one batch
+// per half window (one job, one lock and one wake-up for all of them), and all
+// operations due by the same time are joined with one wait. Serial mode executes on arrival but joins the same way, so
+// releases and published statistics follow the same schedule in both modes.
 template<size_t NumPlanes = 4, size_t BlocksPerPlane = 1024, size_t PagesPerBlock = 128>
 SC_MODULE(NANDFlash) {
     SC_HAS_PROCESS(NANDFlash);
     
+    static const size_t PAGES_PER_FLASH_BLOCK = PagesPerBlock * 4 * 32;  // wl * ssl * pages_per_ssl
+    
     // SystemC ports
     sc_fifo_in<std::shared_ptr<FlashPacket>> in;
     sc_fifo_out<std::shared_ptr<FlashPacket>> release_out;
@@ -70,24 +221,61 @@ SC_MODULE(NANDFlash) {
     const bool m_debug_enable;
     const FlashTimingParams m_timing;
     const uint32_t m_max_pe_cycles;  // Maximum P/E cycles before failure
+    const uint32_t m_num_dies;       // Dies sharing this channel
+    sc_time m_channel_latency;       // Completion -> controller (lookahead in partitioned mode)
+    double m_channel_latency_ns;
+    
+    // Flash memory state, blocks indexed [die][plane][block]
+    NandBlockStore m_flash_memory;
     
-    // Flash memory structure: [plane][block]
-    std::array<std::array<FlashBlock, BlocksPerPlane>, NumPlanes> m_flash_memory;
+    // Resource timing (ns): each die's array and the shared channel bus
+    std::vector<double> m_die_free_ns;
+    double m_bus_free_ns;
+    TimedReleaseQueue<FlashPacket> m_release_queue;
     
     // Random number generation for timing variation
-    mutable std::mt19937 m_rng;
+    mutable RandomStream m_rng;
     mutable std::normal_distribution<double> m_timing_variation;
     
-    // Statistics
+    // Model-side counters (owned by the partition worker in partitioned mode)
+    FlashDeviceCounters m_model_counters;
+    FlashDeviceCounters m_baseline_counters;  // Counters of the restored checkpoint (preconditioning)
+    
+    // Partitioned execution
+    PartitionWorker* m_worker;
+    std::deque<std::shared_ptr<FlashOperationJob>> m_pending_jobs;
+    sc_event m_job_submitted;
+    mutable std::vector<std::shared_ptr<FlashOperationJob>> m_batch;   // Not yet handed to the worker
+    sc_event m_batch_due;
+    size_t m_published_allocated_blocks;
+    size_t m_published_footprint_bytes;
+    
+    // Statistics (published as operations are applied)
     uint64_t m_total_reads;
     uint64_t m_total_programs;
     uint64_t m_total_erases;
     uint64_t m_bad_block_count;
+    uint64_t m_multi_plane_operations;
+    StatsGroup m_stats_group;
+    
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("reads", &m_total_reads);
+        m_stats_group.counter("programs", &m_total_programs);
+        m_stats_group.counter("erases", &m_total_erases);
+        m_stats_group.counter("bad_blocks", &m_bad_block_count);
+        m_stats_group.counter("multi_plane_operations", &m_multi_plane_operations);
+        m_stats_group.gauge("in_flight", [this]() { return static_cast<double>(m_release_queue.in_flight()); }, "ops");
+        m_stats_group.gauge("allocated_blocks",
+                            [this]() { return static_cast<double>(m_published_allocated_blocks); }, "blocks");
+        m_stats_group.gauge("state_footprint",
+                            [this]() { return static_cast<double>(m_published_footprint_bytes); }, "bytes");
+    }
     
     // Main processing method
     void flash_process() {
         while (true) {
-            auto packet = in.read();
+            auto packet = SelfProfiler::read(in);
             
             if (!packet) {
                 SOC_SIM_ERROR("NANDFlash", soc_sim::error::codes::INVALID_PACKET_TYPE,
@@ -95,101 +283,278 @@ SC_MODULE(NANDFlash) {
                 continue;
             }
             
-            const FlashAddress& addr = packet->get_flash_address();
-            FlashCommand cmd = packet->get_flash_command();
+            // The first plane's packet carries the rest of a multi-plane operation
+            std::shared_ptr<FlashOperationJob> job(new FlashOperationJob());
+            job->planes.push_back(packet);
+            job->planes.insert(job->planes.end(), packet->plane_group.begin(), packet->plane_group.end());
+            packet->plane_group.clear();
+            job->start = sc_time_stamp();
+            job->start_ns = job->start.to_seconds() * 1e9;
+            
+            job->join_time = job->start + m_channel_latency;
+            if (m_worker) {
+                if (m_batch.empty()) {
+                    m_batch_due.notify(m_channel_latency / 2);   // Well before the first join
+                }
+                m_batch.push_back(job);
+            } else {
+                execute_operation(*job);
+            }
+            m_pending_jobs.push_back(job);
+            m_job_submitted.notify(SC_ZERO_TIME);
+        }
+    }
+    
+    // Partitioned mode: hand the operations of the last half window to the worker
+    void partition_submit_process() {
+        if (!m_worker) {
+            return;
+        }
+        while (true) {
+            SelfProfiler::wait(m_batch_due);
+            submit_batch();
+        }
+    }
+    
+    void submit_batch() const {
+        if (m_batch.empty()) {
+            return;
+        }
+        std::vector<std::shared_ptr<FlashOperationJob>> batch;
+        batch.swap(m_batch);
+        NANDFlash* self = const_cast<NANDFlash*>(this);
+        PartitionWorker::Ticket ticket = m_worker->submit([self, batch]() {
+            for (const auto& job : batch) {
+                self->execute_operation(*job);
+            }
+        });
+        for (const auto& job : batch) {
+            job->ticket = ticket;
+        }
+    }
+    
+    // Join operations in submission order once the lookahead has elapsed (the next
+    // delta cycle for a zero channel latency); one worker wait covers every operation due
+    void partition_join_process() {
+        while (true) {
+            while (m_pending_jobs.empty()) {
+                SelfProfiler::wait(m_job_submitted);
+            }
+            sc_time now = sc_time_stamp();
+            if (m_pending_jobs.front()->join_time > now) {
+                SelfProfiler::wait(m_pending_jobs.front()->join_time - now);
+                now = sc_time_stamp();
+            }
+            size_t due = 0;
+            while (due < m_pending_jobs.size() && m_pending_jobs[due]->join_time <= now) {
+                due++;
+            }
+            if (m_worker) {
+                if (m_pending_jobs[due - 1]->ticket == 0) {
+                    submit_batch();     // Only with a lookahead too short to batch ahead
+                }
+                m_worker->wait_for(m_pending_jobs[due - 1]->ticket);
+            }
+            for (size_t i = 0; i < due; i++) {
+                apply_operation(*m_pending_jobs.front());
+                m_pending_jobs.pop_front();
+            }
+        }
+    }
+    
+    // Release completed packets in completion order
+    void release_process() {
+        while (true) {
+            SelfProfiler::write(release_out, m_release_queue.pop());
+        }
+    }
+    
+    // Model side of an operation; touches only this device's state, never the kernel
+    void execute_operation(FlashOperationJob& job) {
+        if (validate_operation(job)) {
+            schedule_operation(job);
+        }
+        job.counters = m_model_counters;
+        job.allocated_blocks = m_flash_memory.allocated_blocks();
+        job.footprint_bytes = m_flash_memory.footprint_bytes();
+    }
+    
+    // SystemC side: read data, release times, error reports, debug output and statistics
+    void apply_operation(const FlashOperationJob& job) {
+        for (const auto& error : job.errors) {
+            SOC_SIM_ERROR("NANDFlash", error.first, error.second);
+        }
+        for (const auto& packet : job.clean_reads) {
+            // Reading from clean page returns all 0xFF (or default data)
+            if (packet->original_packet) {
+                packet->original_packet->set_data(0xFF);
+            }
+        }
+        if (m_debug_enable && !job.releases.empty()) {
+            FlashCommand cmd = job.planes.front()->get_flash_command();
+            const char* cmd_str = (cmd == FlashCommand::READ) ? "READ" :
+                                  (cmd == FlashCommand::PROGRAM) ? "PROGRAM" : "ERASE";
+            std::cout << job.start << " | NANDFlash: " << cmd_str
+                      << " " << job.planes.front()->get_flash_address().to_string()
+                      << " x" << job.planes.size() << " plane(s)"
+                      << " (array=" << std::fixed << std::setprecision(1)
+                      << job.array_ns << "ns, done at " << sc_time(job.done_ns, SC_NS)
+                      << ", success=" << job.success << ")"
+                      << std::endl;
+        }
+        for (const auto& release : job.releases) {
+            m_release_queue.push(release.first, sc_time(release.second, SC_NS));
+        }
+        publish_counters(job.counters, job.allocated_blocks, job.footprint_bytes);
+    }
+    
+    void publish_counters(const FlashDeviceCounters& counters, size_t allocated_blocks, size_t footprint_bytes) {
+        m_total_reads = counters.reads;
+        m_total_programs = counters.programs;
+        m_total_erases = counters.erases;
+        m_bad_block_count = counters.bad_blocks;
+        m_multi_plane_operations = counters.multi_plane_operations;
+        m_published_allocated_blocks = allocated_blocks;
+        m_published_footprint_bytes = footprint_bytes;
+    }
+    
+    bool validate_operation(FlashOperationJob& job) {
+        const std::vector<std::shared_ptr<FlashPacket>>& planes = job.planes;
+        const FlashAddress& first = planes.front()->get_flash_address();
+        uint32_t plane_mask = 0;
+        
+        for (const auto& plane_packet : planes) {
+            const FlashAddress& addr = plane_packet->get_flash_address();
             
             // Validate address bounds
             if (!is_valid_address(addr)) {
-                SOC_SIM_ERROR("NANDFlash", soc_sim::error::codes::ADDRESS_OUT_OF_BOUNDS,
-                             "Invalid flash address: " + addr.to_string());
-                continue;
+                job.errors.push_back(std::make_pair(soc_sim::error::codes::ADDRESS_OUT_OF_BOUNDS,
+                                                    "Invalid flash address: " + addr.to_string()));
+                return false;
             }
             
-            // Check for bad block
-            if (m_flash_memory[addr.plane][addr.block].is_bad_block) {
-                SOC_SIM_ERROR("NANDFlash", soc_sim::error::codes::DEVICE_ERROR,
-                             "Access to bad block: " + addr.to_string());
-                continue;
+            // Multi-plane members: same die and command, one packet per plane
+            if (addr.die != first.die || plane_packet->get_flash_command() != planes.front()->get_flash_command() ||
+                (plane_mask & (1u << addr.plane))) {
+                job.errors.push_back(std::make_pair(soc_sim::error::codes::INVALID_PACKET_TYPE,
+                                                    "Malformed multi-plane operation at " + addr.to_string()));
+                return false;
             }
+            plane_mask |= (1u << addr.plane);
             
-            // Process the flash operation
-            bool operation_success = false;
-            double operation_delay_ns = 0.0;
-            
+            // Check for bad block
+            if (m_flash_memory.is_bad(block_index(addr))) {
+                job.errors.push_back(std::make_pair(soc_sim::error::codes::DEVICE_ERROR,
+                                                    "Access to bad block: " + addr.to_string()));
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Apply the operation to the page states and reserve the die and the channel bus.
+    // READ: array read on the die, then each plane's data out over the bus.
+    // PROGRAM: each plane's data in over the bus, then one array program.
+    // ERASE: array only.
+    void schedule_operation(FlashOperationJob& job) {
+        const std::vector<std::shared_ptr<FlashPacket>>& planes = job.planes;
+        FlashCommand cmd = planes.front()->get_flash_command();
+        uint8_t die = planes.front()->get_flash_address().die;
+        double now = job.start_ns;
+        double array_ns = 0.0;
+        bool operation_success = true;
+        
+        for (const auto& plane_packet : planes) {
             switch (cmd) {
                 case FlashCommand::READ:
-                    operation_success = process_read(packet, operation_delay_ns);
-                    m_total_reads++;
+                    operation_success &= process_read(job, plane_packet, array_ns);
+                    m_model_counters.reads++;
                     break;
-                    
+                
                 case FlashCommand::PROGRAM:
-                    operation_success = process_program(packet, operation_delay_ns);
-                    m_total_programs++;
+                    operation_success &= process_program(job, plane_packet, array_ns);
+                    m_model_counters.programs++;
                     break;
-                    
+                
                 case FlashCommand::ERASE:
-                    operation_success = process_erase(packet, operation_delay_ns);
-                    m_total_erases++;
+                    operation_success &= process_erase(plane_packet, array_ns);
+                    m_model_counters.erases++;
                     break;
-                    
+                
                 default:
-                    SOC_SIM_ERROR("NANDFlash", soc_sim::error::codes::INVALID_PACKET_TYPE,
-                                 "Unknown flash command");
-                    continue;
+                    job.errors.push_back(std::make_pair(soc_sim::error::codes::INVALID_PACKET_TYPE,
+                                                        std::string("Unknown flash command")));
+                    return;
             }
-            
-            // Apply operation delay with variation
-            if (operation_delay_ns > 0.0) {
-                double actual_delay = add_timing_variation(operation_delay_ns);
-                wait(actual_delay, SC_NS);
+        }
+        if (planes.size() > 1) {
+            m_model_counters.multi_plane_operations++;
+        }
+        
+        // Apply operation delay with variation
+        double array_time = add_timing_variation(array_ns);
+        double done;
+        
+        if (cmd == FlashCommand::READ) {
+            done = std::max(now, m_die_free_ns[die]) + array_time;
+            for (const auto& plane_packet : planes) {
+                done = std::max(done, m_bus_free_ns) + io_time_ns(plane_packet);
+                m_bus_free_ns = done;
+                job.releases.push_back(std::make_pair(plane_packet, done + m_channel_latency_ns));
             }
-            
-            if (m_debug_enable) {
-                const char* cmd_str = (cmd == FlashCommand::READ) ? "READ" :
-                                      (cmd == FlashCommand::PROGRAM) ? "PROGRAM" : "ERASE";
-                std::cout << sc_time_stamp() << " | NANDFlash: " << cmd_str 
-                          << " " << addr.to_string() 
-                          << " (delay=" << std::fixed << std::setprecision(1) 
-                          << operation_delay_ns << "ns, success=" << operation_success << ")"
-                          << std::endl;
+        } else {
+            double data_in = now;
+            if (cmd == FlashCommand::PROGRAM) {
+                data_in = std::max(now, m_bus_free_ns);
+                for (const auto& plane_packet : planes) {
+                    data_in += io_time_ns(plane_packet);
+                }
+                m_bus_free_ns = data_in;
+            }
+            done = std::max(data_in, m_die_free_ns[die]) + array_time;
+            for (const auto& plane_packet : planes) {
+                job.releases.push_back(std::make_pair(plane_packet, done + m_channel_latency_ns));
             }
-            
-            // Send processed packet back
-            release_out.write(packet);
         }
+        m_die_free_ns[die] = done;
+        
+        job.array_ns = array_ns;
+        job.done_ns = done;
+        job.success = operation_success;
+    }
+    
+    double io_time_ns(const std::shared_ptr<FlashPacket>& packet) const {
+        return m_timing.calculate_io_time_ns(packet->get_data_size());
     }
     
     // Process read operation
-    bool process_read(std::shared_ptr<FlashPacket> packet, double& delay_ns) {
+    bool process_read(FlashOperationJob& job, std::shared_ptr<FlashPacket> packet, double& array_ns) {
         const FlashAddress& addr = packet->get_flash_address();
         
-        // Calculate read delay: tR + I/O transfer time
-        delay_ns = m_timing.tR_ns + m_timing.calculate_io_time_ns(packet->get_data_size());
+        // Array read time; the data transfer is accounted on the channel bus
+        array_ns = m_timing.tR_ns;
         
         // Check if page has valid data
         PageState page_state = get_page_state(addr);
         if (page_state == PageState::CLEAN) {
-            // Reading from clean page returns all 0xFF (or default data)
-            if (packet->original_packet) {
-                packet->original_packet->set_data(0xFF);
-            }
+            job.clean_reads.push_back(packet);   // Data is filled in on the SystemC side
         }
         
         return true; // Read operations rarely fail in simulation
     }
     
     // Process program operation
-    bool process_program(std::shared_ptr<FlashPacket> packet, double& delay_ns) {
+    bool process_program(FlashOperationJob& job, std::shared_ptr<FlashPacket> packet, double& array_ns) {
         const FlashAddress& addr = packet->get_flash_address();
         
-        // Calculate program delay: tProg + I/O transfer time
-        delay_ns = m_timing.tProg_ns + m_timing.calculate_io_time_ns(packet->get_data_size());
+        // Array program time; the data transfer is accounted on the channel bus
+        array_ns = m_timing.tProg_ns;
         
         // Check if page is in clean state (erase-before-write rule)
         PageState page_state = get_page_state(addr);
         if (page_state != PageState::CLEAN) {
-            SOC_SIM_ERROR("NANDFlash", soc_sim::error::codes::DEVICE_ERROR,
-                         "Program operation to non-clean page: " + addr.to_string());
+            job.errors.push_back(std::make_pair(soc_sim::error::codes::DEVICE_ERROR,
+                                                "Program operation to non-clean page: " + addr.to_string()));
             return false;
         }
         
@@ -198,7 +563,7 @@ SC_MODULE(NANDFlash) {
         
         // Check for program failure (rare in simulation)
         if (should_fail_operation(0.001)) { // 0.1% failure rate
-            mark_bad_block(addr.plane, addr.block);
+            mark_bad_block(addr);
             return false;
         }
         
@@ -206,30 +571,25 @@ SC_MODULE(NANDFlash) {
     }
     
     // Process erase operation
-    bool process_erase(std::shared_ptr<FlashPacket> packet, double& delay_ns) {
+    bool process_erase(std::shared_ptr<FlashPacket> packet, double& array_ns) {
         const FlashAddress& addr = packet->get_flash_address();
         
         // Erase operates on entire block
-        delay_ns = m_timing.tErase_ns;
+        array_ns = m_timing.tErase_ns;
         
-        // Erase entire block (all pages become clean)
-        FlashBlock& block = m_flash_memory[addr.plane][addr.block];
-        for (auto& page : block.pages) {
-            page = PageState::CLEAN;
-        }
-        
-        // Increment erase count
-        block.erase_count++;
+        // Erase entire block (all pages become clean) and increment its erase count
+        size_t block = block_index(addr);
+        m_flash_memory.erase(block);
         
         // Check for wear-out
-        if (block.erase_count >= m_max_pe_cycles && should_fail_operation(0.1)) {
-            mark_bad_block(addr.plane, addr.block);
+        if (m_flash_memory.get_erase_count(block) >= m_max_pe_cycles && should_fail_operation(0.1)) {
+            mark_bad_block(addr);
             return false;
         }
         
         // Check for erase failure (rare)
         if (should_fail_operation(0.01)) { // 1% failure rate
-            mark_bad_block(addr.plane, addr.block);
+            mark_bad_block(addr);
             return false;
         }
         
@@ -238,32 +598,36 @@ SC_MODULE(NANDFlash) {
     
     // Helper methods
     bool is_valid_address(const FlashAddress& addr) const {
-        return (addr.plane < NumPlanes) && 
+        return (addr.die < m_num_dies) &&
+               (addr.plane < NumPlanes) &&
                (addr.block < BlocksPerPlane) &&
                (addr.wl < PagesPerBlock) &&
                (addr.ssl < 4) &&  // Typical SSL count
                (addr.page < 32);  // Typical pages per SSL
     }
     
+    static size_t block_index(uint32_t die, uint32_t plane, uint32_t block) {
+        return (static_cast<size_t>(die) * NumPlanes + plane) * BlocksPerPlane + block;
+    }
+    
+    static size_t block_index(const FlashAddress& addr) {
+        return block_index(addr.die, addr.plane, addr.block);
+    }
+    
     PageState get_page_state(const FlashAddress& addr) const {
         size_t page_index = addr.wl * 4 * 32 + addr.ssl * 32 + addr.page;
-        if (page_index < m_flash_memory[addr.plane][addr.block].pages.size()) {
-            return m_flash_memory[addr.plane][addr.block].pages[page_index];
-        }
-        return PageState::CLEAN;
+        return m_flash_memory.get_page(block_index(addr), page_index);
     }
     
     void set_page_state(const FlashAddress& addr, PageState state) {
         size_t page_index = addr.wl * 4 * 32 + addr.ssl * 32 + addr.page;
-        if (page_index < m_flash_memory[addr.plane][addr.block].pages.size()) {
-            m_flash_memory[addr.plane][addr.block].pages[page_index] = state;
-        }
+        m_flash_memory.set_page(block_index(addr), page_index, state);
     }
     
-    void mark_bad_block(uint8_t plane, uint16_t block) {
-        if (plane < NumPlanes && block < BlocksPerPlane) {
-            m_flash_memory[plane][block].is_bad_block = true;
-            m_bad_block_count++;
+    void mark_bad_block(const FlashAddress& addr) {
+        if (is_valid_address(addr) && !m_flash_memory.is_bad(block_index(addr))) {
+            m_flash_memory.mark_bad(block_index(addr));
+            m_model_counters.bad_blocks++;
         }
     }
     
@@ -282,34 +646,122 @@ SC_MODULE(NANDFlash) {
     NANDFlash(sc_module_name name,
               const FlashTimingParams& timing = FlashTimingParams(),
               uint32_t max_pe_cycles = 100000,
-              bool debug_enable = false)
+              bool debug_enable = false,
+              uint32_t num_dies = 1,
+              uint32_t seed = 0)
         : sc_module(name),
           m_debug_enable(debug_enable),
           m_timing(timing),
           m_max_pe_cycles(max_pe_cycles),
-          m_rng(std::random_device{}()),
+          m_num_dies(num_dies > 0 ? num_dies : 1),
+          m_channel_latency(SC_ZERO_TIME),
+          m_channel_latency_ns(0.0),
+          m_flash_memory(m_num_dies * NumPlanes * BlocksPerPlane, PAGES_PER_FLASH_BLOCK),
+          m_die_free_ns(m_num_dies, 0.0),
+          m_bus_free_ns(0.0),
+          m_rng(seed != 0 ? RandomStream(seed) : RandomService::stream(this->name())),
           m_timing_variation(0.0, 1.0),
+          m_worker(nullptr),
+          m_published_allocated_blocks(0),
+          m_published_footprint_bytes(m_flash_memory.footprint_bytes()),
           m_total_reads(0),
           m_total_programs(0),
           m_total_erases(0),
-          m_bad_block_count(0) {
-        
-        // Initialize flash memory structure
-        for (auto& plane : m_flash_memory) {
-            for (auto& block : plane) {
-                block = FlashBlock(PagesPerBlock * 4 * 32); // wl * ssl * pages_per_ssl
-            }
-        }
+          m_bad_block_count(0),
+          m_multi_plane_operations(0) {
         
         if (m_debug_enable) {
             std::cout << "0 s | " << basename() << ": NAND Flash initialized "
-                      << "(" << NumPlanes << " planes, " << BlocksPerPlane << " blocks/plane, "
+                      << "(" << m_num_dies << " dies, " << NumPlanes << " planes, " << BlocksPerPlane << " blocks/plane, "
                       << PagesPerBlock << " pages/block, tR=" << m_timing.tR_ns/1000.0 << "μs, "
                       << "tProg=" << m_timing.tProg_ns/1000.0 << "μs, "
                       << "tErase=" << m_timing.tErase_ns/1000000.0 << "ms)" << std::endl;
         }
         
+        register_stats();
         SC_THREAD(flash_process);
+        SC_THREAD(release_process);
+        SC_THREAD(partition_submit_process);
+        SC_THREAD(partition_join_process);
+    }
+    
+    ~NANDFlash() {
+        join_model();
+    }
+    
+    // Partitioned execution; set before the simulation starts
+    void set_partition_worker(PartitionWorker* worker) { m_worker = worker; }
+    bool is_partitioned() const { return m_worker != nullptr; }
+    
+    // Completion -> controller latency; the lookahead of partitioned execution
+    void set_channel_latency(const sc_time& latency) {
+        m_channel_latency = latency;
+        m_channel_latency_ns = latency.to_seconds() * 1e9;
+    }
+    const sc_time& get_channel_latency() const { return m_channel_latency; }
+    
+    // Waits for the worker; the model state is then the one serial mode has at this time.
+    // Published statistics are left alone, they change only as operations are joined.
+    void join_model() const {
+        if (m_worker) {
+            submit_batch();
+            m_worker->drain();
+        }
+    }
+    
+    // End of simulation: joins the operations still inside the lookahead window and
+    // publishes their statistics (same in both modes, the pending queue is shared)
+    void sync_partition() const {
+        join_model();
+        if (!m_pending_jobs.empty()) {
+            NANDFlash* self = const_cast<NANDFlash*>(this);
+            const FlashOperationJob& last = *m_pending_jobs.back();
+            self->publish_counters(last.counters, last.allocated_blocks, last.footprint_bytes);
+        }
+    }
+    
+    // Checkpoint: page states, erase counts, bad blocks and the counters so far
+    void save_checkpoint(CheckpointWriter& writer) const {
+        join_model();
+        writer.begin_section(name());
+        m_flash_memory.save(writer);
+        FlashDeviceCounters lifetime = m_baseline_counters;
+        lifetime.reads += m_model_counters.reads;
+        lifetime.programs += m_model_counters.programs;
+        lifetime.erases += m_model_counters.erases;
+        lifetime.bad_blocks += m_model_counters.bad_blocks;
+        lifetime.multi_plane_operations += m_model_counters.multi_plane_operations;
+        writer.write(lifetime);
+        writer.end_section();
+    }
+    
+    // At elaboration: the device state is restored, counters start from zero and the
+    // checkpoint's counters become the baseline
+    bool restore_checkpoint(CheckpointReader& reader) {
+        if (!reader.begin_section(name()) || !m_flash_memory.restore(reader) || !reader.read(m_baseline_counters)) {
+            return false;
+        }
+        m_model_counters = FlashDeviceCounters();
+        publish_counters(m_model_counters, m_flash_memory.allocated_blocks(), m_flash_memory.footprint_bytes());
+        return true;
+    }
+    
+    const FlashDeviceCounters& get_baseline_counters() const { return m_baseline_counters; }
+    
+    // Fast-forward (untimed warm-up): page and block state only - no timing, no failure
+    // draws, no counters. PROGRAM marks a clean page programmed, ERASE cleans the block.
+    void fast_forward_access(FlashCommand command, const FlashAddress& addr) {
+        join_model();
+        if (!is_valid_address(addr)) {
+            return;
+        }
+        if (command == FlashCommand::PROGRAM && get_page_state(addr) == PageState::CLEAN) {
+            set_page_state(addr, PageState::PROGRAMMED);
+        } else if (command == FlashCommand::ERASE) {
+            m_flash_memory.erase(block_index(addr));
+        }
+        m_published_allocated_blocks = m_flash_memory.allocated_blocks();
+        m_published_footprint_bytes = m_flash_memory.footprint_bytes();
     }
     
     // Statistics and monitoring methods
@@ -317,22 +769,30 @@ SC_MODULE(NANDFlash) {
     uint64_t get_total_programs() const { return m_total_programs; }
     uint64_t get_total_erases() const { return m_total_erases; }
     uint64_t get_bad_block_count() const { return m_bad_block_count; }
+    uint64_t get_multi_plane_operations() const { return m_multi_plane_operations; }
+    
+    // Host memory held by the page-state store, as of the last joined operation (no worker sync)
+    size_t get_allocated_blocks() const { return m_published_allocated_blocks; }
+    size_t get_state_footprint_bytes() const { return m_published_footprint_bytes; }
     
-    uint32_t get_block_erase_count(uint8_t plane, uint16_t block) const {
-        if (plane < NumPlanes && block < BlocksPerPlane) {
-            return m_flash_memory[plane][block].erase_count;
+    uint32_t get_block_erase_count(uint8_t plane, uint16_t block, uint8_t die = 0) const {
+        join_model();
+        if (die < m_num_dies && plane < NumPlanes && block < BlocksPerPlane) {
+            return m_flash_memory.get_erase_count(block_index(die, plane, block));
         }
         return 0;
     }
     
-    bool is_bad_block(uint8_t plane, uint16_t block) const {
-        if (plane < NumPlanes && block < BlocksPerPlane) {
-            return m_flash_memory[plane][block].is_bad_block;
+    bool is_bad_block(uint8_t plane, uint16_t block, uint8_t die = 0) const {
+        join_model();
+        if (die < m_num_dies && plane < NumPlanes && block < BlocksPerPlane) {
+            return m_flash_memory.is_bad(block_index(die, plane, block));
         }
         return false;
     }
     
     // Get flash geometry information
+    uint32_t get_num_dies() const { return m_num_dies; }
     static constexpr size_t get_num_planes() { return NumPlanes; }
     static constexpr size_t get_blocks_per_plane() { return BlocksPerPlane; }
     static constexpr size_t get_pages_per_block() { return PagesPerBlock; }
@@ -351,10 +811,12 @@ NANDFlash<NumPlanes, BlocksPerPlane, PagesPerBlock>* create_nand_flash(
     sc_module_name name,
     const FlashTimingParams& timing = FlashTimingParams(),
     uint32_t max_pe_cycles = 100000,
-    bool debug_enable = false) {
+    bool debug_enable = false,
+    uint32_t num_dies = 1,
+    uint32_t seed = 0) {
     
     return new NANDFlash<NumPlanes, BlocksPerPlane, PagesPerBlock>(
-        name, timing, max_pe_cycles, debug_enable);
+        name, timing, max_pe_cycles, debug_enable, num_dies, seed);
 }
 
 #endif
\ No newline at end of file
@@ -7,8 +7,18 @@
 #include <random>
 #include <iomanip>
 #include <functional>
+#include <type_traits>
+#include <map>
+#include <unordered_map>
+#include <vector>
 #include "packet/pcie_packet.h"
+#include "packet/packet_pool.h"
+#include "base/delay_pipeline.h"
 #include "common/error_handling.h"
+#include "common/quantum_keeper.h"
+#include "common/stats_registry.h"
+#include "common/random.h"
+#include "common/self_profiler.h"
 
 // PCIe Link utilization tracking with cumulative profiling
 struct PCIeLinkUtilization {
@@ -146,8 +156,234 @@ struct PCIeCongestionModel {
     }
 };
 
-// Template-based PCIe DelayLine with generation-specific CRC and timing
+// Link-layer model
+// SERIAL:    one transfer on the link at a time: read -> wait(total delay) -> write,
+//            CRC retries stall the link (original behaviour)
+// PIPELINED: TLPs serialize back-to-back and propagate concurrently; flow-control
+//            credits gate transmission and CRC failures are replayed from the replay
+//            buffer into free link slots without stalling unrelated TLPs
+enum class PCIeLinkMode {
+    SERIAL,
+    PIPELINED
+};
+
+inline PCIeLinkMode parse_pcie_link_mode(const std::string& mode_str) {
+    if (mode_str == "PIPELINED") return PCIeLinkMode::PIPELINED;
+    return PCIeLinkMode::SERIAL;
+}
+
+inline const char* pcie_link_mode_name(PCIeLinkMode mode) {
+    return (mode == PCIeLinkMode::PIPELINED) ? "PIPELINED" : "SERIAL";
+}
+
+// Flow-control credit classes (PCIe base spec 2.6)
+enum class PCIeCreditClass {
+    POSTED,         // Memory writes
+    NON_POSTED,     // Memory read requests
+    COMPLETION      // Completions (the upstream link)
+};
+
+// Link-layer parameters for PIPELINED mode (pcie.link_layer in pcie_config.json).
+// Credit limits of 0 are infinite, as advertised for completions by root complexes.
+struct PCIeLinkLayerConfig {
+    uint32_t posted_header_credits;
+    uint32_t posted_data_credits;        // 16-byte units
+    uint32_t non_posted_header_credits;
+    uint32_t non_posted_data_credits;
+    uint32_t completion_header_credits;
+    uint32_t completion_data_credits;
+    double update_fc_latency_ns;         // Receiver consumes a TLP -> credits back at the transmitter
+    double replay_timeout_ns;            // Failed TLP -> replay from the replay buffer (NAK round trip)
+    uint32_t max_replays;                // Per TLP; the transfer fails after that
+    double link_latency_ns;              // Wire / PHY latency on top of CRC processing
+    uint32_t max_read_request_size;      // Read requests split at MRRS (0 = one request)
+    
+    PCIeLinkLayerConfig() : posted_header_credits(32), posted_data_credits(1024),
+                            non_posted_header_credits(32), non_posted_data_credits(0),
+                            completion_header_credits(0), completion_data_credits(0),
+                            update_fc_latency_ns(50.0), replay_timeout_ns(100.0), max_replays(3),
+                            link_latency_ns(0.0), max_read_request_size(0) {}
+};
+
+// Credit pool for one class. Returns are kept as a time-ordered heap and applied
+// lazily, so credit accounting costs no SystemC events.
+class PCIeCreditPool {
+public:
+    PCIeCreditPool() : m_header_limit(0), m_data_limit(0), m_header_available(0), m_data_available(0) {}
+    
+    void configure(uint32_t header_limit, uint32_t data_limit) {
+        m_header_limit = header_limit;
+        m_data_limit = data_limit;
+        m_header_available = header_limit;
+        m_data_available = data_limit;
+        m_returns = ReturnHeap();
+    }
+    
+    // Takes one header and data_credits data credits at the earliest time >= earliest
+    // they are available (earliest is advanced to it; stalled is set if that is later).
+    // False, with nothing taken, when the credits still held by the receiver have no
+    // return scheduled yet.
+    bool acquire(sc_time& earliest, uint32_t& data_credits, bool& stalled) {
+        if (m_data_limit > 0) {
+            data_credits = std::min(data_credits, m_data_limit);   // A TLP never needs more than the pool
+        } else {
+            data_credits = 0;
+        }
+        while (short_of(data_credits) && !m_returns.empty()) {
+            const CreditReturn& credit_return = m_returns.top();
+            if (credit_return.time > earliest) {
+                earliest = credit_return.time;
+                stalled = true;
+            }
+            m_header_available += credit_return.header;
+            m_data_available += credit_return.data;
+            m_returns.pop();
+        }
+        if (short_of(data_credits)) {
+            return false;
+        }
+        if (m_header_limit > 0) m_header_available--;
+        m_data_available -= data_credits;
+        return true;
+    }
+    
+    // Credits of headers TLPs (data_credits in all) come back at time
+    void release_at(const sc_time& time, uint32_t data_credits, uint32_t headers = 1) {
+        if ((m_header_limit == 0 || headers == 0) && data_credits == 0) return;
+        CreditReturn credit_return = {time, m_header_limit > 0 ? headers : 0u, data_credits};
+        m_returns.push(credit_return);
+    }
+
+private:
+    bool short_of(uint32_t data_credits) const {
+        return (m_header_limit > 0 && m_header_available == 0) || m_data_available < data_credits;
+    }
+    
+    struct CreditReturn {
+        sc_time time;
+        uint32_t header;
+        uint32_t data;
+    };
+    struct LaterReturn {
+        bool operator()(const CreditReturn& a, const CreditReturn& b) const { return a.time > b.time; }
+    };
+    typedef std::priority_queue<CreditReturn, std::vector<CreditReturn>, LaterReturn> ReturnHeap;
+    
+    uint32_t m_header_limit;
+    uint32_t m_data_limit;
+    uint32_t m_header_available;
+    uint32_t m_data_available;
+    ReturnHeap m_returns;
+};
+
+// Packet <-> TLP conversion policies for PCIeDelayLine, resolved at compile time.
+//
+// Wrapping (BasePacket-derived types): every packet is carried in a pooled PCIePacket
+// whose original_packet is the input, and the original comes back out - static casts
+// only. A PCIePacket sent through a PCIeDelayLine<BasePacket> is wrapped like any other
+// packet; instantiate PCIeDelayLine<PCIePacket> to time TLPs directly.
+template<typename PacketType>
+struct WrappingPCIeConversion {
+    std::shared_ptr<PCIePacket> to_pcie(const std::shared_ptr<PacketType>& packet,
+                                        PCIeGeneration generation, uint8_t lanes) const {
+        return PacketPool<PCIePacket>::acquire(std::static_pointer_cast<BasePacket>(packet), generation, lanes);
+    }
+    
+    std::shared_ptr<PacketType> from_pcie(const std::shared_ptr<PCIePacket>& pcie_packet) const {
+        std::shared_ptr<PacketType> original = std::static_pointer_cast<PacketType>(pcie_packet->original_packet);
+        if (original) {
+            // Update original packet with any changes
+            original->restore_transfer_length(pcie_packet->data_payload_size);
+        }
+        return original;
+    }
+};
+
+// Identity: the delay line already carries TLPs
+struct IdentityPCIeConversion {
+    std::shared_ptr<PCIePacket> to_pcie(const std::shared_ptr<PCIePacket>& packet,
+                                        PCIeGeneration, uint8_t) const {
+        return packet;
+    }
+    
+    std::shared_ptr<PCIePacket> from_pcie(const std::shared_ptr<PCIePacket>& pcie_packet) const {
+        return pcie_packet;
+    }
+};
+
+// Runtime converters for custom packet types; without converters it falls back to
+// dynamic casts and the original_packet link
+template<typename PacketType>
+struct FunctionPCIeConversion {
+    std::function<std::shared_ptr<PCIePacket>(std::shared_ptr<PacketType>)> m_to_pcie_converter;
+    std::function<std::shared_ptr<PacketType>(std::shared_ptr<PCIePacket>)> m_from_pcie_converter;
+    
+    FunctionPCIeConversion() {}
+    FunctionPCIeConversion(std::function<std::shared_ptr<PCIePacket>(std::shared_ptr<PacketType>)> to_pcie,
+                           std::function<std::shared_ptr<PacketType>(std::shared_ptr<PCIePacket>)> from_pcie)
+        : m_to_pcie_converter(to_pcie), m_from_pcie_converter(from_pcie) {}
+    
+    std::shared_ptr<PCIePacket> to_pcie(const std::shared_ptr<PacketType>& packet,
+                                        PCIeGeneration generation, uint8_t lanes) const {
+        // Try direct cast first
+        auto pcie_packet = std::dynamic_pointer_cast<PCIePacket>(packet);
+        if (pcie_packet) {
+            return pcie_packet;
+        }
+        
+        // Use custom converter if available
+        if (m_to_pcie_converter) {
+            return m_to_pcie_converter(packet);
+        }
+        
+        // Default conversion for BasePacket-derived types
+        auto base_packet = std::dynamic_pointer_cast<BasePacket>(packet);
+        if (base_packet) {
+            return PacketPool<PCIePacket>::acquire(base_packet, generation, lanes);
+        }
+        
+        return nullptr;
+    }
+    
+    std::shared_ptr<PacketType> from_pcie(const std::shared_ptr<PCIePacket>& pcie_packet) const {
+        // Try direct cast first
+        auto packet = std::dynamic_pointer_cast<PacketType>(pcie_packet);
+        if (packet) {
+            return packet;
+        }
+        
+        // Use custom converter if available
+        if (m_from_pcie_converter) {
+            return m_from_pcie_converter(pcie_packet);
+        }
+        
+        // Return original packet if available
+        if (pcie_packet->original_packet) {
+            auto original = std::dynamic_pointer_cast<PacketType>(pcie_packet->original_packet);
+            if (original) {
+                // Update original packet with any changes
+                original->restore_transfer_length(pcie_packet->data_payload_size);
+                return original;
+            }
+        }
+        
+        return nullptr;
+    }
+};
+
+// Default policy per packet type: identity for PCIePacket, wrapping for other
+// BasePacket-derived types, runtime converters otherwise
 template<typename PacketType>
+struct DefaultPCIeConversion {
+    typedef typename std::conditional<std::is_same<PacketType, PCIePacket>::value,
+                                      IdentityPCIeConversion,
+                                      typename std::conditional<std::is_base_of<BasePacket, PacketType>::value,
+                                                                WrappingPCIeConversion<PacketType>,
+                                                                FunctionPCIeConversion<PacketType>>::type>::type type;
+};
+
+// Template-based PCIe DelayLine with generation-specific CRC and timing
+template<typename PacketType, typename Conversion = typename DefaultPCIeConversion<PacketType>::type>
 SC_MODULE(PCIeDelayLine) {
     SC_HAS_PROCESS(PCIeDelayLine);
     
@@ -162,28 +398,57 @@ SC_MODULE(PCIeDelayLine) {
     const bool m_enable_crc_simulation;
     const bool m_enable_congestion_model;
     
+    // Max payload size: transfers cross the link as ceil(length / MPS) TLPs, each with
+    // its own header and CRC, but stay one packet in the simulation (0 = one TLP)
+    uint32_t m_max_payload_size;
+    
     // Link characteristics
     PCIeLinkUtilization m_link_utilization;
     PCIeCongestionModel m_congestion_model;
     
-    // CRC error simulation
-    mutable std::mt19937 m_rng;
-    mutable std::uniform_real_distribution<double> m_error_dist;
+    // CRC error simulation (per-link stream, seeded from the module name)
+    RandomStream m_rng;
     
     // Statistics
     uint64_t m_total_packets_processed;
+    uint64_t m_total_tlps;
     uint64_t m_total_crc_errors;
     uint64_t m_total_retries;
     double m_total_processing_time_ns;
+    LatencyHistogram m_processing_histogram;    // Per-TLP link delay
+    StatsGroup m_stats_group;
     
-    // Packet conversion functions
-    std::function<std::shared_ptr<PCIePacket>(std::shared_ptr<PacketType>)> m_to_pcie_converter;
-    std::function<std::shared_ptr<PacketType>(std::shared_ptr<PCIePacket>)> m_from_pcie_converter;
+    // Temporal decoupling (TimingMode::LOOSE): link latency is annotated on the packet
+    const bool m_loosely_timed;
+    QuantumKeeper m_quantum_keeper;
+    
+    // Packet conversion policy
+    Conversion m_conversion;
+    
+    // PIPELINED link layer
+    const PCIeLinkMode m_link_mode;               // Fixed at construction: only its processes exist
+    PCIeLinkLayerConfig m_link_layer;
+    bool m_completion_link;                       // Every TLP is a completion (upstream link)
+    PCIeCreditPool m_credits[3];                  // Indexed by PCIeCreditClass
+    sc_time m_tx_free;                            // Transmitter is free from here on
+    std::map<sc_time, sc_time> m_replay_slots;    // Future link slots taken by replays (start -> end)
+    TimedReleaseQueue<PCIePacket> m_delivery_queue;
+    uint64_t m_credit_stalls;
+    
+    // Credits of a delivered transfer go back once the receiver has taken it from the
+    // delivery queue (out.write returned), so receiver back-pressure reaches the transmitter
+    struct HeldCredits {
+        PCIeCreditClass credit_class;
+        uint32_t headers;
+        uint32_t data;
+    };
+    std::unordered_map<const PCIePacket*, HeldCredits> m_held_credits;
+    sc_event m_credits_returned;
     
     // Main processing method
     void process_packets() {
         while (true) {
-            auto packet = in.read();
+            auto packet = SelfProfiler::read(in);
             
             if (!packet) {
                 SOC_SIM_ERROR("PCIeDelayLine", soc_sim::error::codes::INVALID_PACKET_TYPE,
@@ -191,13 +456,21 @@ SC_MODULE(PCIeDelayLine) {
                 continue;
             }
             
+            // LOOSE mode: the link is busy until max(own local time, packet arrival)
+            if (m_loosely_timed) {
+                m_quantum_keeper.align_to(QuantumKeeper::packet_time(*packet));
+            }
+            
             // Convert to PCIePacket if needed
-            std::shared_ptr<PCIePacket> pcie_packet = convert_to_pcie_packet(packet);
+            std::shared_ptr<PCIePacket> pcie_packet = m_conversion.to_pcie(packet, m_generation, m_lanes);
             if (!pcie_packet) {
                 SOC_SIM_ERROR("PCIeDelayLine", soc_sim::error::codes::INVALID_PACKET_TYPE,
                              "Failed to convert packet to PCIePacket");
                 continue;
             }
+            if (pcie_packet->max_payload_size != m_max_payload_size) {
+                pcie_packet->set_max_payload_size(m_max_payload_size);
+            }
             
             // Process PCIe packet with CRC and timing simulation
             bool success = process_pcie_packet(pcie_packet);
@@ -214,7 +487,7 @@ SC_MODULE(PCIeDelayLine) {
                 }
                 
                 // Retry with additional delay
-                wait(100, SC_NS);  // Retry penalty
+                apply_delay(sc_time(100, SC_NS));  // Retry penalty
                 success = process_pcie_packet(pcie_packet);
             }
             
@@ -225,15 +498,267 @@ SC_MODULE(PCIeDelayLine) {
             }
             
             // Convert back to original packet type if needed
-            auto output_packet = convert_from_pcie_packet(pcie_packet);
+            auto output_packet = m_conversion.from_pcie(pcie_packet);
             if (output_packet) {
-                out.write(output_packet);
+                if (m_loosely_timed) {
+                    output_packet->set_lt_time(m_quantum_keeper.get_current_time());
+                }
+                SelfProfiler::write(out, output_packet);
             }
             
             m_total_packets_processed++;
+            m_total_tlps += pcie_packet->tlp_count;
+            
+            if (m_loosely_timed) {
+                m_quantum_keeper.sync_if_needed();
+            }
         }
     }
     
+    // PIPELINED mode: schedule the transfer's TLPs on the link and hand the packet to
+    // the delivery queue; the transmitter only waits for its own serialization
+    void pipelined_transmit_process() {
+        while (true) {
+            auto packet = SelfProfiler::read(in);
+            
+            if (!packet) {
+                SOC_SIM_ERROR("PCIeDelayLine", soc_sim::error::codes::INVALID_PACKET_TYPE,
+                             "Received null packet");
+                continue;
+            }
+            
+            if (m_loosely_timed) {
+                m_quantum_keeper.align_to(QuantumKeeper::packet_time(*packet));
+            }
+            
+            std::shared_ptr<PCIePacket> pcie_packet = m_conversion.to_pcie(packet, m_generation, m_lanes);
+            if (!pcie_packet) {
+                SOC_SIM_ERROR("PCIeDelayLine", soc_sim::error::codes::INVALID_PACKET_TYPE,
+                             "Failed to convert packet to PCIePacket");
+                continue;
+            }
+            if (pcie_packet->max_payload_size != m_max_payload_size) {
+                pcie_packet->set_max_payload_size(m_max_payload_size);
+            }
+            
+            sc_time now = m_loosely_timed ? m_quantum_keeper.get_current_time() : sc_time_stamp();
+            sc_time delivery_time;
+            bool success = schedule_transfer(pcie_packet, now, delivery_time);
+            
+            if (!success) {
+                SOC_SIM_ERROR("PCIeDelayLine", soc_sim::error::codes::DEVICE_ERROR,
+                             "Packet failed after maximum retries");
+            } else {
+                double total_delay_ns = (delivery_time - now).to_seconds() * 1e9;
+                m_total_processing_time_ns += total_delay_ns;
+                m_processing_histogram.record(static_cast<uint64_t>(total_delay_ns + 0.5));
+                m_total_packets_processed++;
+                
+                if (m_debug_enable) {
+                    std::cout << sc_time_stamp() << " | " << basename() << ": "
+                              << PCIeGenerationSpecs::get_generation_name(m_generation)
+                              << " x" << static_cast<int>(m_lanes)
+                              << ", Tag: " << pcie_packet->tlp_header.tag
+                              << ", Size: " << pcie_packet->total_packet_size << "B"
+                              << " (" << pcie_packet->tlp_count << " TLP)"
+                              << ", Delivery in: " << std::fixed << std::setprecision(1) << total_delay_ns << "ns"
+                              << ", Util: " << std::setprecision(1) << m_link_utilization.current_utilization << "%"
+                              << std::endl;
+                }
+                
+                if (m_loosely_timed) {
+                    // Annotated: the packet reaches the far end at its delivery time
+                    auto output_packet = m_conversion.from_pcie(pcie_packet);
+                    if (output_packet) {
+                        output_packet->set_lt_time(delivery_time);
+                        SelfProfiler::write(out, output_packet);
+                    }
+                } else {
+                    m_delivery_queue.push(pcie_packet, delivery_time);
+                }
+            }
+            
+            // Back-pressure: the next transfer starts when the transmitter is free
+            if (m_tx_free > now) {
+                apply_delay(m_tx_free - now);
+            }
+            if (m_loosely_timed) {
+                m_quantum_keeper.sync_if_needed();
+            }
+        }
+    }
+    
+    void pipelined_delivery_process() {
+        const sc_time update_fc(m_link_layer.update_fc_latency_ns, SC_NS);
+        while (true) {
+            std::shared_ptr<PCIePacket> pcie_packet = m_delivery_queue.pop();
+            auto output_packet = m_conversion.from_pcie(pcie_packet);
+            if (output_packet) {
+                SelfProfiler::write(out, output_packet);
+            }
+            
+            // Consumed by the receiver: UpdateFC reaches the transmitter update_fc later
+            auto held = m_held_credits.find(pcie_packet.get());
+            if (held != m_held_credits.end()) {
+                m_credits[static_cast<int>(held->second.credit_class)].release_at(
+                    sc_time_stamp() + update_fc, held->second.data, held->second.headers);
+                m_held_credits.erase(held);
+                m_credits_returned.notify(SC_ZERO_TIME);
+            }
+        }
+    }
+    
+    // Whether the transfer's TLPs carry its data: writes downstream, read completions
+    // upstream. Read requests (MRd) and write completions are header-only.
+    bool carries_data(const PCIePacket& pcie_packet) const {
+        bool is_read = (pcie_packet.tlp_header.tlp_type == TLPType::MEMORY_READ);
+        return m_completion_link ? is_read : !is_read;
+    }
+    
+    PCIeCreditClass credit_class(const PCIePacket& pcie_packet) const {
+        if (m_completion_link) return PCIeCreditClass::COMPLETION;
+        return (pcie_packet.tlp_header.tlp_type == TLPType::MEMORY_READ) ? PCIeCreditClass::NON_POSTED
+                                                                         : PCIeCreditClass::POSTED;
+    }
+    
+    // Places every TLP of the transfer on the link timeline, returns (via delivery_time)
+    // when the last one - replays included - has reached the receiver. Timed mode waits
+    // here while the receiver still holds every credit of the class.
+    bool schedule_transfer(std::shared_ptr<PCIePacket> pcie_packet, const sc_time& now, sc_time& delivery_time) {
+        const PCIeCRCScheme& crc_scheme = pcie_packet->get_crc_scheme();
+        PCIeCreditClass tlp_class = credit_class(*pcie_packet);
+        PCIeCreditPool& credits = m_credits[static_cast<int>(tlp_class)];
+        
+        // Read requests split at MRRS, writes and completions at MPS
+        uint32_t payload = pcie_packet->data_payload_size;
+        uint32_t split = (tlp_class == PCIeCreditClass::NON_POSTED) ? m_link_layer.max_read_request_size
+                                                                     : m_max_payload_size;
+        uint32_t tlps = (split > 0 && payload > 0) ? (payload + split - 1) / split : 1;
+        // An MSI-X interrupt is one more TLP behind the transfer (counted against the same
+        // credit class); the transfer is delivered once it has arrived
+        uint32_t link_tlps = tlps + (pcie_packet->msix_write ? 1 : 0);
+        
+        double processing_ns = crc_scheme.processing_delay_ns;
+        if (m_generation == PCIeGeneration::GEN7) {
+            processing_ns = apply_gen7_optimizations(pcie_packet, processing_ns);
+        }
+        const sc_time propagation((processing_ns + m_link_layer.link_latency_ns), SC_NS);
+        const sc_time update_fc(m_link_layer.update_fc_latency_ns, SC_NS);
+        const sc_time replay_timeout(m_link_layer.replay_timeout_ns, SC_NS);
+        const double bytes_per_ns = pcie_packet->get_link_speed_gbps() * pcie_packet->lanes / 8.0;
+        const uint32_t header_size = pcie_packet->tlp_header.get_header_size();
+        
+        const bool with_data = carries_data(*pcie_packet);
+        const bool return_on_delivery = !m_loosely_timed;
+        HeldCredits held = {tlp_class, 0, 0};
+        
+        double serialization_ns = 0.0;
+        double link_bytes = 0.0;
+        delivery_time = now;
+        for (uint32_t i = 0; i < link_tlps; i++) {
+            bool msix = (i == tlps);
+            uint32_t tlp_payload = msix ? PCIePacket::MSIX_WRITE_BYTES
+                                        : (tlps == 1) ? payload : std::min(split, payload - i * split);
+            uint32_t data_bytes = (with_data || msix) ? tlp_payload : 0;
+            double wire_bytes = (header_size + data_bytes) * (1.0 + crc_scheme.overhead_percent / 100.0);
+            sc_time tlp_time(wire_bytes / bytes_per_ns, SC_NS);
+            
+            // Header-only TLPs carry no data credits; data credits are 16-byte units
+            uint32_t data_credits = (data_bytes + 15) / 16;
+            bool stalled = false;
+            sc_time earliest = now;
+            while (!credits.acquire(earliest, data_credits, stalled)) {
+                // Every credit is held by TLPs the receiver has not consumed yet
+                stalled = true;
+                if (!return_on_delivery) {
+                    break;      // Loosely timed: returns are always scheduled, not reached
+                }
+                if (held.headers > 0 || held.data > 0) {
+                    // The transfer outgrows the pool: the receiver drains its earlier TLPs
+                    // on arrival, or it could never be delivered
+                    credits.release_at(delivery_time + update_fc, held.data, held.headers);
+                    held.headers = 0;
+                    held.data = 0;
+                    continue;
+                }
+                SelfProfiler::wait(m_credits_returned);
+                earliest = std::max(earliest, sc_time_stamp());
+            }
+            if (stalled) {
+                m_credit_stalls++;
+            }
+            
+            sc_time start = reserve_link(earliest, tlp_time);
+            sc_time end = start + tlp_time;
+            serialization_ns += tlp_time.to_seconds() * 1e9;
+            
+            // NAK -> replay from the replay buffer once the round trip has elapsed
+            uint32_t replays = 0;
+            while (m_enable_crc_simulation && pcie_packet->should_crc_error_occur(m_rng)) {
+                m_total_crc_errors++;
+                if (++replays > m_link_layer.max_replays) {
+                    // Dropped: this TLP's credits and those held for the earlier ones come back
+                    credits.release_at(end + update_fc, data_credits + held.data, 1 + held.headers);
+                    return false;
+                }
+                m_total_retries++;
+                start = reserve_replay(end + replay_timeout, tlp_time);
+                end = start + tlp_time;
+                serialization_ns += tlp_time.to_seconds() * 1e9;
+            }
+            
+            sc_time arrival = end + propagation;
+            if (return_on_delivery) {
+                held.headers++;
+                held.data += data_credits;
+            } else {
+                credits.release_at(arrival + update_fc, data_credits);
+            }
+            link_bytes += wire_bytes;
+            if (arrival > delivery_time) {
+                delivery_time = arrival;
+            }
+        }
+        
+        if (return_on_delivery) {
+            m_held_credits[pcie_packet.get()] = held;
+        }
+        m_total_tlps += link_tlps;
+        m_link_utilization.update_utilization(static_cast<uint32_t>(link_bytes + 0.5), serialization_ns);
+        return true;
+    }
+    
+    // Next free slot of length duration at or after earliest, around reserved replays
+    sc_time reserve_link(const sc_time& earliest, const sc_time& duration) {
+        sc_time start = std::max(earliest, m_tx_free);
+        auto it = m_replay_slots.begin();
+        while (it != m_replay_slots.end()) {
+            if (it->second <= start) {
+                it = m_replay_slots.erase(it);      // Already behind the transmitter
+                continue;
+            }
+            if (start + duration <= it->first) {
+                break;                              // Fits in the gap before this replay
+            }
+            start = it->second;
+            it = m_replay_slots.erase(it);
+        }
+        m_tx_free = start + duration;
+        return start;
+    }
+    
+    // Replays take the first gap after ready without moving the transmitter
+    sc_time reserve_replay(const sc_time& ready, const sc_time& duration) {
+        sc_time start = std::max(ready, m_tx_free);
+        for (auto it = m_replay_slots.begin(); it != m_replay_slots.end(); ++it) {
+            if (it->second <= start) continue;
+            if (start + duration <= it->first) break;
+            start = it->second;
+        }
+        m_replay_slots[start] = start + duration;
+        return start;
+    }
+    
     // Process individual PCIe packet with timing and CRC simulation
     bool process_pcie_packet(std::shared_ptr<PCIePacket> pcie_packet) {
         const PCIeCRCScheme& crc_scheme = pcie_packet->get_crc_scheme();
@@ -261,7 +786,7 @@ SC_MODULE(PCIeDelayLine) {
         
         // Apply delay
         if (total_delay_ns > 0.0) {
-            wait(total_delay_ns, SC_NS);
+            apply_delay(sc_time(total_delay_ns, SC_NS));
         }
         
         // Update link utilization
@@ -270,7 +795,7 @@ SC_MODULE(PCIeDelayLine) {
         // CRC error simulation
         bool crc_success = true;
         if (m_enable_crc_simulation) {
-            crc_success = !pcie_packet->should_crc_error_occur();
+            crc_success = !pcie_packet->should_crc_error_occur(m_rng);
             if (!crc_success) {
                 m_total_crc_errors++;
                 pcie_packet->crc_error_injected = true;
@@ -284,6 +809,7 @@ SC_MODULE(PCIeDelayLine) {
                       << " x" << static_cast<int>(m_lanes)
                       << ", Tag: " << pcie_packet->tlp_header.tag
                       << ", Size: " << pcie_packet->total_packet_size << "B"
+                      << " (" << pcie_packet->tlp_count << " TLP)"
                       << ", Delay: " << std::fixed << std::setprecision(1) << total_delay_ns << "ns"
                       << ", Util: " << std::setprecision(1) << m_link_utilization.current_utilization << "%"
                       << ", CRC: " << (crc_success ? "OK" : "ERROR")
@@ -291,9 +817,19 @@ SC_MODULE(PCIeDelayLine) {
         }
         
         m_total_processing_time_ns += total_delay_ns;
+        m_processing_histogram.record(static_cast<uint64_t>(total_delay_ns + 0.5));
         return crc_success;
     }
     
+    // wait() in APPROXIMATE mode, annotate local time in LOOSE mode
+    void apply_delay(const sc_time& delay) {
+        if (m_loosely_timed) {
+            m_quantum_keeper.inc(delay);
+        } else {
+            SelfProfiler::wait(delay);
+        }
+    }
+    
     // Apply Gen7 AI-based optimizations
     double apply_gen7_optimizations(std::shared_ptr<PCIePacket> pcie_packet, double base_delay) const {
         if (m_generation != PCIeGeneration::GEN7) {
@@ -328,73 +864,32 @@ SC_MODULE(PCIeDelayLine) {
         return std::max(1.0, optimized_delay);  // Minimum 1ns delay
     }
     
-    // Packet conversion methods
-    std::shared_ptr<PCIePacket> convert_to_pcie_packet(std::shared_ptr<PacketType> packet) {
-        // Try direct cast first
-        auto pcie_packet = std::dynamic_pointer_cast<PCIePacket>(packet);
-        if (pcie_packet) {
-            return pcie_packet;
-        }
-        
-        // Use custom converter if available
-        if (m_to_pcie_converter) {
-            return m_to_pcie_converter(packet);
-        }
-        
-        // Default conversion for BasePacket-derived types
-        auto base_packet = std::dynamic_pointer_cast<BasePacket>(packet);
-        if (base_packet) {
-            return std::make_shared<PCIePacket>(base_packet, m_generation, m_lanes);
-        }
-        
-        return nullptr;
-    }
-    
-    std::shared_ptr<PacketType> convert_from_pcie_packet(std::shared_ptr<PCIePacket> pcie_packet) {
-        // Try direct cast first
-        auto packet = std::dynamic_pointer_cast<PacketType>(pcie_packet);
-        if (packet) {
-            return packet;
-        }
-        
-        // Use custom converter if available
-        if (m_from_pcie_converter) {
-            return m_from_pcie_converter(pcie_packet);
-        }
-        
-        // Return original packet if available
-        if (pcie_packet->original_packet) {
-            auto original = std::dynamic_pointer_cast<PacketType>(pcie_packet->original_packet);
-            if (original) {
-                // Update original packet with any changes
-                original->set_databyte(static_cast<unsigned char>(pcie_packet->data_payload_size));
-                return original;
-            }
-        }
-        
-        // Last resort: return the PCIePacket as-is (if types are compatible)
-        return std::dynamic_pointer_cast<PacketType>(pcie_packet);
-    }
-    
     // Constructor
     PCIeDelayLine(sc_module_name name,
                   PCIeGeneration generation = PCIeGeneration::GEN3,
                   uint8_t lanes = 8,
                   bool debug_enable = false,
                   bool enable_crc_simulation = true,
-                  bool enable_congestion_model = true)
+                  bool enable_congestion_model = true,
+                  PCIeLinkMode link_mode = PCIeLinkMode::SERIAL)
         : sc_module(name),
           m_generation(generation),
           m_lanes(lanes),
           m_debug_enable(debug_enable),
           m_enable_crc_simulation(enable_crc_simulation),
           m_enable_congestion_model(enable_congestion_model),
-          m_rng(std::random_device{}()),
-          m_error_dist(0.0, 1.0),
+          m_max_payload_size(0),
+          m_rng(RandomService::stream(this->name())),
           m_total_packets_processed(0),
+          m_total_tlps(0),
           m_total_crc_errors(0),
           m_total_retries(0),
-          m_total_processing_time_ns(0.0) {
+          m_total_processing_time_ns(0.0),
+          m_loosely_timed(TemporalDecoupling::is_loosely_timed()),
+          m_link_mode(link_mode),
+          m_completion_link(false),
+          m_tx_free(SC_ZERO_TIME),
+          m_credit_stalls(0) {
         
         if (m_debug_enable) {
             const PCIeCRCScheme& crc_scheme = PCIeGenerationSpecs::get_crc_scheme(m_generation);
@@ -407,30 +902,38 @@ SC_MODULE(PCIeDelayLine) {
                       << ")" << std::endl;
         }
         
-        SC_THREAD(process_packets);
+        configure_link_layer(m_link_layer);
+        register_stats();
+        spawn_link_processes();
     }
     
-    // Constructor with custom converters
+    // Constructor with custom converters (Conversion = FunctionPCIeConversion)
     PCIeDelayLine(sc_module_name name,
                   std::function<std::shared_ptr<PCIePacket>(std::shared_ptr<PacketType>)> to_pcie,
                   std::function<std::shared_ptr<PacketType>(std::shared_ptr<PCIePacket>)> from_pcie,
                   PCIeGeneration generation = PCIeGeneration::GEN3,
                   uint8_t lanes = 8,
-                  bool debug_enable = false)
+                  bool debug_enable = false,
+                  PCIeLinkMode link_mode = PCIeLinkMode::SERIAL)
         : sc_module(name),
           m_generation(generation),
           m_lanes(lanes),
           m_debug_enable(debug_enable),
           m_enable_crc_simulation(true),
           m_enable_congestion_model(true),
-          m_rng(std::random_device{}()),
-          m_error_dist(0.0, 1.0),
+          m_max_payload_size(0),
+          m_rng(RandomService::stream(this->name())),
           m_total_packets_processed(0),
+          m_total_tlps(0),
           m_total_crc_errors(0),
           m_total_retries(0),
           m_total_processing_time_ns(0.0),
-          m_to_pcie_converter(to_pcie),
-          m_from_pcie_converter(from_pcie) {
+          m_loosely_timed(TemporalDecoupling::is_loosely_timed()),
+          m_conversion(to_pcie, from_pcie),
+          m_link_mode(link_mode),
+          m_completion_link(false),
+          m_tx_free(SC_ZERO_TIME),
+          m_credit_stalls(0) {
         
         if (m_debug_enable) {
             const PCIeCRCScheme& crc_scheme = PCIeGenerationSpecs::get_crc_scheme(m_generation);
@@ -443,18 +946,52 @@ SC_MODULE(PCIeDelayLine) {
                       << ")" << std::endl;
         }
         
-        SC_THREAD(process_packets);
+        configure_link_layer(m_link_layer);
+        register_stats();
+        spawn_link_processes();
+    }
+    
+    // SERIAL: one process does the whole transfer. PIPELINED: a transmitter and, when timed,
+    // a delivery process (loosely timed transfers are annotated and written by the transmitter)
+    void spawn_link_processes() {
+        if (m_link_mode == PCIeLinkMode::PIPELINED) {
+            SC_THREAD(pipelined_transmit_process);
+            if (!m_loosely_timed) {
+                SC_THREAD(pipelined_delivery_process);
+            }
+        } else {
+            SC_THREAD(process_packets);
+        }
     }
     
     // Statistics and monitoring methods
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("packets", &m_total_packets_processed);
+        m_stats_group.counter("tlps", &m_total_tlps);
+        m_stats_group.counter("crc_errors", &m_total_crc_errors);
+        m_stats_group.counter("retries", &m_total_retries);
+        m_stats_group.counter("credit_stalls", &m_credit_stalls);
+        m_stats_group.counter("bytes", &m_link_utilization.total_bytes_transmitted, "bytes");
+        m_stats_group.gauge("utilization_current", &m_link_utilization.current_utilization, "percent");
+        m_stats_group.gauge("utilization_avg", &m_link_utilization.average_utilization, "percent");
+        m_stats_group.gauge("peak_in_flight", [this]() { return static_cast<double>(get_peak_in_flight()); }, "packets");
+        m_stats_group.histogram("delay", &m_processing_histogram);
+    }
+    
     uint64_t get_total_packets_processed() const { return m_total_packets_processed; }
+    uint64_t get_total_tlps() const { return m_total_tlps; }
     uint64_t get_total_crc_errors() const { return m_total_crc_errors; }
     uint64_t get_total_retries() const { return m_total_retries; }
+    uint64_t get_credit_stalls() const { return m_credit_stalls; }
+    size_t get_peak_in_flight() const { return m_delivery_queue.peak_in_flight(); }
     double get_average_processing_time_ns() const {
         return (m_total_packets_processed > 0) ? 
                (m_total_processing_time_ns / m_total_packets_processed) : 0.0;
     }
     
+    uint64_t get_quantum_sync_count() const { return m_quantum_keeper.get_sync_count(); }
+    
     double get_current_utilization() const { return m_link_utilization.current_utilization; }
     double get_average_utilization() const { return m_link_utilization.average_utilization; }
     
@@ -478,10 +1015,32 @@ SC_MODULE(PCIeDelayLine) {
     void set_max_congestion_delay(double max_delay_ns) {
         m_congestion_model.max_congestion_delay_ns = std::max(0.0, max_delay_ns);
     }
+    
+    // TLP payload limit (pcie.link_configuration.max_payload_size)
+    void set_max_payload_size(uint32_t max_payload_size) { m_max_payload_size = max_payload_size; }
+    uint32_t get_max_payload_size() const { return m_max_payload_size; }
+    
+    // Link-layer model (constructor argument)
+    PCIeLinkMode get_link_mode() const { return m_link_mode; }
+    
+    // Completion link: every TLP uses completion credits (the device -> host direction)
+    void set_completion_link(bool completion_link) { m_completion_link = completion_link; }
+    
+    void configure_link_layer(const PCIeLinkLayerConfig& link_layer) {
+        m_link_layer = link_layer;
+        m_credits[static_cast<int>(PCIeCreditClass::POSTED)].configure(link_layer.posted_header_credits,
+                                                                       link_layer.posted_data_credits);
+        m_credits[static_cast<int>(PCIeCreditClass::NON_POSTED)].configure(link_layer.non_posted_header_credits,
+                                                                           link_layer.non_posted_data_credits);
+        m_credits[static_cast<int>(PCIeCreditClass::COMPLETION)].configure(link_layer.completion_header_credits,
+                                                                           link_layer.completion_data_credits);
+    }
+    const PCIeLinkLayerConfig& get_link_layer() const { return m_link_layer; }
 };
 
 // Type aliases for common configurations
 using PCIeBasePacketDelayLine = PCIeDelayLine<BasePacket>;
+using PCIeTlpDelayLine = PCIeDelayLine<PCIePacket>;
 using PCIeGen3DelayLine = PCIeDelayLine<BasePacket>;
 using PCIeGen7DelayLine = PCIeDelayLine<BasePacket>;
 
@@ -505,4 +1064,18 @@ PCIeDelayLine<PacketType>* create_pcie_delay_line(
     return new PCIeDelayLine<PacketType>(name, generation, lanes, debug_enable);
 }
 
+// PCIe DelayLine with runtime packet converters (custom packet types)
+template<typename PacketType>
+PCIeDelayLine<PacketType, FunctionPCIeConversion<PacketType>>* create_pcie_delay_line(
+    sc_module_name name,
+    std::function<std::shared_ptr<PCIePacket>(std::shared_ptr<PacketType>)> to_pcie,
+    std::function<std::shared_ptr<PacketType>(std::shared_ptr<PCIePacket>)> from_pcie,
+    PCIeGeneration generation = PCIeGeneration::GEN3,
+    uint8_t lanes = 8,
+    bool debug_enable = false) {
+    
+    return new PCIeDelayLine<PacketType, FunctionPCIeConversion<PacketType>>(
+        name, to_pcie, from_pcie, generation, lanes, debug_enable);
+}
+
 #endif
\ No newline at end of file
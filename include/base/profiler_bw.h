@@ -94,6 +94,15 @@ public:
         }
     }
     
+    // Restart the statistics (timed phase after a fast-forward warm-up)
+    void reset() {
+        m_total_bytes = 0;
+        m_total_packets = 0;
+        m_current_period_bytes = 0;
+        m_current_period_packets = 0;
+        m_last_report_time = sc_time_stamp();
+    }
+    
     // Get current statistics (for external queries)
     struct ProfileStats {
         unsigned long long total_bytes;
@@ -199,11 +208,11 @@ private:
         }
     }
     
-    // Extract databyte from packet - specialized for different packet types
+    // Extract transfer size from packet - specialized for different packet types
     unsigned int get_packet_databyte(const PacketType& packet) {
-        // Try to get databyte attribute from packet
+        // Transfer length (falls back to the databyte attribute)
         try {
-            return static_cast<unsigned int>(packet.get_attribute("databyte"));
+            return static_cast<unsigned int>(packet_transfer_length(packet));
         } catch (...) {
             // If attribute doesn't exist, assume default size
             if (m_debug_enable) {
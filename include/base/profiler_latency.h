@@ -4,15 +4,35 @@
 #include <systemc.h>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
 #include "packet/base_packet.h"
+#include "base/latency_histogram.h"
+#include "common/stats_registry.h"
+
+// Per-period percentile source
+enum class LatencyStatsMode {
+    HISTOGRAM,   // Log-linear histogram only: fixed memory, O(buckets) percentiles
+    EXACT        // Also keep every period sample and sort it at report time (validation)
+};
+
+inline LatencyStatsMode parse_latency_stats_mode(const std::string& mode_str) {
+    if (mode_str == "EXACT") return LatencyStatsMode::EXACT;
+    return LatencyStatsMode::HISTOGRAM;
+}
+
+inline const char* latency_stats_mode_name(LatencyStatsMode mode) {
+    return (mode == LatencyStatsMode::EXACT) ? "EXACT" : "HISTOGRAM";
+}
 
 // Latency profiler for measuring request-to-response latency
-// Tracks packets by index and calculates latency statistics
+// Tracks packets by index and calculates latency statistics.
+// In-flight request timestamps live in a flat array indexed by the IndexAllocator tag
+// (sized from max_index, grown if a larger tag shows up). Each latency is recorded in a
+// per-period and a cumulative LatencyHistogram, so overall p50..p99.99 are available at
+// any time (and live in StatsRegistry snapshots).
 template<typename PacketType>
 SC_MODULE(ProfilerLatency) {
     SC_HAS_PROCESS(ProfilerLatency);
@@ -21,32 +41,58 @@ public:
     ProfilerLatency(sc_module_name name,
                     const std::string& profiler_name,
                     sc_time reporting_period = sc_time(100, SC_MS),
-                    bool debug_enable = false)
+                    bool debug_enable = false,
+                    LatencyStatsMode stats_mode = LatencyStatsMode::HISTOGRAM,
+                    unsigned int max_index = 1024)
         : sc_module(name), m_profiler_name(profiler_name),
           m_reporting_period(reporting_period),
           m_debug_enable(debug_enable),
+          m_stats_mode(stats_mode),
           m_total_requests(0),
           m_total_responses(0),
           m_total_latency(SC_ZERO_TIME),
+          m_total_latency_sq_ns(0.0),
           m_min_latency(sc_time(1, SC_SEC)),  // Initialize to high value
           m_max_latency(SC_ZERO_TIME),
-          m_last_report_time(SC_ZERO_TIME) {
+          m_last_report_time(SC_ZERO_TIME),
+          m_request_timestamps(max_index, SC_ZERO_TIME),
+          m_request_pending(max_index, 0),
+          m_pending_requests(0) {
+        
+        m_stats_group.set_prefix(this->name());
+        m_stats_group.counter("requests", &m_total_requests);
+        m_stats_group.counter("responses", &m_total_responses);
+        m_stats_group.counter("pending_requests", &m_pending_requests);
+        m_stats_group.histogram("latency", &m_cumulative_histogram);
         
         // Start the reporting thread (inactive for now, similar to ProfilerBW)
         SC_THREAD(reporting_process);
         
         std::cout << sc_time_stamp() << " | " << m_profiler_name 
                   << ": Latency profiler initialized with reporting period " 
-                  << m_reporting_period << std::endl;
+                  << m_reporting_period << " (" << latency_stats_mode_name(m_stats_mode) << " mode)" << std::endl;
     }
     
     // Function to profile a request packet (called when request is sent)
     void profile_request(const PacketType& packet) {
+        profile_request_at(packet, sc_time_stamp());
+    }
+    
+    // Explicit-timestamp variant (loosely-timed mode passes the packet's annotated time)
+    void profile_request_at(const PacketType& packet, const sc_time& current_time) {
         unsigned int packet_index = get_packet_index(packet);
-        sc_time current_time = sc_time_stamp();
         
         // Store request timestamp
+        if (packet_index >= m_request_timestamps.size()) {
+            size_t new_size = std::max<size_t>(packet_index + 1, m_request_timestamps.size() * 2);
+            m_request_timestamps.resize(new_size, SC_ZERO_TIME);
+            m_request_pending.resize(new_size, 0);
+        }
         m_request_timestamps[packet_index] = current_time;
+        if (!m_request_pending[packet_index]) {
+            m_request_pending[packet_index] = 1;
+            m_pending_requests++;
+        }
         m_total_requests++;
         
         if (m_debug_enable) {
@@ -63,26 +109,35 @@ public:
     
     // Function to profile a response packet (called when response is received)
     void profile_response(const PacketType& packet) {
+        profile_response_at(packet, sc_time_stamp());
+    }
+    
+    void profile_response_at(const PacketType& packet, const sc_time& current_time) {
         unsigned int packet_index = get_packet_index(packet);
-        sc_time current_time = sc_time_stamp();
         
         // Look for matching request
-        auto request_it = m_request_timestamps.find(packet_index);
-        if (request_it != m_request_timestamps.end()) {
+        if (packet_index < m_request_pending.size() && m_request_pending[packet_index]) {
             // Calculate latency
-            sc_time latency = current_time - request_it->second;
+            sc_time latency = current_time - m_request_timestamps[packet_index];
             
             // Update statistics
             m_total_responses++;
             m_total_latency += latency;
-            m_current_period_latencies.push_back(latency);
+            double latency_ns = latency.to_seconds() * 1000000000;
+            m_total_latency_sq_ns += latency_ns * latency_ns;
+            m_period_histogram.record(static_cast<uint64_t>(latency_ns + 0.5));
+            m_cumulative_histogram.record(static_cast<uint64_t>(latency_ns + 0.5));
+            if (m_stats_mode == LatencyStatsMode::EXACT) {
+                m_current_period_latencies.push_back(latency);
+            }
             
             // Update min/max
             if (latency < m_min_latency) m_min_latency = latency;
             if (latency > m_max_latency) m_max_latency = latency;
             
             // Remove the request from tracking
-            m_request_timestamps.erase(request_it);
+            m_request_pending[packet_index] = 0;
+            m_pending_requests--;
             
             if (m_debug_enable) {
                 std::cout << sc_time_stamp() << " | " << m_profiler_name 
@@ -120,6 +175,22 @@ public:
         report_current_period();
     }
     
+    // Restart the statistics and forget in-flight requests (timed phase after a fast-forward warm-up)
+    void reset() {
+        m_total_requests = 0;
+        m_total_responses = 0;
+        m_total_latency = SC_ZERO_TIME;
+        m_total_latency_sq_ns = 0.0;
+        m_min_latency = sc_time(1, SC_SEC);
+        m_max_latency = SC_ZERO_TIME;
+        m_last_report_time = sc_time_stamp();
+        std::fill(m_request_pending.begin(), m_request_pending.end(), 0);
+        m_pending_requests = 0;
+        m_period_histogram.reset();
+        m_cumulative_histogram.reset();
+        m_current_period_latencies.clear();
+    }
+    
     // Get current statistics
     struct LatencyStats {
         unsigned long long total_requests;
@@ -128,35 +199,68 @@ public:
         sc_time min_latency;
         sc_time max_latency;
         unsigned long long pending_requests;
+        double stddev_latency_ns;
+        // Overall percentiles (histogram resolution, < 1% relative error)
+        double p50_latency_ns;
+        double p95_latency_ns;
+        double p99_latency_ns;
+        double p999_latency_ns;
+        double p9999_latency_ns;
     };
     
     LatencyStats get_stats() const {
         sc_time avg_latency = (m_total_responses > 0) ? 
             sc_time(m_total_latency.to_seconds() / m_total_responses, SC_SEC) : SC_ZERO_TIME;
             
-        return {m_total_requests, m_total_responses, avg_latency, 
-                m_min_latency, m_max_latency, m_request_timestamps.size()};
+        double stddev_ns = 0.0;
+        if (m_total_responses > 1) {
+            double mean_ns = m_total_latency.to_seconds() * 1000000000 / m_total_responses;
+            double variance = (m_total_latency_sq_ns - m_total_responses * mean_ns * mean_ns) / (m_total_responses - 1);
+            stddev_ns = (variance > 0.0) ? std::sqrt(variance) : 0.0;
+        }
+            
+        const LatencyHistogram& overall = m_cumulative_histogram;
+        return {m_total_requests, m_total_responses, avg_latency,
+                m_min_latency, m_max_latency, m_pending_requests, stddev_ns,
+                overall.value_at_percentile(50.0), overall.value_at_percentile(95.0),
+                overall.value_at_percentile(99.0), overall.value_at_percentile(99.9),
+                overall.value_at_percentile(99.99)};
+    }
+    
+    // Overall latency at a percentile (0-100), in ns
+    double get_percentile_ns(double percentile) const {
+        return m_cumulative_histogram.value_at_percentile(percentile);
     }
+    
+    const LatencyHistogram& get_cumulative_histogram() const { return m_cumulative_histogram; }
+    LatencyStatsMode get_stats_mode() const { return m_stats_mode; }
 
 private:
     // Configuration
     const std::string m_profiler_name;
     const sc_time m_reporting_period;
     const bool m_debug_enable;
+    const LatencyStatsMode m_stats_mode;
     
     // Statistics
     unsigned long long m_total_requests;
     unsigned long long m_total_responses;
     sc_time m_total_latency;
+    double m_total_latency_sq_ns;       // Sum of squared latencies for overall std deviation
     sc_time m_min_latency;
     sc_time m_max_latency;
     sc_time m_last_report_time;
     
-    // Request tracking
-    std::unordered_map<unsigned int, sc_time> m_request_timestamps;
+    // Request tracking (flat, indexed by packet index)
+    std::vector<sc_time> m_request_timestamps;
+    std::vector<unsigned char> m_request_pending;
+    unsigned long long m_pending_requests;
     
     // Current period tracking
-    std::vector<sc_time> m_current_period_latencies;
+    LatencyHistogram m_period_histogram;
+    LatencyHistogram m_cumulative_histogram;
+    std::vector<sc_time> m_current_period_latencies;   // EXACT mode only
+    StatsGroup m_stats_group;
     
     // Calculate percentile from sorted latency vector
     sc_time calculate_percentile(const std::vector<sc_time>& sorted_latencies, double percentile) const {
@@ -179,22 +283,6 @@ private:
         return sc_time(interpolated_ns / 1000000000, SC_SEC);
     }
     
-    // Calculate standard deviation
-    double calculate_std_deviation(const std::vector<sc_time>& latencies, sc_time mean) const {
-        if (latencies.size() <= 1) return 0.0;
-        
-        double sum_squared_diff = 0.0;
-        double mean_ns = mean.to_seconds() * 1000000000;
-        
-        for (const auto& latency : latencies) {
-            double latency_ns = latency.to_seconds() * 1000000000;
-            double diff = latency_ns - mean_ns;
-            sum_squared_diff += diff * diff;
-        }
-        
-        return std::sqrt(sum_squared_diff / (latencies.size() - 1));
-    }
-    
     // Periodic reporting process thread (inactive - similar to ProfilerBW)
     void reporting_process() {
         // This process is primarily for future extension
@@ -205,32 +293,25 @@ private:
     void report_current_period() {
         sc_time current_time = sc_time_stamp();
         
-        if (!m_current_period_latencies.empty()) {
-            // Calculate period statistics
-            sc_time period_total(SC_ZERO_TIME);
-            sc_time period_min = m_current_period_latencies[0];
-            sc_time period_max = m_current_period_latencies[0];
+        if (!m_period_histogram.empty()) {
+            const LatencyHistogram& period = m_period_histogram;
+            double period_median_ns = period.value_at_percentile(50.0);
+            double period_p95_ns = period.value_at_percentile(95.0);
+            double period_p99_ns = period.value_at_percentile(99.0);
+            double period_p999_ns = period.value_at_percentile(99.9);
+            double period_p9999_ns = period.value_at_percentile(99.99);
             
-            for (const auto& latency : m_current_period_latencies) {
-                period_total += latency;
-                if (latency < period_min) period_min = latency;
-                if (latency > period_max) period_max = latency;
+            // EXACT mode: interpolated percentiles from the sorted period samples
+            if (m_stats_mode == LatencyStatsMode::EXACT && !m_current_period_latencies.empty()) {
+                std::vector<sc_time> sorted_latencies = m_current_period_latencies;
+                std::sort(sorted_latencies.begin(), sorted_latencies.end());
+                period_median_ns = calculate_percentile(sorted_latencies, 50.0).to_seconds() * 1000000000;
+                period_p95_ns = calculate_percentile(sorted_latencies, 95.0).to_seconds() * 1000000000;
+                period_p99_ns = calculate_percentile(sorted_latencies, 99.0).to_seconds() * 1000000000;
+                period_p999_ns = calculate_percentile(sorted_latencies, 99.9).to_seconds() * 1000000000;
+                period_p9999_ns = calculate_percentile(sorted_latencies, 99.99).to_seconds() * 1000000000;
             }
             
-            sc_time period_avg(period_total.to_seconds() / m_current_period_latencies.size(), SC_SEC);
-            
-            // Sort latencies for percentile calculations
-            std::vector<sc_time> sorted_latencies = m_current_period_latencies;
-            std::sort(sorted_latencies.begin(), sorted_latencies.end());
-            
-            // Calculate percentiles
-            sc_time period_median = calculate_percentile(sorted_latencies, 50.0);
-            sc_time period_p95 = calculate_percentile(sorted_latencies, 95.0);
-            sc_time period_p99 = calculate_percentile(sorted_latencies, 99.0);
-            
-            // Calculate standard deviation
-            double period_stddev = calculate_std_deviation(m_current_period_latencies, period_avg);
-            
             // Overall average
             sc_time overall_avg = (m_total_responses > 0) ? 
                 sc_time(m_total_latency.to_seconds() / m_total_responses, SC_SEC) : SC_ZERO_TIME;
@@ -239,29 +320,34 @@ private:
             std::cout << "\n" << std::string(60, '=') << std::endl;
             std::cout << sc_time_stamp() << " | " << m_profiler_name << " LATENCY REPORT" << std::endl;
             std::cout << std::string(60, '=') << std::endl;
-            std::cout << "  Period responses: " << m_current_period_latencies.size() << std::endl;
+            std::cout << "  Period responses: " << period.count() << std::endl;
             std::cout << "  Period avg latency: " << std::fixed << std::setprecision(1) 
-                      << period_avg.to_seconds() * 1000000000 << " ns" << std::endl;
+                      << period.mean() << " ns" << std::endl;
             std::cout << "  Period min latency: " << std::fixed << std::setprecision(1) 
-                      << period_min.to_seconds() * 1000000000 << " ns" << std::endl;
+                      << static_cast<double>(period.min()) << " ns" << std::endl;
             std::cout << "  Period max latency: " << std::fixed << std::setprecision(1) 
-                      << period_max.to_seconds() * 1000000000 << " ns" << std::endl;
+                      << static_cast<double>(period.max()) << " ns" << std::endl;
             std::cout << "  Period median latency: " << std::fixed << std::setprecision(1) 
-                      << period_median.to_seconds() * 1000000000 << " ns" << std::endl;
+                      << period_median_ns << " ns" << std::endl;
             std::cout << "  Period 95th percentile: " << std::fixed << std::setprecision(1) 
-                      << period_p95.to_seconds() * 1000000000 << " ns" << std::endl;
+                      << period_p95_ns << " ns" << std::endl;
             std::cout << "  Period 99th percentile: " << std::fixed << std::setprecision(1) 
-                      << period_p99.to_seconds() * 1000000000 << " ns" << std::endl;
+                      << period_p99_ns << " ns" << std::endl;
+            std::cout << "  Period 99.9th percentile: " << std::fixed << std::setprecision(1) 
+                      << period_p999_ns << " ns" << std::endl;
+            std::cout << "  Period 99.99th percentile: " << std::fixed << std::setprecision(1) 
+                      << period_p9999_ns << " ns" << std::endl;
             std::cout << "  Period std deviation: " << std::fixed << std::setprecision(1) 
-                      << period_stddev << " ns" << std::endl;
+                      << period.stddev() << " ns" << std::endl;
             std::cout << "  Overall avg latency: " << std::fixed << std::setprecision(1) 
                       << overall_avg.to_seconds() * 1000000000 << " ns" << std::endl;
             std::cout << "  Total requests: " << m_total_requests << std::endl;
             std::cout << "  Total responses: " << m_total_responses << std::endl;
-            std::cout << "  Pending requests: " << m_request_timestamps.size() << std::endl;
+            std::cout << "  Pending requests: " << m_pending_requests << std::endl;
             std::cout << std::string(60, '=') << std::endl;
             
             // Reset period counters
+            m_period_histogram.reset();
             m_current_period_latencies.clear();
         }
         
@@ -271,7 +357,7 @@ private:
     // Extract index from packet for tracking
     unsigned int get_packet_index(const PacketType& packet) {
         try {
-            return static_cast<unsigned int>(packet.get_attribute("index"));
+            return static_cast<unsigned int>(get_field<PacketField::INDEX>(packet));
         } catch (...) {
             if (m_debug_enable) {
                 std::cout << sc_time_stamp() << " | " << m_profiler_name 
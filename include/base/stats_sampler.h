@@ -0,0 +1,53 @@
+#ifndef STATS_SAMPLER_H
+#define STATS_SAMPLER_H
+
+#include <systemc.h>
+#include <string>
+#include "common/stats_registry.h"
+#include "common/error_handling.h"
+
+// Periodic StatsRegistry snapshots into a binary StatsSnapshotWriter file.
+// The file is opened at start of simulation, after every module has registered its stats.
+// One snapshot is a read per registered column, so fine intervals (1 us) stay cheap.
+SC_MODULE(StatsSampler) {
+    SC_HAS_PROCESS(StatsSampler);
+
+    StatsSampler(sc_module_name name, const std::string& output_file, sc_time interval)
+        : sc_module(name),
+          m_output_file(output_file),
+          m_interval(interval) {
+        SC_THREAD(sampling_process);
+    }
+
+    ~StatsSampler() { m_writer.close(); }
+
+    uint64_t get_snapshot_count() const { return m_writer.get_snapshot_count(); }
+
+    // Write buffered rows (end of simulation)
+    void flush() { m_writer.flush(); }
+
+protected:
+    void start_of_simulation() override {
+        if (!m_writer.open(m_output_file)) {
+            SOC_SIM_WARNING("StatsSampler", soc_sim::error::codes::CONFIGURATION_ERROR,
+                            "Cannot open stats snapshot file " + m_output_file);
+        }
+    }
+
+private:
+    const std::string m_output_file;
+    const sc_time m_interval;
+    StatsSnapshotWriter m_writer;
+
+    void sampling_process() {
+        if (m_interval == SC_ZERO_TIME) {
+            return;
+        }
+        while (m_writer.is_open()) {
+            m_writer.append(sc_time_stamp().to_seconds() * 1e9);
+            wait(m_interval);
+        }
+    }
+};
+
+#endif // STATS_SAMPLER_H
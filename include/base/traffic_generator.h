@@ -4,6 +4,11 @@
 #include <systemc.h>
 #include "packet/base_packet.h" // Include BasePacket
 #include "packet/generic_packet.h" // Include GenericPacket
+#include "packet/packet_pool.h" // Pooled packet allocation
+#include "common/quantum_keeper.h" // Loosely-timed mode
+#include "common/random.h" // Per-module random streams
+#include "base/block_trace.h" // Trace replay
+#include <functional>
 #include <memory> // For smart pointers
 #include <random> // For C++11 random library
 #include <string>
@@ -21,9 +26,23 @@ enum class TrafficPattern {
     BURST,         // Burst of packets followed by idle
     POISSON,       // Poisson arrival process
     EXPONENTIAL,   // Exponential inter-arrival times
-    NORMAL         // Normally distributed intervals
+    NORMAL,        // Normally distributed intervals
+    TRACE_REPLAY   // Captured block I/O trace (trace_file)
 };
 
+// Trace replay timing
+// OPEN_LOOP:   issue every record at its (scaled) trace timestamp; max_outstanding only
+//              caps the in-flight count, records held back by it are counted as late
+// CLOSED_LOOP: issue as soon as an outstanding slot frees, keeping the (scaled) trace
+//              gap to the previous record as think time
+enum class TraceReplayMode {
+    OPEN_LOOP,
+    CLOSED_LOOP
+};
+
+// Fast-forward warm-up: receives each warm-up I/O to apply functionally (untimed)
+typedef std::function<void(const std::shared_ptr<BasePacket>&)> FastForwardTarget;
+
 // Workload templates
 enum class WorkloadTemplate {
     CUSTOM,        // User-defined parameters
@@ -43,7 +62,9 @@ SC_MODULE(TrafficGenerator) {
     const unsigned int m_locality_percentage; // 0-100: 0=random, 100=sequential
     const unsigned int m_write_percentage; // 0-100: 0=all reads, 100=all writes
     const unsigned char m_databyte_value;
-    const unsigned int m_num_transactions;
+    const uint32_t m_transfer_length;        // Bytes per I/O (0 = databyte_value); carried as one packet
+    const bool m_attach_payload;             // Writes reference a shared payload buffer (zero-copy)
+    unsigned int m_num_transactions;         // TRACE_REPLAY: clamped to the trace length
     const bool m_debug_enable;
     const unsigned int m_start_address;
     const unsigned int m_end_address;
@@ -63,7 +84,18 @@ SC_MODULE(TrafficGenerator) {
     const double m_delay_mean;              // Mean for exponential/normal
     const double m_delay_stddev;            // Standard deviation for normal
     const double m_poisson_rate;            // Rate parameter for Poisson
-
+    
+    // Trace replay parameters (TRACE_REPLAY)
+    const std::string m_trace_file;
+    const BlockTraceFormat m_trace_format;
+    const double m_trace_time_scale;        // Trace time multiplier (0.5 = replay 2x faster)
+    const TraceReplayMode m_trace_replay_mode;
+    
+    // Fast-forward warm-up: I/Os applied through the functional target before the timed
+    // ones, until fast_forward_transactions or fast_forward_until_ns (whichever comes first)
+    const unsigned int m_fast_forward_transactions;
+    const sc_time m_fast_forward_until;
+    
     void run();
     
     // Statistics getter methods
@@ -76,8 +108,12 @@ SC_MODULE(TrafficGenerator) {
     }
     
     // Method to notify completion of a transaction
-    void notify_completion() {
+    // completion_time: annotated completion time in loosely-timed mode (SC_ZERO_TIME = now)
+    void notify_completion(const sc_time& completion_time = SC_ZERO_TIME) {
         m_transactions_completed++;
+        if (completion_time > m_last_completion_time) {
+            m_last_completion_time = completion_time;
+        }
         if (m_outstanding_count > 0) {
             m_outstanding_count--;
         }
@@ -90,7 +126,25 @@ SC_MODULE(TrafficGenerator) {
     bool has_outstanding_capacity() const { 
         return (m_max_outstanding == 0) || (m_outstanding_count < m_max_outstanding); 
     }
-
+    
+    // Loosely-timed mode statistics
+    bool is_loosely_timed() const { return m_loosely_timed; }
+    uint64_t get_quantum_sync_count() const { return m_quantum_keeper.get_sync_count(); }
+    
+    // Trace replay statistics
+    uint64_t get_trace_records() const { return m_trace_reader.size(); }
+    unsigned int get_trace_late_count() const { return m_trace_late_count; }
+    
+    // Fast-forward warm-up; set before the simulation starts. done runs once the warm-up
+    // I/Os have been applied, before the first timed one is generated.
+    bool has_fast_forward() const { return m_fast_forward_transactions > 0 || m_fast_forward_until > SC_ZERO_TIME; }
+    void set_fast_forward_target(const FastForwardTarget& target,
+                                 const std::function<void()>& done = std::function<void()>()) {
+        m_fast_forward_target = target;
+        m_fast_forward_done = done;
+    }
+    unsigned int get_fast_forwarded() const { return m_fast_forwarded; }
+    
     // Updated constructor with new parameter
     TrafficGenerator(sc_module_name name, sc_time interval, unsigned int locality_percentage, unsigned int write_percentage, unsigned char databyte_value, unsigned int num_transactions, bool debug_enable = false, unsigned int start_address = 0, unsigned int end_address = 0xFF, unsigned int address_increment = 0x10);
     
@@ -110,12 +164,21 @@ private:
     
     // Outstanding transaction flow control
     sc_event m_completion_event;                   // Event for completion notifications
+    sc_time m_last_completion_time;                // Latest annotated completion time (LOOSE mode)
+    
+    // Temporal decoupling (TimingMode::LOOSE): inter-arrival gaps are annotated, not waited
+    const bool m_loosely_timed;
+    QuantumKeeper m_quantum_keeper;
     
-    std::mt19937 m_random_generator; // Random number generator
-    std::uniform_int_distribution<int> m_address_dist; // Address distribution
-    std::uniform_int_distribution<int> m_data_dist; // Data distribution
-    std::uniform_int_distribution<int> m_locality_dist; // For locality percentage (0-99)
-    std::uniform_int_distribution<int> m_write_dist; // For write percentage (0-99)
+    RandomStream m_random_generator; // This generator's stream of the RandomService seed
+    std::uniform_int_distribution<int> m_data_dist; // Data distribution (trace records, payloads)
+    
+    // Per-packet draws of generate_packet(), produced DRAW_BLOCK packets at a time:
+    // locality (0-99), write (0-99), random address offset and data lanes
+    static const size_t DRAW_BLOCK = 256;
+    std::vector<uint32_t> m_draws;
+    size_t m_next_draw;
+    void refill_draws();
     
     // Additional distributions for advanced patterns
     std::exponential_distribution<double> m_exponential_dist;
@@ -123,6 +186,21 @@ private:
     std::poisson_distribution<int> m_poisson_dist;
     std::uniform_real_distribution<double> m_uniform_real_dist;
     
+    // Trace replay state
+    BlockTraceReader m_trace_reader;
+    unsigned int m_trace_late_count;        // OPEN_LOOP records issued after their timestamp
+    uint64_t m_trace_time_base_ns;          // Timed replay starts here (last fast-forwarded record)
+    
+    // Fast-forward state
+    FastForwardTarget m_fast_forward_target;
+    std::function<void()> m_fast_forward_done;
+    unsigned int m_fast_forwarded;
+    
+    // Write payload shared by every packet of one size (attach_payload)
+    PayloadRef m_payload;
+    uint32_t m_payload_length;
+    PayloadRef payload_for(uint32_t length);
+    
     // Helper methods
     void apply_workload_template();
     sc_time generate_next_interval();
@@ -130,6 +208,13 @@ private:
     void run_constant_pattern();
     void run_burst_pattern();
     void run_stochastic_pattern();
+    void run_trace_replay();
+    void run_fast_forward();
+    void open_trace();
+    std::shared_ptr<GenericPacket> generate_trace_packet(const BlockTraceRecord& record);
+    sc_time local_time() const;
+    void wait_for_outstanding_capacity();
+    void advance_time(const sc_time& delay);
 };
 
 #endif
\ No newline at end of file
@@ -12,8 +12,32 @@
 #include "packet/base_packet.h"
 #include "cache_l1.h"
 #include "dram_controller.h"
+#include "common/stats_registry.h"
+#include "common/metrics_ring.h"
+#include "common/error_handling.h"
 
-// Web-based real-time profiler for SystemC simulations
+// How WebProfiler hands metrics to web_monitor
+// FILE:     rewrite the metrics JSON file every update interval (polled by app.py)
+// SHM_RING: push one fixed-size record per interval into a shared-memory ring
+//           (common/metrics_ring.h); the dashboard decodes every record
+enum class WebTransport {
+    FILE,
+    SHM_RING
+};
+
+inline WebTransport parse_web_transport(const std::string& transport_str) {
+    if (transport_str == "SHM_RING" || transport_str == "SHM") return WebTransport::SHM_RING;
+    return WebTransport::FILE;
+}
+
+inline const char* web_transport_name(WebTransport transport) {
+    return (transport == WebTransport::SHM_RING) ? "SHM_RING" : "FILE";
+}
+
+// Web-based real-time profiler for SystemC simulations.
+// Cache and DRAM sections are read from the modules' StatsRegistry entries.
+// In SHM_RING mode the record layout is fixed at start of simulation:
+//   sim_time_ns, timestamp_ms, performance.*, caches.<name>.*, dram.<name>.*
 template<typename PacketType>
 SC_MODULE(WebProfiler) {
     SC_HAS_PROCESS(WebProfiler);
@@ -22,16 +46,25 @@ SC_MODULE(WebProfiler) {
     const std::string m_output_file;
     const sc_time m_update_interval;
     const bool m_debug_enable;
+    const WebTransport m_transport;
+    const std::string m_ring_name;
+    const unsigned int m_ring_capacity;
     
     // Constructor
     WebProfiler(sc_module_name name,
                const std::string& output_file = "web_monitor/metrics.json",
                sc_time update_interval = sc_time(1, SC_SEC),
-               bool debug_enable = false)
+               bool debug_enable = false,
+               WebTransport transport = WebTransport::FILE,
+               const std::string& ring_name = "moon_sim_metrics",
+               unsigned int ring_capacity = 4096)
         : sc_module(name),
           m_output_file(output_file),
           m_update_interval(update_interval),
           m_debug_enable(debug_enable),
+          m_transport(transport),
+          m_ring_name(ring_name),
+          m_ring_capacity(ring_capacity),
           m_packet_count(0),
           m_total_bandwidth(0),
           m_last_update_time(SC_ZERO_TIME)
@@ -40,24 +73,24 @@ SC_MODULE(WebProfiler) {
         reset_metrics();
         
         if (m_debug_enable) {
-            std::cout << sc_time_stamp() << " | WebProfiler: Initialized with output=" 
-                      << m_output_file << ", interval=" << m_update_interval << std::endl;
+            std::cout << sc_time_stamp() << " | WebProfiler: Initialized with output="
+                      << (m_transport == WebTransport::SHM_RING ? "/dev/shm/" + m_ring_name : m_output_file)
+                      << ", interval=" << m_update_interval << std::endl;
         }
         
         SC_THREAD(update_process);
     }
     
-    // Register cache for monitoring
+    // Register cache for monitoring (its registry prefix is the module name)
     template<int CACHE_SIZE_KB, int LINE_SIZE, int WAYS>
-    void register_cache(CacheL1<CACHE_SIZE_KB, LINE_SIZE, WAYS>* cache, const std::string& name) {
-        m_caches[name] = reinterpret_cast<void*>(cache);
-        m_cache_types[name] = "L1";
+    void register_cache(const CacheL1<CACHE_SIZE_KB, LINE_SIZE, WAYS>* cache, const std::string& name) {
+        m_caches[name] = cache->name();
     }
     
     // Register DRAM controller for monitoring
     template<int NUM_BANKS, int NUM_RANKS>
-    void register_dram(DramController<NUM_BANKS, NUM_RANKS>* dram, const std::string& name) {
-        m_dram_controllers[name] = reinterpret_cast<void*>(dram);
+    void register_dram(const DramController<NUM_BANKS, NUM_RANKS>* dram, const std::string& name) {
+        m_dram_controllers[name] = dram->name();
     }
     
     // Profile packet processing (called by components)
@@ -78,17 +111,39 @@ SC_MODULE(WebProfiler) {
     void force_update() {
         update_metrics();
     }
+    
+    uint64_t get_dropped_records() const { return m_ring.get_dropped(); }
+
+protected:
+    void start_of_simulation() override {
+        if (m_transport == WebTransport::SHM_RING) {
+            open_ring();
+        }
+    }
+    
+    void end_of_simulation() override {
+        if (m_ring.is_open() && m_ring.get_dropped() > 0) {
+            SOC_SIM_WARNING(name(), soc_sim::error::codes::RESOURCE_EXHAUSTED,
+                            std::to_string(m_ring.get_dropped()) + " metric records dropped (consumer too slow)");
+        }
+        m_ring.close();
+    }
 
 private:
     // Metrics storage
     uint64_t m_packet_count;
     uint64_t m_total_bandwidth;
     std::map<std::string, uint64_t> m_component_packets;
-    std::map<std::string, void*> m_caches;
-    std::map<std::string, std::string> m_cache_types;
-    std::map<std::string, void*> m_dram_controllers;
+    std::map<std::string, std::string> m_caches;             // Display name -> registry prefix
+    std::map<std::string, std::string> m_dram_controllers;   // Display name -> registry prefix
     sc_time m_last_update_time;
     
+    // SHM_RING transport
+    MetricsRing m_ring;
+    std::vector<size_t> m_ring_columns;   // StatsRegistry column per record field after the fixed ones
+    std::vector<double> m_record;
+    static const size_t FIXED_FIELDS = 5;
+    
     // Update process - runs periodically
     void update_process() {
         while (true) {
@@ -117,11 +172,15 @@ private:
         double packet_rate = m_packet_count / elapsed_seconds;
         double bandwidth_mbps = (m_total_bandwidth * 8.0) / (elapsed_seconds * 1e6);
         
-        // Generate JSON output
-        std::string json_output = generate_json_metrics(current_time, packet_rate, bandwidth_mbps);
-        
-        // Write to file
-        write_json_file(json_output);
+        if (m_transport == WebTransport::SHM_RING) {
+            push_record(current_time, packet_rate, bandwidth_mbps);
+        } else {
+            // Generate JSON output
+            std::string json_output = generate_json_metrics(current_time, packet_rate, bandwidth_mbps);
+            
+            // Write to file
+            write_json_file(json_output);
+        }
         
         // Reset for next period
         m_last_update_time = current_time;
@@ -133,6 +192,61 @@ private:
         }
     }
     
+    // Freeze the record layout: the fixed fields, then every registry column of each
+    // registered cache and DRAM controller
+    void open_ring() {
+        std::vector<std::string> fields;
+        fields.push_back("simulation_time_ns");
+        fields.push_back("timestamp");
+        fields.push_back("metrics.performance.packet_rate_pps");
+        fields.push_back("metrics.performance.bandwidth_mbps");
+        fields.push_back("metrics.performance.total_packets");
+        
+        const std::vector<StatColumn>& columns = StatsRegistry::instance().columns();
+        m_ring_columns.clear();
+        add_ring_columns(fields, columns, m_caches, "metrics.caches.");
+        add_ring_columns(fields, columns, m_dram_controllers, "metrics.dram.");
+        m_record.assign(fields.size(), 0.0);
+        
+        if (!m_ring.open(m_ring_name, fields, m_ring_capacity)) {
+            SOC_SIM_WARNING(name(), soc_sim::error::codes::CONFIGURATION_ERROR,
+                            "Cannot create shared-memory ring " + m_ring_name + ", falling back to " + m_output_file);
+        }
+    }
+    
+    void add_ring_columns(std::vector<std::string>& fields, const std::vector<StatColumn>& columns,
+                          const std::map<std::string, std::string>& modules, const std::string& section) {
+        for (const auto& module : modules) {
+            std::string prefix = module.second + ".";
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (columns[i].path.compare(0, prefix.size(), prefix) == 0) {
+                    fields.push_back(section + module.first + "." + columns[i].path.substr(prefix.size()));
+                    m_ring_columns.push_back(i);
+                }
+            }
+        }
+    }
+    
+    // Enqueue one record; the sim thread never formats or blocks here
+    void push_record(sc_time timestamp, double packet_rate, double bandwidth_mbps) {
+        if (!m_ring.is_open()) {
+            write_json_file(generate_json_metrics(timestamp, packet_rate, bandwidth_mbps));
+            return;
+        }
+        auto now = std::chrono::system_clock::now();
+        m_record[0] = timestamp.to_seconds() * 1e9;
+        m_record[1] = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+        m_record[2] = packet_rate;
+        m_record[3] = bandwidth_mbps;
+        m_record[4] = static_cast<double>(m_packet_count);
+        const StatsRegistry& registry = StatsRegistry::instance();
+        for (size_t i = 0; i < m_ring_columns.size(); ++i) {
+            m_record[FIXED_FIELDS + i] = registry.read(m_ring_columns[i]);
+        }
+        m_ring.push(m_record.data());
+    }
+    
     // Generate JSON metrics string
     std::string generate_json_metrics(sc_time timestamp, double packet_rate, double bandwidth_mbps) {
         std::ostringstream json;
@@ -162,7 +276,7 @@ private:
             first_cache = false;
             
             json << "      \"" << cache_pair.first << "\": ";
-            json << get_cache_json(cache_pair.second, cache_pair.first);
+            StatsRegistry::instance().write_json(json, cache_pair.second + ".", 3);
         }
         json << "\\n    },\\n";
         
@@ -174,7 +288,7 @@ private:
             first_dram = false;
             
             json << "      \"" << dram_pair.first << "\": ";
-            json << get_dram_json(dram_pair.second, dram_pair.first);
+            StatsRegistry::instance().write_json(json, dram_pair.second + ".", 3);
         }
         json << "\\n    },\\n";
         
@@ -195,48 +309,6 @@ private:
         return json.str();
     }
     
-    // Get cache statistics as JSON string
-    std::string get_cache_json(void* cache_ptr, const std::string& name) {
-        std::ostringstream json;
-        json << std::fixed << std::setprecision(2);
-        
-        // For now, return placeholder data
-        // In real implementation, we'd cast cache_ptr and get actual stats
-        json << "{\\n";
-        json << "        \"type\": \"L1\",\\n";
-        json << "        \"size_kb\": 32,\\n";
-        json << "        \"hits\": 0,\\n";
-        json << "        \"misses\": 0,\\n";
-        json << "        \"hit_rate\": 0.0,\\n";
-        json << "        \"evictions\": 0,\\n";
-        json << "        \"writebacks\": 0\\n";
-        json << "      }";
-        
-        return json.str();
-    }
-    
-    // Get DRAM statistics as JSON string
-    std::string get_dram_json(void* dram_ptr, const std::string& name) {
-        std::ostringstream json;
-        json << std::fixed << std::setprecision(2);
-        
-        // For now, return placeholder data
-        // In real implementation, we'd cast dram_ptr and get actual stats
-        json << "{\\n";
-        json << "        \"total_requests\": 0,\\n";
-        json << "        \"read_requests\": 0,\\n";
-        json << "        \"write_requests\": 0,\\n";
-        json << "        \"row_hits\": 0,\\n";
-        json << "        \"row_misses\": 0,\\n";
-        json << "        \"row_hit_rate\": 0.0,\\n";
-        json << "        \"bank_conflicts\": 0,\\n";
-        json << "        \"avg_read_latency_ns\": 0.0,\\n";
-        json << "        \"avg_write_latency_ns\": 0.0\\n";
-        json << "      }";
-        
-        return json.str();
-    }
-    
     // Write JSON to file
     void write_json_file(const std::string& json_content) {
         // Create directory if it doesn't exist
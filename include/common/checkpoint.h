@@ -0,0 +1,243 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Binary SSD state checkpoint (preconditioned drive state).
+// Layout: 8-byte magic "MOONCKP1", format version, the geometry table the state was
+// taken with, then named sections (name, byte length, payload) written by each module.
+// A reader indexes the sections up front, so modules restore in any order and a
+// missing section is detected instead of misread.
+
+// Geometry the checkpoint is only valid for: (name, value) pairs from ssd_config.json
+class CheckpointGeometry {
+public:
+    void add(const std::string& name, uint64_t value) { m_fields.push_back(std::make_pair(name, value)); }
+
+    const std::vector<std::pair<std::string, uint64_t>>& fields() const { return m_fields; }
+
+    // Empty when identical, otherwise the first differing field ("num_channels: checkpoint 8, config 16")
+    std::string mismatch(const CheckpointGeometry& config) const {
+        if (m_fields.size() != config.m_fields.size()) {
+            return "geometry field count: checkpoint " + std::to_string(m_fields.size()) +
+                   ", config " + std::to_string(config.m_fields.size());
+        }
+        for (size_t i = 0; i < m_fields.size(); i++) {
+            if (m_fields[i] != config.m_fields[i]) {
+                return m_fields[i].first + ": checkpoint " + std::to_string(m_fields[i].second) +
+                       ", config " + (config.m_fields[i].first == m_fields[i].first
+                                          ? std::to_string(config.m_fields[i].second)
+                                          : config.m_fields[i].first);
+            }
+        }
+        return std::string();
+    }
+
+private:
+    std::vector<std::pair<std::string, uint64_t>> m_fields;
+};
+
+namespace checkpoint_format {
+    static const char MAGIC[8] = {'M', 'O', 'O', 'N', 'C', 'K', 'P', '1'};
+    static const uint32_t VERSION = 1;
+}
+
+class CheckpointWriter {
+public:
+    bool open(const std::string& path, const CheckpointGeometry& geometry) {
+        m_file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open()) {
+            m_error = "cannot create " + path;
+            return false;
+        }
+        m_file.write(checkpoint_format::MAGIC, sizeof(checkpoint_format::MAGIC));
+        put(checkpoint_format::VERSION);
+        put(static_cast<uint32_t>(geometry.fields().size()));
+        for (const auto& field : geometry.fields()) {
+            put_string(field.first);
+            put(field.second);
+        }
+        return m_file.good();
+    }
+
+    // Section payloads are buffered and written with their length on end_section()
+    void begin_section(const std::string& name) {
+        m_section_name = name;
+        m_section.clear();
+    }
+
+    void end_section() {
+        put_string(m_section_name);
+        put(static_cast<uint64_t>(m_section.size()));
+        m_file.write(m_section.data(), static_cast<std::streamsize>(m_section.size()));
+        m_section.clear();
+    }
+
+    void write_bytes(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        m_section.insert(m_section.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "CheckpointWriter::write: trivially copyable types only");
+        write_bytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T>& values) {
+        write(static_cast<uint64_t>(values.size()));
+        if (!values.empty()) {
+            write_bytes(values.data(), values.size() * sizeof(T));
+        }
+    }
+
+    bool close() {
+        m_file.close();
+        return !m_file.fail();
+    }
+
+    const std::string& get_error() const { return m_error; }
+
+private:
+    template<typename T>
+    void put(const T& value) { m_file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    void put_string(const std::string& value) {
+        put(static_cast<uint16_t>(value.size()));
+        m_file.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    std::ofstream m_file;
+    std::string m_section_name;
+    std::vector<char> m_section;
+    std::string m_error;
+};
+
+class CheckpointReader {
+public:
+    CheckpointReader() : m_remaining(0), m_failed(false) {}
+
+    bool open(const std::string& path) {
+        m_file.open(path.c_str(), std::ios::binary);
+        if (!m_file.is_open()) {
+            return fail("cannot open " + path);
+        }
+        char magic[sizeof(checkpoint_format::MAGIC)];
+        uint32_t version = 0, field_count = 0;
+        if (!m_file.read(magic, sizeof(magic)) || std::memcmp(magic, checkpoint_format::MAGIC, sizeof(magic)) != 0) {
+            return fail(path + " is not a checkpoint file");
+        }
+        if (!get(version) || version != checkpoint_format::VERSION) {
+            return fail("unsupported checkpoint version " + std::to_string(version));
+        }
+        if (!get(field_count)) {
+            return fail("truncated checkpoint header");
+        }
+        for (uint32_t i = 0; i < field_count; i++) {
+            std::string name;
+            uint64_t value = 0;
+            if (!get_string(name) || !get(value)) {
+                return fail("truncated checkpoint header");
+            }
+            m_geometry.add(name, value);
+        }
+
+        // Index the sections
+        while (m_file.peek() != std::char_traits<char>::eof()) {
+            std::string name;
+            uint64_t length = 0;
+            if (!get_string(name) || !get(length)) {
+                return fail("truncated checkpoint section table");
+            }
+            m_sections[name] = std::make_pair(static_cast<uint64_t>(m_file.tellg()), length);
+            m_file.seekg(static_cast<std::streamoff>(length), std::ios::cur);
+        }
+        m_file.clear();
+        return true;
+    }
+
+    const CheckpointGeometry& geometry() const { return m_geometry; }
+
+    bool has_section(const std::string& name) const { return m_sections.count(name) > 0; }
+
+    bool begin_section(const std::string& name) {
+        auto it = m_sections.find(name);
+        if (it == m_sections.end()) {
+            return fail("checkpoint has no section " + name);
+        }
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(it->second.first));
+        m_remaining = it->second.second;
+        m_section_name = name;
+        return true;
+    }
+
+    bool read_bytes(void* data, size_t size) {
+        if (m_failed) return false;
+        if (size > m_remaining || !m_file.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+            return fail("section " + m_section_name + " is truncated");
+        }
+        m_remaining -= size;
+        return true;
+    }
+
+    template<typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "CheckpointReader::read: trivially copyable types only");
+        return read_bytes(&value, sizeof(T));
+    }
+
+    // expected_size guards against a table sized for another geometry
+    template<typename T>
+    bool read_vector(std::vector<T>& values, uint64_t expected_size) {
+        uint64_t size = 0;
+        if (!read(size)) return false;
+        if (size != expected_size) {
+            return fail("section " + m_section_name + ": table size " + std::to_string(size) +
+                        ", expected " + std::to_string(expected_size));
+        }
+        values.resize(static_cast<size_t>(size));
+        return values.empty() || read_bytes(&values[0], values.size() * sizeof(T));
+    }
+
+    // Reports an inconsistency found by a module's restore
+    bool fail(const std::string& error) {
+        if (!m_failed) {
+            m_failed = true;
+            m_error = error;
+        }
+        return false;
+    }
+
+    bool ok() const { return !m_failed; }
+    const std::string& get_error() const { return m_error; }
+
+private:
+    template<typename T>
+    bool get(T& value) { return static_cast<bool>(m_file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+    bool get_string(std::string& value) {
+        uint16_t length = 0;
+        if (!get(length)) return false;
+        value.resize(length);
+        return length == 0 || static_cast<bool>(m_file.read(&value[0], length));
+    }
+
+    std::ifstream m_file;
+    CheckpointGeometry m_geometry;
+    std::map<std::string, std::pair<uint64_t, uint64_t>> m_sections;   // name -> (offset, length)
+    std::string m_section_name;
+    uint64_t m_remaining;
+    bool m_failed;
+    std::string m_error;
+};
+
+#endif
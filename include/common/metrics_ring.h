@@ -0,0 +1,150 @@
+#ifndef METRICS_RING_H
+#define METRICS_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Lock-free single-producer / single-consumer ring of fixed-size metric records in
+// POSIX shared memory (/dev/shm/<name>). The simulation thread is the only producer:
+// push() copies one record and publishes it with a release store, and never blocks -
+// when the consumer falls behind the record is dropped and counted instead.
+// The consumer (web_monitor/metrics_ring.py) owns read_index.
+//
+// Segment layout (little-endian, every field naturally aligned):
+//   header  : MetricsRingHeader (2 cache lines, indices on separate lines)
+//   names   : NAMES_BYTES of '\n'-separated field names, NUL-padded
+//   records : capacity x num_fields x f64
+struct MetricsRingHeader {
+    char magic[8];                      // "MOONRING"
+    uint32_t version;
+    uint32_t num_fields;                // f64 values per record
+    uint32_t capacity;                  // Records, power of two
+    uint32_t names_bytes;
+    std::atomic<uint32_t> producer_done;  // Set (release) when the simulation closes the ring
+    uint32_t reserved;
+    std::atomic<uint64_t> dropped;      // Records lost because the ring was full
+    char pad0[64 - 40];
+    std::atomic<uint64_t> write_index;  // Producer: records published
+    char pad1[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> read_index;   // Consumer: records consumed
+    char pad2[64 - sizeof(std::atomic<uint64_t>)];
+};
+
+class MetricsRing {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint32_t NAMES_BYTES = 16384;
+
+    MetricsRing() : m_header(nullptr), m_records(nullptr), m_size(0), m_fd(-1) {}
+    ~MetricsRing() { close(); }
+
+    // Creates (or recreates) the segment. Capacity is rounded up to a power of two.
+    bool open(const std::string& name, const std::vector<std::string>& field_names, uint32_t capacity) {
+        close();
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared-memory ring needs lock-free 64-bit atomics");
+
+        std::string names;
+        for (const std::string& field : field_names) {
+            names += field;
+            names += '\n';
+        }
+        if (field_names.empty() || names.size() > NAMES_BYTES) {
+            return false;
+        }
+        uint32_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+
+        m_name = (name.empty() || name[0] != '/') ? "/" + name : name;
+        shm_unlink(m_name.c_str());
+        m_fd = shm_open(m_name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (m_fd < 0) {
+            return false;
+        }
+        m_size = sizeof(MetricsRingHeader) + NAMES_BYTES +
+                 static_cast<size_t>(rounded) * field_names.size() * sizeof(double);
+        void* base = MAP_FAILED;
+        if (ftruncate(m_fd, static_cast<off_t>(m_size)) == 0) {
+            base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        }
+        if (base == MAP_FAILED) {
+            ::close(m_fd);
+            m_fd = -1;
+            shm_unlink(m_name.c_str());
+            return false;
+        }
+
+        m_header = static_cast<MetricsRingHeader*>(base);
+        char* names_area = static_cast<char*>(base) + sizeof(MetricsRingHeader);
+        std::memset(names_area, 0, NAMES_BYTES);
+        std::memcpy(names_area, names.data(), names.size());
+        m_records = reinterpret_cast<double*>(names_area + NAMES_BYTES);
+
+        m_header->version = FORMAT_VERSION;
+        m_header->num_fields = static_cast<uint32_t>(field_names.size());
+        m_header->capacity = rounded;
+        m_header->names_bytes = NAMES_BYTES;
+        m_header->producer_done.store(0, std::memory_order_relaxed);
+        m_header->dropped.store(0, std::memory_order_relaxed);
+        m_header->write_index.store(0, std::memory_order_relaxed);
+        m_header->read_index.store(0, std::memory_order_relaxed);
+        // Magic last: a reader that sees it sees an initialized header
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(m_header->magic, "MOONRING", 8);
+        return true;
+    }
+
+    bool is_open() const { return m_header != nullptr; }
+    uint32_t num_fields() const { return m_header ? m_header->num_fields : 0; }
+    uint64_t get_pushed() const { return m_header ? m_header->write_index.load(std::memory_order_relaxed) : 0; }
+    uint64_t get_dropped() const { return m_header ? m_header->dropped.load(std::memory_order_acquire) : 0; }
+
+    // Non-blocking: returns false (and counts a drop) when the consumer is a full ring behind
+    bool push(const double* values) {
+        if (!m_header) return false;
+        uint64_t write = m_header->write_index.load(std::memory_order_relaxed);
+        uint64_t read = m_header->read_index.load(std::memory_order_acquire);
+        if (write - read >= m_header->capacity) {
+            // Single producer: a plain load/store pair, published with release like write_index
+            m_header->dropped.store(m_header->dropped.load(std::memory_order_relaxed) + 1,
+                                    std::memory_order_release);
+            return false;
+        }
+        size_t slot = static_cast<size_t>(write & (m_header->capacity - 1));
+        std::memcpy(m_records + slot * m_header->num_fields, values, m_header->num_fields * sizeof(double));
+        m_header->write_index.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Marks the stream finished; the segment stays until the next open() so the
+    // consumer can drain it after the simulation exits.
+    void close() {
+        if (!m_header) return;
+        // Release: a reader that sees producer_done sees every record and drop count before it
+        m_header->producer_done.store(1, std::memory_order_release);
+        munmap(m_header, m_size);
+        ::close(m_fd);
+        m_header = nullptr;
+        m_records = nullptr;
+        m_fd = -1;
+    }
+
+private:
+    MetricsRingHeader* m_header;
+    double* m_records;
+    size_t m_size;
+    int m_fd;
+    std::string m_name;
+
+    static_assert(sizeof(std::atomic<uint32_t>) == 4 && sizeof(std::atomic<uint64_t>) == 8,
+                  "shared-memory ring fields must have the size of their plain types");
+    static_assert(sizeof(MetricsRingHeader) == 192, "MetricsRingHeader layout is shared with metrics_ring.py");
+};
+
+#endif // METRICS_RING_H
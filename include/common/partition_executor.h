@@ -0,0 +1,123 @@
+#ifndef PARTITION_EXECUTOR_H
+#define PARTITION_EXECUTOR_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for partitioned execution of independent model partitions
+// (one flash channel = one partition). SystemC itself stays single-threaded: a
+// partition hands its model computation to a worker and joins the result from its
+// own SystemC process no earlier than the lookahead allows. A partition is pinned
+// to one worker, so its jobs run in submission order, exactly as in serial mode.
+class PartitionWorker {
+public:
+    typedef uint64_t Ticket;
+
+    PartitionWorker() : m_submitted(0), m_completed(0), m_stop(false) {
+        m_thread = std::thread(&PartitionWorker::run, this);
+    }
+
+    ~PartitionWorker() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_job_ready.notify_one();
+        m_thread.join();
+    }
+
+    Ticket submit(std::function<void()> job) {
+        Ticket ticket;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(job);
+            ticket = ++m_submitted;
+        }
+        m_job_ready.notify_one();
+        return ticket;
+    }
+
+    // Blocks the calling (SystemC) thread until the job behind ticket has run
+    void wait_for(Ticket ticket) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job_done.wait(lock, [this, ticket]() { return m_completed >= ticket; });
+    }
+
+    void drain() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job_done.wait(lock, [this]() { return m_completed >= m_submitted; });
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_job_ready.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+                if (m_jobs.empty()) {
+                    return;     // Stopped and drained
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+            {
+                // The job's captures go before the ticket completes: the submitter still
+                // holds its references then, so nothing is freed on this thread
+                std::lock_guard<std::mutex> lock(m_mutex);
+                job = nullptr;
+                m_completed++;
+            }
+            m_job_done.notify_all();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_job_ready;
+    std::condition_variable m_job_done;
+    std::deque<std::function<void()>> m_jobs;
+    Ticket m_submitted;
+    Ticket m_completed;
+    bool m_stop;
+    std::thread m_thread;
+};
+
+// Fixed pool of workers; partitions are spread round-robin
+class PartitionExecutor {
+public:
+    // num_threads 0 = one per hardware thread; never more than num_partitions
+    PartitionExecutor(unsigned num_threads, size_t num_partitions) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        size_t count = std::max<size_t>(1, std::min<size_t>(num_threads, num_partitions));
+        for (size_t i = 0; i < count; i++) {
+            m_workers.push_back(std::unique_ptr<PartitionWorker>(new PartitionWorker()));
+        }
+    }
+
+    PartitionWorker* worker_for(size_t partition) const {
+        return m_workers[partition % m_workers.size()].get();
+    }
+
+    size_t num_threads() const { return m_workers.size(); }
+
+    void drain() const {
+        for (const auto& worker : m_workers) {
+            worker->drain();
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<PartitionWorker>> m_workers;
+};
+
+#endif
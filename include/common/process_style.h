@@ -0,0 +1,31 @@
+#ifndef PROCESS_STYLE_H
+#define PROCESS_STYLE_H
+
+#include <string>
+
+// SystemC process style for simple forwarding/latency stages.
+// THREAD: infinite-loop SC_THREAD blocking on fifo read/write (coroutine switch per hop)
+// METHOD: SC_METHOD state machine re-armed with next_trigger() on fifo events
+//         (no coroutine stack or context switch; same packet-level timing)
+enum class ProcessStyle {
+    THREAD,
+    METHOD
+};
+
+// State of an SC_METHOD forwarding stage between activations
+enum class MethodStageState {
+    READ,    // Waiting for an input packet
+    DELAY,   // Packet held for its latency
+    WRITE    // Waiting for output space
+};
+
+inline ProcessStyle parse_process_style(const std::string& style_str) {
+    if (style_str == "METHOD") return ProcessStyle::METHOD;
+    return ProcessStyle::THREAD;
+}
+
+inline const char* process_style_name(ProcessStyle style) {
+    return (style == ProcessStyle::METHOD) ? "METHOD" : "THREAD";
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef QUANTUM_KEEPER_H
+#define QUANTUM_KEEPER_H
+
+#include <systemc.h>
+#include <string>
+#include <cstdint>
+
+// Global timing style of the Host -> PCIe -> SSD path
+// APPROXIMATE: every latency is a wait() (default, cycle-approximate ordering)
+// LOOSE:       initiators run ahead of simulated time by up to a global quantum;
+//              latencies accumulate as annotated local time and wait() only on sync
+enum class TimingMode {
+    APPROXIMATE,
+    LOOSE
+};
+
+inline TimingMode parse_timing_mode(const std::string& mode_str) {
+    if (mode_str == "LOOSE" || mode_str == "LT") return TimingMode::LOOSE;
+    return TimingMode::APPROXIMATE;
+}
+
+inline const char* timing_mode_name(TimingMode mode) {
+    return (mode == TimingMode::LOOSE) ? "LOOSE" : "APPROXIMATE";
+}
+
+// Process-wide temporal decoupling settings (cf. tlm_global_quantum).
+// Set once from simulation_config.json before the modules are constructed.
+class TemporalDecoupling {
+public:
+    static TimingMode get_mode() { return mode_ref(); }
+    static void set_mode(TimingMode mode) { mode_ref() = mode; }
+    static bool is_loosely_timed() { return mode_ref() == TimingMode::LOOSE; }
+
+    static const sc_time& get_global_quantum() { return quantum_ref(); }
+    static void set_global_quantum(const sc_time& quantum) { quantum_ref() = quantum; }
+
+private:
+    static TimingMode& mode_ref() {
+        static TimingMode mode = TimingMode::APPROXIMATE;
+        return mode;
+    }
+    static sc_time& quantum_ref() {
+        static sc_time quantum(1, SC_US);
+        return quantum;
+    }
+};
+
+// Per-initiator quantum keeper (cf. tlm_utils::tlm_quantumkeeper).
+// Keeps the absolute local time of one process; inc() annotates a latency without
+// yielding, sync() yields once the local time is a full quantum ahead of sc_time_stamp().
+// Local time is absolute, so time that passes while the process is blocked on a fifo
+// is absorbed automatically instead of being counted twice.
+class QuantumKeeper {
+public:
+    QuantumKeeper()
+        : m_local_time(SC_ZERO_TIME), m_total_annotated(SC_ZERO_TIME), m_sync_count(0) {}
+
+    // Absolute local time of this process (never behind simulated time)
+    sc_time get_current_time() const {
+        const sc_time& now = sc_time_stamp();
+        return (m_local_time > now) ? m_local_time : now;
+    }
+
+    // How far this process is ahead of simulated time
+    sc_time get_local_time() const {
+        return get_current_time() - sc_time_stamp();
+    }
+
+    // Annotate a latency
+    void inc(const sc_time& delay) {
+        m_local_time = get_current_time() + delay;
+        m_total_annotated += delay;
+    }
+
+    // Work cannot start before its input arrived (e.g. a packet's annotated time)
+    void align_to(const sc_time& arrival_time) {
+        if (arrival_time > m_local_time) {
+            m_local_time = arrival_time;
+        }
+    }
+
+    bool need_sync() const {
+        return get_local_time() >= TemporalDecoupling::get_global_quantum();
+    }
+
+    // Yield until simulated time catches up with the local time
+    void sync() {
+        sc_time offset = get_local_time();
+        if (offset > SC_ZERO_TIME) {
+            wait(offset);
+        }
+        m_sync_count++;
+    }
+
+    void sync_if_needed() {
+        if (need_sync()) {
+            sync();
+        }
+    }
+
+    // Annotated time a packet has reached on its path (never behind simulated time)
+    template<typename PacketType>
+    static sc_time packet_time(const PacketType& packet) {
+        const sc_time& now = sc_time_stamp();
+        return (packet.get_lt_time() > now) ? packet.get_lt_time() : now;
+    }
+
+    uint64_t get_sync_count() const { return m_sync_count; }
+    const sc_time& get_total_annotated() const { return m_total_annotated; }
+
+private:
+    sc_time m_local_time;
+    sc_time m_total_annotated;
+    uint64_t m_sync_count;
+};
+
+#endif
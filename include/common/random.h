@@ -0,0 +1,128 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+// Random number stream of one model: xoshiro256++ (Blackman & Vigna), 256-bit state and
+// a handful of shifts/adds per 64-bit draw. It is a UniformRandomBitGenerator, so the
+// <random> distributions take it in place of std::mt19937. Seeded through splitmix64.
+class RandomStream {
+public:
+    typedef uint64_t result_type;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+    explicit RandomStream(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        uint64_t x = seed;
+        for (int i = 0; i < 4; i++) {
+            m_state[i] = splitmix64(x);
+        }
+    }
+
+    result_type operator()() {
+        const uint64_t result = rotl(m_state[0] + m_state[3], 23) + m_state[0];
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound), bound <= 2^32: multiply-shift of the upper 32 bits (Lemire),
+    // bias below bound / 2^32
+    uint32_t below(uint64_t bound) {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    // Uniform in [0, 1) with 53 random bits
+    double unit() {
+        return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Batch generation: the draws first, then a branch-free mapping pass over the block
+    // that the compiler vectorizes
+    void fill(uint64_t* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = (*this)();
+        }
+    }
+
+    void fill_below(uint32_t* out, size_t count, uint64_t bound) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = static_cast<uint32_t>((*this)() >> 32);
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = static_cast<uint32_t>(static_cast<uint64_t>(out[i]) * bound >> 32);
+        }
+    }
+
+    void fill_unit(double* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+        }
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t m_state[4];
+};
+
+// Process-wide seed and per-module streams (cf. TemporalDecoupling).
+// Set once from simulation_config.json (random_seed) before the modules are constructed.
+// A module takes the stream of its hierarchical name, so streams are independent of each
+// other, reproducible for one seed, and unaffected by construction order or by modules
+// added elsewhere. Seed 0 draws one from std::random_device and logs it for a rerun.
+class RandomService {
+public:
+    static void set_global_seed(uint64_t seed) { seed_ref() = seed; }
+
+    static uint64_t get_global_seed() {
+        uint64_t& seed = seed_ref();
+        if (seed == 0) {
+            std::random_device device;
+            seed = (static_cast<uint64_t>(device()) << 32) | device();
+            seed = (seed != 0) ? seed : 1;
+            std::cout << "RandomService: random_seed 0, using seed " << seed << std::endl;
+        }
+        return seed;
+    }
+
+    static RandomStream stream(const std::string& name) {
+        return RandomStream(get_global_seed() ^ fnv1a(name));
+    }
+
+private:
+    static uint64_t& seed_ref() {
+        static uint64_t seed = 0;
+        return seed;
+    }
+
+    static uint64_t fnv1a(const std::string& text) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+};
+
+#endif
@@ -0,0 +1,307 @@
+#ifndef SELF_PROFILER_H
+#define SELF_PROFILER_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/stats_registry.h"
+
+// Per-process record of the self-profiler
+struct ProcessProfile {
+    std::string name;           // Hierarchical process name (module path + process)
+    uint64_t activations;
+    uint64_t fifo_reads;
+    uint64_t fifo_writes;
+    uint64_t blocking_reads;    // Reads that found the FIFO empty
+    uint64_t blocking_writes;   // Writes that found the FIFO full
+    uint64_t event_waits;
+    uint64_t timed_waits;
+    double wall_ns;
+
+    explicit ProcessProfile(const std::string& process_name)
+        : name(process_name), activations(0), fifo_reads(0), fifo_writes(0), blocking_reads(0),
+          blocking_writes(0), event_waits(0), timed_waits(0), wall_ns(0.0) {}
+};
+
+// Opt-in simulator self-profiling (simulation_config.json: self_profile), cf. TemporalDecoupling.
+// SystemC has no scheduler hooks, so a process is seen at its instrumented points: CustomFifo
+// operations and SelfProfiler::wait / read / write. A new (process, delta cycle) pair at such a
+// point is one activation, and the wall time between two points of the same activation is
+// charged to that process. Time after a process's last point until the next point of any
+// process (kernel, uninstrumented code) is reported as unattributed. Disabled, each hook costs
+// one predictable branch on a static flag.
+class SelfProfiler {
+public:
+    static bool enabled() { return enabled_ref(); }
+
+    // Set before sc_start
+    static void set_enabled(bool enabled) { enabled_ref() = enabled; }
+
+    // Bracket sc_start
+    static void begin_run() {
+        State& s = state();
+        s.run_start_ns = now_ns();
+        s.last_ns = s.run_start_ns;
+        s.start_delta = sc_delta_count();
+    }
+
+    static void end_run() {
+        State& s = state();
+        uint64_t now = now_ns();
+        s.unattributed_ns += static_cast<double>(now - s.last_ns);
+        s.last_ns = now;
+        s.current = nullptr;
+        s.run_ns = static_cast<double>(now - s.run_start_ns);
+        s.delta_cycles = sc_delta_count() - s.start_delta;
+    }
+
+    // Instrumented waits: plain sc_core::wait when disabled
+    static void wait(const sc_time& delay) {
+        if (!enabled()) { sc_core::wait(delay); return; }
+        suspend(true);
+        sc_core::wait(delay);
+        touch();
+    }
+
+    static void wait(double delay, sc_time_unit unit) {
+        if (!enabled()) { sc_core::wait(delay, unit); return; }
+        suspend(true);
+        sc_core::wait(delay, unit);
+        touch();
+    }
+
+    static void wait(const sc_event& event) {
+        if (!enabled()) { sc_core::wait(event); return; }
+        suspend(false);
+        sc_core::wait(event);
+        touch();
+    }
+
+    static void wait(const sc_event_or_list& events) {
+        if (!enabled()) { sc_core::wait(events); return; }
+        suspend(false);
+        sc_core::wait(events);
+        touch();
+    }
+
+    static void wait(const sc_time& timeout, const sc_event& event) {
+        if (!enabled()) { sc_core::wait(timeout, event); return; }
+        suspend(true);
+        sc_core::wait(timeout, event);
+        touch();
+    }
+
+    // Instrumented blocking FIFO access through a port or channel
+    template<typename Port>
+    static auto read(Port& port) -> decltype(port.read()) {
+        if (!enabled()) {
+            return port.read();
+        }
+        bool blocking = port.num_available() == 0;
+        fifo_access(false, blocking);
+        auto value = port.read();
+        if (blocking) {
+            touch();
+        }
+        return value;
+    }
+
+    template<typename Port, typename T>
+    static void write(Port& port, const T& value) {
+        if (!enabled()) {
+            port.write(value);
+            return;
+        }
+        bool blocking = port.num_free() == 0;
+        fifo_access(true, blocking);
+        port.write(value);
+        if (blocking) {
+            touch();
+        }
+    }
+
+    // Non-blocking access (nb_read / nb_write)
+    static void nb_access(bool is_write) {
+        if (enabled()) {
+            fifo_access(is_write, false);
+        }
+    }
+
+    // Hot-spot table, processes sorted by wall time
+    static void report(std::ostream& os, size_t top = 20) {
+        const State& s = state();
+        std::vector<const ProcessProfile*> sorted;
+        double attributed_ns = 0.0;
+        for (const ProcessProfile& profile : s.profiles) {
+            sorted.push_back(&profile);
+            attributed_ns += profile.wall_ns;
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const ProcessProfile* a, const ProcessProfile* b) {
+            return a->wall_ns > b->wall_ns;
+        });
+        double run_ns = std::max(1.0, s.run_ns);
+
+        os << "\n========== Self-Profile Hot Spots ==========" << std::endl;
+        os << std::fixed << std::setprecision(1);
+        os << "Run Wall Time: " << s.run_ns / 1e6 << " ms (attributed " << attributed_ns / 1e6 << " ms, "
+           << "unattributed " << s.unattributed_ns / 1e6 << " ms = " << s.unattributed_ns * 100.0 / run_ns << "%)" << std::endl;
+        os << "Kernel: " << s.delta_cycles << " delta cycles, " << s.time_steps << " time steps seen, "
+           << s.profiles.size() << " processes seen" << std::endl;
+        os << std::left << std::setw(52) << "Process" << std::right << std::setw(10) << "Wall ms" << std::setw(7) << "%"
+           << std::setw(12) << "Activations" << std::setw(9) << "us/act" << std::setw(18) << "FIFO rd/wr"
+           << std::setw(16) << "Blocked rd/wr" << std::setw(16) << "Waits ev/timed" << std::endl;
+        for (size_t i = 0; i < sorted.size() && i < top; i++) {
+            const ProcessProfile& p = *sorted[i];
+            os << std::left << std::setw(52) << p.name << std::right << std::setprecision(2)
+               << std::setw(10) << p.wall_ns / 1e6 << std::setprecision(1) << std::setw(7) << p.wall_ns * 100.0 / run_ns
+               << std::setw(12) << p.activations << std::setprecision(3)
+               << std::setw(9) << (p.activations > 0 ? p.wall_ns / 1e3 / p.activations : 0.0)
+               << std::setw(18) << (std::to_string(p.fifo_reads) + "/" + std::to_string(p.fifo_writes))
+               << std::setw(16) << (std::to_string(p.blocking_reads) + "/" + std::to_string(p.blocking_writes))
+               << std::setw(16) << (std::to_string(p.event_waits) + "/" + std::to_string(p.timed_waits)) << std::endl;
+        }
+        if (sorted.size() > top) {
+            os << "... " << (sorted.size() - top) << " more processes" << std::endl;
+        }
+        os << "============================================" << std::endl;
+    }
+
+    // Registers every record under prefix.<process name> (after end_run, before the registry is read)
+    static void publish_stats(const std::string& prefix = "self_profile") {
+        State& s = state();
+        StatsRegistry& registry = StatsRegistry::instance();
+        registry.add_gauge(prefix + ".kernel.run_wall_ns", &s.run_ns, "ns");
+        registry.add_gauge(prefix + ".kernel.unattributed_ns", &s.unattributed_ns, "ns");
+        registry.add_counter(prefix + ".kernel.delta_cycles", &s.delta_cycles);
+        registry.add_counter(prefix + ".kernel.time_steps", &s.time_steps);
+        for (ProcessProfile& profile : s.profiles) {
+            std::string path = prefix + "." + profile.name;
+            registry.add_counter(path + ".activations", &profile.activations);
+            registry.add_gauge(path + ".wall_ns", &profile.wall_ns, "ns");
+            registry.add_counter(path + ".fifo_reads", &profile.fifo_reads);
+            registry.add_counter(path + ".fifo_writes", &profile.fifo_writes);
+            registry.add_counter(path + ".blocking_reads", &profile.blocking_reads);
+            registry.add_counter(path + ".blocking_writes", &profile.blocking_writes);
+            registry.add_counter(path + ".event_waits", &profile.event_waits);
+            registry.add_counter(path + ".timed_waits", &profile.timed_waits);
+        }
+    }
+
+private:
+    struct State {
+        std::deque<ProcessProfile> profiles;    // Stable addresses for the registry
+        std::unordered_map<const sc_object*, ProcessProfile*> by_process;
+        const sc_object* last_process;
+        ProcessProfile* last_profile;
+        ProcessProfile* current;                // Running process, nullptr once it suspended
+        uint64_t current_delta;
+        sc_time current_time;
+        uint64_t last_ns;
+        uint64_t run_start_ns;
+        uint64_t start_delta;
+        uint64_t delta_cycles;
+        uint64_t time_steps;
+        double run_ns;
+        double unattributed_ns;
+
+        State()
+            : last_process(nullptr), last_profile(nullptr), current(nullptr), current_delta(0),
+              last_ns(0), run_start_ns(0), start_delta(0), delta_cycles(0), time_steps(0),
+              run_ns(0.0), unattributed_ns(0.0) {}
+    };
+
+    static bool& enabled_ref() {
+        static bool enabled = false;
+        return enabled;
+    }
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static ProcessProfile* profile_of(const sc_object* process) {
+        State& s = state();
+        if (process == s.last_process) {
+            return s.last_profile;
+        }
+        auto it = s.by_process.find(process);
+        ProcessProfile* profile;
+        if (it != s.by_process.end()) {
+            profile = it->second;
+        } else {
+            s.profiles.push_back(ProcessProfile(process->name()));
+            profile = &s.profiles.back();
+            s.by_process[process] = profile;
+        }
+        s.last_process = process;
+        s.last_profile = profile;
+        return profile;
+    }
+
+    // Current process at an instrumented point; charges the time since the previous point
+    static ProcessProfile* touch() {
+        const sc_object* process = sc_get_current_process_handle().get_process_object();
+        if (!process) {
+            return nullptr;     // Elaboration or sc_main
+        }
+        State& s = state();
+        ProcessProfile* profile = profile_of(process);
+        uint64_t now = now_ns();
+        uint64_t delta = sc_delta_count();
+        if (profile == s.current && delta == s.current_delta) {
+            profile->wall_ns += static_cast<double>(now - s.last_ns);
+        } else {
+            s.unattributed_ns += static_cast<double>(now - s.last_ns);
+            profile->activations++;
+            s.current = profile;
+            s.current_delta = delta;
+            sc_time time = sc_time_stamp();
+            if (time != s.current_time) {
+                s.time_steps++;
+                s.current_time = time;
+            }
+        }
+        s.last_ns = now;
+        return profile;
+    }
+
+    static void suspend(bool timed) {
+        ProcessProfile* profile = touch();
+        if (profile) {
+            (timed ? profile->timed_waits : profile->event_waits)++;
+        }
+        state().current = nullptr;
+    }
+
+    static void fifo_access(bool is_write, bool blocking) {
+        ProcessProfile* profile = touch();
+        if (!profile) {
+            return;
+        }
+        if (is_write) {
+            profile->fifo_writes++;
+            profile->blocking_writes += blocking ? 1 : 0;
+        } else {
+            profile->fifo_reads++;
+            profile->blocking_reads += blocking ? 1 : 0;
+        }
+        if (blocking) {
+            state().current = nullptr;
+        }
+    }
+};
+
+#endif
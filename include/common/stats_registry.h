@@ -0,0 +1,436 @@
+#ifndef STATS_REGISTRY_H
+#define STATS_REGISTRY_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include "base/latency_histogram.h"
+
+// Central statistics registry.
+// Modules register their counters, gauges and histograms once at elaboration; the registry
+// keeps a pointer to each variable and reads it in place, so the hot path keeps doing a plain
+// increment and nothing is copied until a snapshot or an export asks for it.
+// Every stat becomes one or more numeric columns with a dotted path (module name + stat name);
+// a histogram expands to .count/.mean/.p50/.p99/.p999/.max columns.
+// JSON export, console printing and binary snapshots (StatsSnapshotWriter) all read the same columns;
+// the simulator's end-of-run console report is print_report() over the module subtree.
+
+enum class StatKind {
+    COUNTER,     // Monotonic event count
+    GAUGE,       // Instantaneous or derived value
+    HISTOGRAM    // Column derived from a LatencyHistogram
+};
+
+inline const char* stat_kind_name(StatKind kind) {
+    switch (kind) {
+        case StatKind::COUNTER: return "counter";
+        case StatKind::GAUGE: return "gauge";
+        case StatKind::HISTOGRAM: return "histogram";
+    }
+    return "gauge";
+}
+
+// How a column's value is read
+enum class StatSource {
+    U32, U64, ULL, I32, I64, LL, F32, F64, TIME_NS, FUNCTION,
+    HIST_COUNT, HIST_MEAN, HIST_P50, HIST_P99, HIST_P999, HIST_MAX
+};
+
+// Registrable variable types
+template<typename T> struct StatSourceOf;
+template<> struct StatSourceOf<unsigned int> { static const StatSource value = StatSource::U32; };
+template<> struct StatSourceOf<unsigned long> { static const StatSource value = StatSource::U64; };
+template<> struct StatSourceOf<unsigned long long> { static const StatSource value = StatSource::ULL; };
+template<> struct StatSourceOf<int> { static const StatSource value = StatSource::I32; };
+template<> struct StatSourceOf<long> { static const StatSource value = StatSource::I64; };
+template<> struct StatSourceOf<long long> { static const StatSource value = StatSource::LL; };
+template<> struct StatSourceOf<float> { static const StatSource value = StatSource::F32; };
+template<> struct StatSourceOf<double> { static const StatSource value = StatSource::F64; };
+template<> struct StatSourceOf<sc_time> { static const StatSource value = StatSource::TIME_NS; };
+
+struct StatColumn {
+    std::string path;
+    StatKind kind;
+    std::string unit;
+    StatSource source;
+    const void* ptr;
+    int function_index;   // FUNCTION source: slot in the registry's function table
+    std::string group;    // Registering module (StatsGroup prefix); path up to the last '.' otherwise
+};
+
+class StatsRegistry {
+public:
+    static StatsRegistry& instance() {
+        static StatsRegistry registry;
+        return registry;
+    }
+
+    // Counters and gauges read the variable in place; it must outlive its registration
+    template<typename T>
+    void add_counter(const std::string& path, const T* value, const std::string& unit = "count",
+                     const std::string& group = "") {
+        add_column(path, StatKind::COUNTER, unit, StatSourceOf<T>::value, value, -1, group);
+    }
+
+    template<typename T>
+    void add_gauge(const std::string& path, const T* value, const std::string& unit = "",
+                   const std::string& group = "") {
+        add_column(path, StatKind::GAUGE, unit, StatSourceOf<T>::value, value, -1, group);
+    }
+
+    // Derived gauge (rates, ratios); evaluated only when the registry is read
+    void add_gauge(const std::string& path, std::function<double()> function, const std::string& unit = "",
+                   const std::string& group = "") {
+        m_functions.push_back(function);
+        add_column(path, StatKind::GAUGE, unit, StatSource::FUNCTION, nullptr,
+                   static_cast<int>(m_functions.size() - 1), group);
+    }
+
+    void add_histogram(const std::string& path, const LatencyHistogram* histogram, const std::string& unit = "ns",
+                       const std::string& group = "") {
+        add_column(path + ".count", StatKind::HISTOGRAM, "count", StatSource::HIST_COUNT, histogram, -1, group);
+        add_column(path + ".mean", StatKind::HISTOGRAM, unit, StatSource::HIST_MEAN, histogram, -1, group);
+        add_column(path + ".p50", StatKind::HISTOGRAM, unit, StatSource::HIST_P50, histogram, -1, group);
+        add_column(path + ".p99", StatKind::HISTOGRAM, unit, StatSource::HIST_P99, histogram, -1, group);
+        add_column(path + ".p999", StatKind::HISTOGRAM, unit, StatSource::HIST_P999, histogram, -1, group);
+        add_column(path + ".max", StatKind::HISTOGRAM, unit, StatSource::HIST_MAX, histogram, -1, group);
+    }
+
+    // Drop every column whose path starts with prefix (module teardown)
+    void remove_prefix(const std::string& prefix) {
+        size_t before = m_columns.size();
+        m_columns.erase(std::remove_if(m_columns.begin(), m_columns.end(),
+                                       [&prefix](const StatColumn& column) {
+                                           return column.path.compare(0, prefix.size(), prefix) == 0;
+                                       }),
+                        m_columns.end());
+        if (m_columns.size() != before) {
+            m_layout_version++;
+        }
+    }
+
+    size_t size() const { return m_columns.size(); }
+    const std::vector<StatColumn>& columns() const { return m_columns; }
+
+    // Bumped on every registration change; snapshot writers compare it to their header
+    uint64_t layout_version() const { return m_layout_version; }
+
+    double read(size_t column) const {
+        const StatColumn& c = m_columns[column];
+        const LatencyHistogram* histogram = static_cast<const LatencyHistogram*>(c.ptr);
+        switch (c.source) {
+            case StatSource::U32: return static_cast<double>(*static_cast<const unsigned int*>(c.ptr));
+            case StatSource::U64: return static_cast<double>(*static_cast<const unsigned long*>(c.ptr));
+            case StatSource::ULL: return static_cast<double>(*static_cast<const unsigned long long*>(c.ptr));
+            case StatSource::I32: return static_cast<double>(*static_cast<const int*>(c.ptr));
+            case StatSource::I64: return static_cast<double>(*static_cast<const long*>(c.ptr));
+            case StatSource::LL: return static_cast<double>(*static_cast<const long long*>(c.ptr));
+            case StatSource::F32: return static_cast<double>(*static_cast<const float*>(c.ptr));
+            case StatSource::F64: return *static_cast<const double*>(c.ptr);
+            case StatSource::TIME_NS: return static_cast<const sc_time*>(c.ptr)->to_seconds() * 1e9;
+            case StatSource::FUNCTION: return m_functions[c.function_index]();
+            case StatSource::HIST_COUNT: return static_cast<double>(histogram->count());
+            case StatSource::HIST_MEAN: return histogram->mean();
+            case StatSource::HIST_P50: return histogram->value_at_percentile(50.0);
+            case StatSource::HIST_P99: return histogram->value_at_percentile(99.0);
+            case StatSource::HIST_P999: return histogram->value_at_percentile(99.9);
+            case StatSource::HIST_MAX: return static_cast<double>(histogram->max());
+        }
+        return 0.0;
+    }
+
+    // All columns, in registration order
+    void sample(double* out) const {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            out[i] = read(i);
+        }
+    }
+
+    bool find(const std::string& path, double& value) const {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            if (m_columns[i].path == path) {
+                value = read(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Console listing of the columns under prefix ("" = all)
+    void print(std::ostream& os, const std::string& prefix = "") const {
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            const StatColumn& c = m_columns[i];
+            if (c.path.compare(0, prefix.size(), prefix) != 0) continue;
+            os << "  " << std::left << std::setw(56) << c.path << std::right << " "
+               << format_value(read(i));
+            if (!c.unit.empty()) os << " " << c.unit;
+            os << std::endl;
+        }
+    }
+
+    // Console report of the columns under prefix: one block per module, in registration
+    // order, with stat names relative to the module
+    void print_report(std::ostream& os, const std::string& prefix = "") const {
+        std::vector<const std::string*> groups;
+        for (const StatColumn& c : m_columns) {
+            if (c.path.compare(0, prefix.size(), prefix) != 0) continue;
+            bool seen = false;
+            for (const std::string* group : groups) {
+                seen = seen || *group == c.group;
+            }
+            if (!seen) groups.push_back(&c.group);
+        }
+        for (const std::string* group : groups) {
+            os << "\n[" << (group->empty() ? "-" : *group) << "]" << std::endl;
+            size_t name_start = group->empty() ? 0 : group->size() + 1;
+            for (size_t i = 0; i < m_columns.size(); ++i) {
+                const StatColumn& c = m_columns[i];
+                if (c.group != *group || c.path.compare(0, prefix.size(), prefix) != 0) continue;
+                os << "  " << std::left << std::setw(40) << c.path.substr(name_start) << std::right << " "
+                   << format_value(read(i));
+                if (!c.unit.empty() && c.unit != "count") os << " " << c.unit;
+                os << std::endl;
+            }
+        }
+    }
+
+    // Nested JSON object of the columns under prefix; path components become object keys.
+    // (A path must not be both a value and a group.)
+    void write_json(std::ostream& os, const std::string& prefix = "", int indent = 0) const {
+        std::vector<size_t> order;
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            if (m_columns[i].path.compare(0, prefix.size(), prefix) == 0) order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return m_columns[a].path < m_columns[b].path;
+        });
+
+        std::vector<std::string> open;   // Currently open object keys
+        std::vector<bool> first(1, true);
+        os << "{";
+        for (size_t index : order) {
+            std::vector<std::string> parts = split_path(m_columns[index].path.substr(prefix.size()));
+            if (parts.empty()) continue;
+            size_t common = 0;
+            while (common < open.size() && common + 1 < parts.size() && open[common] == parts[common]) {
+                common++;
+            }
+            while (open.size() > common) {
+                open.pop_back();
+                first.pop_back();
+                os << "\n" << pad(indent + open.size() + 1) << "}";
+            }
+            for (size_t level = common; level + 1 < parts.size(); ++level) {
+                os << (first.back() ? "" : ",") << "\n" << pad(indent + level + 1) << "\"" << parts[level] << "\": {";
+                first.back() = false;
+                open.push_back(parts[level]);
+                first.push_back(true);
+            }
+            os << (first.back() ? "" : ",") << "\n" << pad(indent + open.size() + 1)
+               << "\"" << parts.back() << "\": " << format_value(read(index));
+            first.back() = false;
+        }
+        while (!open.empty()) {
+            open.pop_back();
+            os << "\n" << pad(indent + open.size() + 1) << "}";
+        }
+        os << "\n" << pad(indent) << "}";
+    }
+
+private:
+    std::vector<StatColumn> m_columns;
+    std::vector<std::function<double()>> m_functions;
+    uint64_t m_layout_version;
+
+    StatsRegistry() : m_layout_version(0) {}
+
+    void add_column(const std::string& path, StatKind kind, const std::string& unit,
+                    StatSource source, const void* ptr, int function_index = -1, const std::string& group = "") {
+        size_t dot = path.rfind('.');
+        StatColumn column = {path, kind, unit, source, ptr, function_index,
+                             !group.empty() ? group : (dot == std::string::npos ? std::string() : path.substr(0, dot))};
+        m_columns.push_back(column);
+        m_layout_version++;
+    }
+
+    static std::vector<std::string> split_path(const std::string& path) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (start <= path.size()) {
+            size_t dot = path.find('.', start);
+            if (dot == std::string::npos) dot = path.size();
+            if (dot > start) parts.push_back(path.substr(start, dot - start));
+            start = dot + 1;
+        }
+        return parts;
+    }
+
+    static std::string pad(size_t level) { return std::string(level * 2, ' '); }
+
+    // Integral values print without a fraction; NaN/inf would not be valid JSON
+    static std::string format_value(double value) {
+        char buffer[32];
+        if (!(value == value) || value > 1e300 || value < -1e300) {
+            return "0";
+        }
+        if (value == static_cast<double>(static_cast<long long>(value)) && value < 9e15 && value > -9e15) {
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%.4f", value);
+        }
+        return buffer;
+    }
+};
+
+// Per-module registration handle: prefixes stat names with the module path and removes
+// them from the registry when the module goes away
+class StatsGroup {
+public:
+    StatsGroup() {}
+    explicit StatsGroup(const std::string& prefix) : m_prefix(prefix) {}
+    ~StatsGroup() {
+        if (!m_prefix.empty()) {
+            StatsRegistry::instance().remove_prefix(m_prefix + ".");
+        }
+    }
+
+    void set_prefix(const std::string& prefix) { m_prefix = prefix; }
+    const std::string& prefix() const { return m_prefix; }
+
+    template<typename T>
+    void counter(const std::string& name, const T* value, const std::string& unit = "count") {
+        StatsRegistry::instance().add_counter(m_prefix + "." + name, value, unit, m_prefix);
+    }
+
+    template<typename T>
+    void gauge(const std::string& name, const T* value, const std::string& unit = "") {
+        StatsRegistry::instance().add_gauge(m_prefix + "." + name, value, unit, m_prefix);
+    }
+
+    void gauge(const std::string& name, std::function<double()> function, const std::string& unit = "") {
+        StatsRegistry::instance().add_gauge(m_prefix + "." + name, function, unit, m_prefix);
+    }
+
+    void histogram(const std::string& name, const LatencyHistogram* histogram, const std::string& unit = "ns") {
+        StatsRegistry::instance().add_histogram(m_prefix + "." + name, histogram, unit, m_prefix);
+    }
+
+    void print(std::ostream& os) const { StatsRegistry::instance().print(os, m_prefix + "."); }
+    void print_report(std::ostream& os) const { StatsRegistry::instance().print_report(os, m_prefix + "."); }
+
+private:
+    std::string m_prefix;
+
+    StatsGroup(const StatsGroup&);
+    StatsGroup& operator=(const StatsGroup&);
+};
+
+// Binary snapshot file. Layout (little-endian):
+//   header : "MOONSTAT" | u32 version (1) | u32 columns |
+//            per column: u8 kind | u16 path length | path | u16 unit length | unit
+//   blocks : u32 rows | f64 time_ns[rows] | f64 column_0[rows] | ... | f64 column_N-1[rows]
+// Rows are buffered column-major and written a block at a time, so a snapshot costs one
+// read per column plus a store; stats_snapshot.py converts the file to CSV.
+class StatsSnapshotWriter {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    explicit StatsSnapshotWriter(uint32_t block_rows = 1024)
+        : m_file(nullptr), m_block_rows(std::max<uint32_t>(block_rows, 1)), m_rows(0),
+          m_columns(0), m_layout_version(0), m_snapshots(0) {}
+
+    ~StatsSnapshotWriter() { close(); }
+
+    // Freezes the registry layout: columns registered afterwards are not sampled
+    bool open(const std::string& path) {
+        close();
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            return false;
+        }
+        const StatsRegistry& registry = StatsRegistry::instance();
+        m_columns = static_cast<uint32_t>(registry.size());
+        m_layout_version = registry.layout_version();
+        m_block.assign(static_cast<size_t>(m_columns + 1) * m_block_rows, 0.0);
+        m_row.assign(m_columns, 0.0);
+        m_rows = 0;
+
+        std::fwrite("MOONSTAT", 1, 8, m_file);
+        write_u32(FORMAT_VERSION);
+        write_u32(m_columns);
+        for (const StatColumn& column : registry.columns()) {
+            uint8_t kind = static_cast<uint8_t>(column.kind);
+            std::fwrite(&kind, 1, 1, m_file);
+            write_string(column.path);
+            write_string(column.unit);
+        }
+        return true;
+    }
+
+    bool is_open() const { return m_file != nullptr; }
+    uint64_t get_snapshot_count() const { return m_snapshots; }
+
+    void append(double time_ns) {
+        if (!m_file) return;
+        const StatsRegistry& registry = StatsRegistry::instance();
+        if (registry.layout_version() != m_layout_version) {
+            std::cerr << "StatsSnapshotWriter: registry layout changed, snapshots stopped" << std::endl;
+            close();
+            return;
+        }
+        registry.sample(m_row.data());
+        m_block[m_rows] = time_ns;
+        for (uint32_t c = 0; c < m_columns; ++c) {
+            m_block[static_cast<size_t>(c + 1) * m_block_rows + m_rows] = m_row[c];
+        }
+        m_snapshots++;
+        if (++m_rows == m_block_rows) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (!m_file || m_rows == 0) return;
+        write_u32(m_rows);
+        for (uint32_t c = 0; c <= m_columns; ++c) {
+            std::fwrite(&m_block[static_cast<size_t>(c) * m_block_rows], sizeof(double), m_rows, m_file);
+        }
+        m_rows = 0;
+    }
+
+    void close() {
+        if (!m_file) return;
+        flush();
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+private:
+    std::FILE* m_file;
+    const uint32_t m_block_rows;
+    uint32_t m_rows;
+    uint32_t m_columns;
+    uint64_t m_layout_version;
+    uint64_t m_snapshots;
+    std::vector<double> m_block;   // (columns + 1) x block_rows, column-major; column 0 = time
+    std::vector<double> m_row;
+
+    StatsSnapshotWriter(const StatsSnapshotWriter&);
+    StatsSnapshotWriter& operator=(const StatsSnapshotWriter&);
+
+    void write_u32(uint32_t value) { std::fwrite(&value, sizeof(value), 1, m_file); }
+
+    void write_string(const std::string& text) {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), 0xFFFF));
+        std::fwrite(&length, sizeof(length), 1, m_file);
+        std::fwrite(text.data(), 1, length, m_file);
+    }
+};
+
+#endif // STATS_REGISTRY_H
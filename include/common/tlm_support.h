@@ -0,0 +1,47 @@
+#ifndef TLM_SUPPORT_H
+#define TLM_SUPPORT_H
+
+#include <systemc.h>
+#include <tlm>
+#include <tlm_utils/simple_target_socket.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <cstdint>
+#include "packet/base_packet.h"
+
+// TLM-2.0 front-end shared by the memory models.
+// Every model keeps its sc_fifo packet ports; the sockets below are an alternative
+// entry point for virtual platforms. b_transport is functional: state and statistics
+// are updated and the access latency is added to the annotated delay, nothing waits.
+// Sockets are the *_optional variants (SystemC >= 2.3.2), so leaving them unbound is legal.
+template<typename ModuleType>
+using TlmTargetSocket = tlm_utils::simple_target_socket_optional<ModuleType>;
+
+template<typename ModuleType>
+using TlmInitiatorSocket = tlm_utils::simple_initiator_socket_optional<ModuleType>;
+
+// Map a generic payload command onto the packet command set
+inline Command tlm_command_to_packet(const tlm::tlm_generic_payload& trans) {
+    return (trans.get_command() == tlm::TLM_WRITE_COMMAND) ? Command::WRITE : Command::READ;
+}
+
+// Reject payload features the models do not implement; sets the response status on failure.
+// address_limit = 0 means no upper bound (timing-only targets).
+inline bool tlm_check_payload(tlm::tlm_generic_payload& trans, uint64_t address_limit = 0) {
+    if (trans.get_byte_enable_ptr() != nullptr) {
+        trans.set_response_status(tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE);
+        return false;
+    }
+    if (trans.get_streaming_width() < trans.get_data_length()) {
+        trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+        return false;
+    }
+    if (address_limit > 0 &&
+        (trans.get_address() >= address_limit ||
+         trans.get_data_length() > address_limit - trans.get_address())) {
+        trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef TRANSACTION_TRACE_H
+#define TRANSACTION_TRACE_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "packet/base_packet.h"
+
+// Compact binary transaction trace: one fixed 32-byte record per traced FIFO operation.
+// Records go into a large in-memory buffer; full buffers are handed to a background
+// writer thread, so the simulation thread never formats text or waits on the disk
+// (it only blocks if every buffer is still queued for writing).
+//
+// File layout (little-endian):
+//   header  : "MOONTRC1" | u32 record size (32) | u32 reserved | u64 time resolution (fs)
+//   records : TraceRecord[]
+//   footer  : u32 fifo count | per fifo: u16 name length | name |
+//             u64 footer offset | "MOONTEND"
+// trace_convert.py turns a trace into CSV or VCD.
+
+enum class TraceDirection : uint8_t {
+    IN = 0,     // Packet written into the FIFO
+    OUT = 1     // Packet read out of the FIFO
+};
+
+struct TraceRecord {
+    uint64_t time;          // sc_time_stamp() in time-resolution units
+    uint32_t fifo_id;
+    int32_t index;
+    int32_t address;
+    uint32_t bytes;
+    int32_t data;
+    uint8_t command;
+    uint8_t direction;
+    uint16_t reserved;
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord layout is shared with trace_convert.py");
+
+// Packet -> record field extraction (same dispatch as update_packet_vcd_traces)
+template<typename T>
+typename std::enable_if<std::is_convertible<T, std::shared_ptr<BasePacket>>::value, bool>::type
+fill_trace_record(const T& packet, TraceRecord& record) {
+    if (!packet) return false;
+    record.index = packet->get_index();
+    record.address = packet->get_address();
+    record.bytes = packet->get_transfer_length();
+    record.data = packet->get_data();
+    record.command = static_cast<uint8_t>(packet->get_command());
+    return true;
+}
+
+template<typename T>
+typename std::enable_if<std::is_base_of<BasePacket, T>::value &&
+                       !std::is_convertible<T, std::shared_ptr<BasePacket>>::value, bool>::type
+fill_trace_record(const T& packet, TraceRecord& record) {
+    record.index = packet.get_index();
+    record.address = packet.get_address();
+    record.bytes = packet.get_transfer_length();
+    record.data = packet.get_data();
+    record.command = static_cast<uint8_t>(packet.get_command());
+    return true;
+}
+
+template<typename T>
+typename std::enable_if<!std::is_convertible<T, std::shared_ptr<BasePacket>>::value &&
+                       !std::is_base_of<BasePacket, T>::value, bool>::type
+fill_trace_record(const T&, TraceRecord&) {
+    return false;
+}
+
+// Process-wide trace sink. Configured once from simulation_config.json before the
+// FIFOs are constructed; each FIFO asks register_fifo() for its id at construction.
+class TransactionTrace {
+public:
+    static TransactionTrace& instance() {
+        static TransactionTrace trace;
+        return trace;
+    }
+
+    // fifo_filter: comma-separated FIFO names (empty = every FIFO)
+    // sample_ratio: record one of every N operations per FIFO and direction (1 = all)
+    bool configure(const std::string& path, const std::string& fifo_filter,
+                   unsigned int sample_ratio, size_t buffer_records) {
+        close();
+        m_sample_ratio = std::max(sample_ratio, 1u);
+        m_buffer_records = std::max<size_t>(buffer_records, 1024);
+        m_filter.clear();
+        std::stringstream filter(fifo_filter);
+        std::string item;
+        while (std::getline(filter, item, ',')) {
+            size_t begin = item.find_first_not_of(' ');
+            size_t end = item.find_last_not_of(' ');
+            if (begin != std::string::npos) {
+                m_filter.push_back(item.substr(begin, end - begin + 1));
+            }
+        }
+
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            return false;
+        }
+        uint32_t record_size = sizeof(TraceRecord);
+        uint32_t reserved = 0;
+        uint64_t resolution_fs = static_cast<uint64_t>(sc_get_time_resolution().to_seconds() * 1e15 + 0.5);
+        std::fwrite("MOONTRC1", 1, 8, m_file);
+        std::fwrite(&record_size, sizeof(record_size), 1, m_file);
+        std::fwrite(&reserved, sizeof(reserved), 1, m_file);
+        std::fwrite(&resolution_fs, sizeof(resolution_fs), 1, m_file);
+
+        m_active.reset(new std::vector<TraceRecord>());
+        m_active->reserve(m_buffer_records);
+        m_stop = false;
+        m_writer = std::thread(&TransactionTrace::writer_loop, this);
+        return true;
+    }
+
+    bool is_enabled() const { return m_file != nullptr; }
+
+    // Returns the FIFO's trace id, or -1 if it is not traced
+    int register_fifo(const std::string& fifo_name) {
+        if (!m_file) return -1;
+        if (!m_filter.empty() &&
+            std::find(m_filter.begin(), m_filter.end(), fifo_name) == m_filter.end()) {
+            return -1;
+        }
+        m_fifo_names.push_back(fifo_name);
+        return static_cast<int>(m_fifo_names.size() - 1);
+    }
+
+    unsigned int get_sample_ratio() const { return m_sample_ratio; }
+    uint64_t get_record_count() const { return m_records; }
+
+    // Simulation thread only
+    template<typename T>
+    void record(int fifo_id, TraceDirection direction, const T& packet) {
+        TraceRecord record;
+        record.time = sc_time_stamp().value();
+        record.fifo_id = static_cast<uint32_t>(fifo_id);
+        record.direction = static_cast<uint8_t>(direction);
+        record.reserved = 0;
+        if (!fill_trace_record(packet, record)) {
+            return;
+        }
+        m_active->push_back(record);
+        m_records++;
+        if (m_active->size() >= m_buffer_records) {
+            submit_active();
+        }
+    }
+
+    // Drains the buffers, writes the FIFO name table and closes the file
+    void close() {
+        if (!m_file) return;
+        submit_active();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_ready.notify_all();
+        m_writer.join();
+
+        uint64_t footer_offset = static_cast<uint64_t>(std::ftell(m_file));
+        uint32_t fifo_count = static_cast<uint32_t>(m_fifo_names.size());
+        std::fwrite(&fifo_count, sizeof(fifo_count), 1, m_file);
+        for (const std::string& fifo_name : m_fifo_names) {
+            uint16_t length = static_cast<uint16_t>(fifo_name.size());
+            std::fwrite(&length, sizeof(length), 1, m_file);
+            std::fwrite(fifo_name.data(), 1, length, m_file);
+        }
+        std::fwrite(&footer_offset, sizeof(footer_offset), 1, m_file);
+        std::fwrite("MOONTEND", 1, 8, m_file);
+        std::fclose(m_file);
+        m_file = nullptr;
+        m_fifo_names.clear();
+    }
+
+    ~TransactionTrace() { close(); }
+
+private:
+    static const size_t MAX_QUEUED_BUFFERS = 4;
+
+    std::FILE* m_file;
+    unsigned int m_sample_ratio;
+    size_t m_buffer_records;
+    std::vector<std::string> m_filter;
+    std::vector<std::string> m_fifo_names;
+    uint64_t m_records;
+
+    std::unique_ptr<std::vector<TraceRecord>> m_active;
+    std::deque<std::unique_ptr<std::vector<TraceRecord>>> m_queued;   // Full, waiting for the writer
+    std::vector<std::unique_ptr<std::vector<TraceRecord>>> m_free;    // Written, ready for reuse
+    std::mutex m_mutex;
+    std::condition_variable m_ready;      // Writer: a buffer was queued (or stop)
+    std::condition_variable m_released;   // Producer: a buffer was freed
+    bool m_stop;
+    std::thread m_writer;
+
+    TransactionTrace()
+        : m_file(nullptr), m_sample_ratio(1), m_buffer_records(65536), m_records(0), m_stop(false) {}
+    TransactionTrace(const TransactionTrace&);
+    TransactionTrace& operator=(const TransactionTrace&);
+
+    void submit_active() {
+        if (!m_active || m_active->empty()) return;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_released.wait(lock, [this] { return m_queued.size() < MAX_QUEUED_BUFFERS; });
+        m_queued.push_back(std::move(m_active));
+        if (!m_free.empty()) {
+            m_active = std::move(m_free.back());
+            m_free.pop_back();
+        } else {
+            m_active.reset(new std::vector<TraceRecord>());
+            m_active->reserve(m_buffer_records);
+        }
+        lock.unlock();
+        m_ready.notify_one();
+    }
+
+    void writer_loop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_ready.wait(lock, [this] { return m_stop || !m_queued.empty(); });
+            if (m_queued.empty()) {
+                return;   // Stopped and drained
+            }
+            std::unique_ptr<std::vector<TraceRecord>> buffer = std::move(m_queued.front());
+            m_queued.pop_front();
+            lock.unlock();
+            std::fwrite(buffer->data(), sizeof(TraceRecord), buffer->size(), m_file);
+            buffer->clear();
+            lock.lock();
+            m_free.push_back(std::move(buffer));
+            m_released.notify_one();
+        }
+    }
+};
+
+#endif // TRANSACTION_TRACE_H
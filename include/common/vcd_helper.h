@@ -112,7 +112,7 @@ update_packet_vcd_traces(const T& packet, PacketTraceSignals& signals) {
         signals.address_signal.write(packet->get_address());
         signals.data_signal.write(packet->get_data());
         signals.databyte_signal.write(packet->get_databyte());
-        signals.index_signal.write(static_cast<int>(packet->get_attribute("index")));
+        signals.index_signal.write(get_field<PacketField::INDEX>(*packet));
     }
 }
 
@@ -125,7 +125,7 @@ update_packet_vcd_traces(const T& packet, PacketTraceSignals& signals) {
     signals.address_signal.write(packet.get_address());
     signals.data_signal.write(packet.get_data());
     signals.databyte_signal.write(packet.get_databyte());
-    signals.index_signal.write(static_cast<int>(packet.get_attribute("index")));
+    signals.index_signal.write(get_field<PacketField::INDEX>(packet));
 }
 
 // Fallback for unsupported types (no-op)
@@ -2,10 +2,13 @@
 #define HOST_SYSTEM_H
 
 #include <systemc.h>
+#include <functional>
 #include <memory>
+#include <vector>
 #include "base/traffic_generator.h"
 #include "base/index_allocator.h"
 #include "base/profiler_bw.h"
+#include "base/profiler_latency.h"
 #include "packet/base_packet.h"
 #include "common/json_config.h"
 
@@ -30,55 +33,120 @@ public:
         if (m_profiler) {
             m_profiler->force_report();
         }
+        if (m_latency_profiler) {
+            m_latency_profiler->force_report();
+        }
+    }
+    
+    // End-to-end (issue -> completion) latency; in LOOSE timing mode measured on annotated time
+    bool has_latency_profiler() const { return m_latency_profiler != nullptr; }
+    ProfilerLatency<BasePacket>::LatencyStats get_latency_stats() const {
+        return m_latency_profiler ? m_latency_profiler->get_stats()
+                                  : ProfilerLatency<BasePacket>::LatencyStats{0, 0, SC_ZERO_TIME, SC_ZERO_TIME,
+                                                                             SC_ZERO_TIME, 0, 0.0,
+                                                                             0.0, 0.0, 0.0, 0.0, 0.0};
+    }
+    
+    // Quantum syncs of the traffic generators (0 in APPROXIMATE mode)
+    uint64_t get_quantum_sync_count() const {
+        uint64_t syncs = 0;
+        for (const auto& queue : m_queues) {
+            syncs += queue.traffic_generator->get_quantum_sync_count();
+        }
+        return syncs;
+    }
+    
+    size_t get_num_queues() const { return m_queues.size(); }
+    
+    // Fast-forward warm-up: every queue's generator applies its warm-up I/Os through target.
+    // When the last one is done the profilers restart and done runs (e.g. to reset the
+    // target's statistics). Set before the simulation starts.
+    void set_fast_forward_target(const FastForwardTarget& target,
+                                 const std::function<void()>& done = std::function<void()>());
+    
+    unsigned int get_fast_forwarded_transactions() const {
+        unsigned int forwarded = 0;
+        for (const auto& queue : m_queues) {
+            forwarded += queue.traffic_generator->get_fast_forwarded();
+        }
+        return forwarded;
     }
 
 private:
+    typedef sc_fifo<std::shared_ptr<BasePacket>> PacketFifo;
+    
+    // One NVMe-style submission queue: its own generator, queue depth and tag range
+    // [index_base, index_base + depth)
+    struct HostQueue {
+        std::unique_ptr<TrafficGenerator> traffic_generator;
+        std::unique_ptr<IndexAllocator<BasePacket, QueueIndexSetter>> index_allocator;
+        std::unique_ptr<PacketFifo> internal_fifo;     // TrafficGenerator -> IndexAllocator
+        std::unique_ptr<PacketFifo> profiling_fifo;    // IndexAllocator -> profiling_process
+        std::unique_ptr<PacketFifo> release_fifo;      // release_process -> IndexAllocator
+        unsigned int index_base;
+        unsigned int depth;
+    };
+    
     // Internal components
-    std::unique_ptr<TrafficGenerator> m_traffic_generator;
-    std::unique_ptr<IndexAllocator<BasePacket>> m_index_allocator;
+    std::vector<HostQueue> m_queues;
     std::unique_ptr<ProfilerBW<BasePacket>> m_profiler;
+    std::unique_ptr<ProfilerLatency<BasePacket>> m_latency_profiler;
     
-    // Internal FIFO connection between TrafficGenerator and IndexAllocator
-    std::unique_ptr<sc_fifo<std::shared_ptr<BasePacket>>> m_internal_fifo;
+    // Next queue served by profiling_process (round-robin doorbell arbitration)
+    size_t m_next_submission_queue;
     
-    // Internal FIFO for profiling (IndexAllocator -> Profiler -> out)
-    std::unique_ptr<sc_fifo<std::shared_ptr<BasePacket>>> m_profiling_fifo;
-    
-    // Internal FIFO for release processing (release_in -> IndexAllocator)
-    std::unique_ptr<sc_fifo<std::shared_ptr<BasePacket>>> m_release_fifo;
+    // Fast-forward: queues still warming up, and the hook run when all are done
+    size_t m_fast_forward_pending;
+    std::function<void()> m_fast_forward_done;
+    void fast_forward_queue_done();
     
     // Configuration
     void configure_components(const JsonConfig& config, const std::string& config_file_path);
     
-    // Process for profiling outgoing packets
+    // Process for profiling outgoing packets (round-robin over the submission queues)
     void profiling_process();
     
     // Process for handling release packets and tracking completion
     void release_process();
-    
-    // Helper method to create index setter function for IndexAllocator
-    std::function<void(BasePacket&, unsigned int)> create_index_setter();
 
 public:
-    // TrafficGenerator statistics access
+    // TrafficGenerator statistics access (summed over all queues)
     unsigned int get_total_transactions() const {
-        return m_traffic_generator ? m_traffic_generator->get_total_transactions() : 0;
+        unsigned int total = 0;
+        for (const auto& queue : m_queues) {
+            total += queue.traffic_generator->get_total_transactions();
+        }
+        return total;
     }
     
     unsigned int get_sent_transactions() const {
-        return m_traffic_generator ? m_traffic_generator->get_sent_transactions() : 0;
+        unsigned int sent = 0;
+        for (const auto& queue : m_queues) {
+            sent += queue.traffic_generator->get_sent_transactions();
+        }
+        return sent;
     }
     
     unsigned int get_completed_transactions() const {
-        return m_traffic_generator ? m_traffic_generator->get_completed_transactions() : 0;
+        unsigned int completed = 0;
+        for (const auto& queue : m_queues) {
+            completed += queue.traffic_generator->get_completed_transactions();
+        }
+        return completed;
     }
     
     bool is_generation_complete() const {
-        return m_traffic_generator ? m_traffic_generator->is_generation_complete() : true;
+        for (const auto& queue : m_queues) {
+            if (!queue.traffic_generator->is_generation_complete()) {
+                return false;
+            }
+        }
+        return true;
     }
     
     double get_completion_rate() const {
-        return m_traffic_generator ? m_traffic_generator->get_completion_rate() : 0.0;
+        unsigned int total = get_total_transactions();
+        return (total > 0) ? static_cast<double>(get_completed_transactions()) / total : 0.0;
     }
 };
 
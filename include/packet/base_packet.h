@@ -4,12 +4,25 @@
 #include <systemc.h>
 #include <string>
 #include <iostream>
+#include <cstdint>
+#include <type_traits>
+#include "packet/payload.h"
 
 enum class Command {
     READ,
     WRITE
 };
 
+// Common packet fields with typed, compile-time resolved accessors
+// (see PacketFieldTraits / get_field / set_field below)
+enum class PacketField {
+    INDEX,
+    ADDRESS,
+    COMMAND,
+    DATA,
+    DATABYTE
+};
+
 // Abstract Base Packet Class
 class BasePacket {
 public:
@@ -30,6 +43,45 @@ public:
     virtual void set_data(int data) = 0;
     virtual void set_databyte(unsigned char databyte) = 0;
 
+    // Typed index/address access - defaults fall back to the string attribute path,
+    // packet types with a native field override them
+    virtual int get_index() const { return static_cast<int>(get_attribute("index")); }
+    virtual void set_index(int index) { set_attribute("index", static_cast<double>(index)); }
+    virtual void set_address(int address) { set_attribute("address", static_cast<double>(address)); }
+
+    // Loosely-timed mode: absolute local time the packet has reached on its path,
+    // i.e. sc_time_stamp() plus the latency annotated so far (SC_ZERO_TIME when unused)
+    const sc_time& get_lt_time() const { return m_lt_time; }
+    void set_lt_time(const sc_time& lt_time) { m_lt_time = lt_time; }
+    
+    // NVMe submission/completion queue pair the command was issued on (0 = single queue)
+    uint16_t get_queue_id() const { return m_queue_id; }
+    void set_queue_id(uint16_t queue_id) { m_queue_id = queue_id; }
+    
+    // Transfer length in bytes. databyte is the legacy 8-bit size; a packet that sets a
+    // transfer length describes one multi-KB I/O instead of hundreds of small packets.
+    uint32_t get_transfer_length() const { return m_transfer_length ? m_transfer_length : get_databyte(); }
+    void set_transfer_length(uint32_t length) { m_transfer_length = length; }
+    bool has_transfer_length() const { return m_transfer_length != 0; }
+    
+    // Completion that raises an MSI-X interrupt: the interrupt's posted write crosses the
+    // upstream link right behind it
+    bool get_msix_interrupt() const { return m_msix_interrupt; }
+    void set_msix_interrupt(bool msix_interrupt) { m_msix_interrupt = msix_interrupt; }
+    
+    // Restore a size carried through another packet type (PCIe/flash conversion)
+    void restore_transfer_length(uint32_t length) {
+        if (m_transfer_length != 0 || length > 0xFF) {
+            m_transfer_length = length;
+        } else {
+            set_databyte(static_cast<unsigned char>(length));
+        }
+    }
+    
+    // Optional zero-copy payload (scatter-gather list into shared buffers)
+    const PayloadRef& get_payload() const { return m_payload; }
+    void set_payload(const PayloadRef& payload) { m_payload = payload; }
+
     // Friend function to allow operator<< to call virtual print
     friend std::ostream& operator<<(std::ostream& os, const BasePacket& p) {
         p.print(os);
@@ -38,8 +90,93 @@ public:
 
     // Virtual sc_trace for polymorphic tracing
     virtual void sc_trace_impl(sc_trace_file* tf, const std::string& name) const = 0;
+
+private:
+    sc_time m_lt_time;
+    uint16_t m_queue_id = 0;
+    uint32_t m_transfer_length = 0;
+    bool m_msix_interrupt = false;
+    PayloadRef m_payload;
+};
+
+// Compile-time field access: PacketFieldTraits<F> maps a field tag to the
+// typed member call, so hot paths never build a string or go through double.
+// The string get_attribute/set_attribute API remains for config-driven tooling.
+template<PacketField F>
+struct PacketFieldTraits;
+
+template<>
+struct PacketFieldTraits<PacketField::INDEX> {
+    typedef int value_type;
+    static const char* name() { return "index"; }
+    template<typename P> static value_type get(const P& p) { return p.get_index(); }
+    template<typename P> static void set(P& p, value_type v) { p.set_index(v); }
+};
+
+template<>
+struct PacketFieldTraits<PacketField::ADDRESS> {
+    typedef int value_type;
+    static const char* name() { return "address"; }
+    template<typename P> static value_type get(const P& p) { return p.get_address(); }
+    template<typename P> static void set(P& p, value_type v) { p.set_address(v); }
 };
 
+template<>
+struct PacketFieldTraits<PacketField::COMMAND> {
+    typedef Command value_type;
+    static const char* name() { return "command"; }
+    template<typename P> static value_type get(const P& p) { return p.get_command(); }
+};
+
+template<>
+struct PacketFieldTraits<PacketField::DATA> {
+    typedef int value_type;
+    static const char* name() { return "data"; }
+    template<typename P> static value_type get(const P& p) { return p.get_data(); }
+    template<typename P> static void set(P& p, value_type v) { p.set_data(v); }
+};
+
+template<>
+struct PacketFieldTraits<PacketField::DATABYTE> {
+    typedef unsigned char value_type;
+    static const char* name() { return "databyte"; }
+    template<typename P> static value_type get(const P& p) { return p.get_databyte(); }
+    template<typename P> static void set(P& p, value_type v) { p.set_databyte(v); }
+};
+
+template<PacketField F, typename P>
+inline typename PacketFieldTraits<F>::value_type get_field(const P& packet) {
+    return PacketFieldTraits<F>::get(packet);
+}
+
+template<PacketField F, typename P>
+inline void set_field(P& packet, typename PacketFieldTraits<F>::value_type value) {
+    PacketFieldTraits<F>::set(packet, value);
+}
+
+// Transfer size in bytes: the transfer length for BasePacket-derived types, databyte otherwise
+template<typename P>
+inline typename std::enable_if<std::is_base_of<BasePacket, P>::value, uint32_t>::type
+packet_transfer_length(const P& packet) {
+    return packet.get_transfer_length();
+}
+
+template<typename P>
+inline typename std::enable_if<!std::is_base_of<BasePacket, P>::value, uint32_t>::type
+packet_transfer_length(const P& packet) {
+    return static_cast<uint32_t>(get_field<PacketField::DATABYTE>(packet));
+}
+
+// Slow-path lookup from a config/attribute name to a typed field
+inline bool packet_field_from_name(const std::string& name, PacketField& field) {
+    if (name == "index") { field = PacketField::INDEX; return true; }
+    if (name == "address") { field = PacketField::ADDRESS; return true; }
+    if (name == "command") { field = PacketField::COMMAND; return true; }
+    if (name == "data") { field = PacketField::DATA; return true; }
+    if (name == "databyte") { field = PacketField::DATABYTE; return true; }
+    return false;
+}
+
 // Global sc_trace function for BasePacket pointers
 inline void sc_trace(sc_trace_file* tf, const BasePacket& p, const std::string& name) {
     p.sc_trace_impl(tf, name);
@@ -5,6 +5,7 @@
 #include <string>
 #include <iostream>
 #include <memory>
+#include <vector>
 #include "packet/base_packet.h"
 
 // Flash-specific command types
@@ -14,22 +15,24 @@ enum class FlashCommand {
     ERASE = 2
 };
 
-// NAND Flash 5-dimensional addressing structure
+// NAND Flash addressing structure: die within the channel, then the 5-dimensional in-die address
 struct FlashAddress {
+    uint8_t die;        // Die (LUN) on the channel
     uint8_t plane;      // Plane (0-3 for 4-plane)
     uint16_t block;     // Block address
     uint8_t wl;         // WordLine (0-127 typical)
     uint8_t ssl;        // String Select Line
     uint16_t page;      // Page address (16KiB units)
     
-    FlashAddress() : plane(0), block(0), wl(0), ssl(0), page(0) {}
+    FlashAddress() : die(0), plane(0), block(0), wl(0), ssl(0), page(0) {}
     
-    FlashAddress(uint8_t p, uint16_t b, uint8_t w, uint8_t s, uint16_t pg)
-        : plane(p), block(b), wl(w), ssl(s), page(pg) {}
+    FlashAddress(uint8_t p, uint16_t b, uint8_t w, uint8_t s, uint16_t pg, uint8_t d = 0)
+        : die(d), plane(p), block(b), wl(w), ssl(s), page(pg) {}
     
     // Convert to string for debugging
     std::string to_string() const {
-        return "P" + std::to_string(plane) + 
+        return "D" + std::to_string(die) +
+               "P" + std::to_string(plane) + 
                "B" + std::to_string(block) +
                "W" + std::to_string(wl) +
                "S" + std::to_string(ssl) +
@@ -47,6 +50,10 @@ struct FlashPacket : public BasePacket {
     // Preserve original BasePacket information
     std::shared_ptr<BasePacket> original_packet;
     
+    // Further planes of a multi-plane operation, carried by the first plane's packet.
+    // Same die and command; the device releases each plane's packet on its own.
+    std::vector<std::shared_ptr<FlashPacket>> plane_group;
+    
     // Default constructor
     FlashPacket() : flash_command(FlashCommand::READ), data_size(0), index(-1) {}
     
@@ -55,13 +62,15 @@ struct FlashPacket : public BasePacket {
         : flash_command(FlashCommand::READ), data_size(0), index(-1), original_packet(orig_packet) {
         if (orig_packet) {
             // Copy basic attributes from original packet
-            index = static_cast<int>(orig_packet->get_attribute("index"));
+            index = orig_packet->get_index();
         }
     }
     
     // Implementation of virtual get_attribute from BasePacket
     double get_attribute(const std::string& attribute_name) const override {
-        if (attribute_name == "plane") {
+        if (attribute_name == "die") {
+            return static_cast<double>(flash_address.die);
+        } else if (attribute_name == "plane") {
             return static_cast<double>(flash_address.plane);
         } else if (attribute_name == "block") {
             return static_cast<double>(flash_address.block);
@@ -88,7 +97,9 @@ struct FlashPacket : public BasePacket {
     
     // Implementation of virtual set_attribute from BasePacket
     void set_attribute(const std::string& attribute_name, double value) override {
-        if (attribute_name == "plane") {
+        if (attribute_name == "die") {
+            flash_address.die = static_cast<uint8_t>(value);
+        } else if (attribute_name == "plane") {
             flash_address.plane = static_cast<uint8_t>(value);
         } else if (attribute_name == "block") {
             flash_address.block = static_cast<uint16_t>(value);
@@ -123,6 +134,7 @@ struct FlashPacket : public BasePacket {
     void sc_trace_impl(sc_trace_file* tf, const std::string& name) const override {
         int command_value = static_cast<int>(flash_command);
         sc_trace(tf, command_value, name + ".flash_command");
+        sc_trace(tf, flash_address.die, name + ".die");
         sc_trace(tf, flash_address.plane, name + ".plane");
         sc_trace(tf, flash_address.block, name + ".block");
         sc_trace(tf, flash_address.wl, name + ".wl");
@@ -139,7 +151,7 @@ struct FlashPacket : public BasePacket {
     
     int get_address() const override { 
         // Return a linearized address for compatibility
-        return (flash_address.plane << 20) | (flash_address.block << 8) | 
+        return (flash_address.die << 24) | (flash_address.plane << 20) |(flash_address.block << 8) | 
                (flash_address.wl << 4) | (flash_address.ssl << 2) | flash_address.page;
     }
     
@@ -160,6 +172,9 @@ struct FlashPacket : public BasePacket {
         data_size = static_cast<uint32_t>(databyte);
     }
     
+    int get_index() const override { return index; }
+    void set_index(int new_index) override { index = new_index; }
+    
     // Flash-specific methods
     FlashCommand get_flash_command() const { return flash_command; }
     const FlashAddress& get_flash_address() const { return flash_address; }
@@ -167,7 +182,7 @@ struct FlashPacket : public BasePacket {
     
     void set_flash_command(FlashCommand cmd) { flash_command = cmd; }
     void set_flash_address(const FlashAddress& addr) { flash_address = addr; }
-    void set_data_size(uint32_t size) { data_size = size; }
+    void set_data_size(uint32_t size) { data_size = size; set_transfer_length(size); }
 };
 
 #endif
\ No newline at end of file
@@ -8,7 +8,7 @@
 #include "common/error_handling.h" // Include error handling utilities
 
 // GenericPacket inherits from BasePacket
-struct GenericPacket : public BasePacket {
+struct GenericPacket final : public BasePacket {
     Command command;
     int address;
     int data;
@@ -58,6 +58,9 @@ struct GenericPacket : public BasePacket {
     unsigned char get_databyte() const override { return databyte; }
     void set_data(int new_data) override { data = new_data; }
     void set_databyte(unsigned char new_databyte) override { databyte = new_databyte; }
+    int get_index() const override { return index; }
+    void set_index(int new_index) override { index = new_index; }
+    void set_address(int new_address) override { address = new_address; }
 
     // Implementation of virtual set_attribute from BasePacket
     void set_attribute(const std::string& attribute_name, double value) override {
@@ -0,0 +1,183 @@
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Packet pool - recycles packet storage instead of going through malloc/free
+// for every transaction.
+//
+// PacketPool<T>::acquire() returns an ordinary std::shared_ptr<T>, so pooled
+// packets travel through the existing sc_fifo<std::shared_ptr<BasePacket>>
+// channels unchanged. The packet and its shared_ptr control block live in one
+// pooled chunk (std::allocate_shared), and the chunk goes back to the pool's
+// free list when the last reference is dropped - for host traffic that is the
+// IndexAllocator release path, right after the index is freed.
+//
+// The free lists are not locked. Every acquire and release must happen on the
+// SystemC thread: partition workers (PartitionWorker, flash channels) may run
+// model code, but they drop their packet references before their ticket
+// completes, so the last reference - and the free - stays on the submitting
+// SystemC process. Debug builds assert this on every free-list access.
+
+// Per-packet-type pool statistics
+struct PacketPoolStats {
+    unsigned long long heap_allocations;   // Chunks obtained from the heap
+    unsigned long long recycled;           // Allocations served from the free list
+    unsigned long long in_use;             // Chunks currently handed out
+
+    PacketPoolStats() : heap_allocations(0), recycled(0), in_use(0) {}
+};
+
+// Free list of fixed-size chunks for one allocation type.
+// Chunks are carved from slabs and never returned to the heap; the free list is
+// created on first use and intentionally never destroyed, so packets released
+// during static destruction still have somewhere to go.
+template<typename T, typename PacketType>
+class PacketPoolFreeList {
+public:
+    static PacketPoolFreeList& instance() {
+        static PacketPoolFreeList* free_list = new PacketPoolFreeList();
+        return *free_list;
+    }
+
+    void* acquire(PacketPoolStats& stats) {
+        assert(std::this_thread::get_id() == m_owner && "PacketPool used off the SystemC thread");
+        if (!m_head) {
+            grow();
+            stats.heap_allocations += SLAB_CHUNKS;
+        } else {
+            stats.recycled++;
+        }
+        Chunk* chunk = m_head;
+        m_head = chunk->next;
+        stats.in_use++;
+        return chunk;
+    }
+
+    void release(void* ptr, PacketPoolStats& stats) {
+        assert(std::this_thread::get_id() == m_owner && "PacketPool chunk freed off the SystemC thread");
+        Chunk* chunk = static_cast<Chunk*>(ptr);
+        chunk->next = m_head;
+        m_head = chunk;
+        stats.in_use--;
+    }
+
+private:
+    static const std::size_t SLAB_CHUNKS = 64;
+
+    union Chunk {
+        Chunk* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    Chunk* m_head;
+    std::vector<std::unique_ptr<Chunk[]>> m_slabs;
+#ifndef NDEBUG
+    const std::thread::id m_owner;    // Thread of first use (the SystemC thread)
+#endif
+
+#ifndef NDEBUG
+    PacketPoolFreeList() : m_head(nullptr), m_owner(std::this_thread::get_id()) {}
+#else
+    PacketPoolFreeList() : m_head(nullptr) {}
+#endif
+
+    void grow() {
+        std::unique_ptr<Chunk[]> slab(new Chunk[SLAB_CHUNKS]);
+        for (std::size_t i = 0; i < SLAB_CHUNKS; ++i) {
+            slab[i].next = m_head;
+            m_head = &slab[i];
+        }
+        m_slabs.push_back(std::move(slab));
+    }
+};
+
+template<typename PacketType>
+class PacketPool;
+
+// Standard allocator handing out chunks from PacketPoolFreeList. PacketType is
+// carried through rebind so every chunk is accounted to the packet type's pool.
+template<typename T, typename PacketType>
+struct PacketPoolAllocator {
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind {
+        typedef PacketPoolAllocator<U, PacketType> other;
+    };
+
+    PacketPoolAllocator() {}
+
+    template<typename U>
+    PacketPoolAllocator(const PacketPoolAllocator<U, PacketType>&) {}
+
+    T* allocate(std::size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(PacketPoolFreeList<T, PacketType>::instance().acquire(
+            PacketPool<PacketType>::mutable_stats()));
+    }
+
+    void deallocate(T* ptr, std::size_t n) {
+        if (n != 1) {
+            ::operator delete(ptr);
+            return;
+        }
+        PacketPoolFreeList<T, PacketType>::instance().release(
+            ptr, PacketPool<PacketType>::mutable_stats());
+    }
+};
+
+template<typename T, typename U, typename PacketType>
+bool operator==(const PacketPoolAllocator<T, PacketType>&, const PacketPoolAllocator<U, PacketType>&) {
+    return true;
+}
+
+template<typename T, typename U, typename PacketType>
+bool operator!=(const PacketPoolAllocator<T, PacketType>&, const PacketPoolAllocator<U, PacketType>&) {
+    return false;
+}
+
+// Pool front-end for one packet type
+template<typename PacketType>
+class PacketPool {
+public:
+    // Construct a packet in pooled storage (drop-in for std::make_shared)
+    template<typename... Args>
+    static std::shared_ptr<PacketType> acquire(Args&&... args) {
+        return std::allocate_shared<PacketType>(PacketPoolAllocator<PacketType, PacketType>(),
+                                                std::forward<Args>(args)...);
+    }
+
+    // Pre-populate the free list so the first `count` packets in flight never hit the heap
+    static void reserve(std::size_t count) {
+        std::vector<std::shared_ptr<PacketType>> warm_up;
+        warm_up.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            warm_up.push_back(acquire());
+        }
+    }
+
+    static const PacketPoolStats& stats() {
+        return mutable_stats();
+    }
+
+private:
+    template<typename T, typename P>
+    friend struct PacketPoolAllocator;
+
+    static PacketPoolStats& mutable_stats() {
+        static PacketPoolStats stats;
+        return stats;
+    }
+};
+
+#endif
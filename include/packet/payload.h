@@ -0,0 +1,74 @@
+#ifndef PAYLOAD_H
+#define PAYLOAD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Zero-copy payload handle for large transfers. A packet carries a scatter-gather
+// list of (buffer, offset, length) segments; the bytes live in reference-counted
+// buffers shared by every packet (and every split of a packet) that points at them.
+// Nothing on the simulated path copies payload bytes - splitting a transfer into
+// TLPs or flash pages only slices the segment list.
+
+typedef std::vector<uint8_t> PayloadBuffer;
+
+struct SgSegment {
+    std::shared_ptr<const PayloadBuffer> buffer;
+    uint64_t offset;
+    uint32_t length;
+
+    SgSegment() : offset(0), length(0) {}
+    SgSegment(std::shared_ptr<const PayloadBuffer> buf, uint64_t off, uint32_t len)
+        : buffer(buf), offset(off), length(len) {}
+
+    const uint8_t* data() const { return buffer ? buffer->data() + offset : nullptr; }
+};
+
+class SgList {
+public:
+    SgList() : m_total_length(0) {}
+
+    // Whole-buffer list
+    explicit SgList(std::shared_ptr<const PayloadBuffer> buffer) : m_total_length(0) {
+        if (buffer) {
+            append(SgSegment(buffer, 0, static_cast<uint32_t>(buffer->size())));
+        }
+    }
+
+    void append(const SgSegment& segment) {
+        if (segment.length == 0) return;
+        m_segments.push_back(segment);
+        m_total_length += segment.length;
+    }
+
+    const std::vector<SgSegment>& segments() const { return m_segments; }
+    uint64_t total_length() const { return m_total_length; }
+    bool empty() const { return m_total_length == 0; }
+
+    // Segments covering [offset, offset + length) of the list (still referencing the same buffers)
+    SgList slice(uint64_t offset, uint64_t length) const {
+        SgList result;
+        uint64_t position = 0;
+        for (const SgSegment& segment : m_segments) {
+            uint64_t segment_end = position + segment.length;
+            if (segment_end > offset && position < offset + length) {
+                uint64_t begin = (offset > position) ? offset - position : 0;
+                uint64_t end = std::min<uint64_t>(segment.length, offset + length - position);
+                result.append(SgSegment(segment.buffer, segment.offset + begin, static_cast<uint32_t>(end - begin)));
+            }
+            position = segment_end;
+            if (position >= offset + length) break;
+        }
+        return result;
+    }
+
+private:
+    std::vector<SgSegment> m_segments;
+    uint64_t m_total_length;
+};
+
+typedef std::shared_ptr<const SgList> PayloadRef;
+
+#endif // PAYLOAD_H
@@ -6,8 +6,10 @@
 #include <iostream>
 #include <memory>
 #include <map>
+#include <algorithm>
 #include <random>
 #include "packet/base_packet.h"
+#include "common/random.h"
 
 // PCIe Generation enumeration with speed characteristics
 enum class PCIeGeneration {
@@ -151,6 +153,11 @@ struct PCIePacket : public BasePacket {
     uint8_t lanes;                     // Number of PCIe lanes (x1, x4, x8, x16)
     uint32_t data_payload_size;        // Actual data size in bytes
     uint32_t total_packet_size;        // Including headers and CRC overhead
+    uint32_t max_payload_size;         // MPS: payload bytes per TLP (0 = single TLP)
+    uint32_t tlp_count;                // TLPs the transfer is split into on the link
+    bool msix_write;                   // An MSI-X posted write TLP follows the transfer
+    
+    static const uint32_t MSIX_WRITE_BYTES = 4;   // MSI-X message data
     
     // CRC and error simulation
     bool crc_error_injected;           // For testing error recovery
@@ -166,14 +173,16 @@ struct PCIePacket : public BasePacket {
     // Default constructor
     PCIePacket(PCIeGeneration gen = PCIeGeneration::GEN3, uint8_t lane_count = 8) 
         : generation(gen), lanes(lane_count), data_payload_size(0), total_packet_size(0),
-          crc_error_injected(false), retry_count(0), creation_time(sc_time_stamp()) {
+          max_payload_size(0), tlp_count(1), msix_write(false), crc_error_injected(false), retry_count(0),
+          creation_time(sc_time_stamp()) {
         calculate_packet_size();
     }
     
     // Constructor with original packet
     PCIePacket(std::shared_ptr<BasePacket> orig_packet, PCIeGeneration gen = PCIeGeneration::GEN3, uint8_t lane_count = 8)
         : generation(gen), lanes(lane_count), data_payload_size(0), total_packet_size(0),
-          crc_error_injected(false), retry_count(0), original_packet(orig_packet),
+          max_payload_size(0), tlp_count(1), msix_write(false), crc_error_injected(false), retry_count(0),
+          original_packet(orig_packet),
           creation_time(sc_time_stamp()) {
         if (orig_packet) {
             setup_from_base_packet(*orig_packet);
@@ -193,24 +202,39 @@ struct PCIePacket : public BasePacket {
         tlp_header.completer_id = 0x0200;  // Default device ID
         
         // Set data size
-        data_payload_size = static_cast<uint32_t>(base_packet.get_databyte());
+        data_payload_size = base_packet.get_transfer_length();
         if (data_payload_size == 0) data_payload_size = 64;  // Default size
-        
-        // Calculate length in DW (32-bit words)
-        tlp_header.length = (data_payload_size + 3) / 4;
+        set_transfer_length(data_payload_size);
+        set_payload(base_packet.get_payload());
+        msix_write = base_packet.get_msix_interrupt();
         
         // Set tag from packet index
-        tlp_header.tag = static_cast<uint16_t>(base_packet.get_attribute("index")) % 
+        tlp_header.tag = static_cast<uint16_t>(base_packet.get_index()) % 
                         tlp_header.get_max_tag(generation);
     }
     
-    // Calculate total packet size including CRC overhead
+    // Split the transfer into TLPs of at most mps payload bytes (0 = one TLP)
+    void set_max_payload_size(uint32_t mps) {
+        max_payload_size = mps;
+        calculate_packet_size();
+    }
+    
+    // Calculate total packet size including CRC overhead (all TLPs of the transfer)
     void calculate_packet_size() {
         const PCIeCRCScheme& crc_scheme = PCIeGenerationSpecs::get_crc_scheme(generation);
         
-        uint32_t header_size = tlp_header.get_header_size();
+        // One header per MPS-sized TLP; length is the DW count of a full TLP
         uint32_t payload_size = data_payload_size;
-        uint32_t base_size = header_size + payload_size;
+        uint32_t tlp_payload = (max_payload_size > 0) ? std::min(payload_size, max_payload_size) : payload_size;
+        tlp_count = (max_payload_size > 0 && payload_size > 0) ? (payload_size + max_payload_size - 1) / max_payload_size : 1;
+        tlp_header.length = static_cast<uint16_t>((tlp_payload + 3) / 4);
+        
+        uint32_t header_size = tlp_header.get_header_size();
+        uint32_t base_size = header_size * tlp_count + payload_size;
+        if (msix_write) {
+            tlp_count++;
+            base_size += header_size + MSIX_WRITE_BYTES;
+        }
         
         // Add CRC overhead
         uint32_t crc_overhead = static_cast<uint32_t>(base_size * crc_scheme.overhead_percent / 100.0);
@@ -230,15 +254,10 @@ struct PCIePacket : public BasePacket {
         crc_processing_time = sc_time(base_processing_time, SC_NS);
     }
     
-    // Check if CRC error should occur (probabilistic)
-    bool should_crc_error_occur() const {
+    // Check if CRC error should occur (probabilistic, drawn from the link's stream)
+    bool should_crc_error_occur(RandomStream& rng) const {
         const PCIeCRCScheme& crc_scheme = PCIeGenerationSpecs::get_crc_scheme(generation);
-        
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_real_distribution<double> dis(0.0, 1.0);
-        
-        return dis(gen) < crc_scheme.retry_probability;
+        return rng.unit() < crc_scheme.retry_probability;
     }
     
     // Implementation of virtual methods from BasePacket
@@ -251,6 +270,8 @@ struct PCIePacket : public BasePacket {
             return static_cast<double>(tlp_header.tag);
         } else if (attribute_name == "total_size") {
             return static_cast<double>(total_packet_size);
+        } else if (attribute_name == "tlp_count") {
+            return static_cast<double>(tlp_count);
         } else if (attribute_name == "crc_overhead") {
             const PCIeCRCScheme& crc_scheme = PCIeGenerationSpecs::get_crc_scheme(generation);
             return crc_scheme.overhead_percent;
@@ -275,6 +296,7 @@ struct PCIePacket : public BasePacket {
             tlp_header.tag = static_cast<uint16_t>(value);
         } else if (attribute_name == "data_payload_size") {
             data_payload_size = static_cast<uint32_t>(value);
+            set_transfer_length(data_payload_size);
             calculate_packet_size();
         } else if (attribute_name == "retry_count") {
             retry_count = static_cast<uint32_t>(value);
@@ -292,8 +314,11 @@ struct PCIePacket : public BasePacket {
            << ", TLP: " << tlp_str
            << ", Tag: " << tlp_header.tag
            << ", Addr: 0x" << std::hex << tlp_header.address << std::dec
-           << ", Size: " << total_packet_size << "B"
-           << ", Retries: " << retry_count;
+           << ", Size: " << total_packet_size << "B";
+        if (tlp_count > 1) {
+            os << " (" << tlp_count << " TLPs)";
+        }
+        os << ", Retries: " << retry_count;
     }
     
     void sc_trace_impl(sc_trace_file* tf, const std::string& name) const override {
@@ -336,9 +361,18 @@ struct PCIePacket : public BasePacket {
     void set_databyte(unsigned char databyte) override {
         if (original_packet) original_packet->set_databyte(databyte);
         data_payload_size = static_cast<uint32_t>(databyte);
+        set_transfer_length(data_payload_size);
         calculate_packet_size();
     }
     
+    int get_index() const override {
+        return original_packet ? original_packet->get_index() : 0;
+    }
+    
+    void set_index(int index) override {
+        if (original_packet) original_packet->set_index(index);
+    }
+    
     // PCIe-specific methods
     const PCIeCRCScheme& get_crc_scheme() const {
         return PCIeGenerationSpecs::get_crc_scheme(generation);
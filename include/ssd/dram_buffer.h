@@ -0,0 +1,281 @@
+#ifndef DRAM_BUFFER_H
+#define DRAM_BUFFER_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include "packet/base_packet.h"
+#include "packet/generic_packet.h"
+#include "packet/packet_pool.h"
+#include "common/stats_registry.h"
+#include "common/error_handling.h"
+#include "common/self_profiler.h"
+
+// SSD DRAM data buffer between the DRAM controller and the flash controller.
+// Host data is held at flash page granularity with LRU replacement. A read whose pages
+// are all buffered completes from DRAM; otherwise it is read from flash and its pages
+// are buffered on the way back. Writes are absorbed (their pages become dirty) and
+// complete from DRAM; an evicted dirty page is written back to flash as one page program.
+// Each output has a single writer process fed by a queue, so fills never block on
+// write-backs and flash completions are always drained.
+// A capacity of 0 buffers nothing: every DRAM completion is passed through to flash and
+// completes from there (reads count as misses).
+// Write-backs are pooled GenericPackets, so PacketType must be a base of GenericPacket;
+// a host packet that is not a PacketType is rejected instead of being sent to flash.
+template<typename PacketType = BasePacket>
+SC_MODULE(DramBuffer) {
+    SC_HAS_PROCESS(DramBuffer);
+    static_assert(std::is_base_of<PacketType, GenericPacket>::value,
+                  "DramBuffer: write-backs are GenericPackets, PacketType must be BasePacket or GenericPacket");
+
+    sc_fifo_in<std::shared_ptr<BasePacket>> dram_in;      // Completions of the DRAM controller
+    sc_fifo_out<std::shared_ptr<BasePacket>> cache_out;   // Fills and acknowledgements to the cache
+    sc_fifo_out<std::shared_ptr<PacketType>> flash_out;   // Read misses and write-backs
+    sc_fifo_in<std::shared_ptr<PacketType>> flash_in;     // Flash completions
+
+    // Configuration
+    const bool m_debug_enable;
+    const uint64_t m_page_bytes;
+    const size_t m_capacity_pages;
+
+    // Buffered pages, most recently used first
+    struct BufferedPage {
+        uint64_t page;
+        bool dirty;
+    };
+    std::list<BufferedPage> m_lru;
+    std::unordered_map<uint64_t, typename std::list<BufferedPage>::iterator> m_pages;
+    size_t m_dirty_pages;
+
+    // Write-backs in flight (completions are consumed here)
+    std::unordered_set<const BasePacket*> m_write_backs;
+
+    std::deque<std::shared_ptr<BasePacket>> m_cache_queue;
+    sc_event m_cache_ready;
+    std::deque<std::shared_ptr<BasePacket>> m_flash_queue;
+    sc_event m_flash_ready;
+
+    // Statistics
+    uint64_t m_read_hits;
+    uint64_t m_read_misses;
+    uint64_t m_writes;
+    uint64_t m_write_backs_issued;
+    uint64_t m_write_backs_completed;
+    StatsGroup m_stats_group;
+
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("read_hits", &m_read_hits);
+        m_stats_group.counter("read_misses", &m_read_misses);
+        m_stats_group.counter("writes", &m_writes);
+        m_stats_group.counter("write_backs", &m_write_backs_issued, "pages");
+        m_stats_group.counter("write_backs_completed", &m_write_backs_completed, "pages");
+        m_stats_group.gauge("read_hit_rate", [this]() { return get_read_hit_rate(); }, "ratio");
+        m_stats_group.gauge("buffered_pages", [this]() { return static_cast<double>(m_pages.size()); }, "pages");
+        m_stats_group.gauge("dirty_pages", [this]() { return static_cast<double>(m_dirty_pages); }, "pages");
+    }
+
+    // DRAM completions: hit, read miss to flash, or absorbed write
+    void dram_process() {
+        while (true) {
+            auto packet = SelfProfiler::read(dram_in);
+            if (m_capacity_pages == 0) {
+                if (packet->get_command() == Command::WRITE) {
+                    m_writes++;
+                } else {
+                    m_read_misses++;
+                }
+                queue_to_flash(packet);
+                continue;
+            }
+            uint64_t first_page, last_page;
+            page_range(*packet, first_page, last_page);
+
+            if (packet->get_command() == Command::WRITE) {
+                m_writes++;
+                for (uint64_t page = first_page; page <= last_page; page++) {
+                    insert_page(page, true);
+                }
+                queue_to_cache(packet);
+                continue;
+            }
+
+            bool buffered = true;
+            for (uint64_t page = first_page; page <= last_page && buffered; page++) {
+                buffered = m_pages.count(page) > 0;
+            }
+            if (buffered) {
+                m_read_hits++;
+                for (uint64_t page = first_page; page <= last_page; page++) {
+                    insert_page(page, false);
+                }
+                queue_to_cache(packet);
+            } else {
+                m_read_misses++;
+                if (m_debug_enable) {
+                    std::cout << sc_time_stamp() << " | DramBuffer: READ miss address=0x" << std::hex
+                              << packet->get_address() << std::dec << " - reading from flash" << std::endl;
+                }
+                queue_to_flash(packet);
+            }
+        }
+    }
+
+    // Flash completions: buffer the pages of a read miss and complete it; drop write-backs
+    void flash_completion_process() {
+        while (true) {
+            std::shared_ptr<BasePacket> packet = SelfProfiler::read(flash_in);
+            auto write_back = m_write_backs.find(packet.get());
+            if (write_back != m_write_backs.end()) {
+                m_write_backs.erase(write_back);
+                m_write_backs_completed++;
+                continue;
+            }
+            if (m_capacity_pages > 0) {
+                uint64_t first_page, last_page;
+                page_range(*packet, first_page, last_page);
+                for (uint64_t page = first_page; page <= last_page; page++) {
+                    insert_page(page, false);
+                }
+            }
+            queue_to_cache(packet);
+        }
+    }
+
+    void cache_output_process() {
+        while (true) {
+            while (m_cache_queue.empty()) {
+                SelfProfiler::wait(m_cache_ready);
+            }
+            auto packet = m_cache_queue.front();
+            m_cache_queue.pop_front();
+            SelfProfiler::write(cache_out, packet);
+        }
+    }
+
+    void flash_output_process() {
+        while (true) {
+            while (m_flash_queue.empty()) {
+                SelfProfiler::wait(m_flash_ready);
+            }
+            auto packet = m_flash_queue.front();
+            m_flash_queue.pop_front();
+            auto flash_packet = std::dynamic_pointer_cast<PacketType>(packet);
+            if (!flash_packet) {
+                SOC_SIM_ERROR(name(), soc_sim::error::codes::INVALID_PACKET_TYPE,
+                              "Packet is not of the flash controller's packet type, dropped");
+                continue;
+            }
+            SelfProfiler::write(flash_out, flash_packet);
+        }
+    }
+
+    void queue_to_cache(const std::shared_ptr<BasePacket>& packet) {
+        m_cache_queue.push_back(packet);
+        m_cache_ready.notify();
+    }
+
+    void queue_to_flash(const std::shared_ptr<BasePacket>& packet) {
+        m_flash_queue.push_back(packet);
+        m_flash_ready.notify();
+    }
+
+    void page_range(const BasePacket& packet, uint64_t& first_page, uint64_t& last_page) const {
+        uint64_t start = static_cast<uint32_t>(packet.get_address());
+        uint64_t length = std::max<uint32_t>(1, packet_transfer_length(packet));
+        first_page = start / m_page_bytes;
+        last_page = (start + length - 1) / m_page_bytes;
+    }
+
+    // Buffer (or touch) a page; a write marks it dirty. Evicts the LRU page when full.
+    void insert_page(uint64_t page, bool dirty) {
+        auto it = m_pages.find(page);
+        if (it != m_pages.end()) {
+            if (dirty && !it->second->dirty) {
+                it->second->dirty = true;
+                m_dirty_pages++;
+            }
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return;
+        }
+        if (m_pages.size() >= m_capacity_pages) {
+            evict_page();
+        }
+        BufferedPage entry = {page, dirty};
+        m_lru.push_front(entry);
+        m_pages[page] = m_lru.begin();
+        m_dirty_pages += dirty ? 1 : 0;
+    }
+
+    void evict_page() {
+        const BufferedPage& victim = m_lru.back();
+        // Packet addresses are signed 32-bit: a page past 2 GiB cannot be written back
+        uint64_t address = victim.page * m_page_bytes;
+        if (victim.dirty && address > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            SOC_SIM_ERROR(name(), soc_sim::error::codes::ADDRESS_OUT_OF_BOUNDS,
+                          "Write-back address out of packet range: " + std::to_string(address));
+            m_dirty_pages--;
+        } else if (victim.dirty) {
+            auto write_back = PacketPool<GenericPacket>::acquire();
+            write_back->command = Command::WRITE;
+            write_back->address = static_cast<int>(address);
+            write_back->data = 0;
+            write_back->databyte = 0;
+            write_back->index = -1;
+            write_back->set_transfer_length(static_cast<uint32_t>(m_page_bytes));
+            m_write_backs.insert(write_back.get());
+            m_write_backs_issued++;
+            m_dirty_pages--;
+            if (m_debug_enable) {
+                std::cout << sc_time_stamp() << " | DramBuffer: write-back of page " << victim.page << std::endl;
+            }
+            queue_to_flash(write_back);
+        }
+        m_pages.erase(victim.page);
+        m_lru.pop_back();
+    }
+
+    // Constructor
+    DramBuffer(sc_module_name name, uint32_t page_size_kb, uint32_t capacity_kb, bool debug_enable = false)
+        : sc_module(name),
+          m_debug_enable(debug_enable),
+          m_page_bytes(std::max<uint32_t>(1, page_size_kb) * 1024ULL),
+          m_capacity_pages(capacity_kb > 0 ? std::max<size_t>(1, capacity_kb / std::max<uint32_t>(1, page_size_kb)) : 0),
+          m_dirty_pages(0),
+          m_read_hits(0),
+          m_read_misses(0),
+          m_writes(0),
+          m_write_backs_issued(0),
+          m_write_backs_completed(0) {
+
+        if (m_debug_enable) {
+            std::cout << "0 s | " << basename() << ": DRAM data buffer " << m_capacity_pages << " pages of "
+                      << m_page_bytes / 1024 << " KB" << std::endl;
+        }
+
+        register_stats();
+        SC_THREAD(dram_process);
+        SC_THREAD(flash_completion_process);
+        SC_THREAD(cache_output_process);
+        SC_THREAD(flash_output_process);
+    }
+
+    double get_read_hit_rate() const {
+        uint64_t reads = m_read_hits + m_read_misses;
+        return reads > 0 ? static_cast<double>(m_read_hits) / reads : 0.0;
+    }
+
+    uint64_t get_read_misses() const { return m_read_misses; }
+    uint64_t get_write_backs() const { return m_write_backs_issued; }
+    size_t get_capacity_pages() const { return m_capacity_pages; }
+};
+
+#endif
@@ -7,36 +7,55 @@
  */
 
 #include <systemc.h>
+#include <functional>
 #include <memory>
 #include <queue>
+#include <deque>
 #include <vector>
 #include <unordered_map>
-#include <random>
 #include <algorithm>
 #include <iomanip>
 #include "packet/base_packet.h"
 #include "packet/flash_packet.h"
+#include "packet/packet_pool.h"
 #include "base/nand_flash.h"
+#include "ssd/page_ftl.h"
 #include "common/json_config.h"
 #include "common/error_handling.h"
+#include "common/stats_registry.h"
+#include "common/self_profiler.h"
 
 // Flash Controller configuration
 struct FlashControllerConfig {
     uint32_t num_channels;           // Number of Flash channels
     uint32_t dies_per_channel;       // Dies per channel
+    uint32_t planes_per_die;         // Planes per die
     uint32_t command_queue_depth;    // Command queue depth per channel
     uint32_t page_size_kb;           // Page size in KB
     uint32_t pages_per_block;        // Pages per block
     uint32_t blocks_per_die;         // Blocks per die
     double channel_bandwidth_mbps;   // Channel bandwidth in MB/s
-    bool enable_interleaving;        // Enable channel interleaving
+    bool enable_interleaving;        // Enable die interleaving within a channel
+    bool enable_multi_plane;         // Merge same-die, different-plane commands into one operation
     bool enable_wear_leveling;       // Enable wear leveling
+    uint32_t wear_leveling_threshold;     // Max - min block erase count that triggers wear leveling
+    double wear_leveling_interval_us;     // Firmware check period (0 = check when an erase raises the max)
     std::string ecc_type;            // ECC type (BCH, LDPC, etc.)
+    double over_provisioning;        // Fraction of physical pages hidden from the host
+    GcPolicy gc_policy;              // Garbage collection victim selection
+    uint32_t gc_threshold_blocks;    // GC runs while fewer FTL blocks than this are free
     
-    FlashControllerConfig() : num_channels(8), dies_per_channel(4), command_queue_depth(16),
-                            page_size_kb(16), pages_per_block(128), blocks_per_die(1024),
+    FlashControllerConfig() : num_channels(8), dies_per_channel(4), planes_per_die(4), command_queue_depth(16),
+                            page_size_kb(16), pages_per_block(128), blocks_per_die(4096),
                             channel_bandwidth_mbps(400.0), enable_interleaving(true),
-                            enable_wear_leveling(true), ecc_type("LDPC") {}
+                            enable_multi_plane(true), enable_wear_leveling(true),
+                            wear_leveling_threshold(100), wear_leveling_interval_us(0.0), ecc_type("LDPC"),
+                            over_provisioning(0.07), gc_policy(GcPolicy::GREEDY), gc_threshold_blocks(2) {}
+    
+    uint32_t blocks_per_plane() const { return blocks_per_die / planes_per_die; }
+    
+    // FTL erase unit: the same block on every channel, die and plane (physical pages stripe across them)
+    uint32_t pages_per_ftl_block() const { return num_channels * dies_per_channel * planes_per_die * pages_per_block; }
 };
 
 // Flash operation types
@@ -58,30 +77,46 @@ struct FlashControllerCommand {
     uint32_t block;
     uint32_t page;
     uint64_t physical_address;
+    uint32_t transfer_bytes;         // Bytes of the host transfer that fall in this page
     sc_time submit_time;
     sc_time start_time;
     sc_time completion_time;
     bool completed;
     
+    // Garbage collection commands have no original packet
+    uint32_t gc_lpn;                 // Logical page being relocated
+    uint32_t gc_source_ppn;          // Its physical page in the victim block
+    
     FlashControllerCommand(std::shared_ptr<BasePacket> pkt, FlashOperation op)
         : original_packet(pkt), operation(op), channel(0), die(0), plane(0),
-          block(0), page(0), physical_address(0), submit_time(sc_time_stamp()),
-          start_time(SC_ZERO_TIME), completion_time(SC_ZERO_TIME), completed(false) {}
+          block(0), page(0), physical_address(0), transfer_bytes(0), submit_time(sc_time_stamp()),
+          start_time(SC_ZERO_TIME), completion_time(SC_ZERO_TIME), completed(false),
+          gc_lpn(0), gc_source_ppn(0) {}
+    
+    bool is_internal() const { return !original_packet; }
 };
 
-// Channel state tracking
+// Channel state tracking. Each die runs one (possibly multi-plane) operation at a time;
+// the channel is busy while any of its dies is.
 struct ChannelState {
-    bool busy;
-    std::queue<std::shared_ptr<FlashControllerCommand>> command_queue;
+    std::deque<std::shared_ptr<FlashControllerCommand>> command_queue;
+    std::vector<uint32_t> die_outstanding;   // Plane commands in flight per die
+    uint32_t busy_dies;
     sc_time last_operation_time;
+    sc_time busy_since;
+    sc_time busy_time;                       // Time with at least one die busy
     uint64_t total_operations;
     uint64_t read_operations;
     uint64_t write_operations;
     uint64_t erase_operations;
+    uint64_t multi_plane_operations;
     
-    ChannelState() : busy(false), last_operation_time(SC_ZERO_TIME),
+    ChannelState() : busy_dies(0), last_operation_time(SC_ZERO_TIME),
+                    busy_since(SC_ZERO_TIME), busy_time(SC_ZERO_TIME),
                     total_operations(0), read_operations(0), write_operations(0),
-                    erase_operations(0) {}
+                    erase_operations(0), multi_plane_operations(0) {}
+    
+    bool is_busy() const { return busy_dies > 0; }
 };
 
 // Flash Controller SystemC Module
@@ -107,11 +142,40 @@ SC_MODULE(FlashController) {
     
     // Events for efficient communication
     sc_event m_command_available;
-    sc_event m_completion_available;
+    sc_event m_channel_space_freed;       // A host command left a channel queue
+    
+    // Plane commands sent to the NAND devices, by packet
+    std::unordered_map<const FlashPacket*, std::shared_ptr<FlashControllerCommand>> m_in_flight;
+    
+    // Host transfers spanning several pages: one command per page, the packet completes
+    // when the last page does
+    struct SplitTransfer {
+        uint32_t remaining_pages;
+        sc_time submit_time;
+    };
+    std::unordered_map<const BasePacket*, SplitTransfer> m_split_transfers;
+    
+    // Functional NAND access used by fast-forward (page program / block erase, untimed)
+    typedef std::function<void(uint32_t channel, FlashCommand command, const FlashAddress& address)> FunctionalFlashPort;
+    FunctionalFlashPort m_functional_flash;
     
     // Address translation and mapping
-    std::unordered_map<uint64_t, uint64_t> m_logical_to_physical;
+    std::unique_ptr<PageMappedFtl> m_ftl;
     std::vector<uint32_t> m_erase_counts;  // Per-block erase count for wear leveling
+    uint32_t m_max_erase_count;            // Running max of m_erase_counts
+    uint32_t m_min_erase_count;            // Lower bound of min(m_erase_counts), refreshed on checks
+    uint32_t m_wear_checked_max;           // m_max_erase_count at the last wear leveling check
+    sc_event m_block_erased;
+    bool m_wear_leveling_requested;        // Spread over threshold: GC process relocates a cold block
+    uint64_t m_wear_leveling_relocations;  // Cold blocks relocated by static wear leveling
+    
+    // Garbage collection progress (one victim at a time)
+    sc_event m_gc_wakeup;
+    sc_event m_gc_progress;
+    sc_event m_block_freed;
+    uint32_t m_gc_pending_copies;
+    uint32_t m_gc_pending_erases;
+    uint64_t m_gc_flash_commands;
     
     // Statistics
     uint64_t m_total_flash_commands;
@@ -121,16 +185,48 @@ SC_MODULE(FlashController) {
     uint64_t m_erase_commands;
     double m_total_flash_latency_ns;
     uint64_t m_channel_conflicts;
-    
-    // Random number generator for wear leveling
-    mutable std::mt19937 m_rng;
-    mutable std::uniform_int_distribution<uint32_t> m_block_dist;
+    uint64_t m_page_commands;             // Host page commands (> host commands when transfers span pages)
+    StatsGroup m_stats_group;
+    
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("commands", &m_total_flash_commands);
+        m_stats_group.counter("completed_commands", &m_completed_flash_commands);
+        m_stats_group.counter("read_commands", &m_read_commands);
+        m_stats_group.counter("write_commands", &m_write_commands);
+        m_stats_group.counter("erase_commands", &m_erase_commands);
+        m_stats_group.counter("gc_commands", &m_gc_flash_commands);
+        m_stats_group.counter("wear_leveling_relocations", &m_wear_leveling_relocations, "blocks");
+        m_stats_group.counter("channel_conflicts", &m_channel_conflicts);
+        m_stats_group.counter("page_commands", &m_page_commands);
+        m_stats_group.gauge("avg_latency", [this]() { return get_average_flash_latency_ns(); }, "ns");
+        
+        const FtlStats& ftl = m_ftl->get_stats();
+        m_stats_group.counter("ftl.host_writes", &ftl.host_writes, "pages");
+        m_stats_group.counter("ftl.gc_writes", &ftl.gc_writes, "pages");
+        m_stats_group.counter("ftl.unmapped_reads", &ftl.unmapped_reads);
+        m_stats_group.counter("ftl.gc_victims", &ftl.gc_invocations, "blocks");
+        m_stats_group.counter("ftl.block_erases", &ftl.block_erases, "blocks");
+        m_stats_group.gauge("ftl.write_amplification", [this]() { return get_write_amplification(); }, "ratio");
+        m_stats_group.gauge("ftl.free_blocks", [this]() { return static_cast<double>(m_ftl->get_free_blocks()); }, "blocks");
+        
+        for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
+            const ChannelState& channel = m_channels[ch];
+            std::string prefix = "channel" + std::to_string(ch) + ".";
+            m_stats_group.counter(prefix + "operations", &channel.total_operations);
+            m_stats_group.counter(prefix + "reads", &channel.read_operations);
+            m_stats_group.counter(prefix + "writes", &channel.write_operations);
+            m_stats_group.counter(prefix + "erases", &channel.erase_operations);
+            m_stats_group.counter(prefix + "multi_plane_operations", &channel.multi_plane_operations);
+            m_stats_group.gauge(prefix + "utilization", [this, ch]() { return get_channel_utilization(ch); }, "percent");
+        }
+    }
     
     // Main Flash Controller processes
     void command_reception_process() {
         while (true) {
             // Wait for command from DRAM Controller
-            auto packet = dram_in.read();
+            auto packet = SelfProfiler::read(dram_in);
             
             if (!packet) {
                 if (m_debug_enable) {
@@ -141,108 +237,178 @@ SC_MODULE(FlashController) {
             
             m_total_flash_commands++;
             
-            // Translate logical address to physical address
-            uint64_t logical_addr = packet->get_address();
-            uint64_t physical_addr = translate_address(logical_addr);
-            
             // Determine Flash operation type
-            FlashOperation operation = (packet->get_command() == Command::READ) ? 
+            FlashOperation operation = (packet->get_command() == Command::READ) ?
                                      FlashOperation::READ_PAGE : FlashOperation::PROGRAM_PAGE;
             
-            // Create Flash command
-            auto flash_cmd = std::make_shared<FlashControllerCommand>(packet, operation);
-            decode_physical_address(physical_addr, flash_cmd);
-            
-            if (m_debug_enable) {
-                std::cout << sc_time_stamp() << " | FlashController: Received " 
-                          << (operation == FlashOperation::READ_PAGE ? "READ" : "WRITE")
-                          << " command, Logical 0x" << std::hex << logical_addr 
-                          << " → Physical 0x" << physical_addr << std::dec
-                          << " (Ch" << flash_cmd->channel << "/Die" << flash_cmd->die 
-                          << "/Block" << flash_cmd->block << "/Page" << flash_cmd->page << ")" << std::endl;
+            // Split the transfer at flash page boundaries (most transfers fit one page)
+            const uint64_t page_bytes = m_config.page_size_kb * 1024ULL;
+            uint64_t transfer_start = static_cast<uint32_t>(packet->get_address());
+            uint64_t transfer_end = transfer_start + std::max<uint32_t>(1, packet_transfer_length(*packet));
+            uint64_t first_page = transfer_start / page_bytes;
+            uint32_t num_pages = static_cast<uint32_t>((transfer_end - 1) / page_bytes - first_page + 1);
+            if (num_pages > 1) {
+                SplitTransfer split = {num_pages, sc_time_stamp()};
+                m_split_transfers[packet.get()] = split;
             }
             
-            // Route command to appropriate channel
-            route_command_to_channel(flash_cmd);
-            
-            // Notify arbitration process
-            m_command_available.notify();
-        }
-    }
-    
-    void channel_arbitration_process() {
-        while (true) {
-            // Process commands for each channel
-            for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
-                ChannelState& channel = m_channels[ch];
-                
-                // Skip if channel is busy or no commands queued
-                if (channel.busy || channel.command_queue.empty()) {
-                    continue;
-                }
+            for (uint32_t i = 0; i < num_pages; i++) {
+                uint64_t logical_addr = (i == 0) ? transfer_start : (first_page + i) * page_bytes;
+                uint64_t chunk_end = std::min(transfer_end, (first_page + i + 1) * page_bytes);
                 
-                // Get next command from channel queue
-                auto flash_cmd = channel.command_queue.front();
-                channel.command_queue.pop();
+                // Translate logical address to physical address
+                uint64_t physical_addr = translate_address(logical_addr, operation);
                 
-                // Mark channel as busy
-                channel.busy = true;
-                flash_cmd->start_time = sc_time_stamp();
+                // Create Flash command
+                auto flash_cmd = std::make_shared<FlashControllerCommand>(packet, operation);
+                flash_cmd->transfer_bytes = static_cast<uint32_t>(chunk_end - logical_addr);
+                decode_physical_address(physical_addr, flash_cmd);
+                m_page_commands++;
                 
                 if (m_debug_enable) {
-                    std::cout << sc_time_stamp() << " | FlashController: Starting " 
-                              << get_operation_name(flash_cmd->operation) 
-                              << " on Channel " << ch << std::endl;
+                    std::cout << sc_time_stamp() << " | FlashController: Received " 
+                              << (operation == FlashOperation::READ_PAGE ? "READ" : "WRITE")
+                              << " command, Logical 0x" << std::hex << logical_addr 
+                              << " → Physical 0x" << physical_addr << std::dec
+                              << " (Ch" << flash_cmd->channel << "/Die" << flash_cmd->die 
+                              << "/Block" << flash_cmd->block << "/Page" << flash_cmd->page << ")";
+                    if (num_pages > 1) {
+                        std::cout << " [page " << (i + 1) << "/" << num_pages << "]";
+                    }
+                    std::cout << std::endl;
                 }
                 
-                // Send command to appropriate Flash device
-                send_command_to_flash(flash_cmd);
-                
-                // Update channel statistics
-                channel.total_operations++;
-                channel.last_operation_time = sc_time_stamp();
+                // Route command to appropriate channel
+                route_command_to_channel(flash_cmd);
                 
-                switch (flash_cmd->operation) {
-                    case FlashOperation::READ_PAGE:
-                        channel.read_operations++;
-                        m_read_commands++;
-                        break;
-                    case FlashOperation::PROGRAM_PAGE:
-                        channel.write_operations++;
-                        m_write_commands++;
-                        break;
-                    case FlashOperation::ERASE_BLOCK:
-                        channel.erase_operations++;
-                        m_erase_commands++;
-                        break;
-                    default:
-                        break;
+                // Notify arbitration process
+                m_command_available.notify();
+            }
+        }
+    }
+    
+    void channel_arbitration_process() {
+        while (true) {
+            bool dispatched = false;
+            
+            // Dispatch every command whose die is idle, across all channels
+            for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
+                while (dispatch_next_operation(ch)) {
+                    dispatched = true;
                 }
             }
             
-            // Wait for new commands to arrive
-            if (all_channels_idle()) {
-                wait(m_command_available);
+            // Wait for new commands or completions
+            if (!dispatched) {
+                SelfProfiler::wait(m_command_available);
+            }
+        }
+    }
+    
+    // Start the oldest queued command on an idle die of the channel, merged with
+    // queued commands for the other planes of that die (multi-plane operation)
+    bool dispatch_next_operation(uint32_t ch) {
+        ChannelState& channel = m_channels[ch];
+        if (!m_config.enable_interleaving && channel.is_busy()) {
+            return false;
+        }
+        
+        auto it = channel.command_queue.begin();
+        while (it != channel.command_queue.end() && channel.die_outstanding[(*it)->die] > 0) {
+            ++it;
+        }
+        if (it == channel.command_queue.end()) {
+            return false;
+        }
+        
+        std::vector<std::shared_ptr<FlashControllerCommand>> group(1, *it);
+        it = channel.command_queue.erase(it);
+        m_channel_space_freed.notify();
+        if (m_config.enable_multi_plane) {
+            uint32_t plane_mask = 1u << group.front()->plane;
+            while (it != channel.command_queue.end() && group.size() < m_config.planes_per_die) {
+                if (can_join_multi_plane(*group.front(), **it, plane_mask)) {
+                    plane_mask |= 1u << (*it)->plane;
+                    group.push_back(*it);
+                    it = channel.command_queue.erase(it);
+                } else {
+                    ++it;
+                }
             }
         }
+        
+        if (channel.busy_dies == 0) {
+            channel.busy_since = sc_time_stamp();
+        }
+        channel.busy_dies++;
+        channel.die_outstanding[group.front()->die] = static_cast<uint32_t>(group.size());
+        
+        if (m_debug_enable) {
+            std::cout << sc_time_stamp() << " | FlashController: Starting " 
+                      << get_operation_name(group.front()->operation) 
+                      << " on Channel " << ch << " Die " << group.front()->die
+                      << " (" << group.size() << " plane(s))" << std::endl;
+        }
+        
+        // Send command to appropriate Flash device
+        send_command_to_flash(group);
+        
+        // Update channel statistics
+        channel.total_operations += group.size();
+        channel.last_operation_time = sc_time_stamp();
+        if (group.size() > 1) {
+            channel.multi_plane_operations++;
+        }
+        
+        switch (group.front()->operation) {
+            case FlashOperation::READ_PAGE:
+                channel.read_operations += group.size();
+                m_read_commands += group.size();
+                break;
+            case FlashOperation::PROGRAM_PAGE:
+                channel.write_operations += group.size();
+                m_write_commands += group.size();
+                break;
+            case FlashOperation::ERASE_BLOCK:
+                channel.erase_operations += group.size();
+                m_erase_commands += group.size();
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+    
+    // Multi-plane rule: same die, same operation, same block and page, a plane not yet in the group
+    bool can_join_multi_plane(const FlashControllerCommand& first, const FlashControllerCommand& cmd,
+                              uint32_t plane_mask) const {
+        return cmd.die == first.die && cmd.operation == first.operation &&
+               cmd.block == first.block &&
+               (cmd.operation == FlashOperation::ERASE_BLOCK || cmd.page == first.page) &&
+               !(plane_mask & (1u << cmd.plane));
     }
     
     void completion_handling_process() {
+        // Completions may arrive on any channel
+        sc_event_or_list completion_events;
+        for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
+            completion_events |= flash_in[ch]->data_written_event();
+        }
+        
         while (true) {
-            // Check for completions from all Flash channels
+            bool handled = false;
             for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
-                if (flash_in[ch]->num_available() > 0) {
-                    auto flash_packet = flash_in[ch]->read();
-                    
+                while (flash_in[ch]->num_available() > 0) {
+                    auto flash_packet = SelfProfiler::read(*flash_in[ch]);
                     if (flash_packet) {
                         handle_flash_completion(flash_packet, ch);
                     }
+                    handled = true;
                 }
             }
             
-            // Wait for completions to arrive
-            if (no_completions_pending()) {
-                wait(m_completion_available);
+            if (!handled) {
+                SelfProfiler::wait(completion_events);
             }
         }
     }
@@ -253,64 +419,168 @@ SC_MODULE(FlashController) {
         }
         
         while (true) {
-            // Periodic wear leveling check (every 100ms simulation time)
-            wait(100000, SC_NS);
+            if (m_config.wear_leveling_interval_us > 0.0) {
+                // Firmware timer (explicitly configured)
+                SelfProfiler::wait(m_config.wear_leveling_interval_us, SC_US);
+            } else {
+                // The erase count spread can only grow when an erase raises the max
+                do {
+                    SelfProfiler::wait(m_block_erased);
+                } while (m_max_erase_count <= m_wear_checked_max);
+            }
+            m_wear_checked_max = m_max_erase_count;
             
-            // Find blocks with high erase counts
-            uint32_t max_erase_count = *std::max_element(m_erase_counts.begin(), m_erase_counts.end());
-            uint32_t min_erase_count = *std::min_element(m_erase_counts.begin(), m_erase_counts.end());
+            // Cheap test against the cached lower bound before scanning for the real minimum
+            if (m_max_erase_count - m_min_erase_count <= m_config.wear_leveling_threshold) {
+                continue;
+            }
+            m_min_erase_count = *std::min_element(m_erase_counts.begin(), m_erase_counts.end());
+            uint32_t max_erase_count = m_max_erase_count;
+            uint32_t min_erase_count = m_min_erase_count;
             
-            // Trigger wear leveling if difference is too high
-            if (max_erase_count - min_erase_count > 100) {
+            // Static wear leveling if difference is too high: the GC process relocates the
+            // coldest data block so it is erased and reused by hot writes
+            if (max_erase_count - min_erase_count > m_config.wear_leveling_threshold) {
                 if (m_debug_enable) {
                     std::cout << sc_time_stamp() << " | FlashController: Wear leveling triggered "
                               << "(Max: " << max_erase_count << ", Min: " << min_erase_count << ")" << std::endl;
                 }
-                
-                // Perform wear leveling (simplified)
-                perform_wear_leveling();
+                m_wear_leveling_requested = true;
+                m_gc_wakeup.notify();
             }
         }
     }
     
-    // Address translation and management
-    uint64_t translate_address(uint64_t logical_addr) {
-        // Simple direct mapping for now
-        // In real SSD, this would involve complex FTL (Flash Translation Layer)
-        auto it = m_logical_to_physical.find(logical_addr);
-        if (it != m_logical_to_physical.end()) {
-            return it->second;
+    // Garbage collection: while free FTL blocks are short, relocate the valid pages of
+    // a victim block (flash read, then program into the GC active block) and erase it.
+    // With free blocks to spare, a wear leveling request relocates a cold block the same way.
+    void garbage_collection_process() {
+        while (true) {
+            while (!m_ftl->needs_gc() && !m_wear_leveling_requested) {
+                SelfProfiler::wait(m_gc_wakeup);
+            }
+            
+            bool wear_leveling = !m_ftl->needs_gc();
+            int victim;
+            if (wear_leveling) {
+                m_wear_leveling_requested = false;
+                victim = m_ftl->select_wear_leveling_victim(m_config.wear_leveling_threshold);
+                if (victim < 0) {
+                    continue;   // The least-worn blocks are free; dynamic wear leveling opens them first
+                }
+                m_wear_leveling_relocations++;
+            } else {
+                victim = m_ftl->select_victim();
+                if (victim < 0) {
+                    // Nothing reclaimable until more pages are invalidated
+                    SelfProfiler::wait(m_gc_wakeup);
+                    continue;
+                }
+            }
+            
+            auto valid_pages = m_ftl->begin_collection(victim);
+            if (m_debug_enable) {
+                std::cout << sc_time_stamp() << " | FlashController: " << (wear_leveling ? "Wear leveling" : "GC")
+                          << " victim block " << victim
+                          << " (" << valid_pages.size() << " valid pages, "
+                          << m_ftl->get_free_blocks() << " free blocks)" << std::endl;
+            }
+            
+            m_gc_pending_copies = static_cast<uint32_t>(valid_pages.size());
+            for (const auto& page : valid_pages) {
+                auto read_cmd = std::make_shared<FlashControllerCommand>(nullptr, FlashOperation::READ_PAGE);
+                read_cmd->gc_lpn = page.first;
+                read_cmd->gc_source_ppn = page.second;
+                decode_physical_address(page.second, read_cmd);
+                enqueue_internal_command(read_cmd);
+            }
+            while (m_gc_pending_copies > 0) {
+                SelfProfiler::wait(m_gc_progress);
+            }
+            
+            // Erase the victim's block on every channel, die and plane
+            m_gc_pending_erases = m_config.num_channels * m_config.dies_per_channel * m_config.planes_per_die;
+            uint64_t first_page = static_cast<uint64_t>(victim) * m_config.pages_per_ftl_block();
+            for (uint32_t i = 0; i < m_gc_pending_erases; i++) {
+                auto erase_cmd = std::make_shared<FlashControllerCommand>(nullptr, FlashOperation::ERASE_BLOCK);
+                decode_physical_address(first_page + i, erase_cmd);
+                enqueue_internal_command(erase_cmd);
+            }
+            while (m_gc_pending_erases > 0) {
+                SelfProfiler::wait(m_gc_progress);
+            }
+            
+            m_ftl->erase_block(victim);
+            m_block_freed.notify();
         }
+    }
+    
+    // Address translation and management: reads look up the L2P table, writes are
+    // mapped out of place and stall while GC reclaims a block
+    uint64_t translate_address(uint64_t logical_addr, FlashOperation operation) {
+        uint32_t lpn = static_cast<uint32_t>(logical_addr / (m_config.page_size_kb * 1024ULL));
         
-        // Allocate new physical address
-        uint64_t physical_addr = allocate_physical_address();
-        m_logical_to_physical[logical_addr] = physical_addr;
+        if (operation == FlashOperation::READ_PAGE) {
+            uint32_t ppn = m_ftl->lookup(lpn);
+            // A never-written page is read at its direct-mapped location (erased data)
+            return (ppn != PageMappedFtl::UNMAPPED) ? ppn : (lpn % m_ftl->get_logical_pages());
+        }
         
+        while (!m_ftl->can_write()) {
+            m_gc_wakeup.notify();
+            SelfProfiler::wait(m_block_freed);
+        }
+        uint64_t physical_addr = m_ftl->write(lpn);
+        if (m_ftl->needs_gc()) {
+            m_gc_wakeup.notify();
+        }
         return physical_addr;
     }
     
-    uint64_t allocate_physical_address() {
-        // Simple round-robin allocation across channels
-        static uint64_t next_addr = 0;
-        return next_addr++;
+    // GC commands bypass the host queue limit so relocations cannot deadlock behind host traffic
+    void enqueue_internal_command(std::shared_ptr<FlashControllerCommand> cmd) {
+        m_channels[cmd->channel].command_queue.push_back(cmd);
+        m_command_available.notify();
     }
     
     void decode_physical_address(uint64_t physical_addr, std::shared_ptr<FlashControllerCommand> cmd) {
-        // Extract channel, die, block, page from physical address
-        // Address format: [Channel][Die][Block][Page]
-        uint32_t pages_per_die = m_config.blocks_per_die * m_config.pages_per_block;
-        uint32_t pages_per_channel = pages_per_die * m_config.dies_per_channel;
+        decode_physical_address(physical_addr, *cmd);
+    }
+    
+    void decode_physical_address(uint64_t physical_addr, FlashControllerCommand& cmd) {
+        // Extract channel, die, plane, page, block from physical address
+        // Address format: [Block][Page][Plane][Die][Channel], channel in the lowest digit,
+        // so consecutive pages stripe across channels, then dies, then planes of one page
+        uint64_t addr = physical_addr;
+        
+        cmd.channel = addr % m_config.num_channels;
+        addr /= m_config.num_channels;
         
-        cmd->channel = (physical_addr / pages_per_channel) % m_config.num_channels;
-        uint64_t addr_in_channel = physical_addr % pages_per_channel;
+        cmd.die = addr % m_config.dies_per_channel;
+        addr /= m_config.dies_per_channel;
         
-        cmd->die = addr_in_channel / pages_per_die;
-        uint64_t addr_in_die = addr_in_channel % pages_per_die;
+        cmd.plane = addr % m_config.planes_per_die;
+        addr /= m_config.planes_per_die;
         
-        cmd->block = addr_in_die / m_config.pages_per_block;
-        cmd->page = addr_in_die % m_config.pages_per_block;
+        cmd.page = addr % m_config.pages_per_block;
+        addr /= m_config.pages_per_block;
         
-        cmd->physical_address = physical_addr;
+        cmd.block = addr % m_config.blocks_per_plane();
+        
+        cmd.physical_address = physical_addr;
+    }
+    
+    // NAND address of a command; the page within the block maps to wordline / string
+    // select line / page as in NANDFlash (4 SSLs x 32 pages per WL)
+    static FlashAddress flash_address_of(const FlashControllerCommand& cmd) {
+        FlashAddress address;
+        address.die = static_cast<uint8_t>(cmd.die);
+        address.plane = static_cast<uint8_t>(cmd.plane);
+        address.block = static_cast<uint16_t>(cmd.block);
+        address.page = static_cast<uint16_t>(cmd.page % 32);
+        address.ssl = static_cast<uint8_t>((cmd.page / 32) % 4);
+        address.wl = static_cast<uint8_t>(cmd.page / 128);
+        return address;
     }
     
     void route_command_to_channel(std::shared_ptr<FlashControllerCommand> cmd) {
@@ -324,27 +594,40 @@ SC_MODULE(FlashController) {
                           << cmd->channel << " queue full, waiting..." << std::endl;
             }
             
-            // Wait for space in channel queue
+            // Wait until arbitration dispatches from a channel queue
             while (channel.command_queue.size() >= m_config.command_queue_depth) {
-                wait(10, SC_NS);
+                SelfProfiler::wait(m_channel_space_freed);
             }
         }
         
         // Add command to channel queue
-        channel.command_queue.push(cmd);
+        channel.command_queue.push_back(cmd);
+    }
+    
+    // Send one operation to the channel's NAND device; further planes ride on the first packet
+    void send_command_to_flash(const std::vector<std::shared_ptr<FlashControllerCommand>>& group) {
+        auto flash_packet = create_flash_packet(group.front());
+        for (size_t i = 1; i < group.size(); i++) {
+            flash_packet->plane_group.push_back(create_flash_packet(group[i]));
+        }
+        
+        // Send to appropriate Flash device
+        SelfProfiler::write(*flash_out[group.front()->channel], flash_packet);
     }
     
-    void send_command_to_flash(std::shared_ptr<FlashControllerCommand> cmd) {
+    std::shared_ptr<FlashPacket> create_flash_packet(std::shared_ptr<FlashControllerCommand> cmd) {
         // Create Flash packet
-        auto flash_packet = std::make_shared<FlashPacket>();
-        flash_packet->set_databyte(cmd->original_packet->get_databyte());
+        auto flash_packet = PacketPool<FlashPacket>::acquire();
+        if (cmd->is_internal()) {
+            flash_packet->set_data_size(m_config.page_size_kb * 1024);  // GC moves whole pages
+        } else {
+            flash_packet->set_data_size(cmd->transfer_bytes);
+            flash_packet->original_packet = cmd->original_packet;
+            flash_packet->index = cmd->original_packet->get_index();
+        }
         
         // Set Flash-specific address fields
-        flash_packet->flash_address.plane = static_cast<uint8_t>(cmd->plane);
-        flash_packet->flash_address.block = static_cast<uint16_t>(cmd->block);
-        flash_packet->flash_address.page = static_cast<uint16_t>(cmd->page);
-        flash_packet->flash_address.wl = 0;  // Default wordline
-        flash_packet->flash_address.ssl = 0; // Default string select line
+        flash_packet->flash_address = flash_address_of(*cmd);
         
         // Determine Flash command type
         switch (cmd->operation) {
@@ -362,70 +645,143 @@ SC_MODULE(FlashController) {
                 break;
         }
         
-        // Send to appropriate Flash device
-        flash_out[cmd->channel]->write(flash_packet);
+        cmd->start_time = sc_time_stamp();
+        m_in_flight[flash_packet.get()] = cmd;
+        return flash_packet;
     }
     
     void handle_flash_completion(std::shared_ptr<FlashPacket> flash_packet, uint32_t channel) {
-        // Mark channel as not busy
-        m_channels[channel].busy = false;
+        auto it = m_in_flight.find(flash_packet.get());
+        if (it == m_in_flight.end()) {
+            SOC_SIM_WARNING("FlashController", soc_sim::error::codes::INVALID_PACKET_TYPE,
+                           "Completion for unknown flash packet on channel " + std::to_string(channel));
+            return;
+        }
+        std::shared_ptr<FlashControllerCommand> cmd = it->second;
+        m_in_flight.erase(it);
+        
+        // Free the die once every plane of its operation is back
+        ChannelState& channel_state = m_channels[channel];
+        if (--channel_state.die_outstanding[cmd->die] == 0) {
+            channel_state.busy_dies--;
+            if (channel_state.busy_dies == 0) {
+                channel_state.busy_time += sc_time_stamp() - channel_state.busy_since;
+            }
+        }
+        
+        cmd->completion_time = sc_time_stamp();
+        cmd->completed = true;
+        
+        // Notify arbitration about the available die
+        m_command_available.notify();
+        
+        if (cmd->is_internal()) {
+            handle_gc_completion(cmd);
+            return;
+        }
+        
+        // A split transfer completes with its last page
+        sc_time submit_time = cmd->submit_time;
+        auto split = m_split_transfers.find(cmd->original_packet.get());
+        if (split != m_split_transfers.end()) {
+            if (--split->second.remaining_pages > 0) {
+                return;
+            }
+            submit_time = split->second.submit_time;
+            m_split_transfers.erase(split);
+        }
         
         // Calculate latency
-        sc_time completion_time = sc_time_stamp();
-        // Note: We'd need to track the original command to calculate accurate latency
+        m_total_flash_latency_ns += (cmd->completion_time - submit_time).to_seconds() * 1e9;
         
         if (m_debug_enable) {
             std::cout << sc_time_stamp() << " | FlashController: Flash operation completed on Channel " 
-                      << channel << std::endl;
+                      << channel << " Die " << cmd->die << " Plane " << cmd->plane << std::endl;
         }
         
-        // Convert back to original packet format and send to DRAM Controller
-        auto response_packet = std::static_pointer_cast<PacketType>(flash_packet);
-        dram_out.write(response_packet);
+        // Send the original packet back to DRAM Controller
+        auto response_packet = std::static_pointer_cast<PacketType>(cmd->original_packet);
+        SelfProfiler::write(dram_out, response_packet);
         
         m_completed_flash_commands++;
-        
-        // Notify completion handler and arbitration about available channel
-        m_completion_available.notify();
-        m_command_available.notify();
     }
     
-    void perform_wear_leveling() {
-        // Simplified wear leveling: swap data between high and low wear blocks
-        // Real implementation would be much more complex
-        
-        if (m_debug_enable) {
-            std::cout << sc_time_stamp() << " | FlashController: Performing wear leveling..." << std::endl;
-        }
-        
-        // Find high and low wear blocks
-        auto max_it = std::max_element(m_erase_counts.begin(), m_erase_counts.end());
-        auto min_it = std::min_element(m_erase_counts.begin(), m_erase_counts.end());
-        
-        // Swap erase counts (simplified)
-        if (max_it != m_erase_counts.end() && min_it != m_erase_counts.end()) {
-            std::swap(*max_it, *min_it);
+    void handle_gc_completion(std::shared_ptr<FlashControllerCommand> cmd) {
+        m_gc_flash_commands++;
+        switch (cmd->operation) {
+            case FlashOperation::READ_PAGE: {
+                // Program the relocated page unless the host rewrote it meanwhile
+                uint32_t new_ppn = m_ftl->relocate(cmd->gc_lpn, cmd->gc_source_ppn);
+                if (new_ppn == PageMappedFtl::UNMAPPED) {
+                    m_gc_pending_copies--;
+                    m_gc_progress.notify();
+                    break;
+                }
+                auto program_cmd = std::make_shared<FlashControllerCommand>(nullptr, FlashOperation::PROGRAM_PAGE);
+                decode_physical_address(new_ppn, program_cmd);
+                enqueue_internal_command(program_cmd);
+                break;
+            }
+            case FlashOperation::PROGRAM_PAGE:
+                m_gc_pending_copies--;
+                m_gc_progress.notify();
+                break;
+            case FlashOperation::ERASE_BLOCK: {
+                if (count_erase(*cmd)) {
+                    m_block_erased.notify();
+                }
+                m_gc_pending_erases--;
+                m_gc_progress.notify();
+                break;
+            }
+            default:
+                break;
         }
     }
     
-    bool all_channels_idle() const {
-        for (const auto& channel : m_channels) {
-            if (!channel.command_queue.empty() || channel.busy) {
-                return false;
-            }
+    // Per-block wear count of an erased (channel, die, plane, block)
+    bool count_erase(const FlashControllerCommand& cmd) {
+        uint32_t block_index = (cmd.channel * m_config.dies_per_channel + cmd.die) * m_config.blocks_per_die +
+                               cmd.plane * m_config.blocks_per_plane() + cmd.block;
+        if (block_index >= m_erase_counts.size()) {
+            return false;
         }
+        m_max_erase_count = std::max(m_max_erase_count, ++m_erase_counts[block_index]);
         return true;
     }
     
-    bool no_completions_pending() const {
-        for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
-            if (flash_in[ch]->num_available() > 0) {
-                return false;
-            }
+    // Fast-forward: one garbage collection pass done in place - the victim's valid pages
+    // are relocated and its block erased on every channel, die and plane
+    bool fast_forward_collect() {
+        int victim = m_ftl->select_victim();
+        if (victim < 0) {
+            return false;
+        }
+        for (const auto& page : m_ftl->begin_collection(victim)) {
+            fast_forward_flash(FlashOperation::PROGRAM_PAGE, m_ftl->relocate(page.first, page.second));
         }
+        uint32_t erase_units = m_config.num_channels * m_config.dies_per_channel * m_config.planes_per_die;
+        uint64_t first_page = static_cast<uint64_t>(victim) * m_config.pages_per_ftl_block();
+        for (uint32_t i = 0; i < erase_units; i++) {
+            fast_forward_flash(FlashOperation::ERASE_BLOCK, first_page + i);
+        }
+        m_ftl->erase_block(victim);
         return true;
     }
     
+    void fast_forward_flash(FlashOperation operation, uint64_t physical_addr) {
+        FlashControllerCommand cmd(nullptr, operation);
+        decode_physical_address(physical_addr, cmd);
+        if (operation == FlashOperation::ERASE_BLOCK) {
+            count_erase(cmd);
+        }
+        if (m_functional_flash) {
+            m_functional_flash(cmd.channel,
+                               (operation == FlashOperation::ERASE_BLOCK) ? FlashCommand::ERASE : FlashCommand::PROGRAM,
+                               flash_address_of(cmd));
+        }
+    }
+    
     std::string get_operation_name(FlashOperation op) const {
         switch (op) {
             case FlashOperation::READ_PAGE: return "READ";
@@ -443,22 +799,35 @@ SC_MODULE(FlashController) {
             JsonConfig config(m_config_file);
             
             // Load Flash Controller configuration
-            m_config.num_channels = 1; // Force to 1 channel for now
-            m_config.dies_per_channel = config.get_int("ssd.flash.dies_per_channel", 4);
+            m_config.num_channels = std::max(1, config.get_int("ssd.flash.num_channels", 8));
+            m_config.dies_per_channel = std::max(1, config.get_int("ssd.flash.dies_per_channel", 4));
+            m_config.planes_per_die = std::max(1, config.get_int("ssd.flash.planes_per_die", 4));
             m_config.command_queue_depth = config.get_int("ssd.flash.command_queue_depth", 16);
             m_config.page_size_kb = config.get_int("ssd.flash.page_size_kb", 16);
             m_config.pages_per_block = config.get_int("ssd.flash.pages_per_block", 128);
-            m_config.blocks_per_die = config.get_int("ssd.flash.blocks_per_die", 1024);
+            m_config.blocks_per_die = config.get_int("ssd.flash.blocks_per_die",
+                                                     m_config.planes_per_die * config.get_int("ssd.flash.blocks_per_plane", 1024));
             m_config.channel_bandwidth_mbps = config.get_double("ssd.flash.channel_bandwidth_mbps", 400.0);
             m_config.enable_interleaving = config.get_bool("ssd.flash.enable_interleaving", true);
+            m_config.enable_multi_plane = config.get_bool("ssd.flash.enable_multi_plane", true);
             m_config.enable_wear_leveling = config.get_bool("ssd.flash.enable_wear_leveling", true);
+            m_config.wear_leveling_threshold = config.get_int("ssd.flash.wear_leveling_threshold", 100);
+            m_config.wear_leveling_interval_us = config.get_double("ssd.flash.wear_leveling_interval_us", 0.0);
             m_config.ecc_type = config.get_string("ssd.flash.ecc_type", "LDPC");
+            m_config.over_provisioning = config.get_double("ssd.flash.ftl.over_provisioning", 0.07);
+            m_config.gc_policy = parse_gc_policy(config.get_string("ssd.flash.ftl.gc_policy",
+                                                                   config.get_string("ssd.controller.gc_algorithm", "GREEDY")));
+            m_config.gc_threshold_blocks = config.get_int("ssd.flash.ftl.gc_threshold_blocks", 2);
             
             if (m_debug_enable) {
                 std::cout << "Flash Controller Configuration loaded:" << std::endl;
                 std::cout << "  Channels: " << m_config.num_channels << std::endl;
                 std::cout << "  Dies per Channel: " << m_config.dies_per_channel << std::endl;
+                std::cout << "  Planes per Die: " << m_config.planes_per_die
+                          << (m_config.enable_multi_plane ? " (multi-plane)" : "") << std::endl;
                 std::cout << "  ECC Type: " << m_config.ecc_type << std::endl;
+                std::cout << "  FTL: " << gc_policy_name(m_config.gc_policy) << " GC, "
+                          << (m_config.over_provisioning * 100.0) << "% over-provisioning" << std::endl;
                 std::cout << "  Wear Leveling: " << (m_config.enable_wear_leveling ? "Enabled" : "Disabled") << std::endl;
             }
             
@@ -476,6 +845,14 @@ SC_MODULE(FlashController) {
         : sc_module(name),
           m_debug_enable(debug_enable),
           m_config_file(config_file),
+          m_max_erase_count(0),
+          m_min_erase_count(0),
+          m_wear_checked_max(0),
+          m_wear_leveling_requested(false),
+          m_wear_leveling_relocations(0),
+          m_gc_pending_copies(0),
+          m_gc_pending_erases(0),
+          m_gc_flash_commands(0),
           m_total_flash_commands(0),
           m_completed_flash_commands(0),
           m_read_commands(0),
@@ -483,20 +860,27 @@ SC_MODULE(FlashController) {
           m_erase_commands(0),
           m_total_flash_latency_ns(0.0),
           m_channel_conflicts(0),
-          m_rng(std::random_device{}()) {
+          m_page_commands(0) {
         
         // Load configuration
         load_configuration();
         
         // Initialize channels
         m_channels.resize(m_config.num_channels);
+        for (auto& channel : m_channels) {
+            channel.die_outstanding.assign(m_config.dies_per_channel, 0);
+        }
         flash_out.resize(m_config.num_channels);
         flash_in.resize(m_config.num_channels);
         
+        // FTL over the whole geometry; its blocks span every channel, die and plane
+        m_ftl.reset(new PageMappedFtl(m_config.blocks_per_plane(), m_config.pages_per_ftl_block(),
+                                      m_config.over_provisioning, m_config.gc_policy,
+                                      m_config.gc_threshold_blocks));
+        
         // Initialize erase counts
         uint32_t total_blocks = m_config.num_channels * m_config.dies_per_channel * m_config.blocks_per_die;
         m_erase_counts.resize(total_blocks, 0);
-        m_block_dist = std::uniform_int_distribution<uint32_t>(0, total_blocks - 1);
         
         // Create FIFO connections for each channel
         for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
@@ -511,10 +895,13 @@ SC_MODULE(FlashController) {
                       << ", ECC: " << m_config.ecc_type << ")" << std::endl;
         }
         
+        register_stats();
+        
         // Start controller processes
         SC_THREAD(command_reception_process);
         SC_THREAD(channel_arbitration_process);
         SC_THREAD(completion_handling_process);
+        SC_THREAD(garbage_collection_process);
         SC_THREAD(wear_leveling_process);
     }
     
@@ -537,15 +924,77 @@ public:
     uint64_t get_write_commands() const { return m_write_commands; }
     uint64_t get_erase_commands() const { return m_erase_commands; }
     uint64_t get_channel_conflicts() const { return m_channel_conflicts; }
+    uint64_t get_gc_flash_commands() const { return m_gc_flash_commands; }
+    uint64_t get_wear_leveling_relocations() const { return m_wear_leveling_relocations; }
+    const PageMappedFtl& get_ftl() const { return *m_ftl; }
+    
+    // NAND side of fast-forward; set before the simulation starts
+    void set_functional_flash_port(const FunctionalFlashPort& port) { m_functional_flash = port; }
+    
+    // Fast-forward (untimed warm-up) host access, split at flash pages like the timed path:
+    // writes are mapped out of place with garbage collection run inline, NAND page states
+    // follow through the functional flash port. Reads leave no state. Nothing waits and no
+    // controller statistics are counted. False when a write found no reclaimable block.
+    bool fast_forward_access(uint64_t address, uint32_t length, bool is_write) {
+        if (!is_write) {
+            return true;
+        }
+        const uint64_t page_bytes = m_config.page_size_kb * 1024ULL;
+        uint64_t first_page = address / page_bytes;
+        uint64_t last_page = (address + std::max<uint32_t>(1, length) - 1) / page_bytes;
+        for (uint64_t lpn = first_page; lpn <= last_page; lpn++) {
+            while (!m_ftl->can_write()) {
+                if (!fast_forward_collect()) {
+                    return false;
+                }
+            }
+            fast_forward_flash(FlashOperation::PROGRAM_PAGE, m_ftl->write(static_cast<uint32_t>(lpn)));
+            while (m_ftl->needs_gc() && fast_forward_collect()) {
+            }
+        }
+        return true;
+    }
+    
+    // FTL statistics of the warm-up become the baseline of the measured run
+    void end_fast_forward() {
+        m_ftl->rebase_stats();
+        m_min_erase_count = m_erase_counts.empty() ? 0 : *std::min_element(m_erase_counts.begin(), m_erase_counts.end());
+    }
+    
+    // Checkpoint: FTL tables and wear-leveling erase counts
+    void save_checkpoint(CheckpointWriter& writer) const {
+        writer.begin_section(name());
+        m_ftl->save(writer);
+        writer.write_vector(m_erase_counts);
+        writer.write(m_max_erase_count);
+        writer.end_section();
+    }
+    
+    bool restore_checkpoint(CheckpointReader& reader) {
+        if (!reader.begin_section(name()) || !m_ftl->restore(reader) ||
+            !reader.read_vector(m_erase_counts, m_erase_counts.size()) || !reader.read(m_max_erase_count)) {
+            return false;
+        }
+        m_min_erase_count = m_erase_counts.empty() ? 0 : *std::min_element(m_erase_counts.begin(), m_erase_counts.end());
+        m_wear_checked_max = m_max_erase_count;
+        return true;
+    }
+    double get_write_amplification() const { return m_ftl->get_stats().get_write_amplification(); }
     
     double get_average_flash_latency_ns() const {
         return (m_completed_flash_commands > 0) ? (m_total_flash_latency_ns / m_completed_flash_commands) : 0.0;
     }
     
+    // Percentage of simulated time with at least one die of the channel busy
     double get_channel_utilization(uint32_t channel) const {
         if (channel >= m_config.num_channels) return 0.0;
         const ChannelState& ch = m_channels[channel];
-        return ch.busy ? 100.0 : 0.0; // Simplified utilization
+        sc_time busy = ch.busy_time;
+        if (ch.is_busy()) {
+            busy += sc_time_stamp() - ch.busy_since;
+        }
+        double elapsed = sc_time_stamp().to_seconds();
+        return (elapsed > 0.0) ? 100.0 * busy.to_seconds() / elapsed : 0.0;
     }
     
     // Configuration access
@@ -556,30 +1005,6 @@ public:
         static ChannelState empty_state;
         return (channel < m_config.num_channels) ? m_channels[channel] : empty_state;
     }
-    
-    // Performance metrics
-    void print_statistics() const {
-        std::cout << "\n======== Flash Controller Statistics ========" << std::endl;
-        std::cout << "Total Flash Commands: " << m_total_flash_commands << std::endl;
-        std::cout << "Completed Flash Commands: " << m_completed_flash_commands << std::endl;
-        std::cout << "Read Commands: " << m_read_commands << std::endl;
-        std::cout << "Write Commands: " << m_write_commands << std::endl;
-        std::cout << "Erase Commands: " << m_erase_commands << std::endl;
-        std::cout << "Channel Conflicts: " << m_channel_conflicts << std::endl;
-        std::cout << "Average Flash Latency: " << std::fixed << std::setprecision(1) 
-                  << get_average_flash_latency_ns() << " ns" << std::endl;
-        
-        std::cout << "\nChannel Statistics:" << std::endl;
-        for (uint32_t ch = 0; ch < m_config.num_channels; ch++) {
-            const ChannelState& channel = m_channels[ch];
-            std::cout << "  Channel " << ch << ": " 
-                      << channel.total_operations << " ops "
-                      << "(R:" << channel.read_operations 
-                      << " W:" << channel.write_operations 
-                      << " E:" << channel.erase_operations << ")" << std::endl;
-        }
-        std::cout << "=============================================" << std::endl;
-    }
 };
 
 // Type aliases for common configurations
@@ -0,0 +1,358 @@
+#ifndef PAGE_FTL_H
+#define PAGE_FTL_H
+
+/*
+ * MOON-SIM: Modular Object-Oriented Network Simulator
+ * Page-mapped FTL - dense L2P table, greedy / cost-benefit garbage collection
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <stdexcept>
+#include "common/checkpoint.h"
+
+// Victim selection for garbage collection
+enum class GcPolicy {
+    GREEDY,        // Fewest valid pages
+    COST_BENEFIT   // Highest (1 - u) * age / (2u), u = valid ratio (Kawaguchi et al.)
+};
+
+inline GcPolicy parse_gc_policy(const std::string& policy_str) {
+    if (policy_str == "COST_BENEFIT" || policy_str == "cost_benefit") return GcPolicy::COST_BENEFIT;
+    return GcPolicy::GREEDY;
+}
+
+inline const char* gc_policy_name(GcPolicy policy) {
+    return (policy == GcPolicy::COST_BENEFIT) ? "COST_BENEFIT" : "GREEDY";
+}
+
+// FTL statistics
+struct FtlStats {
+    uint64_t host_writes;      // Pages programmed for the host
+    uint64_t gc_writes;        // Valid pages relocated by GC
+    uint64_t host_reads;
+    uint64_t unmapped_reads;   // Reads of never-written logical pages
+    uint64_t gc_invocations;   // Victim blocks collected
+    uint64_t block_erases;
+
+    FtlStats() : host_writes(0), gc_writes(0), host_reads(0), unmapped_reads(0),
+                 gc_invocations(0), block_erases(0) {}
+
+    double get_write_amplification() const {
+        return (host_writes > 0) ? static_cast<double>(host_writes + gc_writes) / host_writes : 0.0;
+    }
+    
+    FtlStats& operator+=(const FtlStats& other) {
+        host_writes += other.host_writes;
+        gc_writes += other.gc_writes;
+        host_reads += other.host_reads;
+        unmapped_reads += other.unmapped_reads;
+        gc_invocations += other.gc_invocations;
+        block_erases += other.block_erases;
+        return *this;
+    }
+};
+
+// Page-level flash translation layer.
+// Physical pages are numbered ppn = block * pages_per_block + page, where a block is the
+// FTL's erase unit (one physical block on every channel/die/plane when the controller
+// stripes pages across them). The L2P and P2L tables are flat arrays sized from the
+// geometry; a fraction over_provisioning of the physical pages is hidden from the host.
+// Host and GC writes fill separate active blocks. Host writes never open one of the last
+// GC_RESERVE_BLOCKS free blocks, so a collection (or a wear-leveling relocation) can always
+// open a GC active block: it relocates at most one block of pages and frees its victim.
+class PageMappedFtl {
+public:
+    static const uint32_t UNMAPPED = 0xFFFFFFFF;
+    static const uint32_t GC_RESERVE_BLOCKS = 1;
+
+    PageMappedFtl(uint32_t num_blocks, uint32_t pages_per_block, double over_provisioning,
+                  GcPolicy gc_policy = GcPolicy::GREEDY, uint32_t gc_threshold_blocks = 2)
+        : m_num_blocks(std::max<uint32_t>(num_blocks, 3)),
+          m_pages_per_block(std::max<uint32_t>(pages_per_block, 1)),
+          m_gc_policy(gc_policy),
+          m_gc_threshold(std::max<uint32_t>(gc_threshold_blocks, GC_RESERVE_BLOCKS + 1)),
+          m_blocks(m_num_blocks),
+          m_host_block(-1),
+          m_gc_block(-1),
+          m_write_sequence(0) {
+        uint64_t physical_pages = static_cast<uint64_t>(m_num_blocks) * m_pages_per_block;
+        double op = std::min(std::max(over_provisioning, 0.0), 0.5);
+        // At least the GC reserve plus the two active blocks stays hidden from the host
+        uint64_t reserved = std::max<uint64_t>(static_cast<uint64_t>(physical_pages * op),
+                                               static_cast<uint64_t>(m_gc_threshold + 2) * m_pages_per_block);
+        m_logical_pages = static_cast<uint32_t>(physical_pages - std::min(reserved, physical_pages - 1));
+        m_l2p.assign(m_logical_pages, static_cast<uint32_t>(UNMAPPED));  // By value: no out-of-line definition
+        m_p2l.assign(physical_pages, static_cast<uint32_t>(UNMAPPED));
+        for (uint32_t block = 0; block < m_num_blocks; ++block) {
+            m_free_blocks.push_back(block);
+        }
+    }
+
+    uint32_t get_num_blocks() const { return m_num_blocks; }
+    uint32_t get_pages_per_block() const { return m_pages_per_block; }
+    uint32_t get_logical_pages() const { return m_logical_pages; }
+    uint64_t get_physical_pages() const { return m_p2l.size(); }
+    GcPolicy get_gc_policy() const { return m_gc_policy; }
+    uint32_t get_free_blocks() const { return static_cast<uint32_t>(m_free_blocks.size()); }
+    uint32_t get_valid_pages(uint32_t block) const { return m_blocks[block].valid_pages; }
+    uint32_t get_erase_count(uint32_t block) const { return m_blocks[block].erase_count; }
+    const FtlStats& get_stats() const { return m_stats; }
+    const FtlStats& get_baseline_stats() const { return m_baseline_stats; }
+    
+    // Statistics so far become part of the baseline (end of a fast-forward warm-up)
+    void rebase_stats() {
+        m_baseline_stats += m_stats;
+        m_stats = FtlStats();
+    }
+
+    // Physical page of a logical page, or UNMAPPED
+    uint32_t lookup(uint32_t lpn) {
+        m_stats.host_reads++;
+        uint32_t ppn = m_l2p[lpn % m_logical_pages];
+        if (ppn == UNMAPPED) {
+            m_stats.unmapped_reads++;
+        }
+        return ppn;
+    }
+
+    // Host writes stall rather than open a block below the GC threshold;
+    // the reserved free blocks are always left to GC relocations
+    bool can_write() const {
+        return has_room(m_host_block) ||
+               (m_free_blocks.size() >= m_gc_threshold && m_free_blocks.size() > GC_RESERVE_BLOCKS);
+    }
+
+    bool needs_gc() const { return m_free_blocks.size() < m_gc_threshold; }
+
+    // Out-of-place update: map lpn to the next page of the host (or GC) active block
+    // and invalidate the old copy. Returns the new physical page.
+    uint32_t write(uint32_t lpn, bool gc_relocation = false) {
+        lpn %= m_logical_pages;
+        int& active = gc_relocation ? m_gc_block : m_host_block;
+        if (!has_room(active)) {
+            active = take_free_block();
+        }
+        Block& block = m_blocks[active];
+        uint32_t ppn = static_cast<uint32_t>(active) * m_pages_per_block + block.write_pointer++;
+        block.valid_pages++;
+        block.last_write = ++m_write_sequence;
+
+        invalidate(lpn);
+        m_l2p[lpn] = ppn;
+        m_p2l[ppn] = lpn;
+        if (gc_relocation) {
+            m_stats.gc_writes++;
+        } else {
+            m_stats.host_writes++;
+        }
+        return ppn;
+    }
+
+    // Pick a full, non-active block to collect; -1 when none has any invalid page
+    int select_victim() const {
+        int victim = -1;
+        double best_score = 0.0;
+        for (uint32_t i = 0; i < m_num_blocks; ++i) {
+            const Block& block = m_blocks[i];
+            if (static_cast<int>(i) == m_host_block || static_cast<int>(i) == m_gc_block ||
+                block.collecting || block.write_pointer < m_pages_per_block ||
+                block.valid_pages == m_pages_per_block) {
+                continue;
+            }
+            double score;
+            if (m_gc_policy == GcPolicy::COST_BENEFIT) {
+                double u = static_cast<double>(block.valid_pages) / m_pages_per_block;
+                double age = static_cast<double>(m_write_sequence - block.last_write + 1);
+                score = (u == 0.0) ? 1e300 : (1.0 - u) * age / (2.0 * u);
+            } else {
+                score = static_cast<double>(m_pages_per_block - block.valid_pages);
+            }
+            if (victim == -1 || score > best_score) {
+                victim = static_cast<int>(i);
+                best_score = score;
+            }
+        }
+        return victim;
+    }
+
+    // Static wear leveling: the least-erased full block holding data, when its erase count
+    // trails the most-erased block by more than threshold; -1 otherwise. Relocating it
+    // (begin_collection .. erase_block) puts the cold block back into the free pool, where
+    // take_free_block hands it to the next hot writes.
+    int select_wear_leveling_victim(uint32_t threshold) const {
+        int victim = -1;
+        uint32_t max_erase_count = 0;
+        for (uint32_t i = 0; i < m_num_blocks; ++i) {
+            const Block& block = m_blocks[i];
+            max_erase_count = std::max(max_erase_count, block.erase_count);
+            if (static_cast<int>(i) == m_host_block || static_cast<int>(i) == m_gc_block ||
+                block.collecting || block.write_pointer < m_pages_per_block || block.valid_pages == 0) {
+                continue;
+            }
+            if (victim == -1 || block.erase_count < m_blocks[victim].erase_count) {
+                victim = static_cast<int>(i);
+            }
+        }
+        if (victim >= 0 && max_erase_count - m_blocks[victim].erase_count <= threshold) {
+            return -1;
+        }
+        return victim;
+    }
+
+    // Start collecting a victim: returns its still-valid (lpn, ppn) pairs to relocate
+    std::vector<std::pair<uint32_t, uint32_t>> begin_collection(uint32_t block) {
+        m_blocks[block].collecting = true;
+        m_stats.gc_invocations++;
+        std::vector<std::pair<uint32_t, uint32_t>> valid;
+        uint32_t first = block * m_pages_per_block;
+        for (uint32_t ppn = first; ppn < first + m_pages_per_block; ++ppn) {
+            uint32_t lpn = m_p2l[ppn];
+            if (lpn != UNMAPPED && m_l2p[lpn] == ppn) {
+                valid.push_back(std::make_pair(lpn, ppn));
+            }
+        }
+        return valid;
+    }
+
+    // Relocate one page of a victim unless the host rewrote it meanwhile.
+    // Returns the new physical page, or UNMAPPED when the copy is no longer needed.
+    uint32_t relocate(uint32_t lpn, uint32_t old_ppn) {
+        if (m_l2p[lpn] != old_ppn) {
+            return UNMAPPED;
+        }
+        return write(lpn, true);
+    }
+
+    // The victim's erase finished: every page is clean, the block goes back to the free pool
+    void erase_block(uint32_t block) {
+        Block& state = m_blocks[block];
+        uint32_t first = block * m_pages_per_block;
+        for (uint32_t ppn = first; ppn < first + m_pages_per_block; ++ppn) {
+            uint32_t lpn = m_p2l[ppn];
+            if (lpn != UNMAPPED && m_l2p[lpn] == ppn) {
+                m_l2p[lpn] = UNMAPPED;  // Only reached if collection was skipped
+            }
+            m_p2l[ppn] = UNMAPPED;
+        }
+        state.valid_pages = 0;
+        state.write_pointer = 0;
+        state.collecting = false;
+        state.erase_count++;
+        m_stats.block_erases++;
+        m_free_blocks.push_back(block);
+    }
+
+    // Checkpoint: mapping tables, block states and free pool. A collection in progress
+    // is not carried over; its victim simply becomes a GC candidate again.
+    void save(CheckpointWriter& writer) const {
+        writer.write(m_num_blocks);
+        writer.write(m_pages_per_block);
+        writer.write(m_logical_pages);
+        writer.write_vector(m_l2p);
+        writer.write_vector(m_p2l);
+        writer.write_vector(m_blocks);
+        writer.write_vector(std::vector<uint32_t>(m_free_blocks.begin(), m_free_blocks.end()));
+        writer.write(m_host_block);
+        writer.write(m_gc_block);
+        writer.write(m_write_sequence);
+        FtlStats lifetime = m_baseline_stats;
+        lifetime += m_stats;
+        writer.write(lifetime);
+    }
+    
+    // Statistics restart from zero; the checkpoint's become the baseline
+    bool restore(CheckpointReader& reader) {
+        uint32_t num_blocks = 0, pages_per_block = 0, logical_pages = 0;
+        if (!reader.read(num_blocks) || !reader.read(pages_per_block) || !reader.read(logical_pages)) return false;
+        if (num_blocks != m_num_blocks || pages_per_block != m_pages_per_block || logical_pages != m_logical_pages) {
+            return reader.fail("FTL geometry differs from the checkpoint");
+        }
+        std::vector<uint32_t> free_blocks;
+        if (!reader.read_vector(m_l2p, m_logical_pages) || !reader.read_vector(m_p2l, m_p2l.size()) ||
+            !reader.read_vector(m_blocks, m_num_blocks)) {
+            return false;
+        }
+        uint64_t free_count = 0;
+        if (!reader.read(free_count) || free_count > m_num_blocks) {
+            return reader.fail("FTL free block list is corrupt");
+        }
+        free_blocks.resize(static_cast<size_t>(free_count));
+        if (!free_blocks.empty() && !reader.read_bytes(&free_blocks[0], free_blocks.size() * sizeof(uint32_t))) {
+            return false;
+        }
+        if (!reader.read(m_host_block) || !reader.read(m_gc_block) || !reader.read(m_write_sequence) ||
+            !reader.read(m_baseline_stats)) {
+            return false;
+        }
+        if (m_host_block >= static_cast<int>(m_num_blocks) || m_gc_block >= static_cast<int>(m_num_blocks)) {
+            return reader.fail("FTL active block out of range");
+        }
+        m_free_blocks.assign(free_blocks.begin(), free_blocks.end());
+        for (Block& block : m_blocks) {
+            block.collecting = false;
+        }
+        m_stats = FtlStats();
+        return true;
+    }
+
+private:
+    struct Block {
+        uint32_t valid_pages;
+        uint32_t write_pointer;   // Next page to program
+        uint32_t erase_count;
+        uint64_t last_write;      // Write sequence of the newest page (cost-benefit age)
+        bool collecting;
+
+        Block() : valid_pages(0), write_pointer(0), erase_count(0), last_write(0), collecting(false) {}
+    };
+
+    bool has_room(int block) const {
+        return block >= 0 && m_blocks[block].write_pointer < m_pages_per_block;
+    }
+
+    void invalidate(uint32_t lpn) {
+        uint32_t old_ppn = m_l2p[lpn];
+        if (old_ppn != UNMAPPED) {
+            m_blocks[old_ppn / m_pages_per_block].valid_pages--;
+        }
+    }
+
+    // Dynamic wear leveling: open the least-erased free block. The GC reserve makes an
+    // empty pool an FTL bug rather than a workload condition.
+    int take_free_block() {
+        if (m_free_blocks.empty()) {
+            throw std::logic_error("PageMappedFtl: no free block left to open (GC reserve exhausted)");
+        }
+        auto best = m_free_blocks.begin();
+        for (auto it = m_free_blocks.begin(); it != m_free_blocks.end(); ++it) {
+            if (m_blocks[*it].erase_count < m_blocks[*best].erase_count) {
+                best = it;
+            }
+        }
+        int block = static_cast<int>(*best);
+        m_free_blocks.erase(best);
+        return block;
+    }
+
+    const uint32_t m_num_blocks;
+    const uint32_t m_pages_per_block;
+    const GcPolicy m_gc_policy;
+    const uint32_t m_gc_threshold;      // GC runs while fewer blocks than this are free (>= 2)
+    uint32_t m_logical_pages;
+
+    std::vector<uint32_t> m_l2p;        // Logical page -> physical page
+    std::vector<uint32_t> m_p2l;        // Physical page -> logical page (GC reverse map)
+    std::vector<Block> m_blocks;
+    std::deque<uint32_t> m_free_blocks;
+    int m_host_block;                   // Active block for host writes
+    int m_gc_block;                     // Active block for GC relocations
+    uint64_t m_write_sequence;
+    FtlStats m_stats;
+    FtlStats m_baseline_stats;          // Restored checkpoint (preconditioning)
+};
+
+#endif // PAGE_FTL_H
@@ -12,10 +12,33 @@
 #include <vector>
 #include <unordered_map>
 #include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
 #include "packet/base_packet.h"
 #include "packet/pcie_packet.h"
 #include "common/json_config.h"
 #include "common/error_handling.h"
+#include "common/quantum_keeper.h"
+#include "common/stats_registry.h"
+#include "common/self_profiler.h"
+
+// Submission queue arbitration (NVMe 1.4, 4.13)
+// ROUND_ROBIN:          one command per non-empty SQ in turn
+// WEIGHTED_ROUND_ROBIN: up to queue_weights[q] commands from SQ q before moving on
+enum class SQArbitration {
+    ROUND_ROBIN,
+    WEIGHTED_ROUND_ROBIN
+};
+
+inline SQArbitration parse_sq_arbitration(const std::string& arbitration_str) {
+    if (arbitration_str == "WEIGHTED_ROUND_ROBIN" || arbitration_str == "WRR") return SQArbitration::WEIGHTED_ROUND_ROBIN;
+    return SQArbitration::ROUND_ROBIN;
+}
+
+inline const char* sq_arbitration_name(SQArbitration arbitration) {
+    return (arbitration == SQArbitration::WEIGHTED_ROUND_ROBIN) ? "WEIGHTED_ROUND_ROBIN" : "ROUND_ROBIN";
+}
 
 // SSD Controller configuration
 struct SSDControllerConfig {
@@ -27,9 +50,29 @@ struct SSDControllerConfig {
     uint32_t max_lba_range;           // Maximum LBA address range
     std::string controller_type;       // AHCI, NVMe, etc.
     
+    // NVMe queue pairs: command_queue_depth is the depth of each SQ
+    uint32_t num_queues;              // SQ/CQ pairs (commands map by packet queue id)
+    SQArbitration arbitration;
+    std::vector<uint32_t> queue_weights;  // WRR weight per SQ (missing entries = 1)
+    
+    // Interrupt coalescing per CQ: interrupt after aggregation_threshold completions or
+    // aggregation_time_ns after the oldest pending one (threshold <= 1 = every completion);
+    // pending completions also interrupt once their queue pair has nothing in flight.
+    // A coalesced interrupt is an MSI-X posted write that crosses the upstream link behind
+    // the last completion of the batch (timed by the PCIeDelayLine, not the controller)
+    uint32_t aggregation_threshold;
+    double aggregation_time_ns;
+    
     SSDControllerConfig() : command_queue_depth(32), completion_queue_depth(32),
                           max_data_transfer_size(65536), command_processing_time_ns(100.0),
-                          enable_ncq(true), max_lba_range(0xFFFFFFFF), controller_type("NVMe") {}
+                          enable_ncq(true), max_lba_range(0xFFFFFFFF), controller_type("NVMe"),
+                          num_queues(1), arbitration(SQArbitration::ROUND_ROBIN),
+                          aggregation_threshold(1), aggregation_time_ns(0.0) {}
+    
+    bool coalescing_enabled() const { return aggregation_threshold > 1; }
+    uint32_t weight(uint32_t queue) const {
+        return (queue < queue_weights.size() && queue_weights[queue] > 0) ? queue_weights[queue] : 1;
+    }
 };
 
 // Command state tracking
@@ -51,11 +94,25 @@ struct SSDCommand {
     uint32_t command_id;
     uint64_t lba;
     uint32_t transfer_size;
+    uint32_t queue_id;
     
-    SSDCommand(std::shared_ptr<BasePacket> pkt, uint32_t id) 
+    SSDCommand(std::shared_ptr<BasePacket> pkt, uint32_t id, uint32_t queue)
         : packet(pkt), state(CommandState::SUBMITTED), submit_time(sc_time_stamp()),
           start_time(SC_ZERO_TIME), completion_time(SC_ZERO_TIME), command_id(id),
-          lba(pkt->get_address()), transfer_size(pkt->get_databyte()) {}
+          lba(pkt->get_address()), transfer_size(pkt->get_transfer_length()), queue_id(queue) {}
+};
+
+// Per-queue-pair state: submission queue, pending (not yet interrupted) completions
+struct NVMeQueuePair {
+    std::queue<std::shared_ptr<SSDCommand>> submission_queue;
+    std::vector<std::shared_ptr<SSDCommand>> pending_completions;
+    sc_time oldest_pending_time;
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t interrupts;
+    uint64_t in_flight;               // Queued or dispatched, not yet completed
+    
+    NVMeQueuePair() : oldest_pending_time(SC_ZERO_TIME), submitted(0), completed(0), interrupts(0), in_flight(0) {}
 };
 
 // SSD Controller SystemC Module
@@ -79,13 +136,24 @@ SC_MODULE(SSDController) {
     // PCIe Command Buffer (prevents PCIe blocking)
     sc_fifo<std::shared_ptr<PacketType>> m_pcie_command_buffer;
     
-    // Command tracking
-    std::queue<std::shared_ptr<SSDCommand>> m_command_queue;
-    std::unordered_map<uint32_t, std::shared_ptr<SSDCommand>> m_active_commands;
+    // Command tracking: one SQ/CQ pair per NVMe queue
+    std::vector<NVMeQueuePair> m_queue_pairs;
+    size_t m_queued_commands;                 // Sum of all SQ occupancies
+    std::unordered_map<const BasePacket*, std::shared_ptr<SSDCommand>> m_active_commands;  // By host packet
     uint32_t m_next_command_id;
     
+    // Arbitration state: current SQ and commands it may still take this round
+    uint32_t m_arbitration_queue;
+    uint32_t m_arbitration_credits;
+    
     // Event for command queue notifications
     sc_event m_command_queued;
+    sc_event m_completion_posted;             // Interrupt coalescing wakeup
+    sc_event m_sq_space_freed;                // Dispatch popped a submission queue entry
+    
+    // Temporal decoupling (TimingMode::LOOSE): command overhead is annotated on the packet
+    const bool m_loosely_timed;
+    QuantumKeeper m_quantum_keeper;
     
     // Statistics
     uint64_t m_total_commands;
@@ -94,16 +162,42 @@ SC_MODULE(SSDController) {
     uint64_t m_total_bytes_transferred;
     double m_total_latency_ns;
     uint64_t m_queue_full_count;
+    uint64_t m_interrupt_count;
+    StatsGroup m_stats_group;
+    
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("commands", &m_total_commands);
+        m_stats_group.counter("completed_commands", &m_completed_commands);
+        m_stats_group.counter("error_commands", &m_error_commands);
+        m_stats_group.counter("bytes_transferred", &m_total_bytes_transferred, "bytes");
+        m_stats_group.counter("queue_full_events", &m_queue_full_count);
+        m_stats_group.counter("interrupts", &m_interrupt_count);
+        m_stats_group.gauge("active_commands", [this]() { return static_cast<double>(m_active_commands.size()); });
+        m_stats_group.gauge("queued_commands", [this]() { return static_cast<double>(m_queued_commands); });
+        m_stats_group.gauge("avg_latency", [this]() { return get_average_latency_ns(); }, "ns");
+        m_stats_group.gauge("completions_per_interrupt", [this]() { return get_completions_per_interrupt(); });
+        m_stats_group.gauge("completion_rate", [this]() { return get_command_completion_rate(); }, "ratio");
+        m_stats_group.gauge("buffered_commands", [this]() { return static_cast<double>(m_pcie_command_buffer.num_available()); });
+        if (m_queue_pairs.size() > 1) {
+            for (size_t q = 0; q < m_queue_pairs.size(); ++q) {
+                std::string queue = "queue" + std::to_string(q) + ".";
+                m_stats_group.counter(queue + "submitted", &m_queue_pairs[q].submitted);
+                m_stats_group.counter(queue + "completed", &m_queue_pairs[q].completed);
+                m_stats_group.counter(queue + "interrupts", &m_queue_pairs[q].interrupts);
+            }
+        }
+    }
     
     // PCIe command reception process (event-driven)
     void pcie_reception_process() {
         while (true) {
             // Receive commands from PCIe and buffer them
-            auto packet = pcie_in.read();
+            auto packet = SelfProfiler::read(pcie_in);
             
             if (packet) {
                 // Write to command buffer - blocks if buffer is full (natural backpressure)
-                m_pcie_command_buffer.write(packet);
+                SelfProfiler::write(m_pcie_command_buffer, packet);
                 
                 if (m_debug_enable) {
                     std::cout << sc_time_stamp() << " | SSDController: PCIe command buffered" << std::endl;
@@ -116,12 +210,14 @@ SC_MODULE(SSDController) {
     void command_submission_process() {
         while (true) {
             // Read from command buffer - blocks until data is available (event-driven)
-            auto packet = m_pcie_command_buffer.read();
+            auto packet = SelfProfiler::read(m_pcie_command_buffer);
             
             m_total_commands++;
             
-            // Create internal command structure
-            auto command = std::make_shared<SSDCommand>(packet, m_next_command_id++);
+            // Create internal command structure (host queue id selects the SQ)
+            uint32_t queue_id = packet->get_queue_id() % m_queue_pairs.size();
+            auto command = std::make_shared<SSDCommand>(packet, m_next_command_id++, queue_id);
+            NVMeQueuePair& queue_pair = m_queue_pairs[queue_id];
             
             if (m_debug_enable) {
                 std::cout << sc_time_stamp() << " | SSDController: Processing command ID " 
@@ -129,15 +225,15 @@ SC_MODULE(SSDController) {
                           << std::dec << ", Size " << command->transfer_size << " bytes" << std::endl;
             }
             
-            // Check if command queue has space
-            if (m_command_queue.size() >= m_config.command_queue_depth) {
+            // Check if the submission queue has space
+            if (queue_pair.submission_queue.size() >= m_config.command_queue_depth) {
                 m_queue_full_count++;
                 if (m_debug_enable) {
                     std::cout << sc_time_stamp() << " | SSDController: Command queue full, waiting..." << std::endl;
                 }
-                // Wait until space is available in command queue
-                while (m_command_queue.size() >= m_config.command_queue_depth) {
-                    wait(10, SC_NS); // Small delay to prevent busy waiting
+                // Wait until dispatch frees an entry in this submission queue
+                while (queue_pair.submission_queue.size() >= m_config.command_queue_depth) {
+                    SelfProfiler::wait(m_sq_space_freed);
                 }
             }
             
@@ -156,34 +252,47 @@ SC_MODULE(SSDController) {
                 continue;
             }
             
-            // Add to command queue
+            // Add to the submission queue
             command->state = CommandState::QUEUED;
-            m_command_queue.push(command);
+            queue_pair.submission_queue.push(command);
+            queue_pair.submitted++;
+            queue_pair.in_flight++;
+            m_queued_commands++;
             
             // Notify dispatch process that command is available
             m_command_queued.notify();
             
             // Simulate command processing overhead
-            wait(m_config.command_processing_time_ns, SC_NS);
+            if (m_loosely_timed) {
+                m_quantum_keeper.align_to(QuantumKeeper::packet_time(*packet));
+                m_quantum_keeper.inc(sc_time(m_config.command_processing_time_ns, SC_NS));
+                packet->set_lt_time(m_quantum_keeper.get_current_time());
+                m_quantum_keeper.sync_if_needed();
+            } else {
+                SelfProfiler::wait(m_config.command_processing_time_ns, SC_NS);
+            }
         }
     }
     
     void command_dispatch_process() {
         while (true) {
             // Wait for command available event
-            if (m_command_queue.empty()) {
-                wait(m_command_queued);
+            while (m_queued_commands == 0) {
+                SelfProfiler::wait(m_command_queued);
             }
             
-            // Get next command from queue
-            auto command = m_command_queue.front();
-            m_command_queue.pop();
+            // Get next command from the SQ chosen by arbitration
+            NVMeQueuePair& queue_pair = m_queue_pairs[select_submission_queue()];
+            auto command = queue_pair.submission_queue.front();
+            queue_pair.submission_queue.pop();
+            m_queued_commands--;
+            m_sq_space_freed.notify();
             
             command->state = CommandState::PROCESSING;
             command->start_time = sc_time_stamp();
             
             // Add to active commands tracking
-            m_active_commands[command->command_id] = command;
+            m_active_commands[command->packet.get()] = command;
             
             if (m_debug_enable) {
                 std::cout << sc_time_stamp() << " | SSDController: Dispatching command ID " 
@@ -191,7 +300,7 @@ SC_MODULE(SSDController) {
             }
             
             // Forward packet to storage hierarchy
-            storage_out.write(command->packet);
+            SelfProfiler::write(storage_out, command->packet);
             
             // Update statistics
             m_total_bytes_transferred += command->transfer_size;
@@ -201,7 +310,7 @@ SC_MODULE(SSDController) {
     void completion_handling_process() {
         while (true) {
             // Wait for completion from storage hierarchy
-            auto completed_packet = storage_in.read();
+            auto completed_packet = SelfProfiler::read(storage_in);
             
             if (!completed_packet) {
                 if (m_debug_enable) {
@@ -210,23 +319,17 @@ SC_MODULE(SSDController) {
                 continue;
             }
             
-            // Find corresponding active command
-            // Note: In real implementation, we'd use packet tagging/correlation
-            // For simplicity, we'll match based on address
-            std::shared_ptr<SSDCommand> command = nullptr;
-            for (auto it = m_active_commands.begin(); it != m_active_commands.end(); ++it) {
-                if (it->second->packet->get_address() == completed_packet->get_address()) {
-                    command = it->second;
-                    break;
-                }
-            }
-            
-            if (!command) {
+            // The storage hierarchy completes the host packet it was given, so the packet
+            // itself identifies the command (commands to the same address stay apart)
+            auto active = m_active_commands.find(completed_packet.get());
+            if (active == m_active_commands.end()) {
                 if (m_debug_enable) {
                     std::cout << sc_time_stamp() << " | SSDController: No matching command found for completion" << std::endl;
                 }
                 continue;
             }
+            std::shared_ptr<SSDCommand> command = active->second;
+            m_active_commands.erase(active);    // Before send_completion: the host may reuse the packet
             
             // Update command state and timing
             command->state = CommandState::COMPLETED;
@@ -244,26 +347,112 @@ SC_MODULE(SSDController) {
             
             // Send completion to host
             send_completion(command, true);
-            
-            // Remove from active commands
-            m_active_commands.erase(command->command_id);
             m_completed_commands++;
         }
     }
     
+    // Next SQ to serve (caller guarantees at least one SQ is non-empty)
+    uint32_t select_submission_queue() {
+        uint32_t num_queues = static_cast<uint32_t>(m_queue_pairs.size());
+        while (m_arbitration_credits == 0 || m_queue_pairs[m_arbitration_queue].submission_queue.empty()) {
+            m_arbitration_queue = (m_arbitration_queue + 1) % num_queues;
+            m_arbitration_credits = (m_config.arbitration == SQArbitration::WEIGHTED_ROUND_ROBIN)
+                                        ? m_config.weight(m_arbitration_queue) : 1;
+        }
+        m_arbitration_credits--;
+        return m_arbitration_queue;
+    }
+    
     void send_completion(std::shared_ptr<SSDCommand> command, bool success) {
         // Update packet status if needed
         if (!success) {
             // Mark packet as error (implementation specific)
         }
         
-        // Send completion back to host
-        pcie_out.write(command->packet);
+        NVMeQueuePair& queue_pair = m_queue_pairs[command->queue_id];
+        queue_pair.completed++;
+        if (success) {
+            queue_pair.in_flight--;       // Error completions were never queued
+        }
+        
+        if (!m_config.coalescing_enabled()) {
+            // Send completion back to host (one interrupt per completion, not modeled)
+            command->packet->set_msix_interrupt(false);
+            SelfProfiler::write(pcie_out, command->packet);
+            queue_pair.interrupts++;
+            m_interrupt_count++;
+        } else {
+            // Post to the CQ; interrupt_coalescing_process delivers it
+            if (queue_pair.pending_completions.empty()) {
+                queue_pair.oldest_pending_time = sc_time_stamp();
+            }
+            queue_pair.pending_completions.push_back(command);
+            m_completion_posted.notify();
+        }
+        
+        if (m_debug_enable) {
+            std::cout << sc_time_stamp() << " | SSDController: Sent "
+                      << (success ? "successful" : "error") << " completion for command ID "
+                      << command->command_id << " (queue " << command->queue_id << ")" << std::endl;
+        }
+    }
+    
+    // Interrupt coalescing: a CQ interrupts once aggregation_threshold completions are
+    // pending, its oldest pending completion is aggregation_time_ns old, or its queue pair
+    // has gone idle (nothing else could complete to reach the threshold); the pending
+    // completions then go upstream back-to-back
+    void interrupt_coalescing_process() {
+        if (!m_config.coalescing_enabled()) {
+            return;
+        }
+        const sc_time aggregation_time(m_config.aggregation_time_ns, SC_NS);
+        
+        while (true) {
+            bool have_deadline = false;
+            sc_time next_deadline = SC_ZERO_TIME;
+            
+            for (size_t q = 0; q < m_queue_pairs.size(); ++q) {
+                NVMeQueuePair& queue_pair = m_queue_pairs[q];
+                if (queue_pair.pending_completions.empty()) {
+                    continue;
+                }
+                sc_time deadline = queue_pair.oldest_pending_time + aggregation_time;
+                bool time_expired = (m_config.aggregation_time_ns > 0.0) && sc_time_stamp() >= deadline;
+                bool queue_idle = (queue_pair.in_flight == 0);
+                if (queue_pair.pending_completions.size() >= m_config.aggregation_threshold || time_expired ||
+                    queue_idle) {
+                    raise_interrupt(queue_pair);   // May block on pcie_out
+                    q = static_cast<size_t>(-1);   // Rescan: time passed and more may be due
+                    have_deadline = false;
+                    continue;
+                }
+                if (m_config.aggregation_time_ns > 0.0 && (!have_deadline || deadline < next_deadline)) {
+                    next_deadline = deadline;
+                    have_deadline = true;
+                }
+            }
+            
+            if (have_deadline) {
+                SelfProfiler::wait(next_deadline - sc_time_stamp(), m_completion_posted);
+            } else {
+                SelfProfiler::wait(m_completion_posted);
+            }
+        }
+    }
+    
+    void raise_interrupt(NVMeQueuePair& queue_pair) {
+        std::vector<std::shared_ptr<SSDCommand>> batch;
+        batch.swap(queue_pair.pending_completions);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batch[i]->packet->set_msix_interrupt(i + 1 == batch.size());   // One MSI-X write for the batch
+            SelfProfiler::write(pcie_out, batch[i]->packet);
+        }
+        queue_pair.interrupts++;
+        m_interrupt_count++;
         
         if (m_debug_enable) {
-            std::cout << sc_time_stamp() << " | SSDController: Sent " 
-                      << (success ? "successful" : "error") << " completion for command ID " 
-                      << command->command_id << std::endl;
+            std::cout << sc_time_stamp() << " | SSDController: Interrupt with " << batch.size()
+                      << " coalesced completions" << std::endl;
         }
     }
     
@@ -280,11 +469,29 @@ SC_MODULE(SSDController) {
             m_config.enable_ncq = config.get_bool("ssd.controller.enable_ncq", true);
             m_config.controller_type = config.get_string("ssd.controller.controller_type", "NVMe");
             
+            // NVMe queue pairs, arbitration and interrupt coalescing
+            m_config.num_queues = std::max(1, config.get_int("ssd.controller.num_queues", 1));
+            m_config.arbitration = parse_sq_arbitration(config.get_string("ssd.controller.arbitration", "ROUND_ROBIN"));
+            m_config.queue_weights.clear();
+            std::stringstream weights(config.get_string("ssd.controller.queue_weights", ""));
+            std::string weight;
+            while (std::getline(weights, weight, ',')) {
+                m_config.queue_weights.push_back(static_cast<uint32_t>(std::strtoul(weight.c_str(), nullptr, 10)));
+            }
+            m_config.aggregation_threshold = config.get_int("ssd.controller.interrupt_coalescing.aggregation_threshold", 1);
+            m_config.aggregation_time_ns = config.get_double("ssd.controller.interrupt_coalescing.aggregation_time_ns", 0.0);
+            
             if (m_debug_enable) {
                 std::cout << "SSD Controller Configuration loaded:" << std::endl;
                 std::cout << "  Command Queue Depth: " << m_config.command_queue_depth << std::endl;
                 std::cout << "  Controller Type: " << m_config.controller_type << std::endl;
                 std::cout << "  NCQ Enabled: " << (m_config.enable_ncq ? "Yes" : "No") << std::endl;
+                std::cout << "  Queue Pairs: " << m_config.num_queues << " ("
+                          << sq_arbitration_name(m_config.arbitration) << ")" << std::endl;
+                if (m_config.coalescing_enabled()) {
+                    std::cout << "  Interrupt Coalescing: " << m_config.aggregation_threshold << " completions / "
+                              << m_config.aggregation_time_ns << " ns (flush when idle)" << std::endl;
+                }
             }
             
         } catch (const std::exception& e) {
@@ -302,16 +509,22 @@ SC_MODULE(SSDController) {
           m_debug_enable(debug_enable),
           m_config_file(config_file),
           m_pcie_command_buffer("pcie_cmd_buffer", 64), // PCIe command buffer (larger than command queue)
+          m_queued_commands(0),
           m_next_command_id(1),
+          m_arbitration_queue(0),
+          m_arbitration_credits(0),
+          m_loosely_timed(TemporalDecoupling::is_loosely_timed()),
           m_total_commands(0),
           m_completed_commands(0),
           m_error_commands(0),
           m_total_bytes_transferred(0),
           m_total_latency_ns(0.0),
-          m_queue_full_count(0) {
+          m_queue_full_count(0),
+          m_interrupt_count(0) {
         
         // Load configuration
         load_configuration();
+        m_queue_pairs.resize(m_config.num_queues);
         
         if (m_debug_enable) {
             std::cout << "0 s | " << basename() << ": MOON-SIM SSD Controller initialized"
@@ -320,11 +533,14 @@ SC_MODULE(SSDController) {
                       << ", PCIe Buffer: 64)" << std::endl;
         }
         
+        register_stats();
+        
         // Start controller processes
         SC_THREAD(pcie_reception_process);      // New: Fast PCIe reception
         SC_THREAD(command_submission_process);  // Modified: Process buffered commands
         SC_THREAD(command_dispatch_process);
         SC_THREAD(completion_handling_process);
+        SC_THREAD(interrupt_coalescing_process);
     }
     
 public:
@@ -333,7 +549,13 @@ public:
     uint64_t get_completed_commands() const { return m_completed_commands; }
     uint64_t get_error_commands() const { return m_error_commands; }
     uint64_t get_active_commands() const { return m_active_commands.size(); }
-    uint64_t get_queued_commands() const { return m_command_queue.size(); }
+    uint64_t get_queued_commands() const { return m_queued_commands; }
+    uint64_t get_interrupt_count() const { return m_interrupt_count; }
+    uint32_t get_num_queues() const { return static_cast<uint32_t>(m_queue_pairs.size()); }
+    
+    double get_completions_per_interrupt() const {
+        return (m_interrupt_count > 0) ? static_cast<double>(m_completed_commands + m_error_commands) / m_interrupt_count : 0.0;
+    }
     uint64_t get_buffered_commands() const { return m_pcie_command_buffer.num_available(); }
     uint64_t get_total_bytes_transferred() const { return m_total_bytes_transferred; }
     uint64_t get_queue_full_count() const { return m_queue_full_count; }
@@ -348,24 +570,6 @@ public:
     
     // Configuration access
     const SSDControllerConfig& get_config() const { return m_config; }
-    
-    // Performance metrics
-    void print_statistics() const {
-        std::cout << "\n======== SSD Controller Statistics ========" << std::endl;
-        std::cout << "Total Commands: " << m_total_commands << std::endl;
-        std::cout << "Completed Commands: " << m_completed_commands << std::endl;
-        std::cout << "Error Commands: " << m_error_commands << std::endl;
-        std::cout << "Active Commands: " << m_active_commands.size() << std::endl;
-        std::cout << "Queued Commands: " << m_command_queue.size() << std::endl;
-        std::cout << "Buffered Commands (PCIe): " << m_pcie_command_buffer.num_available() << std::endl;
-        std::cout << "Total Bytes Transferred: " << m_total_bytes_transferred << std::endl;
-        std::cout << "Queue Full Events: " << m_queue_full_count << std::endl;
-        std::cout << "Average Latency: " << std::fixed << std::setprecision(1) 
-                  << get_average_latency_ns() << " ns" << std::endl;
-        std::cout << "Completion Rate: " << std::setprecision(1) 
-                  << get_command_completion_rate() * 100.0 << "%" << std::endl;
-        std::cout << "===========================================" << std::endl;
-    }
 };
 
 // Type aliases for common configurations
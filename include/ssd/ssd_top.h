@@ -10,23 +10,30 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <iomanip>
 #include "packet/base_packet.h"
 #include "packet/pcie_packet.h"
 #include "packet/flash_packet.h"
 #include "common/json_config.h"
 #include "common/error_handling.h"
+#include "common/tlm_support.h"
+#include "common/partition_executor.h"
+#include "common/checkpoint.h"
+#include "common/stats_registry.h"
 
 // Include hardware modules
 #include "ssd/ssd_controller.h"
 #include "ssd/flash_controller.h"
+#include "ssd/dram_buffer.h"
 #include "base/cache_l1.h"
 #include "base/dram_controller.h"
 #include "base/nand_flash.h"
 #include "base/custom_fifo.h"
 
 // Hardware-oriented SSD Top Level Module
-// Architecture: PCIe → SSD Controller → Cache → DRAM Controller → Flash Controller → NAND Flash
+// Architecture: PCIe → SSD Controller → Cache → DRAM Controller → DRAM data buffer → Flash Controller → NAND Flash
+// (buffer read misses and dirty-page write-backs reach the flash controller)
 template<typename PacketType = BasePacket>
 SC_MODULE(SSDTop) {
     SC_HAS_PROCESS(SSDTop);
@@ -35,21 +42,29 @@ SC_MODULE(SSDTop) {
     sc_fifo_in<std::shared_ptr<PacketType>> pcie_in;     // From Host via PCIe
     sc_fifo_out<std::shared_ptr<PacketType>> pcie_out;   // To Host via PCIe
     
+    // TLM-2.0 target (alternative to the PCIe fifo path): controller overhead,
+    // then the cache -> DRAM TLM chain; flash is not reached functionally
+    TlmTargetSocket<SSDTop> tlm_socket;
+    
     // Configuration
     const bool m_debug_enable;
     const std::string m_config_file;
     
     // Hardware Module Instances
+    using SSDCache = CacheL1<32, 64, 4>;                // 32KB, 64B line, 4-way
     SSDController<PacketType>* m_ssd_controller;
-    CacheL1<32, 64, 4>* m_cache_l1;                     // 32KB, 64B line, 4-way
+    SSDCache* m_cache_l1;
     DramController<8, 1>* m_dram_controller;             // 8 banks, 1 rank
+    DramBuffer<PacketType>* m_dram_buffer;               // Host data buffered in DRAM, backed by flash
     FlashController<PacketType>* m_flash_controller;
     std::vector<NANDFlash<4, 1024, 128>*> m_nand_flash_devices;
+    std::unique_ptr<PartitionExecutor> m_partition_executor;  // Partitioned flash channels (optional)
     
     // Inter-module communication CustomFIFOs with VCD tracing
     CustomFifo<std::shared_ptr<PacketType>>* m_controller_to_cache;
     CustomFifo<std::shared_ptr<PacketType>>* m_cache_to_controller;
     CustomFifo<std::shared_ptr<BasePacket>>* m_cache_to_dram;
+    CustomFifo<std::shared_ptr<BasePacket>>* m_dram_to_buffer;
     CustomFifo<std::shared_ptr<BasePacket>>* m_dram_to_cache;
     CustomFifo<std::shared_ptr<PacketType>>* m_dram_to_flash;
     CustomFifo<std::shared_ptr<PacketType>>* m_flash_to_dram;
@@ -61,30 +76,50 @@ SC_MODULE(SSDTop) {
     // Configuration structures
     struct SSDTopConfig {
         uint32_t cache_size_kb;
+        uint32_t cache_mshrs;
+        uint32_t cache_mshr_targets;
         uint32_t dram_size_gb;
+        uint32_t data_buffer_kb;            // DRAM data buffer in front of flash (0 = pass-through)
         uint32_t flash_channels;
         uint32_t fifo_depth;
         bool enable_debug_all_modules;
-        
-        SSDTopConfig() : cache_size_kb(32), dram_size_gb(4), flash_channels(8),
-                        fifo_depth(32), enable_debug_all_modules(false) {}
+        double channel_latency_ns;          // NAND completion -> flash controller
+        uint32_t flash_seed;                // 0 = RandomService stream; channel ch uses seed + ch
+        bool partitioned_execution;         // Flash channels on worker threads
+        uint32_t partition_threads;         // 0 = one per hardware thread
+        double partition_lookahead_ns;      // Channel latency of partitioned runs that set none
+        
+        SSDTopConfig() : cache_size_kb(32), cache_mshrs(4), cache_mshr_targets(4), dram_size_gb(4), data_buffer_kb(0), flash_channels(8),
+                        fifo_depth(32), enable_debug_all_modules(false), channel_latency_ns(0.0), flash_seed(0),
+                        partitioned_execution(false), partition_threads(0), partition_lookahead_ns(1000.0) {}
     } m_config;
     
-    // Statistics aggregation
-    struct SSDStatistics {
-        uint64_t total_requests;
-        uint64_t completed_requests;
-        uint64_t cache_hits;
-        uint64_t cache_misses;
-        uint64_t dram_accesses;
-        uint64_t flash_reads;
-        uint64_t flash_writes;
-        double average_latency_ns;
-        
-        SSDStatistics() : total_requests(0), completed_requests(0), cache_hits(0),
-                         cache_misses(0), dram_accesses(0), flash_reads(0),
-                         flash_writes(0), average_latency_ns(0.0) {}
-    } m_statistics;
+    // Internal TLM chain: tlm_socket -> controller overhead -> cache -> DRAM
+    TlmInitiatorSocket<SSDTop> m_tlm_to_cache;
+    uint64_t m_tlm_transactions;
+    
+    // Checkpoint the drive state was restored from (empty = fresh drive)
+    std::string m_restored_checkpoint;
+    
+    // Fast-forward warm-up
+    uint64_t m_fast_forward_accesses;
+    bool m_fast_forward_full;                           // A warm-up write found no reclaimable block
+    unsigned char m_fast_forward_line[SSDCache::LINE_SIZE];
+    
+    // Drive-level statistics (module statistics register under their own names)
+    StatsGroup m_stats_group;
+    
+    void register_stats() {
+        m_stats_group.set_prefix(name());
+        m_stats_group.counter("tlm_transactions", &m_tlm_transactions);
+        m_stats_group.counter("fast_forward_accesses", &m_fast_forward_accesses);
+        m_stats_group.gauge("preconditioned.host_writes", [this]() {
+            return static_cast<double>(m_flash_controller->get_ftl().get_baseline_stats().host_writes);
+        }, "pages");
+        m_stats_group.gauge("preconditioned.write_amplification", [this]() {
+            return m_flash_controller->get_ftl().get_baseline_stats().get_write_amplification();
+        }, "ratio");
+    }
     
     // Events for efficient bridge communication
     sc_event m_cache_data_ready;
@@ -97,14 +132,28 @@ SC_MODULE(SSDTop) {
             
             // Load SSD Top level configuration
             m_config.cache_size_kb = config.get_int("ssd.cache.cache_size_mb", 256) / 1024; // Convert MB to KB for template
+            m_config.cache_mshrs = config.get_int("ssd.cache.num_mshrs", 4);
+            m_config.cache_mshr_targets = config.get_int("ssd.cache.mshr_max_targets", 4);
             m_config.dram_size_gb = config.get_int("ssd.dram.dram_size_gb", 4);
-            m_config.flash_channels = 1; // Force to 1 channel for simplicity
+            m_config.data_buffer_kb = static_cast<uint32_t>(std::max(0, config.get_int("ssd.dram.data_buffer_kb", 0)));
+            m_config.flash_channels = std::max(1, config.get_int("ssd.flash.num_channels", 8));
             m_config.fifo_depth = config.get_int("ssd.top.fifo_depth", 32);
             m_config.enable_debug_all_modules = config.get_bool("ssd.top.enable_debug_all_modules", false);
+            m_config.channel_latency_ns = config.get_double("ssd.flash.channel_latency_ns", 0.0);
+            m_config.flash_seed = static_cast<uint32_t>(config.get_int("ssd.flash.random_seed", 0));
+            m_config.partitioned_execution = config.get_bool("ssd.flash.partitioned_execution.enable", false);
+            m_config.partition_threads = static_cast<uint32_t>(config.get_int("ssd.flash.partitioned_execution.num_threads", 0));
+            m_config.partition_lookahead_ns = config.get_double("ssd.flash.partitioned_execution.lookahead_ns", 1000.0);
+            // Serial runs keep the configured channel latency (0 by default); only a partitioned
+            // run without one gets the lookahead as its channel latency
+            if (m_config.partitioned_execution && m_config.channel_latency_ns <= 0.0) {
+                m_config.channel_latency_ns = m_config.partition_lookahead_ns;
+            }
             
             if (m_debug_enable) {
                 std::cout << "SSD Top Configuration loaded:" << std::endl;
                 std::cout << "  Cache Size: " << m_config.cache_size_kb << "KB" << std::endl;
+                std::cout << "  Cache MSHRs: " << m_config.cache_mshrs << " x " << m_config.cache_mshr_targets << " targets" << std::endl;
                 std::cout << "  DRAM Size: " << m_config.dram_size_gb << "GB" << std::endl;
                 std::cout << "  Flash Channels: " << m_config.flash_channels << std::endl;
                 std::cout << "  FIFO Depth: " << m_config.fifo_depth << std::endl;
@@ -125,7 +174,9 @@ SC_MODULE(SSDTop) {
         m_ssd_controller = new SSDController<PacketType>("ssd_controller", m_config_file, module_debug);
         
         // Create L1 Cache (template parameters: size, line_size, associativity)
-        m_cache_l1 = new CacheL1<32, 64, 4>("cache_l1");
+        m_cache_l1 = new SSDCache("cache_l1", ReplacementPolicy::LRU, WritePolicy::WRITE_BACK,
+                                            AllocationPolicy::WRITE_ALLOCATE, sc_time(1, SC_NS), sc_time(10, SC_NS),
+                                            false, false, m_config.cache_mshrs, m_config.cache_mshr_targets);
         
         // Create DRAM Controller (DDR4 with default timings)
         m_dram_controller = new DramController<8, 1>("dram_controller", DramTiming(), MemoryType::DDR4, 1024, 8, true, true, module_debug);
@@ -133,11 +184,35 @@ SC_MODULE(SSDTop) {
         // Create Flash Controller
         m_flash_controller = new FlashController<PacketType>("flash_controller", m_config_file, module_debug);
         
-        // Create NAND Flash devices (one per channel)
+        // DRAM data buffer: flash-page granularity, misses and write-backs go to the flash controller
+        m_dram_buffer = new DramBuffer<PacketType>("dram_buffer", m_flash_controller->get_config().page_size_kb,
+                                                   m_config.data_buffer_kb, module_debug);
+        
+        // Create NAND Flash devices (one per channel, holding all dies of the channel)
+        m_config.flash_channels = m_flash_controller->get_config().num_channels;
+        uint32_t dies_per_channel = m_flash_controller->get_config().dies_per_channel;
         m_nand_flash_devices.resize(m_config.flash_channels);
         for (uint32_t ch = 0; ch < m_config.flash_channels; ch++) {
             std::string flash_name = std::string("nand_flash_ch") + std::to_string(ch);
-            m_nand_flash_devices[ch] = new NANDFlash<4, 1024, 128>(flash_name.c_str(), FlashTimingParams(), 100000, module_debug);
+            uint32_t seed = (m_config.flash_seed != 0) ? m_config.flash_seed + ch : 0;
+            m_nand_flash_devices[ch] = new NANDFlash<4, 1024, 128>(flash_name.c_str(), FlashTimingParams(), 100000,
+                                                                    module_debug, dies_per_channel, seed);
+            m_nand_flash_devices[ch]->set_channel_latency(sc_time(m_config.channel_latency_ns, SC_NS));
+        }
+        
+        // Partitioned execution: each channel's NAND model runs on a worker thread,
+        // joined conservatively after the channel latency (results match serial mode)
+        if (m_config.partitioned_execution && m_config.channel_latency_ns <= 0.0) {
+            SOC_SIM_WARNING(basename(), soc_sim::error::codes::CONFIGURATION_ERROR,
+                            "Partitioned flash execution needs a lookahead > 0 (ssd.flash.channel_latency_ns or partitioned_execution.lookahead_ns), running channels serially");
+        } else if (m_config.partitioned_execution) {
+            m_partition_executor.reset(new PartitionExecutor(m_config.partition_threads, m_config.flash_channels));
+            for (uint32_t ch = 0; ch < m_config.flash_channels; ch++) {
+                m_nand_flash_devices[ch]->set_partition_worker(m_partition_executor->worker_for(ch));
+            }
+            std::cout << "0 s | " << basename() << ": Partitioned flash execution, " << m_config.flash_channels
+                      << " channels on " << m_partition_executor->num_threads() << " worker threads (lookahead "
+                      << m_config.channel_latency_ns << " ns)" << std::endl;
         }
         
         if (m_debug_enable) {
@@ -145,6 +220,7 @@ SC_MODULE(SSDTop) {
             std::cout << "  - SSD Controller" << std::endl;
             std::cout << "  - L1 Cache (32KB, 4-way)" << std::endl;
             std::cout << "  - DRAM Controller" << std::endl;
+            std::cout << "  - DRAM Data Buffer (" << m_config.data_buffer_kb << "KB)" << std::endl;
             std::cout << "  - Flash Controller" << std::endl;
             std::cout << "  - " << m_config.flash_channels << " NAND Flash devices" << std::endl;
         }
@@ -160,6 +236,7 @@ SC_MODULE(SSDTop) {
         m_controller_to_cache = new CustomFifo<std::shared_ptr<PacketType>>("controller_to_cache", fifo_depth, ssd_config);
         m_cache_to_controller = new CustomFifo<std::shared_ptr<PacketType>>("cache_to_controller", fifo_depth, ssd_config);
         m_cache_to_dram = new CustomFifo<std::shared_ptr<BasePacket>>("cache_to_dram", fifo_depth, ssd_config);
+        m_dram_to_buffer = new CustomFifo<std::shared_ptr<BasePacket>>("dram_to_buffer", fifo_depth, ssd_config);
         m_dram_to_cache = new CustomFifo<std::shared_ptr<BasePacket>>("dram_to_cache", fifo_depth, ssd_config);
         m_dram_to_flash = new CustomFifo<std::shared_ptr<PacketType>>("dram_to_flash", fifo_depth, ssd_config);
         m_flash_to_dram = new CustomFifo<std::shared_ptr<PacketType>>("flash_to_dram", fifo_depth, ssd_config);
@@ -200,26 +277,103 @@ SC_MODULE(SSDTop) {
         
         // Connect DRAM Controller with basic ports
         m_dram_controller->mem_in(m_cache_to_dram->get_fifo());
-        m_dram_controller->mem_out(m_dram_to_cache->get_fifo());
+        m_dram_controller->mem_out(m_dram_to_buffer->get_fifo());
+        
+        // DRAM data buffer: hits back to the cache, misses and write-backs to flash
+        m_dram_buffer->dram_in(m_dram_to_buffer->get_fifo());
+        m_dram_buffer->cache_out(m_dram_to_cache->get_fifo());
+        m_dram_buffer->flash_out(m_dram_to_flash->get_fifo());
+        m_dram_buffer->flash_in(m_flash_to_dram->get_fifo());
         
         // Connect Flash Controller
         m_flash_controller->dram_in(m_dram_to_flash->get_fifo());
         m_flash_controller->dram_out(m_flash_to_dram->get_fifo());
         
-        // Connect only the first Flash device to avoid complexity
-        if (m_config.flash_channels > 0) {
-            m_flash_controller->flash_out[0]->bind(m_flash_channel_out[0]->get_fifo());
-            m_flash_controller->flash_in[0]->bind(m_flash_channel_in[0]->get_fifo());
+        // Connect every Flash channel to its NAND device
+        for (uint32_t ch = 0; ch < m_config.flash_channels; ch++) {
+            m_flash_controller->flash_out[ch]->bind(m_flash_channel_out[ch]->get_fifo());
+            m_flash_controller->flash_in[ch]->bind(m_flash_channel_in[ch]->get_fifo());
             
-            m_nand_flash_devices[0]->in(m_flash_channel_out[0]->get_fifo());
-            m_nand_flash_devices[0]->release_out(m_flash_channel_in[0]->get_fifo());
+            m_nand_flash_devices[ch]->in(m_flash_channel_out[ch]->get_fifo());
+            m_nand_flash_devices[ch]->release_out(m_flash_channel_in[ch]->get_fifo());
         }
         
+        // Fast-forward reaches the NAND page states directly
+        m_flash_controller->set_functional_flash_port(
+            [this](uint32_t channel, FlashCommand command, const FlashAddress& address) {
+                if (channel < m_nand_flash_devices.size()) {
+                    m_nand_flash_devices[channel]->fast_forward_access(command, address);
+                }
+            });
+        
+        // TLM chain alongside the fifo path
+        tlm_socket.register_b_transport(this, &SSDTop::b_transport);
+        tlm_socket.register_transport_dbg(this, &SSDTop::transport_dbg);
+        m_tlm_to_cache.bind(m_cache_l1->tlm_socket);
+        m_cache_l1->tlm_mem_socket.bind(m_dram_controller->tlm_socket);
+        
         if (m_debug_enable) {
             std::cout << "0 s | " << basename() << ": Connected hardware modules (minimal)" << std::endl;
         }
     }
     
+    // TLM entry point: controller command overhead, then cache/DRAM functional access
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        m_tlm_transactions++;
+        delay += sc_time(m_ssd_controller->m_config.command_processing_time_ns, SC_NS);
+        m_tlm_to_cache->b_transport(trans, delay);
+    }
+    
+    unsigned int transport_dbg(tlm::tlm_generic_payload& trans) {
+        return m_tlm_to_cache->transport_dbg(trans);
+    }
+    
+    // Fast-forward (untimed warm-up) of one host I/O: cache tags and DRAM rows through the
+    // TLM chain (the annotated delay is discarded), FTL mapping, GC and NAND page states
+    // through the flash controller. Nothing waits and nothing is profiled; end_fast_forward()
+    // restarts the statistics for the timed phase. Only valid once the simulation runs.
+    void fast_forward_access(const std::shared_ptr<BasePacket>& packet) {
+        if (!packet) {
+            return;
+        }
+        bool is_write = (packet->get_command() == Command::WRITE);
+        uint64_t address = static_cast<uint32_t>(packet->get_address());
+        uint32_t length = packet->get_transfer_length();
+        
+        // One cache access per I/O as on the timed path, kept within its line
+        const uint32_t line_size = sizeof(m_fast_forward_line);
+        uint32_t cache_bytes = std::min<uint32_t>(std::max<uint32_t>(1, length),
+                                                  line_size - static_cast<uint32_t>(address % line_size));
+        tlm::tlm_generic_payload trans;
+        trans.set_command(is_write ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND);
+        trans.set_address(address);
+        trans.set_data_ptr(m_fast_forward_line);
+        trans.set_data_length(cache_bytes);
+        trans.set_streaming_width(cache_bytes);
+        trans.set_byte_enable_ptr(nullptr);
+        trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+        sc_time delay = SC_ZERO_TIME;
+        m_tlm_to_cache->b_transport(trans, delay);
+        
+        if (!m_flash_controller->fast_forward_access(address, length, is_write) && !m_fast_forward_full) {
+            m_fast_forward_full = true;
+            SOC_SIM_WARNING(basename(), soc_sim::error::codes::RESOURCE_EXHAUSTED,
+                            "Fast-forward: no reclaimable flash block left, later warm-up writes are not mapped");
+        }
+        m_fast_forward_accesses++;
+    }
+    
+    // Switch to the timed pipeline: warm-up state is kept, warm-up statistics are not
+    void end_fast_forward() {
+        m_cache_l1->reset_stats();
+        m_dram_controller->end_fast_forward();
+        m_flash_controller->end_fast_forward();
+        std::cout << sc_time_stamp() << " | " << basename() << ": Fast-forward done after "
+                  << m_fast_forward_accesses << " functional I/Os" << std::endl;
+    }
+    
+    uint64_t get_fast_forward_accesses() const { return m_fast_forward_accesses; }
+    
     // Bridge processes to handle interface mismatches between modules
     void cache_bridge_process() {
         // This process bridges between SSD Controller and Cache
@@ -264,7 +418,12 @@ SC_MODULE(SSDTop) {
           m_ssd_controller(nullptr),
           m_cache_l1(nullptr),
           m_dram_controller(nullptr),
-          m_flash_controller(nullptr) {
+          m_dram_buffer(nullptr),
+          m_flash_controller(nullptr),
+          m_tlm_transactions(0),
+          m_fast_forward_accesses(0),
+          m_fast_forward_full(false),
+          m_fast_forward_line() {
         
         std::cout << "DEBUG: SSDTop constructor started" << std::endl;
         
@@ -288,9 +447,11 @@ SC_MODULE(SSDTop) {
         connect_hardware_modules();
         std::cout << "DEBUG: Hardware modules connected successfully" << std::endl;
         
+        register_stats();
+        
         if (m_debug_enable) {
             std::cout << "0 s | " << basename() << ": Hardware-oriented SSD Top initialized" << std::endl;
-            std::cout << "  Architecture: PCIe → SSD Controller → Cache → DRAM → Flash Controller → NAND Flash" << std::endl;
+            std::cout << "  Architecture: PCIe → SSD Controller → Cache → DRAM → DRAM Buffer → Flash Controller → NAND Flash" << std::endl;
         }
         
         // Bridge processes disabled for now
@@ -305,6 +466,7 @@ SC_MODULE(SSDTop) {
         delete m_ssd_controller;
         delete m_cache_l1;
         delete m_dram_controller;
+        delete m_dram_buffer;
         delete m_flash_controller;
         
         for (auto* flash_device : m_nand_flash_devices) {
@@ -314,6 +476,7 @@ SC_MODULE(SSDTop) {
         delete m_controller_to_cache;
         delete m_cache_to_controller;
         delete m_cache_to_dram;
+        delete m_dram_to_buffer;
         delete m_dram_to_cache;
         delete m_dram_to_flash;
         delete m_flash_to_dram;
@@ -332,18 +495,18 @@ public:
         return m_ssd_controller ? m_ssd_controller->get_total_commands() : 0; 
     }
     
+    uint64_t get_tlm_transactions() const { return m_tlm_transactions; }
+    
     uint64_t get_cache_hits() const { 
-        // This would come from cache module when properly connected
-        return m_statistics.cache_hits; 
+        return m_cache_l1 ? m_cache_l1->get_stats().hits : 0; 
     }
     
     uint64_t get_cache_misses() const { 
-        return m_statistics.cache_misses; 
+        return m_cache_l1 ? m_cache_l1->get_stats().misses : 0; 
     }
     
     double get_cache_hit_rate() const { 
-        uint64_t total = get_cache_hits() + get_cache_misses();
-        return (total > 0) ? (static_cast<double>(get_cache_hits()) / total) : 0.0; 
+        return m_cache_l1 ? m_cache_l1->get_stats().get_hit_rate() : 0.0; 
     }
     
     uint64_t get_dram_accesses() const { 
@@ -360,49 +523,100 @@ public:
     
     // Hardware module access for detailed statistics
     const SSDController<PacketType>* get_ssd_controller() const { return m_ssd_controller; }
-    const CacheL1<32, 64, 4>* get_cache() const { return m_cache_l1; }
+    const SSDCache* get_cache() const { return m_cache_l1; }
     const DramController<8, 1>* get_dram_controller() const { return m_dram_controller; }
+    const DramBuffer<PacketType>* get_dram_buffer() const { return m_dram_buffer; }
     const FlashController<PacketType>* get_flash_controller() const { return m_flash_controller; }
     const NANDFlash<4, 1024, 128>* get_nand_flash(uint32_t channel) const { 
         return (channel < m_nand_flash_devices.size()) ? m_nand_flash_devices[channel] : nullptr; 
     }
     
-    // Performance metrics - aggregate from all modules
-    void print_statistics() const {
-        std::cout << "\n========== Hardware-Oriented SSD Statistics ==========" << std::endl;
-        std::cout << "Total Requests: " << get_total_requests() << std::endl;
-        std::cout << "Cache Hits: " << get_cache_hits() << " (" 
-                  << std::fixed << std::setprecision(1) << get_cache_hit_rate() * 100.0 << "%)" << std::endl;
-        std::cout << "Cache Misses: " << get_cache_misses() << std::endl;
-        std::cout << "DRAM Accesses: " << get_dram_accesses() << std::endl;
-        std::cout << "Flash Reads: " << get_flash_reads() << std::endl;
-        std::cout << "Flash Writes: " << get_flash_writes() << std::endl;
-        std::cout << "=======================================================" << std::endl;
-        
-        // Print detailed statistics from each hardware module
-        if (m_ssd_controller) {
-            m_ssd_controller->print_statistics();
+    // Geometry a checkpoint must match: flash layout (ssd.flash.*), FTL mapping size, cache shape
+    CheckpointGeometry checkpoint_geometry() const {
+        const FlashControllerConfig& flash = m_flash_controller->get_config();
+        CheckpointGeometry geometry;
+        geometry.add("num_channels", flash.num_channels);
+        geometry.add("dies_per_channel", flash.dies_per_channel);
+        geometry.add("planes_per_die", flash.planes_per_die);
+        geometry.add("blocks_per_die", flash.blocks_per_die);
+        geometry.add("pages_per_block", flash.pages_per_block);
+        geometry.add("page_size_kb", flash.page_size_kb);
+        geometry.add("ftl_blocks", m_flash_controller->get_ftl().get_num_blocks());
+        geometry.add("ftl_logical_pages", m_flash_controller->get_ftl().get_logical_pages());
+        geometry.add("nand_planes", NANDFlash<4, 1024, 128>::get_num_planes());
+        geometry.add("nand_blocks_per_plane", NANDFlash<4, 1024, 128>::get_blocks_per_plane());
+        geometry.add("nand_pages_per_block", NANDFlash<4, 1024, 128>::get_pages_per_block());
+        geometry.add("cache_size_kb", SSDCache::CACHE_SIZE / 1024);
+        geometry.add("cache_line_bytes", SSDCache::LINE_SIZE);
+        geometry.add("cache_ways", SSDCache::WAYS);
+        return geometry;
+    }
+    
+    // Write NAND page/erase state, FTL tables, cache contents and statistics baselines
+    bool save_checkpoint(const std::string& path, std::string& error) const {
+        CheckpointWriter writer;
+        if (!writer.open(path, checkpoint_geometry())) {
+            error = writer.get_error();
+            return false;
         }
-        
-        if (m_flash_controller) {
-            m_flash_controller->print_statistics();
+        for (const auto* nand : m_nand_flash_devices) {
+            nand->save_checkpoint(writer);
         }
-        
-        // Print per-channel flash statistics
-        std::cout << "\n========== NAND Flash Channel Statistics ==========" << std::endl;
-        for (uint32_t ch = 0; ch < m_nand_flash_devices.size(); ch++) {
-            if (m_nand_flash_devices[ch]) {
-                std::cout << "Channel " << ch << ": ";
-                // NAND flash statistics would be printed here
-                std::cout << "Active" << std::endl;
+        m_flash_controller->save_checkpoint(writer);
+        m_cache_l1->save_checkpoint(writer);
+        if (!writer.close()) {
+            error = "write error on " + path;
+            return false;
+        }
+        return true;
+    }
+    
+    // At elaboration (before sc_start): start from a preconditioned drive
+    bool restore_checkpoint(const std::string& path, std::string& error) {
+        CheckpointReader reader;
+        if (!reader.open(path)) {
+            error = reader.get_error();
+            return false;
+        }
+        std::string mismatch = reader.geometry().mismatch(checkpoint_geometry());
+        if (!mismatch.empty()) {
+            error = path + " was taken with another geometry (" + mismatch + ")";
+            return false;
+        }
+        bool restored = true;
+        for (auto* nand : m_nand_flash_devices) {
+            restored = restored && nand->restore_checkpoint(reader);
+        }
+        restored = restored && m_flash_controller->restore_checkpoint(reader) &&
+                   m_cache_l1->restore_checkpoint(reader);
+        if (!restored) {
+            error = reader.get_error();
+            return false;
+        }
+        m_restored_checkpoint = path;
+        return true;
+    }
+    
+    const std::string& get_restored_checkpoint() const { return m_restored_checkpoint; }
+    
+    // End-of-run report: every statistic registered under this module, one block per
+    // module, so it always matches the registry export (stats.json, snapshots)
+    void print_statistics() const {
+        for (const auto* nand : m_nand_flash_devices) {
+            if (nand) {
+                nand->sync_partition();
             }
         }
-        std::cout << "===================================================" << std::endl;
+        std::cout << "\n========== Hardware-Oriented SSD Statistics ==========" << std::endl;
+        if (!m_restored_checkpoint.empty()) {
+            std::cout << "Preconditioned from: " << m_restored_checkpoint << std::endl;
+        }
+        m_stats_group.print_report(std::cout);
+        std::cout << "=======================================================" << std::endl;
     }
 };
 
 // Type aliases for common configurations
 using BasePacketSSDTop = SSDTop<BasePacket>;
-using PCIePacketSSDTop = SSDTop<PCIePacket>;
 
 #endif // SSD_TOP_H
\ No newline at end of file
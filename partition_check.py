@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+Partitioned flash execution check (serial vs. partitioned sim_ssd runs)
+Usage:
+  python3 partition_check.py [--config config/base] [--seed 1] [--lookahead-ns NS]
+                             [--threads N] [--work-dir partition_check]
+Runs sim_ssd twice on copies of the config directory, with the same
+ssd.flash.random_seed and channel_latency_ns, once with the NAND channels on
+the SystemC thread and once on partition workers, then diffs metrics.csv and
+stats.json. Wall-clock metrics are skipped in the diff; the wall-clock time of
+each run and their ratio are printed. Exits 1 on any difference.
+"""
+
+import argparse
+import csv
+import json
+import shutil
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+# metrics.csv rows that measure the host, not the simulated drive
+WALL_CLOCK_METRICS = {"sim_speed", "simulation_time"}
+
+
+def set_path(data, path, value):
+    keys = path.split(".")
+    for key in keys[:-1]:
+        data = data.setdefault(key, {})
+    data[keys[-1]] = value
+
+
+def update_json(path, updates):
+    with open(path) as f:
+        data = json.load(f)
+    for key, value in updates.items():
+        set_path(data, key, value)
+    with open(path, "w") as f:
+        json.dump(data, f, indent=2)
+
+
+def prepare_run(args, name, partitioned):
+    run_dir = (Path(args.work_dir) / name).resolve()
+    if run_dir.exists():
+        shutil.rmtree(run_dir)
+    shutil.copytree(args.config, run_dir, ignore=shutil.ignore_patterns("sweeps", "*.log"))
+    update_json(run_dir / "ssd_config.json", {
+        "ssd.flash.random_seed": args.seed,
+        "ssd.flash.channel_latency_ns": args.lookahead_ns,
+        "ssd.flash.partitioned_execution.enable": partitioned,
+        "ssd.flash.partitioned_execution.num_threads": args.threads,
+    })
+    # Outputs in the run directory; nothing that depends on wall-clock time in stats.json
+    update_json(run_dir / "simulation_config.json", {
+        "output_dir": str(run_dir),
+        "stats_json_file": "log/stats.json",
+        "self_profile": False,
+        "web_monitor": False,
+    })
+    return run_dir
+
+
+def run(executable, run_dir, partitioned):
+    """Run sim_ssd on run_dir; wall-clock seconds, None on failure"""
+    start = time.monotonic()
+    result = subprocess.run([executable, str(run_dir)], capture_output=True, text=True)
+    wall_s = time.monotonic() - start
+    (run_dir / "sim_ssd.out").write_text(result.stdout + result.stderr)
+    if result.returncode != 0:
+        print("%s failed (exit %d), see %s" % (run_dir.name, result.returncode, run_dir / "sim_ssd.out"))
+        return None
+    if partitioned and "Partitioned flash execution" not in result.stdout:
+        print("%s did not run partitioned, see %s" % (run_dir.name, run_dir / "sim_ssd.out"))
+        return None
+    return wall_s
+
+
+def load_metrics(path):
+    with open(path) as f:
+        return {row["metric"]: row["value"] for row in csv.DictReader(f)
+                if row["metric"] not in WALL_CLOCK_METRICS}
+
+
+def flatten(data, prefix=""):
+    if not isinstance(data, dict):
+        return {prefix: data}
+    values = {}
+    for key, value in data.items():
+        values.update(flatten(value, prefix + "." + key if prefix else key))
+    return values
+
+
+def load_stats(path):
+    with open(path) as f:
+        return flatten(json.load(f))
+
+
+def diff(label, serial, partitioned):
+    differences = []
+    for key in sorted(set(serial) | set(partitioned)):
+        if serial.get(key) != partitioned.get(key):
+            differences.append("%s %s: serial %s, partitioned %s" % (label, key, serial.get(key), partitioned.get(key)))
+    print("%-12s %6d values, %d differ" % (label, len(serial), len(differences)))
+    return differences
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check that partitioned flash execution matches serial mode")
+    parser.add_argument("--config", default="config/base", help="Config directory to run (default config/base)")
+    parser.add_argument("--executable", default="./sim_ssd", help="sim_ssd binary (default ./sim_ssd)")
+    parser.add_argument("--seed", type=int, default=1, help="ssd.flash.random_seed of both runs (default 1, must be != 0)")
+    parser.add_argument("--lookahead-ns", type=float, default=1000.0,
+                        help="ssd.flash.channel_latency_ns of both runs (default 1000, must be > 0)")
+    parser.add_argument("--threads", type=int, default=0, help="Partition worker threads (default 0 = one per hardware thread)")
+    parser.add_argument("--work-dir", default="partition_check", help="Directory for the two runs (default partition_check)")
+    args = parser.parse_args()
+    if args.seed == 0 or args.lookahead_ns <= 0.0:
+        parser.error("--seed must be != 0 and --lookahead-ns > 0")
+
+    serial_dir = prepare_run(args, "serial", False)
+    partitioned_dir = prepare_run(args, "partitioned", True)
+    serial_s = run(args.executable, serial_dir, False)
+    partitioned_s = run(args.executable, partitioned_dir, True) if serial_s is not None else None
+    if partitioned_s is None:
+        return 1
+    print("wall-clock   serial %.2f s, partitioned %.2f s (%.2fx)"
+          % (serial_s, partitioned_s, serial_s / partitioned_s if partitioned_s > 0 else 0.0))
+
+    differences = diff("metrics.csv", load_metrics(serial_dir / "metrics.csv"),
+                       load_metrics(partitioned_dir / "metrics.csv"))
+    differences += diff("stats.json", load_stats(serial_dir / "log" / "stats.json"),
+                        load_stats(partitioned_dir / "log" / "stats.json"))
+    if differences:
+        print("\nPartitioned run differs from serial:")
+        for difference in differences:
+            print("  " + difference)
+        return 1
+    print("\nPartitioned run matches serial (seed %d, lookahead %g ns)" % (args.seed, args.lookahead_ns))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -4,7 +4,11 @@ SystemC Parameter Sweep Test Runner (Enhanced Python Version)
 Usage: 
   Interactive mode: python3 run_sweep.py
   Command line mode: python3 run_sweep.py <sweep_config_file> [batch_name] [target]
+                     [--jobs N] [--pin-cpus]
 Targets: sim (default), sim_ssd, cache_test, web_test
+Parallel sim_ssd sweeps: --jobs N runs N test cases at once (0 = one per CPU),
+--pin-cpus pins each to its own CPU. Results are collected as test cases
+complete and reported in TC order, as with a serial run.
 """
 
 import json
@@ -17,6 +21,8 @@ from datetime import datetime
 from pathlib import Path
 import argparse
 import glob
+import queue
+from concurrent.futures import ThreadPoolExecutor, as_completed
 
 class Colors:
     RED = '\033[0;31m'
@@ -27,7 +33,7 @@ class Colors:
     NC = '\033[0m'  # No Color
 
 class SweepRunner:
-    def __init__(self, sweep_config_file, batch_name=None, target="sim"):
+    def __init__(self, sweep_config_file, batch_name=None, target="sim", jobs=1, pin_cpus=False):
         self.sweep_config_file = sweep_config_file
         
         # Enable auto-detection if target is default and config file might have target field
@@ -83,6 +89,14 @@ class SweepRunner:
         self.failed = 0
         self.results = []
         
+        # Parallel execution (sim_ssd only: its outputs can be written to the TC directory)
+        self.jobs = jobs
+        self.pin_cpus = pin_cpus
+        self.parallel = (jobs != 1)
+        if self.parallel and self.target != "sim_ssd":
+            print(f"{Colors.YELLOW}Warning: parallel execution needs target sim_ssd, running '{self.target}' serially{Colors.NC}")
+            self.parallel = False
+
     def load_sweep_config(self):
         """Load and validate sweep configuration"""
         try:
@@ -182,6 +196,14 @@ class SweepRunner:
             # Modify the target parameter
             self.modify_config_parameter(tc_config_dir, current_value)
             
+            # Start every test case from the same preconditioned drive
+            if self.sweep_config.get('checkpoint'):
+                self.set_checkpoint_restore(tc_config_dir, self.sweep_config['checkpoint'])
+            
+            # Parallel test cases cannot share the working directory for their outputs
+            if self.parallel:
+                self.set_output_dir(tc_config_dir)
+
             # Create TC info file
             self.create_tc_info(tc_config_dir, tc_name, current_value)
             
@@ -214,6 +236,33 @@ class SweepRunner:
         except Exception as e:
             print(f"{Colors.RED}Error modifying config file {target_file}: {e}{Colors.NC}")
             
+    def set_checkpoint_restore(self, tc_config_dir, checkpoint):
+        """Point simulation_config.json at an SSD checkpoint (written by a run with checkpoint_save)"""
+        if not Path(checkpoint).exists():
+            print(f"{Colors.RED}Warning: Checkpoint '{checkpoint}' not found{Colors.NC}")
+        sim_config_file = tc_config_dir / "simulation_config.json"
+        try:
+            with open(sim_config_file, 'r') as f:
+                config_data = json.load(f)
+            config_data['checkpoint_restore'] = str(Path(checkpoint).resolve())
+            config_data['checkpoint_save'] = ""
+            with open(sim_config_file, 'w') as f:
+                json.dump(config_data, f, indent=2)
+        except Exception as e:
+            print(f"{Colors.RED}Error setting checkpoint in {sim_config_file}: {e}{Colors.NC}")
+    
+    def set_output_dir(self, tc_config_dir):
+        """Have sim_ssd write metrics, logs and traces into the TC directory itself"""
+        sim_config_file = tc_config_dir / "simulation_config.json"
+        try:
+            with open(sim_config_file, 'r') as f:
+                config_data = json.load(f)
+            config_data['output_dir'] = str(tc_config_dir.resolve())
+            with open(sim_config_file, 'w') as f:
+                json.dump(config_data, f, indent=2)
+        except Exception as e:
+            print(f"{Colors.RED}Error setting output_dir in {sim_config_file}: {e}{Colors.NC}")
+    
     def update_parameter_in_dict(self, data, param_name, value):
         """Recursively search and update parameter in nested dictionary"""
         if isinstance(data, dict):
@@ -261,10 +310,8 @@ Modified File: {self.sweep_config['config_file']}
         start_time = time.time()
         try:
             executable = self.target_configs[self.target]['executable']
-            # Use longer timeout for complex simulations like SSD
-            timeout = 60 if self.target == 'sim_ssd' else 30
             result = subprocess.run([executable, str(tc_config_dir)], 
-                                  timeout=timeout, 
+                                  timeout=self.case_timeout(), 
                                   capture_output=True, 
                                   text=True,
                                   env=os.environ)
@@ -336,7 +383,7 @@ Modified File: {self.sweep_config['config_file']}
                     print(f"{Colors.BLUE}Moved {vcd_file} to {tc_config_dir}{Colors.NC}")
             
             self.results.append(f"{tc_name},{value},0,0,0,0,0,0,0,0,0,0,0,0.0,TIMEOUT")
-            self.create_tc_result(tc_config_dir, tc_name, value, "TIMEOUT", 30)
+            self.create_tc_result(tc_config_dir, tc_name, value, "TIMEOUT", self.case_timeout())
             return False
             
     def extract_performance_metrics(self, tc_results_dir, stdout_content=""):
@@ -513,8 +560,112 @@ Results: {tc_results_dir}
         with open(tc_results_dir / "TC_RESULT.txt", 'w') as f:
             f.write(result_content)
             
+    def sweep_cases(self):
+        """(tc_number, value) of every test case"""
+        cases = []
+        tc_number = 1
+        current_value = self.sweep_config['start']
+        while current_value <= self.sweep_config['end']:
+            cases.append((tc_number, current_value))
+            tc_number += 1
+            current_value += self.sweep_config['step']
+        return cases
+    
+    def job_count(self):
+        return self.jobs if self.jobs > 0 else (os.cpu_count() or 1)
+    
+    def case_timeout(self):
+        """Seconds a test case may run, serial or parallel (longer for complex simulations like SSD)"""
+        return 60 if self.target == 'sim_ssd' else 30
+    
+    def finish_parallel_case(self, tc_number, value, status, duration):
+        """Evaluate a test case run in parallel; returns its result line"""
+        tc_name = f"TC{tc_number:03d}"
+        tc_dir = self.sweep_results_dir / tc_name
+        if status != "PASSED":
+            print(f"{Colors.RED}✗ {tc_name} {status} ({duration}s){Colors.NC}")
+            self.create_tc_result(tc_dir, tc_name, value, status, duration)
+            return f"{tc_name},{value},0,0,0,0,0,0,0,0,0,0,0,0.0,{status}"
+        
+        print(f"{Colors.GREEN}✓ {tc_name} PASSED ({duration}s){Colors.NC}")
+        stdout_content = ""
+        console_file = tc_dir / "sim_ssd.out"
+        if console_file.exists():
+            with open(console_file, 'r', errors='replace') as f:
+                stdout_content = f.read()
+        throughput, sim_time, latency, latency_p50, latency_p95, latency_p99, latency_stddev, bw_mbps, traffic_total, traffic_sent, traffic_completed, traffic_completion_rate = self.extract_performance_metrics(tc_dir, stdout_content)
+        if throughput and throughput != "0":
+            print(f"{Colors.YELLOW}Performance: {throughput} cps, {sim_time} ms, {latency} ns avg, p95={latency_p95} ns, {bw_mbps} MB/s{Colors.NC}")
+        self.create_tc_result(tc_dir, tc_name, value, "PASSED", duration)
+        return f"{tc_name},{value},{throughput},{sim_time},{latency},{latency_p50},{latency_p95},{latency_p99},{latency_stddev},{bw_mbps},{traffic_total},{traffic_sent},{traffic_completed},{traffic_completion_rate},PASSED"
+    
+    def record_parallel_results(self, finished):
+        """Store results in TC order, so the CSV matches a serial sweep"""
+        for tc_number in sorted(finished):
+            line = finished[tc_number]
+            self.results.append(line)
+            if line.endswith(",PASSED"):
+                self.passed += 1
+            else:
+                self.failed += 1
+    
+    def run_sweep_parallel(self, cases):
+        """Run up to job_count() sim_ssd processes at once, optionally pinned one per CPU"""
+        jobs = self.job_count()
+        executable = self.target_configs[self.target]['executable']
+        timeout = self.case_timeout()
+        
+        free_cpus = queue.Queue()
+        if self.pin_cpus and hasattr(os, 'sched_getaffinity'):
+            cpus = sorted(os.sched_getaffinity(0))
+            jobs = min(jobs, len(cpus))
+            for cpu in cpus[:jobs]:
+                free_cpus.put(cpu)
+        print(f"{Colors.YELLOW}Running {len(cases)} test cases, {jobs} in parallel{' (pinned)' if not free_cpus.empty() else ''}...{Colors.NC}")
+        
+        def run_one(tc_number, value):
+            tc_dir = self.sweep_results_dir / f"TC{tc_number:03d}"
+            cpu = free_cpus.get() if self.pin_cpus and not free_cpus.empty() else None
+            start_time = time.time()
+            try:
+                # No preexec_fn: it is unsafe with threads, so the child is pinned after it starts
+                with open(tc_dir / "sim_ssd.out", 'w') as console:
+                    process = subprocess.Popen([executable, str(tc_dir)],
+                                               stdout=console,
+                                               stderr=subprocess.STDOUT,
+                                               env=os.environ)
+                    if cpu is not None:
+                        try:
+                            os.sched_setaffinity(process.pid, {cpu})
+                        except OSError:
+                            pass    # Already exited
+                    try:
+                        returncode = process.wait(timeout=timeout)
+                        status = "PASSED" if returncode == 0 else "FAILED"
+                    except subprocess.TimeoutExpired:
+                        process.kill()
+                        process.wait()
+                        status = "TIMEOUT"
+            finally:
+                if cpu is not None:
+                    free_cpus.put(cpu)
+            return tc_number, value, status, int(time.time() - start_time)
+        
+        finished = {}
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            futures = [pool.submit(run_one, tc_number, value) for tc_number, value in cases]
+            for future in as_completed(futures):
+                tc_number, value, status, duration = future.result()
+                finished[tc_number] = self.finish_parallel_case(tc_number, value, status, duration)
+                print(f"{Colors.CYAN}Completed {len(finished)}/{len(cases)}{Colors.NC}")
+        self.record_parallel_results(finished)
+    
     def run_sweep(self):
         """Run the complete parameter sweep"""
+        if self.parallel:
+            self.run_sweep_parallel(self.sweep_cases())
+            return
+        
         print(f"{Colors.YELLOW}Running test cases...{Colors.NC}")
         
         tc_number = 1
@@ -860,6 +1011,7 @@ def main():
         
         # Get configuration through interactive prompts
         sweep_config_file, batch_name, target = interactive_mode()
+        run_options = {}
         
     else:
         # Command line mode (backward compatibility)
@@ -867,13 +1019,15 @@ def main():
         parser.add_argument('sweep_config', nargs='?', help='JSON file defining the parameter sweep')
         parser.add_argument('batch_name', nargs='?', default='', help='Optional custom batch name')
         parser.add_argument('target', nargs='?', default='sim', help='Simulation target (sim, sim_ssd, cache_test, web_test)')
+        parser.add_argument('--jobs', type=int, default=1, help='Test cases run in parallel, sim_ssd only (default 1, 0 = one per CPU)')
+        parser.add_argument('--pin-cpus', action='store_true', help='Pin each parallel test case to its own CPU')
         
         args = parser.parse_args()
         
         if not args.sweep_config:
             print(f"{Colors.YELLOW}Usage:{Colors.NC}")
             print(f"  Interactive mode: python3 run_sweep.py")
-            print(f"  Command line mode: python3 run_sweep.py <sweep_config_file> [batch_name] [target]")
+            print(f"  Command line mode: python3 run_sweep.py <sweep_config_file> [batch_name] [target] [--jobs N] [--pin-cpus]")
             print(f"{Colors.YELLOW}Example: python3 run_sweep.py config/sweeps/write_ratio_sweep.json my_sweep sim_ssd{Colors.NC}")
             sys.exit(1)
         
@@ -898,7 +1052,8 @@ def main():
         sweep_config_file = completed_config
         batch_name = args.batch_name if args.batch_name else None
         target = args.target
-        
+        run_options = {'jobs': args.jobs, 'pin_cpus': args.pin_cpus}
+
         print(f"{Colors.CYAN}[INFO]{Colors.NC} Starting parameter sweep...")
         print(f"{Colors.CYAN}[INFO]{Colors.NC} Config file: {sweep_config_file}")
         if batch_name:
@@ -906,7 +1061,7 @@ def main():
     
     # Run the sweep
     try:
-        runner = SweepRunner(sweep_config_file, batch_name, target)
+        runner = SweepRunner(sweep_config_file, batch_name, target, **run_options)
         exit_code = runner.run()
         
         # Show results directory (like sweep.sh does)
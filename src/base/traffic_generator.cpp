@@ -1,27 +1,37 @@
 #include "base/traffic_generator.h"
 #include "common/common_utils.h"
 #include "common/json_config.h"
+#include "common/error_handling.h"
+#include "common/self_profiler.h"
+#include <algorithm>
 #include <cmath>
 
 TrafficGenerator::TrafficGenerator(sc_module_name name, sc_time interval, unsigned int locality_percentage, unsigned int write_percentage, unsigned char databyte_value, unsigned int num_transactions, bool debug_enable, unsigned int start_address, unsigned int end_address, unsigned int address_increment)
-    : sc_module(name), m_interval(interval), m_locality_percentage(locality_percentage), m_write_percentage(write_percentage), m_databyte_value(databyte_value), m_num_transactions(num_transactions), m_debug_enable(debug_enable), m_start_address(start_address), m_end_address(end_address), m_address_increment(address_increment), m_max_outstanding(0),
+    : sc_module(name), m_interval(interval), m_locality_percentage(locality_percentage), m_write_percentage(write_percentage), m_databyte_value(databyte_value), m_transfer_length(0), m_attach_payload(false), m_num_transactions(num_transactions), m_debug_enable(debug_enable), m_start_address(start_address), m_end_address(end_address), m_address_increment(address_increment), m_max_outstanding(0),
       // Default to CONSTANT pattern and CUSTOM template
       m_traffic_pattern(TrafficPattern::CONSTANT), m_workload_template(WorkloadTemplate::CUSTOM),
       m_burst_size(10), m_burst_interval(sc_time(10, SC_NS)), m_idle_time(sc_time(1000, SC_NS)),
       m_delay_mean(100.0), m_delay_stddev(20.0), m_poisson_rate(1000.0),
+      m_trace_format(BlockTraceFormat::AUTO), m_trace_time_scale(1.0), m_trace_replay_mode(TraceReplayMode::OPEN_LOOP),
+      m_fast_forward_transactions(0), m_fast_forward_until(SC_ZERO_TIME),
       m_current_address(start_address),
       m_transactions_sent(0),
       m_transactions_completed(0),
       m_outstanding_count(0),
-      m_random_generator(std::random_device{}()),
-      m_address_dist(start_address, end_address),
+      m_last_completion_time(SC_ZERO_TIME),
+      m_loosely_timed(TemporalDecoupling::is_loosely_timed()),
+      m_random_generator(RandomService::stream(this->name())),
       m_data_dist(0, 0xFFF),
-      m_locality_dist(0, 99),
-      m_write_dist(0, 99),
+      m_draws(4 * DRAW_BLOCK, 0),
+      m_next_draw(DRAW_BLOCK),
       m_exponential_dist(1.0 / m_delay_mean),
       m_normal_dist(m_delay_mean, m_delay_stddev),
       m_poisson_dist(static_cast<int>(m_poisson_rate)),
-      m_uniform_real_dist(0.0, 1.0)
+      m_uniform_real_dist(0.0, 1.0),
+      m_trace_late_count(0),
+      m_trace_time_base_ns(0),
+      m_fast_forwarded(0),
+      m_payload_length(0)
 {
     SC_THREAD(run);
 }
@@ -32,9 +42,16 @@ TrafficPattern parse_traffic_pattern(const std::string& pattern) {
     if (pattern == "POISSON") return TrafficPattern::POISSON;
     if (pattern == "EXPONENTIAL") return TrafficPattern::EXPONENTIAL;
     if (pattern == "NORMAL") return TrafficPattern::NORMAL;
+    if (pattern == "TRACE_REPLAY" || pattern == "TRACE") return TrafficPattern::TRACE_REPLAY;
     return TrafficPattern::CONSTANT; // Default
 }
 
+// Helper function to parse trace replay mode from string
+TraceReplayMode parse_trace_replay_mode(const std::string& mode) {
+    if (mode == "CLOSED_LOOP" || mode == "CLOSED") return TraceReplayMode::CLOSED_LOOP;
+    return TraceReplayMode::OPEN_LOOP; // Default
+}
+
 // Helper function to parse workload template from string
 WorkloadTemplate parse_workload_template(const std::string& template_name) {
     if (template_name == "DATABASE") return WorkloadTemplate::DATABASE;
@@ -52,6 +69,8 @@ TrafficGenerator::TrafficGenerator(sc_module_name name, const JsonConfig& config
       m_locality_percentage(config.get_int("locality_percentage", 0)),
       m_write_percentage(config.get_int("write_percentage", 50)),
       m_databyte_value(static_cast<unsigned char>(config.get_int("databyte_value", 64))),
+      m_transfer_length(static_cast<uint32_t>(config.get_int("transfer_length", 0))),
+      m_attach_payload(config.get_bool("attach_payload", false)),
       m_num_transactions(config.get_int("num_transactions", 100000)),
       m_debug_enable(config.get_bool("debug_enable", false)),
       m_start_address(config.get_int("start_address", 0)),
@@ -67,24 +86,40 @@ TrafficGenerator::TrafficGenerator(sc_module_name name, const JsonConfig& config
       m_delay_mean(config.get_double("delay_mean_ns", 100.0)),
       m_delay_stddev(config.get_double("delay_stddev_ns", 20.0)),
       m_poisson_rate(config.get_double("poisson_rate", 1000.0)),
+      // Trace replay configuration
+      m_trace_file(config.get_string("trace_file", "")),
+      m_trace_format(parse_block_trace_format(config.get_string("trace_format", "AUTO"))),
+      m_trace_time_scale(config.get_double("trace_time_scale", 1.0)),
+      m_trace_replay_mode(parse_trace_replay_mode(config.get_string("trace_replay_mode", "OPEN_LOOP"))),
+      // Fast-forward warm-up
+      m_fast_forward_transactions(config.get_int("fast_forward_transactions", 0)),
+      m_fast_forward_until(sc_time(config.get_double("fast_forward_until_ns", 0.0), SC_NS)),
       m_current_address(m_start_address),
       m_transactions_sent(0),
       m_transactions_completed(0),
       m_outstanding_count(0),
-      m_random_generator(std::random_device{}()),
-      m_address_dist(m_start_address, m_end_address),
+      m_last_completion_time(SC_ZERO_TIME),
+      m_loosely_timed(TemporalDecoupling::is_loosely_timed()),
+      m_random_generator(RandomService::stream(this->name())),
       m_data_dist(0, 0xFFF),
-      m_locality_dist(0, 99),
-      m_write_dist(0, 99),
+      m_draws(4 * DRAW_BLOCK, 0),
+      m_next_draw(DRAW_BLOCK),
       m_exponential_dist(1.0 / m_delay_mean),
       m_normal_dist(m_delay_mean, m_delay_stddev),
       m_poisson_dist(static_cast<int>(m_poisson_rate)),
-      m_uniform_real_dist(0.0, 1.0)
+      m_uniform_real_dist(0.0, 1.0),
+      m_trace_late_count(0),
+      m_trace_time_base_ns(0),
+      m_fast_forwarded(0),
+      m_payload_length(0)
 {
     // Apply workload template settings if not CUSTOM
     if (m_workload_template != WorkloadTemplate::CUSTOM) {
         apply_workload_template();
     }
+    if (m_traffic_pattern == TrafficPattern::TRACE_REPLAY) {
+        open_trace();
+    }
     SC_THREAD(run);
 }
 
@@ -102,6 +137,9 @@ void TrafficGenerator::run() {
                   << ", template=" << static_cast<int>(m_workload_template) << std::endl;
     }
     
+    // Warm-up I/Os first, functional only
+    run_fast_forward();
+    
     // Route to appropriate pattern handler
     switch (m_traffic_pattern) {
         case TrafficPattern::CONSTANT:
@@ -115,6 +153,13 @@ void TrafficGenerator::run() {
         case TrafficPattern::NORMAL:
             run_stochastic_pattern();
             break;
+        case TrafficPattern::TRACE_REPLAY:
+            run_trace_replay();
+            break;
+    }
+    
+    if (m_loosely_timed) {
+        m_quantum_keeper.sync(); // Let simulated time catch up with the annotated time
     }
     
     sc_stop(); // Stop simulation after generating transactions
@@ -202,12 +247,27 @@ sc_time TrafficGenerator::generate_next_interval() {
     return sc_time(delay_ns, SC_NS);
 }
 
+// One block of per-packet draws: four lanes filled by the stream's batch API
+void TrafficGenerator::refill_draws() {
+    uint64_t address_span = static_cast<uint64_t>(m_end_address - m_start_address) + 1;
+    m_random_generator.fill_below(&m_draws[0], DRAW_BLOCK, 100);
+    m_random_generator.fill_below(&m_draws[DRAW_BLOCK], DRAW_BLOCK, 100);
+    m_random_generator.fill_below(&m_draws[2 * DRAW_BLOCK], DRAW_BLOCK, address_span);
+    m_random_generator.fill_below(&m_draws[3 * DRAW_BLOCK], DRAW_BLOCK, 0x1000);
+    m_next_draw = 0;
+}
+
 std::shared_ptr<GenericPacket> TrafficGenerator::generate_packet() {
-    auto p = std::make_shared<GenericPacket>();
+    auto p = PacketPool<GenericPacket>::acquire();
     p->index = 0; // Will be assigned by IndexAllocator
-
+    
+    if (m_next_draw == DRAW_BLOCK) {
+        refill_draws();
+    }
+    const size_t draw = m_next_draw++;
+    
     // Determine address based on locality percentage
-    bool use_sequential = (m_locality_dist(m_random_generator) < static_cast<int>(m_locality_percentage));
+    bool use_sequential = (m_draws[draw] < m_locality_percentage);
     
     if (use_sequential) {
         // Sequential access
@@ -218,37 +278,67 @@ std::shared_ptr<GenericPacket> TrafficGenerator::generate_packet() {
         }
     } else {
         // Random access
-        p->address = m_address_dist(m_random_generator);
+        p->address = static_cast<int>(m_start_address + m_draws[2 * DRAW_BLOCK + draw]);
     }
 
     // Determine packet type (READ/WRITE) based on write percentage
-    bool use_write = (m_write_dist(m_random_generator) < static_cast<int>(m_write_percentage));
+    bool use_write = (m_draws[DRAW_BLOCK + draw] < m_write_percentage);
     
     if (use_write) {
         p->command = Command::WRITE;
-        p->data = m_data_dist(m_random_generator);
+        p->data = static_cast<int>(m_draws[3 * DRAW_BLOCK + draw]);
         p->databyte = m_databyte_value;
     } else {
         p->command = Command::READ;
         p->databyte = m_databyte_value;
     }
     
+    // Large I/O: one packet for the whole transfer
+    if (m_transfer_length > 0) {
+        p->set_transfer_length(m_transfer_length);
+    }
+    if (m_attach_payload && use_write) {
+        p->set_payload(payload_for(p->get_transfer_length()));
+    }
+    
+    if (m_loosely_timed) {
+        p->set_lt_time(m_quantum_keeper.get_current_time());
+    }
+    
     return p;
 }
 
+void TrafficGenerator::wait_for_outstanding_capacity() {
+    while (!has_outstanding_capacity()) {
+        if (m_debug_enable) {
+            std::cout << sc_time_stamp() << " | TrafficGenerator: Waiting for outstanding capacity (" 
+                      << m_outstanding_count << "/" << m_max_outstanding << ")" << std::endl;
+        }
+        SelfProfiler::wait(m_completion_event);
+        
+        // Closed loop: the freed slot is not usable before the completion's annotated time
+        if (m_loosely_timed) {
+            m_quantum_keeper.align_to(m_last_completion_time);
+        }
+    }
+}
+
+void TrafficGenerator::advance_time(const sc_time& delay) {
+    if (m_loosely_timed) {
+        m_quantum_keeper.inc(delay);
+        m_quantum_keeper.sync_if_needed();
+    } else {
+        SelfProfiler::wait(delay);
+    }
+}
+
 void TrafficGenerator::run_constant_pattern() {
     for (int i = 0; i < m_num_transactions; ++i) {
         // Wait for outstanding capacity if limited
-        while (!has_outstanding_capacity()) {
-            if (m_debug_enable) {
-                std::cout << sc_time_stamp() << " | TrafficGenerator: Waiting for outstanding capacity (" 
-                          << m_outstanding_count << "/" << m_max_outstanding << ")" << std::endl;
-            }
-            wait(m_completion_event);
-        }
+        wait_for_outstanding_capacity();
         
         auto p = generate_packet();
-        out.write(p);
+        SelfProfiler::write(out, p);
         m_transactions_sent++;
         if (m_max_outstanding > 0) {
             m_outstanding_count++;
@@ -263,7 +353,7 @@ void TrafficGenerator::run_constant_pattern() {
             }
         }
         
-        wait(m_interval);
+        advance_time(m_interval);
     }
 }
 
@@ -280,16 +370,10 @@ void TrafficGenerator::run_burst_pattern() {
         
         for (int i = 0; i < burst_count; ++i) {
             // Wait for outstanding capacity if limited
-            while (!has_outstanding_capacity()) {
-                if (m_debug_enable) {
-                    std::cout << sc_time_stamp() << " | TrafficGenerator: Waiting for outstanding capacity (" 
-                              << m_outstanding_count << "/" << m_max_outstanding << ")" << std::endl;
-                }
-                wait(m_completion_event);
-            }
+            wait_for_outstanding_capacity();
             
             auto p = generate_packet();
-            out.write(p);
+            SelfProfiler::write(out, p);
             m_transactions_sent++;
             if (m_max_outstanding > 0) {
                 m_outstanding_count++;
@@ -305,7 +389,7 @@ void TrafficGenerator::run_burst_pattern() {
             }
             
             if (i < burst_count - 1) { // Don't wait after the last packet in burst
-                wait(m_burst_interval);
+                advance_time(m_burst_interval);
             }
         }
         
@@ -315,7 +399,7 @@ void TrafficGenerator::run_burst_pattern() {
                 std::cout << sc_time_stamp() << " | TrafficGenerator: Entering idle period for " 
                           << m_idle_time << std::endl;
             }
-            wait(m_idle_time);
+            advance_time(m_idle_time);
         }
     }
 }
@@ -323,16 +407,10 @@ void TrafficGenerator::run_burst_pattern() {
 void TrafficGenerator::run_stochastic_pattern() {
     for (int i = 0; i < m_num_transactions; ++i) {
         // Wait for outstanding capacity if limited
-        while (!has_outstanding_capacity()) {
-            if (m_debug_enable) {
-                std::cout << sc_time_stamp() << " | TrafficGenerator: Waiting for outstanding capacity (" 
-                          << m_outstanding_count << "/" << m_max_outstanding << ")" << std::endl;
-            }
-            wait(m_completion_event);
-        }
+        wait_for_outstanding_capacity();
         
         auto p = generate_packet();
-        out.write(p);
+        SelfProfiler::write(out, p);
         m_transactions_sent++;
         if (m_max_outstanding > 0) {
             m_outstanding_count++;
@@ -348,6 +426,185 @@ void TrafficGenerator::run_stochastic_pattern() {
         }
         
         sc_time next_interval = generate_next_interval();
-        wait(next_interval);
+        advance_time(next_interval);
+    }
+}
+
+// Fast-forward warm-up: the pattern's own address/command stream (same random stream the
+// timed phase continues), applied through the functional target at delta 0 - no out.write,
+// no wait(). Virtual time advances by the gaps the pattern would have waited and only
+// serves the fast_forward_until_ns marker. Warm-up I/Os come on top of num_transactions,
+// except in TRACE_REPLAY, where they are the leading records of the trace.
+void TrafficGenerator::run_fast_forward() {
+    if (!has_fast_forward()) {
+        return;
+    }
+    if (!m_fast_forward_target) {
+        SOC_SIM_WARNING(name(), soc_sim::error::codes::CONFIGURATION_ERROR,
+                        "Fast-forward configured but no functional target is attached, warm-up skipped");
+        return;
+    }
+    
+    const bool until_marker = m_fast_forward_until > SC_ZERO_TIME;
+    sc_time virtual_time = SC_ZERO_TIME;
+    while (m_fast_forward_transactions == 0 || m_fast_forwarded < m_fast_forward_transactions) {
+        std::shared_ptr<GenericPacket> p;
+        sc_time gap = SC_ZERO_TIME;
+        if (m_traffic_pattern == TrafficPattern::TRACE_REPLAY) {
+            const BlockTraceRecord* record = m_trace_reader.peek();
+            if (!record) {
+                break;
+            }
+            virtual_time = sc_time(record->timestamp_ns * m_trace_time_scale, SC_NS);
+            if (until_marker && virtual_time >= m_fast_forward_until) {
+                break;
+            }
+            m_trace_time_base_ns = record->timestamp_ns;
+            p = generate_trace_packet(*m_trace_reader.next());
+        } else {
+            if (until_marker && virtual_time >= m_fast_forward_until) {
+                break;
+            }
+            p = generate_packet();
+            switch (m_traffic_pattern) {
+                case TrafficPattern::CONSTANT:
+                    gap = m_interval;
+                    break;
+                case TrafficPattern::BURST:
+                    gap = ((m_fast_forwarded + 1) % std::max(1u, m_burst_size) == 0) ? m_idle_time : m_burst_interval;
+                    break;
+                default:
+                    gap = generate_next_interval();
+                    break;
+            }
+        }
+        m_fast_forward_target(p);
+        m_fast_forwarded++;
+        virtual_time += gap;
+    }
+    
+    // Replay what is left of the trace
+    if (m_traffic_pattern == TrafficPattern::TRACE_REPLAY) {
+        uint64_t remaining = m_trace_reader.size() - m_trace_reader.position();
+        m_num_transactions = static_cast<unsigned int>(std::min<uint64_t>(m_num_transactions, remaining));
+    }
+    
+    std::cout << sc_time_stamp() << " | TrafficGenerator: Fast-forwarded " << m_fast_forwarded
+              << " I/Os functionally (" << virtual_time << " of traffic), timed simulation starts" << std::endl;
+    if (m_fast_forward_done) {
+        m_fast_forward_done();
+    }
+}
+
+void TrafficGenerator::open_trace() {
+    if (m_trace_file.empty() || !m_trace_reader.open(m_trace_file, m_trace_format)) {
+        SOC_SIM_ERROR(name(), soc_sim::error::codes::CONFIGURATION_ERROR,
+                      "TRACE_REPLAY: " + (m_trace_file.empty() ? std::string("trace_file not set")
+                                                               : m_trace_reader.get_error()));
+        m_num_transactions = 0;
+        return;
+    }
+    // num_transactions caps the replay (0 = whole trace)
+    if (m_num_transactions == 0 || m_num_transactions > m_trace_reader.size()) {
+        m_num_transactions = static_cast<unsigned int>(std::min<uint64_t>(m_trace_reader.size(), UINT32_MAX));
+    }
+    std::cout << "TrafficGenerator: Replaying " << m_num_transactions << " of " << m_trace_reader.size()
+              << " records from " << m_trace_file << " ("
+              << (m_trace_replay_mode == TraceReplayMode::CLOSED_LOOP ? "CLOSED_LOOP" : "OPEN_LOOP")
+              << ", time scale " << m_trace_time_scale << ")" << std::endl;
+}
+
+sc_time TrafficGenerator::local_time() const {
+    return m_loosely_timed ? m_quantum_keeper.get_current_time() : sc_time_stamp();
+}
+
+std::shared_ptr<GenericPacket> TrafficGenerator::generate_trace_packet(const BlockTraceRecord& record) {
+    auto p = PacketPool<GenericPacket>::acquire();
+    p->index = 0; // Will be assigned by IndexAllocator
+
+    // Fold the byte offset into the configured address window
+    uint64_t span = static_cast<uint64_t>(m_end_address - m_start_address) + 1;
+    p->address = static_cast<int>(m_start_address + record.offset % span);
+    p->command = record.is_write ? Command::WRITE : Command::READ;
+    if (record.is_write) {
+        p->data = m_data_dist(m_random_generator);
+    }
+    p->databyte = static_cast<unsigned char>(std::min<uint32_t>(record.size, 0xFF));
+    p->set_transfer_length(record.size);
+    if (m_attach_payload && record.is_write) {
+        p->set_payload(payload_for(record.size));
+    }
+
+    if (m_loosely_timed) {
+        p->set_lt_time(m_quantum_keeper.get_current_time());
+    }
+
+    return p;
+}
+
+void TrafficGenerator::run_trace_replay() {
+    // After a fast-forward, trace time restarts at the last warm-up record
+    const sc_time start_time = local_time();
+    uint64_t previous_timestamp_ns = m_trace_time_base_ns;
+
+    for (unsigned int i = 0; i < m_num_transactions; ++i) {
+        const BlockTraceRecord* record = m_trace_reader.next();
+        if (!record) {
+            break;
+        }
+        uint64_t trace_ns = (record->timestamp_ns > m_trace_time_base_ns) ? record->timestamp_ns - m_trace_time_base_ns : 0;
+        sc_time target = start_time + sc_time(trace_ns * m_trace_time_scale, SC_NS);
+
+        if (m_trace_replay_mode == TraceReplayMode::OPEN_LOOP) {
+            sc_time now = local_time();
+            if (target > now) {
+                advance_time(target - now);
+            }
+            if (!has_outstanding_capacity()) {
+                m_trace_late_count++;
+                wait_for_outstanding_capacity();
+            }
+        } else {
+            wait_for_outstanding_capacity();
+            // Out-of-order records (timestamp before the previous one) issue without a gap
+            uint64_t gap_ns = (record->timestamp_ns > previous_timestamp_ns) ? record->timestamp_ns - previous_timestamp_ns : 0;
+            if (gap_ns > 0) {
+                advance_time(sc_time(gap_ns * m_trace_time_scale, SC_NS));
+            }
+        }
+        previous_timestamp_ns = std::max(previous_timestamp_ns, record->timestamp_ns);
+
+        auto p = generate_trace_packet(*record);
+        SelfProfiler::write(out, p);
+        m_transactions_sent++;
+        if (m_max_outstanding > 0) {
+            m_outstanding_count++;
+        }
+
+        if (m_debug_enable) {
+            print_packet_log(std::cout, "TrafficGenerator", *p,
+                            (p->command == Command::WRITE) ? "Sent WRITE (trace)" : "Sent READ (trace)");
+        }
+    }
+
+    if (m_trace_late_count > 0) {
+        std::cout << sc_time_stamp() << " | TrafficGenerator: Trace replay done, " << m_trace_late_count
+                  << " records late (max_outstanding)" << std::endl;
+    }
+}
+
+PayloadRef TrafficGenerator::payload_for(uint32_t length) {
+    // One buffer, sliced per size: packets share it instead of owning their data
+    if (!m_payload || m_payload_length < length) {
+        std::shared_ptr<PayloadBuffer> buffer = std::make_shared<PayloadBuffer>(length);
+        for (uint32_t i = 0; i < length; ++i) {
+            (*buffer)[i] = static_cast<uint8_t>(m_data_dist(m_random_generator));
+        }
+        m_payload = std::make_shared<const SgList>(SgList(buffer));
+        m_payload_length = length;
+    }
+    if (m_payload_length != length) {
+        return std::make_shared<const SgList>(m_payload->slice(0, length));
     }
+    return m_payload;
 }
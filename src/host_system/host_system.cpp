@@ -1,20 +1,31 @@
 #include "host_system/host_system.h"
 #include "common/common_utils.h"
+#include <sstream>
+
+// Comma-separated config list ("a,b,c"); empty entries are kept so positions line up
+static std::vector<std::string> split_config_list(const std::string& list) {
+    std::vector<std::string> items;
+    if (list.empty()) {
+        return items;
+    }
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t begin = item.find_first_not_of(' ');
+        size_t end = item.find_last_not_of(' ');
+        items.push_back(begin == std::string::npos ? std::string() : item.substr(begin, end - begin + 1));
+    }
+    return items;
+}
 
 // Constructor with default host system config file
 HostSystem::HostSystem(sc_module_name name, const std::string& config_file_path)
-    : sc_module(name) {
+    : sc_module(name), m_next_submission_queue(0), m_fast_forward_pending(0) {
     JsonConfig config(config_file_path);
     configure_components(config, config_file_path);
 }
 
 void HostSystem::configure_components(const JsonConfig& config, const std::string& config_file_path) {
-    // Create internal FIFOs
-    m_internal_fifo = std::unique_ptr<sc_fifo<std::shared_ptr<BasePacket>>>(
-        new sc_fifo<std::shared_ptr<BasePacket>>(2));
-    m_profiling_fifo = std::unique_ptr<sc_fifo<std::shared_ptr<BasePacket>>>(
-        new sc_fifo<std::shared_ptr<BasePacket>>(2));
-    
     // Extract config directory from the host system config path
     std::string config_dir = "config/base/";
     size_t last_slash = config_file_path.find_last_of('/');
@@ -22,54 +33,150 @@ void HostSystem::configure_components(const JsonConfig& config, const std::strin
         config_dir = config_file_path.substr(0, last_slash + 1);
     }
     
-    // Create TrafficGenerator with config from same directory
-    m_traffic_generator = std::unique_ptr<TrafficGenerator>(
-        new TrafficGenerator("traffic_generator", config_dir + "traffic_generator_config.json"));
-    
     // Extract IndexAllocator configuration from host system config (using leaf keys)
     unsigned int max_index = config.get_int("max_index", 1024);
     bool ia_debug = config.get_bool("debug_enable", false);
+    IndexAllocatorMode ia_mode = parse_index_allocator_mode(config.get_string("allocator_mode", "SET_SCAN"));
+    unsigned int ia_max_batch = config.get_int("max_batch", 1);
     
-    // Create IndexAllocator with custom index setter
-    m_index_allocator = std::unique_ptr<IndexAllocator<BasePacket>>(
-        new IndexAllocator<BasePacket>(
-            "index_allocator", 
-            max_index, 
-            create_index_setter(),
-            ia_debug
-        ));
+    // Submission queues: each gets its own TrafficGenerator, depth and tag range.
+    // queue_depths / queue_traffic_configs override queue_depth / traffic_generator_config.json per queue.
+    unsigned int num_queues = std::max(1, config.get_int("num_queues", 1));
+    unsigned int default_depth = config.get_int("queue_depth", max_index);
+    std::vector<std::string> queue_depths = split_config_list(config.get_string("queue_depths", ""));
+    std::vector<std::string> queue_configs = split_config_list(config.get_string("queue_traffic_configs", ""));
+    
+    unsigned int total_depth = 0;
+    m_queues.resize(num_queues);
+    for (unsigned int q = 0; q < num_queues; ++q) {
+        HostQueue& queue = m_queues[q];
+        
+        // Single queue keeps the original module names
+        std::string suffix = (num_queues > 1) ? "_q" + std::to_string(q) : "";
+        std::string traffic_config = (q < queue_configs.size() && !queue_configs[q].empty())
+                                         ? queue_configs[q] : "traffic_generator_config.json";
+        queue.depth = (q < queue_depths.size() && !queue_depths[q].empty())
+                          ? static_cast<unsigned int>(std::stoul(queue_depths[q])) : default_depth;
+        queue.depth = std::max(1u, queue.depth);
+        queue.index_base = total_depth;
+        total_depth += queue.depth;
+        
+        // Create internal FIFOs
+        queue.internal_fifo.reset(new PacketFifo(2));
+        queue.profiling_fifo.reset(new PacketFifo(2));
+        queue.release_fifo.reset(new PacketFifo(("release_fifo" + suffix).c_str(), 32));
+        
+        // Create TrafficGenerator with config from same directory
+        queue.traffic_generator.reset(
+            new TrafficGenerator(("traffic_generator" + suffix).c_str(), config_dir + traffic_config));
+        
+        // Create IndexAllocator (queue-local tags, offset into the host-wide tag space)
+        queue.index_allocator.reset(
+            new IndexAllocator<BasePacket, QueueIndexSetter>(
+                ("index_allocator" + suffix).c_str(),
+                queue.depth,
+                QueueIndexSetter(queue.index_base),
+                ia_debug,
+                ia_mode,
+                ia_max_batch
+            ));
+        
+        // Connect components:
+        // TrafficGenerator -> internal_fifo -> IndexAllocator -> profiling_fifo -> profiling_process -> out
+        // release_in -> release_process -> release_fifo -> IndexAllocator (for index deallocation + completion tracking)
+        queue.traffic_generator->out(*queue.internal_fifo);
+        queue.index_allocator->in(*queue.internal_fifo);
+        queue.index_allocator->out(*queue.profiling_fifo);
+        queue.index_allocator->release_in(*queue.release_fifo);
+    }
+    
+    // Warm up the packet pool so steady-state traffic never allocates from the heap
+    PacketPool<GenericPacket>::reserve(total_depth);
     
     // Create bandwidth profiler (optimized for performance)  
     m_profiler = std::unique_ptr<ProfilerBW<BasePacket>>(
         new ProfilerBW<BasePacket>("profiler", "HostSystem_Profiler", sc_time(100, SC_MS), false)); // Longer period for better performance
     
-    // Create internal FIFO for release processing (32 packet buffer)
-    m_release_fifo = std::unique_ptr<sc_fifo<std::shared_ptr<BasePacket>>>(
-        new sc_fifo<std::shared_ptr<BasePacket>>("release_fifo", 32));
-    
-    // Connect components:
-    // TrafficGenerator -> internal_fifo -> IndexAllocator -> profiling_fifo -> profiling_process -> out
-    // release_in -> release_process -> release_fifo -> IndexAllocator (for index deallocation + completion tracking)
-    m_traffic_generator->out(*m_internal_fifo);
-    m_index_allocator->in(*m_internal_fifo);
-    m_index_allocator->out(*m_profiling_fifo);
-    m_index_allocator->release_in(*m_release_fifo);
+    // Create end-to-end latency profiler (request leaves HostSystem -> completion returns)
+    // (in-flight timestamps are indexed by the host-wide tag, so size them from the summed queue depths)
+    if (config.get_bool("enable_latency_profiler", true)) {
+        LatencyStatsMode latency_mode = parse_latency_stats_mode(config.get_string("latency_stats_mode", "HISTOGRAM"));
+        m_latency_profiler = std::unique_ptr<ProfilerLatency<BasePacket>>(
+            new ProfilerLatency<BasePacket>("latency_profiler", "HostSystem_Latency", sc_time(100, SC_MS), false,
+                                            latency_mode, total_depth));
+    }
     
     // Start internal processes
     SC_THREAD(profiling_process);
     SC_THREAD(release_process);
     
-    std::cout << "HostSystem: Configured with TrafficGenerator and IndexAllocator" << std::endl;
-    std::cout << "  IndexAllocator max_index: " << max_index << std::endl;
+    std::cout << "HostSystem: Configured with " << num_queues << " TrafficGenerator/IndexAllocator queue(s)" << std::endl;
+    for (unsigned int q = 0; q < num_queues; ++q) {
+        std::cout << "  Queue " << q << ": depth " << m_queues[q].depth
+                  << ", tags " << m_queues[q].index_base << "-" << (m_queues[q].index_base + m_queues[q].depth - 1) << std::endl;
+    }
+}
+
+void HostSystem::set_fast_forward_target(const FastForwardTarget& target, const std::function<void()>& done) {
+    m_fast_forward_done = done;
+    m_fast_forward_pending = 0;
+    for (auto& queue : m_queues) {
+        if (queue.traffic_generator->has_fast_forward()) {
+            m_fast_forward_pending++;
+        }
+        queue.traffic_generator->set_fast_forward_target(target, [this]() { fast_forward_queue_done(); });
+    }
+}
+
+// Warm-up I/Os never reach the profilers, but the measured run starts from clean counters
+void HostSystem::fast_forward_queue_done() {
+    if (m_fast_forward_pending == 0 || --m_fast_forward_pending > 0) {
+        return;
+    }
+    m_profiler->reset();
+    if (m_latency_profiler) {
+        m_latency_profiler->reset();
+    }
+    if (m_fast_forward_done) {
+        m_fast_forward_done();
+    }
 }
 
 void HostSystem::profiling_process() {
+    // A submission may be rung on any queue
+    sc_event_or_list submission_events;
+    for (auto& queue : m_queues) {
+        submission_events |= queue.profiling_fifo->data_written_event();
+    }
+    
     while (true) {
-        auto packet = m_profiling_fifo->read();
+        // Round-robin: serve the first queue with a pending submission after the last one served
+        size_t q = 0;
+        bool found = false;
+        for (size_t i = 0; i < m_queues.size(); ++i) {
+            q = (m_next_submission_queue + i) % m_queues.size();
+            if (m_queues[q].profiling_fifo->num_available() > 0) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            wait(submission_events);
+            continue;
+        }
+        m_next_submission_queue = (q + 1) % m_queues.size();
+        
+        auto packet = m_queues[q].profiling_fifo->read();
         
         if (packet) {
+            // Tag the packet with its queue (the SSD maps it to a submission queue)
+            packet->set_queue_id(static_cast<uint16_t>(q));
+            
             // Profile the packet
             m_profiler->profile_packet(packet);
+            if (m_latency_profiler) {
+                m_latency_profiler->profile_request_at(*packet, QuantumKeeper::packet_time(*packet));
+            }
             
             // Forward to external output
             out.write(packet);
@@ -83,19 +190,26 @@ void HostSystem::release_process() {
         auto packet = release_in.read();
         
         if (packet) {
-            // Notify TrafficGenerator of completion
-            if (m_traffic_generator) {
-                m_traffic_generator->notify_completion();
+            size_t q = packet->get_queue_id();
+            if (q >= m_queues.size()) {
+                SOC_SIM_ERROR("HostSystem", soc_sim::error::codes::INVALID_PACKET_TYPE,
+                              "Completion for unknown queue " + std::to_string(q));
+                continue;
             }
+            HostQueue& queue = m_queues[q];
             
-            // Forward packet to IndexAllocator for index deallocation
-            m_release_fifo->write(packet);
+            // Completion time: annotated time in LOOSE mode, simulated time otherwise
+            sc_time completion_time = QuantumKeeper::packet_time(*packet);
+            if (m_latency_profiler) {
+                m_latency_profiler->profile_response_at(*packet, completion_time);
+            }
+            
+            // Notify the issuing TrafficGenerator of completion
+            queue.traffic_generator->notify_completion(completion_time);
+            
+            // Forward packet to its IndexAllocator for index deallocation (queue-local tag)
+            packet->set_index(packet->get_index() - static_cast<int>(queue.index_base));
+            queue.release_fifo->write(packet);
         }
     }
 }
-
-std::function<void(BasePacket&, unsigned int)> HostSystem::create_index_setter() {
-    return [](BasePacket& packet, unsigned int index) {
-        packet.set_attribute("index", static_cast<double>(index));
-    };
-}
\ No newline at end of file
@@ -0,0 +1,793 @@
+#include <systemc.h>
+#include "packet/base_packet.h"
+#include "packet/generic_packet.h"
+#include "packet/flash_packet.h"
+#include "packet/packet_pool.h"
+#include "base/custom_fifo.h"
+#include "base/delay_line.h"
+#include "base/index_allocator.h"
+#include "base/memory.h"
+#include "base/cache_l1.h"
+#include "base/dram_controller.h"
+#include "base/nand_flash.h"
+#include "base/pcie_delay_line.h"
+#include "common/json_config.h"
+#include "common/partition_executor.h"
+#include "common/random.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Simulator throughput benchmark (make bench).
+// Every building block is driven in isolation by a closed-loop source (at most `window`
+// transactions outstanding, optional issue gap) into a sink, all cases elaborated up
+// front and run one after another (SystemC elaborates once per process). The full
+// sim_ssd pipeline runs last as a child process. Results go to a JSON file that
+// bench_compare.py checks against a stored baseline.
+
+// Allocation counter: every operator new in the process (packets, pool slabs, events)
+static std::atomic<uint64_t> g_allocations(0);
+static std::atomic<uint64_t> g_allocated_bytes(0);
+
+void* operator new(std::size_t size) {
+    g_allocations++;
+    g_allocated_bytes += size;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+struct BenchOptions {
+    uint64_t transactions;
+    uint64_t warmup_transactions;
+    unsigned window;
+    double gap_ns;
+    ProcessStyle process_style;     // Forwarding/latency stages (delay_line, memory)
+    std::string output;
+    std::string ssd_exe;
+    std::string ssd_config;
+    std::string ssd_log;
+    std::set<std::string> cases;    // Empty = all
+
+    BenchOptions()
+        : transactions(100000), warmup_transactions(10000), window(64), gap_ns(0.0),
+          process_style(ProcessStyle::THREAD),
+          output("bench.json"), ssd_exe("./sim_ssd"), ssd_config("config/base/"), ssd_log("bench_ssd.log") {}
+
+    bool selected(const std::string& name) const { return cases.empty() || cases.count(name) > 0; }
+};
+
+struct BenchResult {
+    bool ok;
+    std::string note;
+    uint64_t transactions;
+    double hops;                // Channel transfers, all transactions
+    double wall_ns;             // Measured section only
+    double run_ns;              // Run phase (sim_ssd reports its own, without startup)
+    double sim_time_ns;
+    double allocations;         // < 0: not measured
+    double allocated_bytes;
+    long peak_rss_kb;           // Process high-water mark after the case
+    long rss_growth_kb;         // Resident set growth over the case
+
+    BenchResult()
+        : ok(false), transactions(0), hops(0.0), wall_ns(0.0), run_ns(0.0), sim_time_ns(0.0),
+          allocations(-1.0), allocated_bytes(-1.0), peak_rss_kb(0), rss_growth_kb(0) {}
+};
+
+// Shared by the source, the sink and the runner of one case
+struct BenchCase {
+    std::string name;
+    unsigned hops;              // Channel transfers per transaction on the main path
+    uint64_t target;
+    uint64_t sent;
+    uint64_t completed;
+    uint64_t extra_hops;        // Transfers off the main path (cache fills, index releases)
+    uint64_t round;
+    unsigned window;
+    sc_time gap;
+    sc_event start;
+    sc_event credit;
+    sc_event done;
+    BenchResult result;
+
+    BenchCase(const std::string& case_name, unsigned case_hops, const BenchOptions& options)
+        : name(case_name), hops(case_hops), target(0), sent(0), completed(0), extra_hops(0), round(0),
+          window(std::max(1u, options.window)), gap(sc_time(options.gap_ns, SC_NS)) {}
+
+    void complete() {
+        completed++;
+        credit.notify();
+        if (completed == target) {
+            done.notify();
+        }
+    }
+};
+
+template<typename PacketType>
+SC_MODULE(BenchSource) {
+    SC_HAS_PROCESS(BenchSource);
+
+    typedef std::function<std::shared_ptr<PacketType>(uint64_t)> Factory;
+
+    sc_fifo_out<std::shared_ptr<PacketType>> out;
+
+    BenchSource(sc_module_name name, BenchCase& bench_case, Factory factory)
+        : sc_module(name), m_case(bench_case), m_factory(factory) {
+        SC_THREAD(run);
+    }
+
+private:
+    BenchCase& m_case;
+    Factory m_factory;
+
+    void run() {
+        uint64_t round = 0;
+        while (true) {
+            while (m_case.round == round) {
+                wait(m_case.start);
+            }
+            round = m_case.round;
+            while (m_case.sent < m_case.target) {
+                while (m_case.sent - m_case.completed >= m_case.window) {
+                    wait(m_case.credit);
+                }
+                out.write(m_factory(m_case.sent));
+                m_case.sent++;
+                if (m_case.gap > SC_ZERO_TIME) {
+                    wait(m_case.gap);
+                }
+            }
+        }
+    }
+};
+
+template<typename PacketType>
+SC_MODULE(BenchSink) {
+    SC_HAS_PROCESS(BenchSink);
+
+    sc_fifo_in<std::shared_ptr<PacketType>> in;
+
+    BenchSink(sc_module_name name, BenchCase& bench_case) : sc_module(name), m_case(bench_case) {
+        SC_THREAD(run);
+    }
+
+private:
+    BenchCase& m_case;
+
+    void run() {
+        while (true) {
+            in.read();
+            m_case.complete();
+        }
+    }
+};
+
+// Sink that hands every packet back to a release port (IndexAllocator)
+template<typename PacketType>
+SC_MODULE(BenchReturn) {
+    SC_HAS_PROCESS(BenchReturn);
+
+    sc_fifo_in<std::shared_ptr<PacketType>> in;
+    sc_fifo_out<std::shared_ptr<PacketType>> release_out;
+
+    BenchReturn(sc_module_name name, BenchCase& bench_case) : sc_module(name), m_case(bench_case) {
+        SC_THREAD(run);
+    }
+
+private:
+    BenchCase& m_case;
+
+    void run() {
+        while (true) {
+            auto packet = in.read();
+            m_case.complete();
+            m_case.extra_hops++;
+            release_out.write(packet);
+        }
+    }
+};
+
+// Zero-latency next level: answers every request with the request itself (CacheL1 misses)
+template<typename PacketType>
+SC_MODULE(BenchEcho) {
+    SC_HAS_PROCESS(BenchEcho);
+
+    sc_fifo_in<std::shared_ptr<PacketType>> in;
+    sc_fifo_out<std::shared_ptr<PacketType>> out;
+
+    BenchEcho(sc_module_name name, BenchCase& bench_case) : sc_module(name), m_case(bench_case) {
+        SC_THREAD(run);
+    }
+
+private:
+    BenchCase& m_case;
+
+    void run() {
+        while (true) {
+            auto packet = in.read();
+            m_case.extra_hops += 2;
+            out.write(packet);
+        }
+    }
+};
+
+long current_rss_kb() {
+    long pages = 0, resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;     // kB on Linux
+}
+
+// Runs the cases one after another: a warm-up round (packet pools, cache and row
+// state), then the measured round
+SC_MODULE(BenchRunner) {
+    SC_HAS_PROCESS(BenchRunner);
+
+    BenchRunner(sc_module_name name, const std::vector<BenchCase*>& cases, const BenchOptions& options)
+        : sc_module(name), m_cases(cases), m_options(options) {
+        SC_THREAD(run);
+    }
+
+private:
+    std::vector<BenchCase*> m_cases;
+    const BenchOptions& m_options;
+
+    void run() {
+        wait(SC_ZERO_TIME);     // Sources are waiting for their first round
+        for (BenchCase* bench_case : m_cases) {
+            std::cout << "Bench: " << bench_case->name << "..." << std::endl;
+            if (m_options.warmup_transactions > 0) {
+                run_round(*bench_case, m_options.warmup_transactions);
+            }
+            bench_case->result = run_round(*bench_case, m_options.transactions);
+        }
+        sc_stop();
+    }
+
+    BenchResult run_round(BenchCase& bench_case, uint64_t count) {
+        bench_case.target = count;
+        bench_case.sent = 0;
+        bench_case.completed = 0;
+        bench_case.extra_hops = 0;
+
+        BenchResult result;
+        long rss_before = current_rss_kb();
+        uint64_t allocations_before = g_allocations.load();
+        uint64_t bytes_before = g_allocated_bytes.load();
+        sc_time sim_start = sc_time_stamp();
+        auto wall_start = std::chrono::steady_clock::now();
+
+        bench_case.round++;
+        bench_case.start.notify();
+        wait(bench_case.done);
+
+        auto wall_end = std::chrono::steady_clock::now();
+        result.ok = true;
+        result.transactions = count;
+        result.hops = static_cast<double>(count) * bench_case.hops + static_cast<double>(bench_case.extra_hops);
+        result.wall_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count());
+        result.run_ns = result.wall_ns;
+        result.sim_time_ns = (sc_time_stamp() - sim_start).to_seconds() * 1e9;
+        result.allocations = static_cast<double>(g_allocations.load() - allocations_before);
+        result.allocated_bytes = static_cast<double>(g_allocated_bytes.load() - bytes_before);
+        result.peak_rss_kb = peak_rss_kb();
+        result.rss_growth_kb = current_rss_kb() - rss_before;
+        return result;
+    }
+};
+
+// Owns the modules and channels of all cases
+class BenchHarness {
+public:
+    explicit BenchHarness(const BenchOptions& options) : m_options(options), m_rng(RandomService::stream("bench")) {}
+
+    const std::vector<BenchCase*>& cases() const { return m_case_list; }
+
+    void build() {
+        if (m_options.selected("custom_fifo")) build_custom_fifo();
+        if (m_options.selected("delay_line")) build_delay_line("delay_line", DelayLineMode::BLOCKING);
+        if (m_options.selected("delay_line_pipelined")) build_delay_line("delay_line_pipelined", DelayLineMode::PIPELINED);
+        if (m_options.selected("index_allocator")) build_index_allocator();
+        if (m_options.selected("memory")) build_memory();
+        if (m_options.selected("cache_l1")) build_cache_l1();
+        if (m_options.selected("dram_controller")) build_dram_controller();
+        if (m_options.selected("nand_flash")) build_nand_flash();
+        if (m_options.selected("nand_channels")) {
+            build_nand_channels("nand_channels_serial", false);
+            build_nand_channels("nand_channels_partitioned", true);
+        }
+        if (m_options.selected("pcie_delay_line")) build_pcie_delay_line();
+    }
+
+private:
+    typedef std::shared_ptr<BasePacket> BasePacketPtr;
+    typedef sc_fifo<BasePacketPtr> BaseFifo;
+
+    const BenchOptions& m_options;
+    RandomStream m_rng;
+    std::unique_ptr<PartitionExecutor> m_executor;      // Outlives the flash devices joined on it
+    std::vector<std::unique_ptr<BenchCase>> m_cases;
+    std::vector<BenchCase*> m_case_list;
+    std::vector<std::unique_ptr<sc_object>> m_objects;
+
+    BenchCase& add_case(const std::string& name, unsigned hops) {
+        m_cases.push_back(std::unique_ptr<BenchCase>(new BenchCase(name, hops, m_options)));
+        m_case_list.push_back(m_cases.back().get());
+        return *m_cases.back();
+    }
+
+    template<typename T>
+    T* own(T* object) {
+        m_objects.push_back(std::unique_ptr<sc_object>(object));
+        return object;
+    }
+
+    std::string child(const BenchCase& bench_case, const std::string& name) const {
+        return bench_case.name + "_" + name;
+    }
+
+    BaseFifo* fifo(const BenchCase& bench_case, const std::string& name) {
+        return own(new BaseFifo(child(bench_case, name).c_str(), 16));
+    }
+
+    static BasePacketPtr generic_packet(Command command, int address, int data) {
+        auto packet = PacketPool<GenericPacket>::acquire();
+        packet->command = command;
+        packet->address = address;
+        packet->data = data;
+        packet->databyte = 0xFF;
+        packet->index = 0;
+        return packet;
+    }
+
+    BenchSource<BasePacket>* source(BenchCase& bench_case, BenchSource<BasePacket>::Factory factory) {
+        return own(new BenchSource<BasePacket>(child(bench_case, "source").c_str(), bench_case, factory));
+    }
+
+    BenchSink<BasePacket>* sink(BenchCase& bench_case) {
+        return own(new BenchSink<BasePacket>(child(bench_case, "sink").c_str(), bench_case));
+    }
+
+    // Address-independent packets (FIFOs, delay lines, index allocation)
+    static BasePacketPtr stream_packet(uint64_t i) {
+        return generic_packet((i & 1) ? Command::READ : Command::WRITE, static_cast<int>(i & 0xFF), static_cast<int>(i));
+    }
+
+    void build_custom_fifo() {
+        BenchCase& bench_case = add_case("custom_fifo", 1);
+        auto channel = own(new CustomFifo<BasePacketPtr>(child(bench_case, "fifo").c_str(), 16));
+        source(bench_case, stream_packet)->out(*channel);
+        sink(bench_case)->in(*channel);
+    }
+
+    void build_delay_line(const std::string& name, DelayLineMode mode) {
+        BenchCase& bench_case = add_case(name, 2);
+        auto delay_line = own(new DelayLine<BasePacket>(child(bench_case, "dut").c_str(), sc_time(1, SC_NS), false, mode, 0,
+                                                         m_options.process_style));
+        auto in = fifo(bench_case, "in");
+        auto out = fifo(bench_case, "out");
+        source(bench_case, stream_packet)->out(*in);
+        delay_line->in(*in);
+        delay_line->out(*out);
+        sink(bench_case)->in(*out);
+    }
+
+    void build_index_allocator() {
+        BenchCase& bench_case = add_case("index_allocator", 2);
+        auto allocator = own(new IndexAllocator<BasePacket>(child(bench_case, "dut").c_str(), 1024, false,
+                                                            IndexAllocatorMode::BITMAP));
+        auto in = fifo(bench_case, "in");
+        auto out = fifo(bench_case, "out");
+        auto release = fifo(bench_case, "release");
+        auto returner = own(new BenchReturn<BasePacket>(child(bench_case, "sink").c_str(), bench_case));
+        source(bench_case, stream_packet)->out(*in);
+        allocator->in(*in);
+        allocator->out(*out);
+        allocator->release_in(*release);
+        returner->in(*out);
+        returner->release_out(*release);
+    }
+
+    void build_memory() {
+        BenchCase& bench_case = add_case("memory", 2);
+        auto memory = own(new BasePacketMemory(child(bench_case, "dut").c_str(), false, 0.0, 0.0, m_options.process_style));
+        auto in = fifo(bench_case, "in");
+        auto out = fifo(bench_case, "out");
+        RandomStream* rng = &m_rng;
+        source(bench_case, [rng](uint64_t i) {
+            return generic_packet((i & 1) ? Command::READ : Command::WRITE,
+                                  static_cast<int>(rng->below(BasePacketMemory::MEMORY_SIZE)), static_cast<int>(i));
+        })->out(*in);
+        memory->in(*in);
+        memory->release_out(*out);
+        sink(bench_case)->in(*out);
+    }
+
+    // 128 KiB working set over a 32 KiB cache: a mix of hits, misses and write-backs
+    void build_cache_l1() {
+        BenchCase& bench_case = add_case("cache_l1", 2);
+        auto cache = own(new CacheL1<32, 64, 4>(child(bench_case, "dut").c_str()));
+        auto cpu_in = fifo(bench_case, "cpu_in");
+        auto cpu_out = fifo(bench_case, "cpu_out");
+        auto mem_out = fifo(bench_case, "mem_out");
+        auto mem_in = fifo(bench_case, "mem_in");
+        auto echo = own(new BenchEcho<BasePacket>(child(bench_case, "next_level").c_str(), bench_case));
+        RandomStream* rng = &m_rng;
+        source(bench_case, [rng](uint64_t i) {
+            return generic_packet((i % 4 == 0) ? Command::WRITE : Command::READ,
+                                  static_cast<int>(rng->below(128 * 1024) & ~3u), static_cast<int>(i));
+        })->out(*cpu_in);
+        cache->cpu_in(*cpu_in);
+        cache->cpu_out(*cpu_out);
+        cache->mem_out(*mem_out);
+        cache->mem_in(*mem_in);
+        echo->in(*mem_out);
+        echo->out(*mem_in);
+        sink(bench_case)->in(*cpu_out);
+    }
+
+    // Refresh is off: it is a timed background process and would keep running during
+    // the cases after this one
+    void build_dram_controller() {
+        BenchCase& bench_case = add_case("dram_controller", 2);
+        auto dram = own(new DramController<8, 1>(child(bench_case, "dut").c_str(), DramTiming(), MemoryType::DDR4,
+                                                 1024, 8, true, false));
+        auto in = fifo(bench_case, "in");
+        auto out = fifo(bench_case, "out");
+        RandomStream* rng = &m_rng;
+        source(bench_case, [rng](uint64_t i) {
+            return generic_packet((i % 3 == 0) ? Command::WRITE : Command::READ,
+                                  static_cast<int>(rng->below(64u << 20) & ~63u), static_cast<int>(i));
+        })->out(*in);
+        dram->mem_in(*in);
+        dram->mem_out(*out);
+        sink(bench_case)->in(*out);
+    }
+
+    // Page reads spread over 4 dies x 4 planes
+    void build_nand_flash() {
+        BenchCase& bench_case = add_case("nand_flash", 2);
+        auto flash = own(new NANDFlash<4, 1024, 128>(child(bench_case, "dut").c_str(), FlashTimingParams(), 100000,
+                                                     false, 4));
+        auto in = own(new sc_fifo<std::shared_ptr<FlashPacket>>(child(bench_case, "in").c_str(), 16));
+        auto out = own(new sc_fifo<std::shared_ptr<FlashPacket>>(child(bench_case, "out").c_str(), 16));
+        RandomStream* rng = &m_rng;
+        auto flash_source = own(new BenchSource<FlashPacket>(child(bench_case, "source").c_str(), bench_case,
+            [rng](uint64_t i) {
+                auto packet = PacketPool<FlashPacket>::acquire();
+                packet->set_flash_command(FlashCommand::READ);
+                packet->set_flash_address(FlashAddress(static_cast<uint8_t>((i / 4) % 4), static_cast<uint16_t>(rng->below(1024)),
+                                                       static_cast<uint8_t>(rng->below(128)), static_cast<uint8_t>(rng->below(4)),
+                                                       static_cast<uint16_t>(rng->below(32)), static_cast<uint8_t>(i % 4)));
+                packet->data_size = 16384;
+                packet->index = static_cast<int>(i);
+                return packet;
+            }));
+        auto flash_sink = own(new BenchSink<FlashPacket>(child(bench_case, "sink").c_str(), bench_case));
+        flash_source->out(*in);
+        flash->in(*in);
+        flash->release_out(*out);
+        flash_sink->in(*out);
+    }
+
+    // The same 8-channel page read stream, with the NAND models run on the SystemC
+    // thread or on partition workers (1 us lookahead, as ssd.flash.channel_latency_ns)
+    void build_nand_channels(const std::string& name, bool partitioned) {
+        const unsigned channels = 8;
+        BenchCase& bench_case = add_case(name, 2);
+        if (partitioned && !m_executor) {
+            m_executor.reset(new PartitionExecutor(0, channels));
+        }
+        RandomStream* rng = &m_rng;
+        for (unsigned ch = 0; ch < channels; ch++) {
+            std::string channel = "ch" + std::to_string(ch) + "_";
+            auto flash = own(new NANDFlash<4, 1024, 128>(child(bench_case, channel + "dut").c_str(), FlashTimingParams(),
+                                                         100000, false, 4));
+            flash->set_channel_latency(sc_time(1, SC_US));
+            if (partitioned) {
+                flash->set_partition_worker(m_executor->worker_for(ch));
+            }
+            auto in = own(new sc_fifo<std::shared_ptr<FlashPacket>>(child(bench_case, channel + "in").c_str(), 16));
+            auto out = own(new sc_fifo<std::shared_ptr<FlashPacket>>(child(bench_case, channel + "out").c_str(), 16));
+            // One source per channel; they share the case's transaction count and window
+            auto flash_source = own(new BenchSource<FlashPacket>(child(bench_case, channel + "source").c_str(), bench_case,
+                [rng](uint64_t i) {
+                    auto packet = PacketPool<FlashPacket>::acquire();
+                    packet->set_flash_command(FlashCommand::READ);
+                    packet->set_flash_address(FlashAddress(static_cast<uint8_t>(rng->below(4)), static_cast<uint16_t>(rng->below(1024)),
+                                                           static_cast<uint8_t>(rng->below(128)), static_cast<uint8_t>(rng->below(4)),
+                                                           static_cast<uint16_t>(rng->below(32)), static_cast<uint8_t>(i % 4)));
+                    packet->data_size = 16384;
+                    packet->index = static_cast<int>(i);
+                    return packet;
+                }));
+            auto flash_sink = own(new BenchSink<FlashPacket>(child(bench_case, channel + "sink").c_str(), bench_case));
+            flash_source->out(*in);
+            flash->in(*in);
+            flash->release_out(*out);
+            flash_sink->in(*out);
+        }
+    }
+    
+    void build_pcie_delay_line() {
+        BenchCase& bench_case = add_case("pcie_delay_line", 2);
+        auto link = own(new PCIeDelayLine<BasePacket>(child(bench_case, "dut").c_str(), PCIeGeneration::GEN4, 4));
+        auto in = fifo(bench_case, "in");
+        auto out = fifo(bench_case, "out");
+        source(bench_case, stream_packet)->out(*in);
+        link->in(*in);
+        link->out(*out);
+        sink(bench_case)->in(*out);
+    }
+};
+
+// Full pipeline: sim_ssd as a child process (its own elaboration, its own rusage).
+// Throughput and transaction count come from the performance.json it writes.
+BenchResult run_ssd_pipeline(const BenchOptions& options) {
+    BenchResult result;
+    std::remove("performance.json");
+
+    auto wall_start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        result.note = "fork failed";
+        return result;
+    }
+    if (pid == 0) {
+        int log_fd = open(options.ssd_log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log_fd >= 0) {
+            dup2(log_fd, STDOUT_FILENO);
+            dup2(log_fd, STDERR_FILENO);
+            close(log_fd);
+        }
+        execl(options.ssd_exe.c_str(), options.ssd_exe.c_str(), options.ssd_config.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        result.note = "wait4 failed";
+        return result;
+    }
+    auto wall_end = std::chrono::steady_clock::now();
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        result.note = options.ssd_exe + " failed (see " + options.ssd_log + ")";
+        return result;
+    }
+
+    JsonConfig performance("performance.json");
+    if (!performance.has_key("completed_transactions")) {
+        result.note = "no performance.json from " + options.ssd_exe;
+        return result;
+    }
+    result.ok = true;
+    result.transactions = static_cast<uint64_t>(performance.get_double("completed_transactions"));
+    result.wall_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count());
+    result.peak_rss_kb = usage.ru_maxrss;
+    result.note = "wall time includes process start, configuration and elaboration; sim_duration_ms does not";
+    result.run_ns = performance.get_double("duration_ms") * 1e6;
+    return result;
+}
+
+void write_number(std::ostream& os, double value, int precision) {
+    os << std::fixed << std::setprecision(precision) << value;
+}
+
+void write_result(std::ostream& os, const std::string& name, const BenchResult& result, bool pipeline, bool last) {
+    double per_transaction = result.transactions > 0 ? 1.0 / static_cast<double>(result.transactions) : 0.0;
+    double run_ns = result.run_ns;
+
+    os << "    \"" << name << "\": {\n";
+    os << "      \"ok\": " << (result.ok ? "true" : "false") << ",\n";
+    if (!result.note.empty()) {
+        os << "      \"note\": \"" << result.note << "\",\n";
+    }
+    os << "      \"transactions\": " << result.transactions << ",\n";
+    os << "      \"wall_ms\": "; write_number(os, result.wall_ns / 1e6, 3); os << ",\n";
+    if (pipeline) {
+        os << "      \"sim_duration_ms\": "; write_number(os, run_ns / 1e6, 0); os << ",\n";
+    } else {
+        os << "      \"sim_time_ns\": "; write_number(os, result.sim_time_ns, 0); os << ",\n";
+    }
+    os << "      \"transactions_per_sec\": "; write_number(os, run_ns > 0.0 ? result.transactions * 1e9 / run_ns : 0.0, 0); os << ",\n";
+    os << "      \"ns_per_transaction\": "; write_number(os, run_ns * per_transaction, 1); os << ",\n";
+    if (pipeline) {
+        os << "      \"hops_per_transaction\": null,\n";
+        os << "      \"ns_per_hop\": null,\n";
+        os << "      \"allocations_per_transaction\": null,\n";
+        os << "      \"bytes_per_transaction\": null,\n";
+    } else {
+        os << "      \"hops_per_transaction\": "; write_number(os, result.hops * per_transaction, 2); os << ",\n";
+        os << "      \"ns_per_hop\": "; write_number(os, result.hops > 0.0 ? run_ns / result.hops : 0.0, 1); os << ",\n";
+        os << "      \"allocations_per_transaction\": "; write_number(os, result.allocations * per_transaction, 2); os << ",\n";
+        os << "      \"bytes_per_transaction\": "; write_number(os, result.allocated_bytes * per_transaction, 1); os << ",\n";
+    }
+    os << "      \"peak_rss_kb\": " << result.peak_rss_kb;
+    if (!pipeline) {
+        os << ",\n      \"rss_growth_kb\": " << result.rss_growth_kb;
+    }
+    os << "\n    }" << (last ? "" : ",") << "\n";
+}
+
+// Wall-clock gain of the partitioned NAND channels over the serial run of the same stream
+void report_partition_gain(const std::vector<BenchCase*>& cases) {
+    const BenchCase* serial = nullptr;
+    BenchCase* partitioned = nullptr;
+    for (BenchCase* bench_case : cases) {
+        if (bench_case->name == "nand_channels_serial") serial = bench_case;
+        if (bench_case->name == "nand_channels_partitioned") partitioned = bench_case;
+    }
+    if (!serial || !partitioned || !serial->result.ok || !partitioned->result.ok || partitioned->result.wall_ns <= 0.0) {
+        return;
+    }
+    double gain = serial->result.wall_ns / partitioned->result.wall_ns;
+    std::ostringstream note;
+    note << std::fixed << std::setprecision(2) << gain << "x wall-clock vs nand_channels_serial";
+    partitioned->result.note = note.str();
+    std::cout << "Bench: partitioned NAND channels " << note.str() << std::endl;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [--transactions N] [--warmup N] [--window N] [--gap-ns NS]\n"
+              << "       [--process-style THREAD|METHOD]\n"
+              << "       [--cases custom_fifo,delay_line,delay_line_pipelined,index_allocator,memory,\n"
+              << "                cache_l1,dram_controller,nand_flash,nand_channels,pcie_delay_line,ssd_pipeline]\n"
+              << "       [--ssd-exe PATH] [--ssd-config DIR] [--output FILE]" << std::endl;
+}
+
+bool parse_options(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: " << arg << " needs a value" << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--transactions") {
+            options.transactions = std::max<uint64_t>(1, std::stoull(value));
+        } else if (arg == "--warmup") {
+            options.warmup_transactions = std::stoull(value);
+        } else if (arg == "--window") {
+            options.window = static_cast<unsigned>(std::stoul(value));
+        } else if (arg == "--gap-ns") {
+            options.gap_ns = std::stod(value);
+        } else if (arg == "--process-style") {
+            options.process_style = parse_process_style(value);
+        } else if (arg == "--cases") {
+            std::stringstream list(value);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (!name.empty()) options.cases.insert(name);
+            }
+        } else if (arg == "--ssd-exe") {
+            options.ssd_exe = value;
+        } else if (arg == "--ssd-config") {
+            options.ssd_config = value;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int sc_main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
+    std::cout << "=====================================" << std::endl;
+    std::cout << "  MOON-SIM Benchmark" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << "Transactions per case: " << options.transactions << " (warm-up " << options.warmup_transactions
+              << "), window " << options.window << ", gap " << options.gap_ns << " ns, "
+              << process_style_name(options.process_style) << " stages" << std::endl;
+
+    RandomService::set_global_seed(1);
+    BenchHarness harness(options);
+    harness.build();
+    BenchRunner runner("bench_runner", harness.cases(), options);
+
+    if (!harness.cases().empty()) {
+        sc_start();
+    }
+    report_partition_gain(harness.cases());
+
+    BenchResult pipeline;
+    bool run_pipeline = options.selected("ssd_pipeline");
+    if (run_pipeline) {
+        std::cout << "Bench: ssd_pipeline (" << options.ssd_exe << " " << options.ssd_config << ")..." << std::endl;
+        pipeline = run_ssd_pipeline(options);
+        if (!pipeline.ok) {
+            std::cerr << "Warning: ssd_pipeline: " << pipeline.note << std::endl;
+        }
+    }
+
+    std::ofstream bench_json(options.output);
+    if (!bench_json.is_open()) {
+        std::cerr << "Error: Could not write " << options.output << std::endl;
+        return 1;
+    }
+    bench_json << "{\n";
+    bench_json << "  \"bench\": {\n";
+    bench_json << "    \"target\": \"sim_bench\",\n";
+    bench_json << "    \"timestamp\": \"" << std::time(nullptr) << "\",\n";
+    bench_json << "    \"transactions\": " << options.transactions << ",\n";
+    bench_json << "    \"warmup_transactions\": " << options.warmup_transactions << ",\n";
+    bench_json << "    \"window\": " << options.window << ",\n";
+    bench_json << "    \"gap_ns\": " << options.gap_ns << ",\n";
+    bench_json << "    \"process_style\": \"" << process_style_name(options.process_style) << "\"\n";
+    bench_json << "  },\n";
+    bench_json << "  \"cases\": {\n";
+    const std::vector<BenchCase*>& cases = harness.cases();
+    for (size_t i = 0; i < cases.size(); i++) {
+        write_result(bench_json, cases[i]->name, cases[i]->result, false, !run_pipeline && i + 1 == cases.size());
+    }
+    if (run_pipeline) {
+        write_result(bench_json, "ssd_pipeline", pipeline, true, true);
+    }
+    bench_json << "  }\n";
+    bench_json << "}\n";
+    bench_json.close();
+
+    std::cout << std::endl << "=== Benchmark Results ===" << std::endl;
+    std::cout << std::left << std::setw(24) << "case" << std::right << std::setw(14) << "TPS"
+              << std::setw(12) << "ns/hop" << std::setw(12) << "allocs/tx" << std::setw(14) << "peak RSS kB" << std::endl;
+    for (BenchCase* bench_case : cases) {
+        const BenchResult& result = bench_case->result;
+        std::cout << std::left << std::setw(24) << bench_case->name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << (result.run_ns > 0.0 ? result.transactions * 1e9 / result.run_ns : 0.0)
+                  << std::setprecision(1) << std::setw(12) << (result.hops > 0.0 ? result.wall_ns / result.hops : 0.0)
+                  << std::setprecision(2) << std::setw(12) << result.allocations / std::max<uint64_t>(1, result.transactions)
+                  << std::setw(14) << result.peak_rss_kb << std::endl;
+    }
+    if (run_pipeline && pipeline.ok) {
+        std::cout << std::left << std::setw(24) << "ssd_pipeline" << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << (pipeline.run_ns > 0.0 ? pipeline.transactions * 1e9 / pipeline.run_ns : 0.0)
+                  << std::setw(12) << "-" << std::setw(12) << "-" << std::setw(14) << pipeline.peak_rss_kb << std::endl;
+    }
+    std::cout << "Results written to " << options.output << std::endl;
+    return (run_pipeline && !pipeline.ok) ? 1 : 0;
+}
@@ -3,12 +3,22 @@
 #include "ssd/ssd_top.h"
 #include "packet/base_packet.h"
 #include "packet/pcie_packet.h"
+#include "packet/flash_packet.h"
+#include "packet/packet_pool.h"
 #include "base/pcie_delay_line.h"
 #include "base/profiler_latency.h"
 #include "base/custom_fifo.h"
+#include "base/stats_sampler.h"
+#include "base/web_profiler.h"
 #include "common/common_utils.h"
 #include "common/json_config.h"
 #include "common/vcd_helper.h"
+#include "common/quantum_keeper.h"
+#include "common/random.h"
+#include "common/self_profiler.h"
+#include "common/stats_registry.h"
+#include "common/transaction_trace.h"
+#include <algorithm>
 #include <memory>
 #include <fstream>
 #include <sstream>
@@ -39,6 +49,14 @@ bool create_directory(const std::string& path) {
     return false; // Failed to create directory
 }
 
+// Output file location: relative paths go below output_dir (empty = working directory)
+std::string output_path(const std::string& output_dir, const std::string& path) {
+    if (output_dir.empty() || path.empty() || path[0] == '/') {
+        return path;
+    }
+    return output_dir + (output_dir.back() == '/' ? "" : "/") + path;
+}
+
 int sc_main(int argc, char* argv[]) {
     std::cout << "=====================================" << std::endl;
     std::cout << "  MOON-SIM v1.0" << std::endl;
@@ -75,6 +93,20 @@ int sc_main(int argc, char* argv[]) {
     PCIeGeneration pcie_gen = static_cast<PCIeGeneration>(pcie_config.get_int("pcie.link_configuration.generation", 7));
     uint8_t pcie_lanes = static_cast<uint8_t>(pcie_config.get_int("pcie.link_configuration.lanes", 4));
     bool pcie_debug = pcie_config.get_bool("pcie.debugging.enable_detailed_logging", false);
+    uint32_t pcie_max_payload_size = static_cast<uint32_t>(pcie_config.get_int("pcie.link_configuration.max_payload_size", 0));
+    PCIeLinkMode pcie_link_mode = parse_pcie_link_mode(pcie_config.get_string("pcie.link_layer.mode", "SERIAL"));
+    PCIeLinkLayerConfig pcie_link_layer;
+    pcie_link_layer.posted_header_credits = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.posted_header_credits", 32));
+    pcie_link_layer.posted_data_credits = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.posted_data_credits", 1024));
+    pcie_link_layer.non_posted_header_credits = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.non_posted_header_credits", 32));
+    pcie_link_layer.non_posted_data_credits = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.non_posted_data_credits", 0));
+    pcie_link_layer.completion_header_credits = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.completion_header_credits", 0));
+    pcie_link_layer.completion_data_credits = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.completion_data_credits", 0));
+    pcie_link_layer.update_fc_latency_ns = pcie_config.get_double("pcie.link_layer.update_fc_latency_ns", 50.0);
+    pcie_link_layer.replay_timeout_ns = pcie_config.get_double("pcie.link_layer.replay_timeout_ns", 100.0);
+    pcie_link_layer.max_replays = static_cast<uint32_t>(pcie_config.get_int("pcie.link_layer.max_replays", 3));
+    pcie_link_layer.link_latency_ns = pcie_config.get_double("pcie.link_layer.link_latency_ns", 0.0);
+    pcie_link_layer.max_read_request_size = static_cast<uint32_t>(pcie_config.get_int("pcie.link_configuration.max_read_request_size", 0));
     std::cout << "DEBUG: PCIe configuration extracted" << std::endl;
     std::cout.flush();
     
@@ -84,34 +116,68 @@ int sc_main(int argc, char* argv[]) {
     bool ssd_debug = sim_config.get_bool("ssd_debug_enable", false);
     double simulation_time_sec = sim_config.get_double("simulation_time_sec", 0.1);
     bool enable_finite_simulation = sim_config.get_bool("enable_finite_simulation", true);
+    std::string checkpoint_restore = sim_config.get_string("checkpoint_restore", "");
+    std::string output_dir = sim_config.get_string("output_dir", "");
+    std::string checkpoint_save = output_path(output_dir, sim_config.get_string("checkpoint_save", ""));
     
     // Extract dump configuration
     bool dump_interface = sim_config.get_bool("interface", false);
     bool dump_resource = sim_config.get_bool("resource", false);
     bool dump_internal = sim_config.get_bool("internal", false);
-    std::string vcd_file = sim_config.get_string("vcd_file", "ssd_traces");
+    std::string vcd_file = output_path(output_dir, sim_config.get_string("vcd_file", "ssd_traces"));
     
+    // Timing style (must be set before the Host/PCIe/SSD modules are constructed)
+    TimingMode timing_mode = parse_timing_mode(sim_config.get_string("timing_mode", "APPROXIMATE"));
+    double quantum_ns = sim_config.get_double("quantum_ns", 1000.0);
+    TemporalDecoupling::set_mode(timing_mode);
+    TemporalDecoupling::set_global_quantum(sc_time(quantum_ns, SC_NS));
+    
+    // Global seed of the per-module random streams (also before construction; 0 = random per run)
+    RandomService::set_global_seed(static_cast<uint64_t>(sim_config.get_int("random_seed", 1)));
+    std::cout << "DEBUG: Random seed: " << RandomService::get_global_seed() << std::endl;
+    
+    // Self-profiling of the simulator's own processes (off = one branch per hook)
+    SelfProfiler::set_enabled(sim_config.get_bool("self_profile", false));
+
     std::cout << "DEBUG: Simulation configuration extracted - time: " << simulation_time_sec << "s, finite: " << enable_finite_simulation << std::endl;
     std::cout << "DEBUG: VCD dump - interface: " << dump_interface << ", resource: " << dump_resource << ", internal: " << dump_internal << std::endl;
+    std::cout << "DEBUG: Timing mode: " << timing_mode_name(timing_mode);
+    if (timing_mode == TimingMode::LOOSE) {
+        std::cout << " (quantum " << quantum_ns << " ns)";
+    }
+    std::cout << std::endl;
     std::cout.flush();
     // Note: Latency profiling capability moved to HostSystem's embedded profiler
     
     // Ensure log directory exists
     std::cout << "DEBUG: Creating log directory..." << std::endl;
     std::cout.flush();
-    if (!create_directory("log")) {
+    if ((!output_dir.empty() && !create_directory(output_dir)) || !create_directory(output_path(output_dir, "log"))) {
         std::cerr << "Error: Failed to create log directory. Logging may not work properly." << std::endl;
     }
     std::cout << "DEBUG: Log directory created" << std::endl;
     std::cout.flush();
     
+    // Binary transaction trace (must be configured before the FIFOs are constructed)
+    std::string trace_file = output_path(output_dir, sim_config.get_string("trace_file", ""));
+    if (!trace_file.empty()) {
+        if (TransactionTrace::instance().configure(trace_file,
+                                                   sim_config.get_string("trace_fifos", ""),
+                                                   static_cast<unsigned int>(sim_config.get_int("trace_sample_ratio", 1)),
+                                                   static_cast<size_t>(sim_config.get_int("trace_buffer_records", 65536)))) {
+            std::cout << "DEBUG: Transaction trace enabled: " << trace_file << std::endl;
+        } else {
+            std::cerr << "Warning: Cannot open transaction trace file " << trace_file << std::endl;
+        }
+    }
+    
     // Generate log file in the log directory (not config directory)
     std::cout << "DEBUG: Generating log filename..." << std::endl;
     std::cout.flush();
     auto now = std::chrono::system_clock::now();
     auto in_time_t = std::chrono::system_clock::to_time_t(now);
     std::stringstream ss;
-    ss << "log/ssd_simulation_" << std::put_time(std::localtime(&in_time_t), "%Y%m%d_%H%M%S") << ".log";
+    ss << output_path(output_dir, "log/ssd_simulation_") << std::put_time(std::localtime(&in_time_t), "%Y%m%d_%H%M%S") << ".log";
     std::string log_filename = ss.str();
     std::cout << "DEBUG: Log filename: " << log_filename << std::endl;
     std::cout.flush();
@@ -153,10 +219,17 @@ int sc_main(int argc, char* argv[]) {
     // 2. Create PCIe DelayLines (Host <-> SSD communication)
     std::cout << "DEBUG: Creating PCIe DelayLines..." << std::endl;
     std::cout.flush();
-    PCIeDelayLine<BasePacket> pcie_downstream("pcie_downstream", pcie_gen, pcie_lanes, pcie_debug);
+    PCIeDelayLine<BasePacket> pcie_downstream("pcie_downstream", pcie_gen, pcie_lanes, pcie_debug, true, true,
+                                              pcie_link_mode);
     std::cout << "DEBUG: PCIe downstream created" << std::endl;
     std::cout.flush();
-    PCIeDelayLine<BasePacket> pcie_upstream("pcie_upstream", pcie_gen, pcie_lanes, pcie_debug);
+    PCIeDelayLine<BasePacket> pcie_upstream("pcie_upstream", pcie_gen, pcie_lanes, pcie_debug, true, true,
+                                            pcie_link_mode);
+    pcie_downstream.set_max_payload_size(pcie_max_payload_size);
+    pcie_upstream.set_max_payload_size(pcie_max_payload_size);
+    pcie_downstream.configure_link_layer(pcie_link_layer);
+    pcie_upstream.configure_link_layer(pcie_link_layer);
+    pcie_upstream.set_completion_link(true);
     std::cout << "DEBUG: PCIe upstream created" << std::endl;
     std::cout.flush();
     
@@ -168,6 +241,43 @@ int sc_main(int argc, char* argv[]) {
     
     // Note: Latency profiling is now handled by HostSystem's embedded profiler
 
+    // Packet pool counters (process-wide, so registered here rather than by a module)
+    StatsRegistry& stats_registry = StatsRegistry::instance();
+    stats_registry.add_counter("packet_pool.generic.heap", &PacketPool<GenericPacket>::stats().heap_allocations, "chunks");
+    stats_registry.add_counter("packet_pool.generic.recycled", &PacketPool<GenericPacket>::stats().recycled);
+    stats_registry.add_gauge("packet_pool.generic.in_use", &PacketPool<GenericPacket>::stats().in_use, "chunks");
+    stats_registry.add_counter("packet_pool.flash.heap", &PacketPool<FlashPacket>::stats().heap_allocations, "chunks");
+    stats_registry.add_counter("packet_pool.flash.recycled", &PacketPool<FlashPacket>::stats().recycled);
+    stats_registry.add_gauge("packet_pool.flash.in_use", &PacketPool<FlashPacket>::stats().in_use, "chunks");
+    stats_registry.add_counter("packet_pool.pcie.heap", &PacketPool<PCIePacket>::stats().heap_allocations, "chunks");
+    stats_registry.add_counter("packet_pool.pcie.recycled", &PacketPool<PCIePacket>::stats().recycled);
+    stats_registry.add_gauge("packet_pool.pcie.in_use", &PacketPool<PCIePacket>::stats().in_use, "chunks");
+
+    // Optional periodic StatsRegistry snapshots (binary, see stats_snapshot.py)
+    double stats_interval_ns = sim_config.get_double("stats_snapshot_interval_ns", 0.0);
+    std::unique_ptr<StatsSampler> stats_sampler;
+    if (stats_interval_ns > 0.0) {
+        stats_sampler.reset(new StatsSampler("stats_sampler",
+                                             output_path(output_dir, sim_config.get_string("stats_snapshot_file", "log/stats_snapshots.bin")),
+                                             sc_time(stats_interval_ns, SC_NS)));
+    }
+    
+    // Optional live metrics for web_monitor (FILE or SHM_RING transport)
+    std::unique_ptr<WebProfiler<BasePacket>> web_profiler;
+    if (sim_config.get_bool("web_monitor", false)) {
+        double web_interval_ns = sim_config.get_double("web_monitor_interval_ns", 1e6);
+        if (web_interval_ns <= 0.0) {
+            web_interval_ns = 1e6;
+        }
+        web_profiler.reset(new WebProfiler<BasePacket>("web_profiler",
+                                                       sim_config.get_string("web_monitor_file", "web_monitor/metrics.json"),
+                                                       sc_time(web_interval_ns, SC_NS), false,
+                                                       parse_web_transport(sim_config.get_string("web_monitor_transport", "FILE")),
+                                                       sim_config.get_string("web_monitor_ring", "moon_sim_metrics")));
+        web_profiler->register_cache(ssd_top.get_cache(), "ssd_cache_l1");
+        web_profiler->register_dram(ssd_top.get_dram_controller(), "ssd_dram");
+    }
+    
     // ================== Connection Setup ==================
     
     // Initialize VCD tracing BEFORE creating CustomFIFOs
@@ -201,6 +311,22 @@ int sc_main(int argc, char* argv[]) {
     pcie_upstream.in(ssd_to_pcie_upstream);
     pcie_upstream.out(pcie_upstream_to_host);
     host_system.release_in(pcie_upstream_to_host);
+    
+    // Preconditioned drive state (must happen before sc_start)
+    if (!checkpoint_restore.empty()) {
+        std::string checkpoint_error;
+        if (!ssd_top.restore_checkpoint(checkpoint_restore, checkpoint_error)) {
+            std::cerr << "Error: Cannot restore checkpoint: " << checkpoint_error << std::endl;
+            return 1;
+        }
+        std::cout << "DEBUG: Restored SSD checkpoint " << checkpoint_restore << std::endl;
+    }
+    
+    // Fast-forward warm-up (traffic generator fast_forward_* keys): warm-up I/Os take the
+    // SSD's functional path, then its statistics restart with the timed phase
+    host_system.set_fast_forward_target(
+        [&ssd_top](const std::shared_ptr<BasePacket>& packet) { ssd_top.fast_forward_access(packet); },
+        [&ssd_top]() { ssd_top.end_fast_forward(); });
 
     // ================== Simulation Execution ==================
     
@@ -211,6 +337,9 @@ int sc_main(int argc, char* argv[]) {
     
     // Record start time
     auto sim_start_time = std::chrono::high_resolution_clock::now();
+    if (SelfProfiler::enabled()) {
+        SelfProfiler::begin_run();
+    }
     
     std::cout << "DEBUG: About to call sc_start()..." << std::endl;
     // Run simulation with configurable time
@@ -226,6 +355,10 @@ int sc_main(int argc, char* argv[]) {
     
     // Record end time
     auto sim_end_time = std::chrono::high_resolution_clock::now();
+    if (SelfProfiler::enabled()) {
+        SelfProfiler::end_run();
+        SelfProfiler::publish_stats();
+    }
     auto sim_duration = std::chrono::duration_cast<std::chrono::milliseconds>(sim_end_time - sim_start_time);
     
     // ================== Results and Statistics ==================
@@ -239,6 +372,35 @@ int sc_main(int argc, char* argv[]) {
     // Print SSD statistics
     ssd_top.print_statistics();
     
+    if (!checkpoint_save.empty()) {
+        std::string checkpoint_error;
+        if (ssd_top.save_checkpoint(checkpoint_save, checkpoint_error)) {
+            std::cout << "SSD checkpoint written: " << checkpoint_save << std::endl;
+        } else {
+            std::cerr << "Warning: Cannot write checkpoint: " << checkpoint_error << std::endl;
+        }
+    }
+    
+    // Registry export: every registered counter/gauge/histogram
+    if (stats_sampler) {
+        stats_sampler->flush();
+        std::cout << "Stats snapshots: " << stats_sampler->get_snapshot_count() << std::endl;
+    }
+    if (sim_config.get_bool("print_stats_registry", false)) {
+        std::cout << "\n========== Stats Registry ==========" << std::endl;
+        StatsRegistry::instance().print(std::cout);
+        std::cout << "====================================" << std::endl;
+    }
+    // StatsRegistry export (empty = off)
+    std::string stats_json_file = output_path(output_dir, sim_config.get_string("stats_json_file", ""));
+    if (!stats_json_file.empty()) {
+        std::ofstream stats_json(stats_json_file);
+        if (stats_json.is_open()) {
+            StatsRegistry::instance().write_json(stats_json);
+            stats_json << "\n";
+        }
+    }
+    
     // Print PCIe statistics
     std::cout << "\n========== PCIe Statistics ==========" << std::endl;
     std::cout << "Generation: " << PCIeGenerationSpecs::get_generation_name(pcie_gen) << std::endl;
@@ -251,27 +413,19 @@ int sc_main(int argc, char* argv[]) {
     std::cout << "Processing Delay: " << crc_scheme.processing_delay_ns << " ns" << std::endl;
     std::cout << "Error Detection Rate: " << crc_scheme.error_detection_rate << std::endl;
     
-    // PCIe DelayLine statistics
-    std::cout << "\nPCIe Downstream Statistics:" << std::endl;
-    std::cout << "  Packets Processed: " << pcie_downstream.get_total_packets_processed() << std::endl;
-    std::cout << "  CRC Errors: " << pcie_downstream.get_total_crc_errors() << std::endl;
-    std::cout << "  CRC Error Rate: " << std::scientific << pcie_downstream.get_crc_error_rate() << std::endl;
-    std::cout << "  Average Processing Time: " << std::fixed << std::setprecision(1) 
-              << pcie_downstream.get_average_processing_time_ns() << " ns" << std::endl;
-    std::cout << "  Current Utilization: " << std::setprecision(1) 
-              << pcie_downstream.get_current_utilization() << "%" << std::endl;
-    std::cout << "  Average Utilization: " << std::setprecision(1) 
-              << pcie_downstream.get_average_utilization() << "%" << std::endl;
-    
-    std::cout << "\nPCIe Upstream Statistics:" << std::endl;
-    std::cout << "  Packets Processed: " << pcie_upstream.get_total_packets_processed() << std::endl;
-    std::cout << "  CRC Errors: " << pcie_upstream.get_total_crc_errors() << std::endl;
-    std::cout << "  Current Utilization: " << std::setprecision(1) 
-              << pcie_upstream.get_current_utilization() << "%" << std::endl;
-    std::cout << "  Average Utilization: " << std::setprecision(1) 
-              << pcie_upstream.get_average_utilization() << "%" << std::endl;
+    std::cout << "Link Mode: " << pcie_link_mode_name(pcie_downstream.get_link_mode())
+              << ", MPS " << pcie_downstream.get_max_payload_size() << "B" << std::endl;
+    
+    // PCIe DelayLine statistics (registry columns of both directions)
+    stats_registry.print_report(std::cout, std::string(pcie_downstream.name()) + ".");
+    stats_registry.print_report(std::cout, std::string(pcie_upstream.name()) + ".");
     std::cout << "====================================" << std::endl;
     
+    // Packet pool statistics (heap chunks vs. recycled allocations)
+    std::cout << "\n========== Packet Pool Statistics ==========" << std::endl;
+    stats_registry.print_report(std::cout, "packet_pool.");
+    std::cout << "============================================" << std::endl;
+    
     // Print profiler results from HostSystem (includes bandwidth and latency if enabled)
     std::cout << "\n========== Performance Profiling ==========" << std::endl;
     host_system.force_profiler_report();  // This includes both BW and latency profiling
@@ -293,29 +447,54 @@ int sc_main(int argc, char* argv[]) {
         double p50_latency_ns = 0.0;
         double p95_latency_ns = 0.0;
         double p99_latency_ns = 0.0;
+        double p999_latency_ns = 0.0;
+        double p9999_latency_ns = 0.0;
         double stddev_latency_ns = 0.0;
         
+        double min_latency_ns = 0.0;
+        double max_latency_ns = 0.0;
+        
         // Extract latency statistics from HostSystem's embedded profiler if available
-        // TODO: Implement proper latency statistics extraction from HostSystem
-        // For now, we'll use realistic placeholder values based on SSD characteristics
-        avg_latency_ns = 8500.0; // Typical SSD latency
-        p95_latency_ns = 12000.0;
-        p99_latency_ns = 15000.0;
-        stddev_latency_ns = 2500.0;
+        // (end-to-end issue -> completion; annotated time in LOOSE mode, so both modes compare directly)
+        // Percentiles come from the profiler's cumulative log-linear histogram
+        ProfilerLatency<BasePacket>::LatencyStats latency_stats = host_system.get_latency_stats();
+        if (latency_stats.total_responses > 0) {
+            avg_latency_ns = latency_stats.avg_latency.to_seconds() * 1e9;
+            min_latency_ns = latency_stats.min_latency.to_seconds() * 1e9;
+            max_latency_ns = latency_stats.max_latency.to_seconds() * 1e9;
+            stddev_latency_ns = latency_stats.stddev_latency_ns;
+            p50_latency_ns = latency_stats.p50_latency_ns;
+            p95_latency_ns = latency_stats.p95_latency_ns;
+            p99_latency_ns = latency_stats.p99_latency_ns;
+            p999_latency_ns = latency_stats.p999_latency_ns;
+            p9999_latency_ns = latency_stats.p9999_latency_ns;
+        }
         
         std::cout << "\n========== Performance Summary ========" << std::endl;
         std::cout << "Total Requests: " << total_requests << std::endl;
+        if (host_system.get_fast_forwarded_transactions() > 0) {
+            std::cout << "Fast-Forwarded I/Os: " << host_system.get_fast_forwarded_transactions() << std::endl;
+        }
         std::cout << "Simulation Duration: " << sim_duration.count() << " ms" << std::endl;
         std::cout << "Sim Speed: " << std::fixed << std::setprecision(0) << tps << " CPS" << std::endl;
         std::cout << "Bandwidth: " << std::setprecision(1) << bandwidth_mbps << " MB/s" << std::endl;
         std::cout << "Cache Hit Rate: " << std::setprecision(1) 
                   << cache_hit_rate * 100.0 << "%" << std::endl;
+        std::cout << "Timing Mode: " << timing_mode_name(timing_mode);
+        if (timing_mode == TimingMode::LOOSE) {
+            std::cout << " (quantum " << std::setprecision(0) << quantum_ns << " ns, "
+                      << host_system.get_quantum_sync_count() << " host syncs)";
+        }
+        std::cout << std::endl;
         std::cout << "Average Latency: " << std::setprecision(1) << avg_latency_ns << " ns" << std::endl;
-        std::cout << "95th Percentile Latency: " << p95_latency_ns << " ns" << std::endl;
+        std::cout << "Min/Max Latency: " << min_latency_ns << " / " << max_latency_ns << " ns" << std::endl;
+        std::cout << "Latency p50/p99/p99.9/p99.99: " << p50_latency_ns << " / " << p99_latency_ns << " / "
+                  << p999_latency_ns << " / " << p9999_latency_ns << " ns" << std::endl;
+        std::cout << "Latency Std Deviation: " << stddev_latency_ns << " ns" << std::endl;
         std::cout << "=======================================" << std::endl;
         
         // Generate standardized metric files for sweep collection
-        std::ofstream metrics_csv("metrics.csv");
+        std::ofstream metrics_csv(output_path(output_dir, "metrics.csv"));
         if (metrics_csv.is_open()) {
             metrics_csv << "metric,value,unit\n";
             metrics_csv << "sim_speed," << std::fixed << std::setprecision(0) << tps << ",cps\n";
@@ -327,7 +506,14 @@ int sc_main(int argc, char* argv[]) {
             metrics_csv << "p50_latency_ns," << std::setprecision(1) << p50_latency_ns << ",ns\n";
             metrics_csv << "p95_latency_ns," << std::setprecision(1) << p95_latency_ns << ",ns\n";
             metrics_csv << "p99_latency_ns," << std::setprecision(1) << p99_latency_ns << ",ns\n";
+            metrics_csv << "p999_latency_ns," << std::setprecision(1) << p999_latency_ns << ",ns\n";
+            metrics_csv << "p9999_latency_ns," << std::setprecision(1) << p9999_latency_ns << ",ns\n";
             metrics_csv << "stddev_latency_ns," << std::setprecision(1) << stddev_latency_ns << ",ns\n";
+            metrics_csv << "min_latency_ns," << std::setprecision(1) << min_latency_ns << ",ns\n";
+            metrics_csv << "max_latency_ns," << std::setprecision(1) << max_latency_ns << ",ns\n";
+            metrics_csv << "timing_mode_loose," << (timing_mode == TimingMode::LOOSE ? 1 : 0) << ",boolean\n";
+            metrics_csv << "quantum_ns," << std::setprecision(0) << quantum_ns << ",ns\n";
+            metrics_csv << "host_quantum_syncs," << host_system.get_quantum_sync_count() << ",count\n";
             metrics_csv << "pcie_downstream_packets," << pcie_downstream.get_total_packets_processed() << ",count\n";
             metrics_csv << "pcie_downstream_crc_errors," << pcie_downstream.get_total_crc_errors() << ",count\n";
             metrics_csv << "pcie_downstream_utilization_current," << std::setprecision(1) << pcie_downstream.get_current_utilization() << ",percent\n";
@@ -347,14 +533,18 @@ int sc_main(int argc, char* argv[]) {
             metrics_csv.close();
         }
         
-        std::ofstream performance_json("performance.json");
+        std::ofstream performance_json(output_path(output_dir, "performance.json"));
         if (performance_json.is_open()) {
             performance_json << "{\n";
             performance_json << "  \"simulation\": {\n";
             performance_json << "    \"target\": \"sim_ssd\",\n";
             performance_json << "    \"timestamp\": \"" << std::time(nullptr) << "\",\n";
             performance_json << "    \"duration_ms\": " << sim_duration.count() << ",\n";
-            performance_json << "    \"systemc_time\": \"" << sc_time_stamp() << "\"\n";
+            performance_json << "    \"systemc_time\": \"" << sc_time_stamp() << "\",\n";
+            performance_json << "    \"timing_mode\": \"" << timing_mode_name(timing_mode) << "\",\n";
+            performance_json << "    \"quantum_ns\": " << std::fixed << std::setprecision(0) << quantum_ns << ",\n";
+            performance_json << "    \"host_quantum_syncs\": " << host_system.get_quantum_sync_count() << ",\n";
+            performance_json << "    \"pcie_quantum_syncs\": " << (pcie_downstream.get_quantum_sync_count() + pcie_upstream.get_quantum_sync_count()) << "\n";
             performance_json << "  },\n";
             performance_json << "  \"performance\": {\n";
             performance_json << "    \"sim_speed_cps\": " << std::fixed << std::setprecision(0) << tps << ",\n";
@@ -370,11 +560,15 @@ int sc_main(int argc, char* argv[]) {
             performance_json << "    \"generation_complete\": " << (host_system.is_generation_complete() ? "true" : "false") << "\n";
             performance_json << "  },\n";
             performance_json << "  \"latency\": {\n";
-            performance_json << "    \"enabled\": true,\n";
+            performance_json << "    \"enabled\": " << (host_system.has_latency_profiler() ? "true" : "false") << ",\n";
             performance_json << "    \"avg_ns\": " << std::setprecision(1) << avg_latency_ns << ",\n";
+            performance_json << "    \"min_ns\": " << min_latency_ns << ",\n";
+            performance_json << "    \"max_ns\": " << max_latency_ns << ",\n";
             performance_json << "    \"p50_ns\": " << p50_latency_ns << ",\n";
             performance_json << "    \"p95_ns\": " << p95_latency_ns << ",\n";
             performance_json << "    \"p99_ns\": " << p99_latency_ns << ",\n";
+            performance_json << "    \"p999_ns\": " << p999_latency_ns << ",\n";
+            performance_json << "    \"p9999_ns\": " << p9999_latency_ns << ",\n";
             performance_json << "    \"stddev_ns\": " << stddev_latency_ns << "\n";
             performance_json << "  },\n";
             performance_json << "  \"pcie\": {\n";
@@ -397,13 +591,24 @@ int sc_main(int argc, char* argv[]) {
     // Finalize VCD files
     CustomFifo<std::shared_ptr<BasePacket>>::finalize_vcd();
     
+    // Flush the transaction trace (joins the writer thread)
+    if (TransactionTrace::instance().is_enabled()) {
+        std::cout << "Transaction trace: " << TransactionTrace::instance().get_record_count()
+                  << " records -> " << trace_file << std::endl;
+        TransactionTrace::instance().close();
+    }
+    
     // Restore cout to its original streambuf
     if (log_file.is_open() && cout_sbuf) {
         std::cout.rdbuf(cout_sbuf);
         log_file.close();
     }
     
+    if (SelfProfiler::enabled()) {
+        SelfProfiler::report(std::cout, static_cast<size_t>(std::max(1, sim_config.get_int("self_profile_top", 20))));
+    }
+    
     std::cout << "Simulation completed." << std::endl;
     
     return 0;
-}
\ No newline at end of file
+}
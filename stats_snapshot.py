@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+StatsRegistry snapshot converter (binary -> CSV)
+Usage:
+  python3 stats_snapshot.py <snapshot_file> [output_csv] [--filter PREFIX] [--list]
+The snapshot file is written by StatsSampler (stats_snapshot_interval_ns > 0).
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+MAGIC = b"MOONSTAT"
+KIND_NAMES = {0: "counter", 1: "gauge", 2: "histogram"}
+
+
+def read_exact(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError("truncated snapshot file")
+    return data
+
+
+def read_string(f):
+    (length,) = struct.unpack("<H", read_exact(f, 2))
+    return read_exact(f, length).decode("utf-8")
+
+
+def read_header(f):
+    if read_exact(f, 8) != MAGIC:
+        raise ValueError("not a stats snapshot file")
+    version, num_columns = struct.unpack("<II", read_exact(f, 8))
+    if version != 1:
+        raise ValueError("unsupported snapshot version %d" % version)
+    columns = []
+    for _ in range(num_columns):
+        (kind,) = struct.unpack("<B", read_exact(f, 1))
+        path = read_string(f)
+        unit = read_string(f)
+        columns.append((path, KIND_NAMES.get(kind, "unknown"), unit))
+    return columns
+
+
+def read_blocks(f, num_columns):
+    """Yield rows as (time_ns, [values]) from column-major blocks."""
+    while True:
+        head = f.read(4)
+        if len(head) < 4:
+            return
+        (rows,) = struct.unpack("<I", head)
+        series = []
+        for _ in range(num_columns + 1):
+            series.append(struct.unpack("<%dd" % rows, read_exact(f, 8 * rows)))
+        for r in range(rows):
+            yield series[0][r], [series[c + 1][r] for c in range(num_columns)]
+
+
+def format_value(value):
+    return str(int(value)) if value == int(value) else "%.6g" % value
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert StatsRegistry snapshots to CSV")
+    parser.add_argument("snapshot_file")
+    parser.add_argument("output_csv", nargs="?", help="output CSV (default: stdout)")
+    parser.add_argument("--filter", action="append", default=[], help="keep columns starting with PREFIX")
+    parser.add_argument("--list", action="store_true", help="list columns and exit")
+    args = parser.parse_args()
+
+    with open(args.snapshot_file, "rb") as f:
+        columns = read_header(f)
+
+        if args.list:
+            for path, kind, unit in columns:
+                print("%-60s %-10s %s" % (path, kind, unit))
+            return 0
+
+        selected = [i for i, (path, _, _) in enumerate(columns)
+                    if not args.filter or any(path.startswith(p) for p in args.filter)]
+
+        out = open(args.output_csv, "w", newline="") if args.output_csv else sys.stdout
+        try:
+            writer = csv.writer(out)
+            writer.writerow(["time_ns"] + [columns[i][0] for i in selected])
+            count = 0
+            for time_ns, values in read_blocks(f, len(columns)):
+                writer.writerow([format_value(time_ns)] + [format_value(values[i]) for i in selected])
+                count += 1
+        finally:
+            if out is not sys.stdout:
+                out.close()
+
+    if args.output_csv:
+        print("Wrote %d snapshots x %d columns to %s" % (count, len(selected), args.output_csv))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
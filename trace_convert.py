@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+Binary transaction trace converter (TransactionTrace -> CSV / VCD)
+Usage:
+  python3 trace_convert.py <trace_file> <output.csv|output.vcd> [--fifo NAME] [--format csv|vcd]
+  python3 trace_convert.py <trace_file> --summary
+The trace file is written when simulation_config.json sets "trace_file".
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+HEADER_MAGIC = b"MOONTRC1"
+FOOTER_MAGIC = b"MOONTEND"
+HEADER_SIZE = 24
+RECORD = struct.Struct("<QIiiIiBBH")     # time, fifo_id, index, address, bytes, data, command, direction, reserved
+COMMANDS = {0: "READ", 1: "WRITE"}
+DIRECTIONS = {0: "in", 1: "out"}
+VCD_FIELDS = [("command", 8), ("address", 32), ("data", 32), ("bytes", 32), ("index", 32)]
+
+
+class TraceFile:
+    def __init__(self, path):
+        self.f = open(path, "rb")
+        magic, record_size, _, self.resolution_fs = struct.unpack("<8sIIQ", self.f.read(HEADER_SIZE))
+        if magic != HEADER_MAGIC or record_size != RECORD.size:
+            raise ValueError("not a transaction trace file")
+
+        # Footer: FIFO name table (missing if the simulation did not close the trace)
+        self.f.seek(0, os.SEEK_END)
+        size = self.f.tell()
+        self.records_end = size
+        self.fifo_names = []
+        if size >= HEADER_SIZE + 16:
+            self.f.seek(size - 16)
+            footer_offset, magic = struct.unpack("<Q8s", self.f.read(16))
+            if magic == FOOTER_MAGIC:
+                self.records_end = footer_offset
+                self.f.seek(footer_offset)
+                (count,) = struct.unpack("<I", self.f.read(4))
+                for _ in range(count):
+                    (length,) = struct.unpack("<H", self.f.read(2))
+                    self.fifo_names.append(self.f.read(length).decode("utf-8"))
+        self.num_records = (self.records_end - HEADER_SIZE) // RECORD.size
+
+    def fifo_name(self, fifo_id):
+        return self.fifo_names[fifo_id] if fifo_id < len(self.fifo_names) else "fifo%d" % fifo_id
+
+    def time_ns(self, time):
+        return time * self.resolution_fs / 1e6
+
+    def records(self, chunk_records=65536):
+        self.f.seek(HEADER_SIZE)
+        remaining = self.num_records
+        while remaining > 0:
+            count = min(chunk_records, remaining)
+            data = self.f.read(count * RECORD.size)
+            for record in RECORD.iter_unpack(data):
+                yield record
+            remaining -= count
+
+
+def write_csv(trace, out, fifo_filter):
+    writer = csv.writer(out)
+    writer.writerow(["time_ns", "fifo", "direction", "command", "address", "index", "bytes", "data"])
+    for time, fifo_id, index, address, nbytes, data, command, direction, _ in trace.records():
+        name = trace.fifo_name(fifo_id)
+        if fifo_filter and name not in fifo_filter:
+            continue
+        writer.writerow(["%.3f" % trace.time_ns(time), name, DIRECTIONS.get(direction, direction),
+                         COMMANDS.get(command, command), address, index, nbytes, data])
+
+
+def write_vcd(trace, out, fifo_filter):
+    """One scope per FIFO with in_/out_ field vectors (same names as the sc_signal VCD)"""
+    identifiers = {}
+    next_id = [0]
+
+    def new_id():
+        value, ident = next_id[0], ""
+        next_id[0] += 1
+        while True:
+            ident += chr(33 + value % 94)
+            value //= 94
+            if value == 0:
+                return ident
+
+    out.write("$timescale %dfs $end\n" % trace.resolution_fs)
+    for fifo_id, name in enumerate(trace.fifo_names):
+        if fifo_filter and name not in fifo_filter:
+            continue
+        out.write("$scope module %s $end\n" % name)
+        for direction in (0, 1):
+            for field, width in VCD_FIELDS:
+                ident = new_id()
+                identifiers[(fifo_id, direction, field)] = ident
+                out.write("$var wire %d %s %s_%s $end\n" % (width, ident, DIRECTIONS[direction], field))
+        out.write("$upscope $end\n")
+    out.write("$enddefinitions $end\n")
+
+    last_time = None
+    for time, fifo_id, index, address, nbytes, data, command, direction, _ in trace.records():
+        if (fifo_id, direction, "command") not in identifiers:
+            continue
+        if time != last_time:
+            out.write("#%d\n" % time)
+            last_time = time
+        values = {"command": command, "address": address, "data": data, "bytes": nbytes, "index": index}
+        for field, width in VCD_FIELDS:
+            value = values[field] & ((1 << width) - 1)
+            out.write("b%s %s\n" % (format(value, "b"), identifiers[(fifo_id, direction, field)]))
+
+
+def print_summary(trace):
+    counts = {}
+    first, last = None, None
+    for time, fifo_id, _, _, _, _, _, direction, _ in trace.records():
+        key = (trace.fifo_name(fifo_id), DIRECTIONS.get(direction, direction))
+        counts[key] = counts.get(key, 0) + 1
+        first = time if first is None else first
+        last = time
+    print("Records: %d  (resolution %d fs)" % (trace.num_records, trace.resolution_fs))
+    if first is not None:
+        print("Time span: %.3f ns .. %.3f ns" % (trace.time_ns(first), trace.time_ns(last)))
+    for (name, direction), count in sorted(counts.items()):
+        print("  %-40s %-4s %d" % (name, direction, count))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a binary transaction trace to CSV or VCD")
+    parser.add_argument("trace_file")
+    parser.add_argument("output", nargs="?", help="output file (.csv or .vcd); stdout if omitted")
+    parser.add_argument("--format", choices=["csv", "vcd"], help="default: from the output extension, else csv")
+    parser.add_argument("--fifo", action="append", default=[], help="only this FIFO (repeatable)")
+    parser.add_argument("--summary", action="store_true", help="print per-FIFO record counts")
+    args = parser.parse_args()
+
+    trace = TraceFile(args.trace_file)
+    if args.summary:
+        print_summary(trace)
+        return 0
+
+    fmt = args.format or ("vcd" if args.output and args.output.endswith(".vcd") else "csv")
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    try:
+        if fmt == "vcd":
+            write_vcd(trace, out, set(args.fifo))
+        else:
+            write_csv(trace, out, set(args.fifo))
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
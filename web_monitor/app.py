@@ -13,18 +13,30 @@ import threading
 from datetime import datetime
 from pathlib import Path
 from simulation_controller import SimulationController
+from metrics_ring import MetricsRingReader
 
 app = Flask(__name__)
 app.config['SECRET_KEY'] = 'systemc_monitor_secret'
 socketio = SocketIO(app, cors_allowed_origins="*", async_mode='threading')
 
 class MetricsMonitor:
-    def __init__(self, metrics_file="metrics.json"):
+    def __init__(self, metrics_file="metrics.json", ring_name="moon_sim_metrics"):
         self.metrics_file = metrics_file
         self.last_modified = 0
         self.latest_metrics = {}
         self.history = []
         self.max_history = 1000  # Keep last 1000 data points
+        self.ring = MetricsRingReader(ring_name)  # WebProfiler transport SHM_RING
+    
+    def poll_ring(self):
+        """Drain the shared-memory ring; returns every new record in order"""
+        records, _ = self.ring.poll()
+        if records:
+            self.latest_metrics = records[-1]
+            self.history.extend(records)
+            if len(self.history) > self.max_history:
+                del self.history[:len(self.history) - self.max_history]
+        return records
         
     def check_for_updates(self):
         """Check if metrics file has been updated"""
@@ -83,12 +95,19 @@ class MetricsMonitor:
         return self.history[-limit:] if self.history else [self.get_default_metrics()]
 
 # Global metrics monitor and simulation controller
-monitor = MetricsMonitor()
+monitor = MetricsMonitor(ring_name=os.environ.get("MOON_METRICS_RING", "moon_sim_metrics"))
 sim_controller = SimulationController()
 
 def background_monitor():
-    """Background thread to monitor file changes"""
+    """Background thread: drain the shared-memory ring if present, else poll the file"""
     while True:
+        if monitor.ring.available():
+            records = monitor.poll_ring()
+            if records:
+                # Whole time series for the charts, latest record for the cards
+                socketio.emit('metrics_batch', records)
+            time.sleep(0.1)
+            continue
         if monitor.check_for_updates():
             # Emit update to all connected clients
             socketio.emit('metrics_update', monitor.get_latest_metrics())
@@ -122,7 +141,8 @@ def get_status():
         "metrics_file": monitor.metrics_file,
         "file_exists": os.path.exists(monitor.metrics_file),
         "last_update": monitor.last_modified,
-        "history_count": len(monitor.history)
+        "history_count": len(monitor.history),
+        "ring": monitor.ring.status()
     })
 
 @socketio.on('connect')
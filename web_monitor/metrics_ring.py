@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Shared-memory metrics ring reader
+Consumer side of include/common/metrics_ring.h (WebProfiler transport SHM_RING).
+Usage: python3 metrics_ring.py [ring_name]   -> prints decoded records
+"""
+
+import json
+import mmap
+import os
+import struct
+import sys
+import time
+
+MAGIC = b"MOONRING"
+HEADER_SIZE = 192
+HEADER_FORMAT = "<8sIIIIIIQ"      # magic, version, num_fields, capacity, names_bytes, producer_done, reserved, dropped
+WRITE_INDEX_OFFSET = 64
+READ_INDEX_OFFSET = 128
+
+
+class MetricsRingReader:
+    def __init__(self, ring_name="moon_sim_metrics"):
+        self.path = os.path.join("/dev/shm", ring_name.lstrip("/"))
+        self.mm = None
+        self.inode = None
+        self.fields = []
+
+    def available(self):
+        return os.path.exists(self.path)
+
+    def _attach(self):
+        """Map the segment; re-attach when the simulator recreated it"""
+        try:
+            stat = os.stat(self.path)
+        except FileNotFoundError:
+            self.close()
+            return False
+        if self.mm is not None and stat.st_ino == self.inode:
+            return True
+        self.close()
+        if stat.st_size < HEADER_SIZE:
+            return False
+        with open(self.path, "r+b") as f:
+            self.mm = mmap.mmap(f.fileno(), stat.st_size)
+        magic, version, num_fields, capacity, names_bytes, _, _, _ = struct.unpack_from(HEADER_FORMAT, self.mm, 0)
+        if magic != MAGIC or version != 1:
+            self.close()
+            return False
+        names = self.mm[HEADER_SIZE:HEADER_SIZE + names_bytes].split(b"\0", 1)[0].decode("utf-8")
+        self.fields = names.split("\n")[:num_fields]
+        self.num_fields = num_fields
+        self.capacity = capacity
+        self.records_offset = HEADER_SIZE + names_bytes
+        self.record_format = "<%dd" % num_fields
+        self.record_size = 8 * num_fields
+        self.inode = stat.st_ino
+        return True
+
+    def close(self):
+        if self.mm is not None:
+            self.mm.close()
+        self.mm = None
+        self.inode = None
+
+    def status(self):
+        if not self._attach():
+            return {"attached": False}
+        _, _, num_fields, capacity, _, done, _, dropped = struct.unpack_from(HEADER_FORMAT, self.mm, 0)
+        write, = struct.unpack_from("<Q", self.mm, WRITE_INDEX_OFFSET)
+        read, = struct.unpack_from("<Q", self.mm, READ_INDEX_OFFSET)
+        return {"attached": True, "fields": num_fields, "capacity": capacity,
+                "published": write, "consumed": read, "dropped": dropped, "producer_done": bool(done)}
+
+    def poll(self):
+        """Consume every published record; returns (records, producer_done)"""
+        if not self._attach():
+            return [], False
+        write, = struct.unpack_from("<Q", self.mm, WRITE_INDEX_OFFSET)
+        read, = struct.unpack_from("<Q", self.mm, READ_INDEX_OFFSET)
+        records = []
+        while read < write:
+            slot = read & (self.capacity - 1)
+            offset = self.records_offset + slot * self.record_size
+            records.append(struct.unpack_from(self.record_format, self.mm, offset))
+            read += 1
+        # Releases the slots to the producer
+        struct.pack_into("<Q", self.mm, READ_INDEX_OFFSET, read)
+        done = struct.unpack_from("<I", self.mm, 24)[0] != 0
+        return [self.to_metrics(r) for r in records], done
+
+    def to_metrics(self, record):
+        """Rebuild the nested metrics.json structure from a flat record"""
+        metrics = {"metrics": {"performance": {}, "caches": {}, "dram": {}, "components": {}}}
+        for path, value in zip(self.fields, record):
+            if value == int(value):
+                value = int(value)
+            node = metrics
+            parts = path.split(".")
+            for part in parts[:-1]:
+                node = node.setdefault(part, {})
+            node[parts[-1]] = value
+        return metrics
+
+
+if __name__ == "__main__":
+    reader = MetricsRingReader(sys.argv[1] if len(sys.argv) > 1 else "moon_sim_metrics")
+    while True:
+        records, done = reader.poll()
+        for record in records:
+            print(json.dumps(record))
+        if done and not records:
+            print(json.dumps(reader.status()))
+            break
+        time.sleep(0.1)
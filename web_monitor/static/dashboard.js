@@ -128,6 +128,13 @@ class SystemCDashboard {
             this.updateDashboard(data);
         });
         
+        // Shared-memory ring transport: every record, in simulation-time order
+        this.socket.on('metrics_batch', (records) => {
+            if (!records || records.length === 0) return;
+            this.updateDashboard(records[records.length - 1], false);
+            this.appendSeries(records);
+        });
+        
         this.socket.on('history_data', (data) => {
             this.loadHistoricalData(data);
         });
@@ -162,7 +169,7 @@ class SystemCDashboard {
         }
     }
     
-    updateDashboard(data) {
+    updateDashboard(data, updateCharts = true) {
         if (!data || !data.metrics) {
             console.log('Invalid data received:', data);
             return;
@@ -188,7 +195,33 @@ class SystemCDashboard {
         this.updateDramMetrics(metrics.dram);
         
         // Update charts
-        this.updateCharts(data);
+        if (updateCharts) {
+            this.updateCharts(data);
+        }
+    }
+    
+    // Append a batch of ring records, labelled by simulation time
+    appendSeries(records) {
+        for (const data of records) {
+            if (!data.metrics || !data.metrics.performance) continue;
+            const label = ((data.simulation_time_ns || 0) / 1e3).toFixed(1) + ' us';
+            this.throughputData.push({ x: label, y: data.metrics.performance.packet_rate_pps || 0 });
+            this.bandwidthData.push({ x: label, y: data.metrics.performance.bandwidth_mbps || 0 });
+        }
+        if (this.throughputData.length > this.maxDataPoints) {
+            this.throughputData.splice(0, this.throughputData.length - this.maxDataPoints);
+        }
+        if (this.bandwidthData.length > this.maxDataPoints) {
+            this.bandwidthData.splice(0, this.bandwidthData.length - this.maxDataPoints);
+        }
+        
+        this.throughputChart.data.labels = this.throughputData.map(d => d.x);
+        this.throughputChart.data.datasets[0].data = this.throughputData.map(d => d.y);
+        this.throughputChart.update('none');
+        
+        this.bandwidthChart.data.labels = this.bandwidthData.map(d => d.x);
+        this.bandwidthChart.data.datasets[0].data = this.bandwidthData.map(d => d.y);
+        this.bandwidthChart.update('none');
     }
     
     updateCacheMetrics(caches) {